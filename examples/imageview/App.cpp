@@ -93,7 +93,10 @@ namespace imageview
     {
         try
         {
-            auto doc = Document::create(_context, path);
+            auto doc = Document::create(
+                _context,
+                std::dynamic_pointer_cast<App>(shared_from_this()),
+                path);
             _documentModel->add(doc);
             _recentFilesModel->addRecent(Path(path.u8string()));
         }
@@ -113,7 +116,10 @@ namespace imageview
         {
             try
             {
-                auto doc = Document::create(_context, path);
+                auto doc = Document::create(
+                    _context,
+                    std::dynamic_pointer_cast<App>(shared_from_this()),
+                    path);
                 _documentModel->add(doc);
                 _recentFilesModel->addRecent(Path(path.u8string()));
             }
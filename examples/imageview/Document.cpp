@@ -3,6 +3,8 @@
 
 #include "Document.h"
 
+#include <ftk/UI/App.h>
+
 #include <ftk/Core/Context.h>
 #include <ftk/Core/ImageIO.h>
 
@@ -12,24 +14,52 @@ namespace imageview
 {
     void Document::_init(
         const std::shared_ptr<Context>& context,
+        const std::shared_ptr<ftk::App>& app,
         const std::filesystem::path& path)
     {
         _path = path;
+        _image = Observable<std::shared_ptr<Image> >::create();
 
+        // Read the image in the background so the UI is not blocked, and
+        // hand it to the main thread when it is done.
         auto io = context->getSystem<ImageIO>();
-        auto read = io->read(path);
-        _image = read->read();
+        _ioWeak = io;
+        std::weak_ptr<ftk::App> appWeak(app);
+        std::weak_ptr<Document> weak(std::dynamic_pointer_cast<Document>(shared_from_this()));
+        _requestID = io->readAsync(
+            path,
+            [appWeak, weak](const std::shared_ptr<Image>& image)
+            {
+                if (auto app = appWeak.lock())
+                {
+                    app->post(
+                        [weak, image]
+                        {
+                            if (auto doc = weak.lock())
+                            {
+                                doc->_image->setIfChanged(image);
+                            }
+                        });
+                }
+            }).id;
     }
 
     Document::~Document()
-    {}
+    {
+        // Nothing happens if the request has already finished.
+        if (auto io = _ioWeak.lock())
+        {
+            io->cancelRequests({ _requestID });
+        }
+    }
 
     std::shared_ptr<Document> Document::create(
         const std::shared_ptr<Context>& context,
+        const std::shared_ptr<ftk::App>& app,
         const std::filesystem::path& path)
     {
         auto out = std::shared_ptr<Document>(new Document);
-        out->_init(context, path);
+        out->_init(context, app, path);
         return out;
     }
 
@@ -49,6 +79,11 @@ namespace imageview
     }
 
     const std::shared_ptr<ftk::Image>& Document::getImage() const
+    {
+        return _image->get();
+    }
+
+    std::shared_ptr<IObservable<std::shared_ptr<Image> > > Document::observeImage() const
     {
         return _image;
     }
@@ -5,10 +5,16 @@
 
 #include <ftk/UI/DocumentModel.h>
 
-#include <ftk/Core/Image.h>
+#include <ftk/Core/ImageIO.h>
+#include <ftk/Core/Observable.h>
 
 #include <filesystem>
 
+namespace ftk
+{
+    class App;
+}
+
 namespace imageview
 {
     //! Document.
@@ -17,6 +23,7 @@ namespace imageview
     protected:
         void _init(
             const std::shared_ptr<ftk::Context>&,
+            const std::shared_ptr<ftk::App>&,
             const std::filesystem::path& = std::filesystem::path());
 
         Document() = default;
@@ -27,6 +34,7 @@ namespace imageview
         //! Create a new document.
         static std::shared_ptr<Document> create(
             const std::shared_ptr<ftk::Context>&,
+            const std::shared_ptr<ftk::App>&,
             const std::filesystem::path& = std::filesystem::path());
 
         //! \name Information
@@ -41,12 +49,19 @@ namespace imageview
         //! \name Image
         ///@{
 
+        //! Get the image. The image is read in the background, and is null
+        //! until it has been read.
         const std::shared_ptr<ftk::Image>& getImage() const;
 
+        //! Observe the image.
+        std::shared_ptr<ftk::IObservable<std::shared_ptr<ftk::Image> > > observeImage() const;
+
         ///@}
 
     private:
         std::filesystem::path _path;
-        std::shared_ptr<ftk::Image> _image;
+        std::weak_ptr<ftk::ImageIO> _ioWeak;
+        uint64_t _requestID = 0;
+        std::shared_ptr<ftk::Observable<std::shared_ptr<ftk::Image> > > _image;
     };
 }
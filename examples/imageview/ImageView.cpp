@@ -21,9 +21,18 @@ namespace imageview
     {
         IWidget::_init(context, "examples::imageview::ImageView", parent);
 
-        _image = doc->getImage();
         _zoom = Observable<float>::create(1.F);
         _channelDisplay = Observable<ChannelDisplay>::create(ChannelDisplay::Color);
+
+        _imageObserver = Observer<std::shared_ptr<Image> >::create(
+            doc->observeImage(),
+            [this](const std::shared_ptr<Image>& value)
+            {
+                _image = value;
+                _frameInit = true;
+                setSizeUpdate();
+                setDrawUpdate();
+            });
     }
 
     ImageView::~ImageView()
@@ -65,5 +65,6 @@ namespace imageview
         std::shared_ptr<ftk::Observable<float> > _zoom;
         bool _frameInit = true;
         std::shared_ptr<ftk::Observable<ftk::ChannelDisplay> > _channelDisplay;
+        std::shared_ptr<ftk::Observer<std::shared_ptr<ftk::Image> > > _imageObserver;
     };
 }
@@ -37,20 +37,22 @@ namespace imageview
             app->getDocumentModel()->observeCurrent(),
             [this, appWeak](const std::shared_ptr<IDocument>& idoc)
             {
-                std::string text;
                 if (auto doc = std::dynamic_pointer_cast<Document>(idoc))
                 {
-                    if (auto image = doc->getImage())
-                    {
-                        const Size2I& size = image->getSize();
-                        text = Format("Size: {0}x{1}, Aspect ratio: {2}, Type: {3}").
-                            arg(size.w).
-                            arg(size.h).
-                            arg(image->getAspect(), 2).
-                            arg(image->getType());
-                    }
+                    // The image is read in the background, so observe it
+                    // rather than getting it once.
+                    _imageObserver = Observer<std::shared_ptr<Image> >::create(
+                        doc->observeImage(),
+                        [this](const std::shared_ptr<Image>& image)
+                        {
+                            _imageUpdate(image);
+                        });
+                }
+                else
+                {
+                    _imageObserver.reset();
+                    _imageUpdate(nullptr);
                 }
-                _labels["Info"]->setText(text);
             });
     }
 
@@ -67,5 +69,18 @@ namespace imageview
         return out;
     }
 
-
+    void StatusBar::_imageUpdate(const std::shared_ptr<Image>& image)
+    {
+        std::string text;
+        if (image)
+        {
+            const Size2I& size = image->getSize();
+            text = Format("Size: {0}x{1}, Aspect ratio: {2}, Type: {3}").
+                arg(size.w).
+                arg(size.h).
+                arg(image->getAspect(), 2).
+                arg(image->getType());
+        }
+        _labels["Info"]->setText(text);
+    }
 }
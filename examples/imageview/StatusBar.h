@@ -34,9 +34,12 @@ namespace imageview
 
 
     private:
+        void _imageUpdate(const std::shared_ptr<ftk::Image>&);
+
         std::map<std::string, std::shared_ptr<ftk::Label> > _labels;
         std::shared_ptr<ftk::HorizontalLayout> _layout;
 
         std::shared_ptr<ftk::Observer<std::shared_ptr<ftk::IDocument> > > _currentObserver;
+        std::shared_ptr<ftk::Observer<std::shared_ptr<ftk::Image> > > _imageObserver;
     };
 }
@@ -45,7 +45,7 @@ namespace objview
         return _path.u8string();
     }
 
-    const std::shared_ptr<ftk::TriMesh3F>& Document::getMesh() const
+    const std::shared_ptr<ftk::IdxMesh3F>& Document::getMesh() const
     {
         return _mesh;
     }
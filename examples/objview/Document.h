@@ -41,7 +41,7 @@ namespace objview
         //! \name Mesh
         ///@{
 
-        const std::shared_ptr<ftk::TriMesh3F>& getMesh() const;
+        const std::shared_ptr<ftk::IdxMesh3F>& getMesh() const;
 
         ///@}
 
@@ -56,7 +56,7 @@ namespace objview
 
     private:
         std::filesystem::path _path;
-        std::shared_ptr<ftk::TriMesh3F> _mesh;
+        std::shared_ptr<ftk::IdxMesh3F> _mesh;
         std::shared_ptr<ftk::Observable<ftk::V3F> > _rotation;
     };
 }
@@ -34,7 +34,7 @@ namespace objview
         {
             _labels["Name"]->setText(Format("Path: {0}").arg(doc->getPath().u8string()));
             auto mesh = doc->getMesh();
-            _labels["Triangles"]->setText(Format("Triangles: {0}").arg(mesh ? mesh->triangles.size() : 0));
+            _labels["Triangles"]->setText(Format("Triangles: {0}").arg(mesh ? mesh->indices.size() / 3 : 0));
         }
 
         // Layout the widgets.
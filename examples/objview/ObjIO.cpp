@@ -10,30 +10,30 @@ using namespace ftk;
 
 namespace objview
 {
-    std::shared_ptr<ftk::TriMesh3F> read(const std::filesystem::path& path)
+    std::shared_ptr<ftk::IdxMesh3F> read(const std::filesystem::path& path)
     {
         const auto lines = readLines(path);
-        auto out = std::make_shared<ftk::TriMesh3F>();
+        TriMesh3F mesh;
         for (const auto& line : lines)
         {
             const auto split = ftk::split(line, { ' ', '\t' });
             const size_t size = split.size();
             if (size >= 4 && "v" == split[0])
             {
-                out->v.push_back(V3F(
+                mesh.v.push_back(V3F(
                     std::atof(split[1].c_str()),
                     std::atof(split[2].c_str()),
                     std::atof(split[3].c_str())));
             }
             else if (size >= 3 && "vt" == split[0])
             {
-                out->t.push_back(V2F(
+                mesh.t.push_back(V2F(
                     std::atof(split[1].c_str()),
                     std::atof(split[2].c_str())));
             }
             else if (size >= 4 && "vn" == split[0])
             {
-                out->n.push_back(V3F(
+                mesh.n.push_back(V3F(
                     std::atof(split[1].c_str()),
                     std::atof(split[2].c_str()),
                     std::atof(split[3].c_str())));
@@ -62,10 +62,10 @@ namespace objview
                     t.v[0] = vs[0];
                     t.v[2] = vs[i];
                     t.v[1] = vs[i + 1];
-                    out->triangles.push_back(t);
+                    mesh.triangles.push_back(t);
                 }
             }
         }
-        return out;
+        return std::make_shared<ftk::IdxMesh3F>(indexed(mesh));
     }
 }
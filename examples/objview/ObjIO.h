@@ -14,5 +14,5 @@ namespace objview
     //! * texture vertices
     //! * normals
     //! * faces
-    std::shared_ptr<ftk::TriMesh3F> read(const std::filesystem::path&);
+    std::shared_ptr<ftk::IdxMesh3F> read(const std::filesystem::path&);
 }
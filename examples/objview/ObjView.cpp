@@ -30,7 +30,7 @@ namespace objview
 
         // Initialize the mesh.
         _mesh = doc->getMesh();
-        //_mesh = std::make_shared<ftk::TriMesh3F>(sphere(5.F, 64, 64));
+        //_mesh = std::make_shared<ftk::IdxMesh3F>(indexed(sphere(5.F, 64, 64)));
         if (_mesh)
         {
             _objectBBox = bbox(*_mesh);
@@ -397,13 +397,19 @@ namespace objview
             }
 
             // Create the mesh vertex buffer.
-            if (_mesh && !_mesh->triangles.empty() && !_vbo)
+            if (_mesh && !_mesh->indices.empty() && !_vbo)
             {
                 _vbo = gl::VBO::create(
-                    _mesh->triangles.size() * 3,
+                    _mesh->v.size(),
                     gl::VBOType::Pos3_F32_UV_F32_Normal_F32_Color_F32);
                 _vbo->copy(gl::convert(*_mesh, _vbo->getType()));
                 _vao = gl::VAO::create(_vbo->getType(), _vbo->getID());
+                _ibo = gl::IBO::create(
+                    _mesh->indices.size(),
+                    gl::getIndexType(_mesh->v.size()));
+                _vao->bind();
+                _ibo->bind();
+                _ibo->copy(_mesh->indices);
             }
 
             // Create the shaders.
@@ -463,7 +469,7 @@ namespace objview
                 glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
                 // Draw the mesh.
-                if (_vbo && _vao)
+                if (_vbo && _vao && _ibo)
                 {
                     _shader->bind();
                     _shader->setUniform("transform.m", model);
@@ -482,7 +488,7 @@ namespace objview
                         glDisable(GL_CULL_FACE);
                     }
                     _vao->bind();
-                    _vao->draw(GL_TRIANGLES, 0, _vbo->getSize());
+                    _vao->drawElements(GL_TRIANGLES, 0, _ibo->getSize(), _ibo->getType());
                 }
 
                 // Draw the grid.
@@ -72,7 +72,7 @@ namespace objview
         ftk::M44F _getMVPTransform(float distance) const;
         ftk::Box3F _getObjectBBoxTransformed() const;
 
-        std::shared_ptr<ftk::TriMesh3F> _mesh;
+        std::shared_ptr<ftk::IdxMesh3F> _mesh;
         ftk::Box3F _objectBBox;
         float _objectSize = 0.F;
         float _fov = 60.F;
@@ -93,6 +93,7 @@ namespace objview
         std::shared_ptr<ftk::gl::Shader> _gridShader;
         std::shared_ptr<ftk::gl::VBO> _vbo;
         std::shared_ptr<ftk::gl::VAO> _vao;
+        std::shared_ptr<ftk::gl::IBO> _ibo;
         std::shared_ptr<ftk::gl::Shader> _shader;
         std::shared_ptr<ftk::gl::OffscreenBuffer> _buffer;
 
@@ -84,6 +84,11 @@ namespace ftk
         return out;
     }
 
+    bool BoxPack::hasRoom(const Size2I& size) const
+    {
+        return _hasRoom(_root, size + _border * 2);
+    }
+
     void BoxPack::_getNodes(
         const std::shared_ptr<BoxPackNode>& node,
         std::vector<std::shared_ptr<BoxPackNode> >& nodes) const
@@ -161,6 +166,25 @@ namespace ftk
         return out;
     }
 
+    bool BoxPack::_hasRoom(
+        const std::shared_ptr<BoxPackNode>& node,
+        const Size2I& size) const
+    {
+        bool out = false;
+        if (node->isBranch())
+        {
+            out =
+                _hasRoom(node->children[0], size) ||
+                _hasRoom(node->children[1], size);
+        }
+        else if (!node->isOccupied())
+        {
+            const Size2I nodeSize = node->box.size();
+            out = size.w <= nodeSize.w && size.h <= nodeSize.h;
+        }
+        return out;
+    }
+
     void BoxPack::_removeFromMap(const std::shared_ptr<BoxPackNode>& node)
     {
         if (const auto i = _idToNode.find(node->id); i != _idToNode.end())
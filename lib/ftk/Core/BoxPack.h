@@ -64,6 +64,10 @@ namespace ftk
         //! Insert a node.
         FTK_API std::shared_ptr<BoxPackNode> insert(const Size2I&);
 
+        //! Get whether a node of the given size can be inserted without
+        //! reusing the space of an older one.
+        FTK_API bool hasRoom(const Size2I&) const;
+
     private:
         void _getNodes(
             const std::shared_ptr<BoxPackNode>&,
@@ -73,6 +77,10 @@ namespace ftk
             std::shared_ptr<BoxPackNode>,
             const Size2I&);
 
+        bool _hasRoom(
+            const std::shared_ptr<BoxPackNode>&,
+            const Size2I&) const;
+
         void _removeFromMap(const std::shared_ptr<BoxPackNode>&);
 
         int _border = 0;
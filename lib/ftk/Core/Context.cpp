@@ -11,10 +11,29 @@
 #include <ftk/Core/Timer.h>
 #include <ftk/Core/Version.h>
 
+#include <mutex>
+
 namespace ftk
 {
+    struct Context::Wakeup
+    {
+        std::mutex mutex;
+        std::function<void(void)> callback;
+
+        void operator () ()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (callback)
+            {
+                callback();
+            }
+        }
+    };
+
     void Context::_init()
     {
+        _wakeup = std::make_shared<Wakeup>();
+
         _logSystem = LogSystem::create(shared_from_this());
         addSystem(_logSystem);
 
@@ -113,4 +132,31 @@ namespace ftk
             }
         }
     }
+
+    std::chrono::steady_clock::time_point Context::getNextTick() const
+    {
+        auto out = std::chrono::steady_clock::time_point::max();
+        for (const auto& i : _systemTimes)
+        {
+            out = std::min(out, i.first->getNextTick(i.second));
+        }
+        return out;
+    }
+
+    void Context::setWakeup(const std::function<void(void)>& value)
+    {
+        std::unique_lock<std::mutex> lock(_wakeup->mutex);
+        _wakeup->callback = value;
+    }
+
+    void Context::wakeup()
+    {
+        (*_wakeup)();
+    }
+
+    std::function<void(void)> Context::getWakeup() const
+    {
+        auto wakeup = _wakeup;
+        return [wakeup] { (*wakeup)(); };
+    }
 }
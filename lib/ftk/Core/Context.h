@@ -6,6 +6,7 @@
 #include <ftk/Core/LogSystem.h>
 
 #include <chrono>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -56,6 +57,25 @@ namespace ftk
         //! Tick the context.
         FTK_API void tick();
 
+        //! Get when the context next needs a tick: the earliest time any of
+        //! the systems needs one.
+        FTK_API std::chrono::steady_clock::time_point getNextTick() const;
+
+        //! Set the function that wakes the application's event loop. The
+        //! application sets this, and clears it before it is destroyed.
+        FTK_API void setWakeup(const std::function<void(void)>&);
+
+        //! Wake the application's event loop, if there is one. Safe to call
+        //! from any thread.
+        FTK_API void wakeup();
+
+        //! Get a function that wakes the application's event loop. It does
+        //! not reference the context, so a system's thread can keep it
+        //! without keeping the context alive. Systems call it when work
+        //! finished on their threads should be seen: an image read, glyphs
+        //! prefetched.
+        FTK_API std::function<void(void)> getWakeup() const;
+
         //! Stop the systems' threads.
         //!
         //! Call this from the thread that owns the context, before the last
@@ -72,6 +92,8 @@ namespace ftk
 
     private:
         std::shared_ptr<LogSystem> _logSystem;
+        struct Wakeup;
+        std::shared_ptr<Wakeup> _wakeup;
         std::list<std::shared_ptr<IBaseSystem> > _systems;
         std::map<std::shared_ptr<IBaseSystem>, std::chrono::steady_clock::time_point> _systemTimes;
     };
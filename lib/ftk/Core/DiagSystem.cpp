@@ -46,6 +46,10 @@ namespace ftk
             "ftk Memory/Images: {0}MB",
             [] { return Image::getTotalByteCount() / megabyte; });
 
+        addSampler(
+            "ftk Memory/Image Pool: {0}MB",
+            [] { return Image::getPoolStats().byteCount / megabyte; });
+
         addSampler(
             "ftk Objects/Images: {0}",
             [] { return Image::getObjectCount(); });
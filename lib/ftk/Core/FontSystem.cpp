@@ -14,11 +14,20 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
+#include FT_MODULE_H
+#include FT_SIZES_H
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
 #include <limits>
+#include <list>
 #include <map>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace ftk_resource
 {
@@ -40,6 +49,11 @@ namespace ftk
         "Mono",
         "Symbols");
 
+    FTK_ENUM_IMPL(
+        GlyphMode,
+        "Bitmap",
+        "SDF");
+
     std::string getDefaultFont(FontType value)
     {
         const std::array<std::string, static_cast<size_t>(FontType::Count)> data =
@@ -62,6 +76,14 @@ namespace ftk
             ImageType::L_U8;
 #endif // FTK_API_GLES_2
 
+        // The size distance fields are made at, and how far from the outline
+        // they reach, in pixels at that size. A reference size four times the
+        // usual UI font size keeps large text sharp, and the reach leaves
+        // room for the edge to be smoothed over a pixel or so when the field
+        // is scaled down.
+        const int sdfSize = 48;
+        const int sdfSpread = 6;
+
 #if defined(_WINDOWS)
         //! \bug https://social.msdn.microsoft.com/Forums/vstudio/en-US/8f40dcd8-c67f-4eba-9134-a19b9178e481/vs-2015-rc-linker-stdcodecvt-error?forum=vcgeneral
         typedef unsigned int ftk_char_t;
@@ -111,36 +133,178 @@ namespace ftk
             }
             return out;
         }
+
+        struct GlyphRunKey
+        {
+            GlyphRunKey(
+                const std::string& text,
+                const FontInfo& fontInfo,
+                int maxLineWidth) :
+                text(text),
+                fontInfo(fontInfo),
+                maxLineWidth(maxLineWidth)
+            {
+                hash = hashCombine(
+                    hashCombine(
+                        std::hash<std::string>{}(text),
+                        std::hash<FontInfo>{}(fontInfo)),
+                    std::hash<int>{}(maxLineWidth));
+            }
+
+            std::string text;
+            FontInfo fontInfo;
+            int maxLineWidth = 0;
+            size_t hash = 0;
+
+            bool operator == (const GlyphRunKey& other) const
+            {
+                return
+                    hash == other.hash &&
+                    maxLineWidth == other.maxLineWidth &&
+                    fontInfo == other.fontInfo &&
+                    text == other.text;
+            }
+        };
     }
+}
+
+namespace std
+{
+    template<>
+    struct hash<ftk::GlyphRunKey>
+    {
+        size_t operator()(const ftk::GlyphRunKey& v) const noexcept
+        {
+            return v.hash;
+        }
+    };
+}
+
+namespace ftk
+{
 
     struct FontSystem::Private
     {
-        // This funciton assumes the caller has already called
-        // FT_Set_Pixel_Sizes so we skip that step.
-        std::shared_ptr<Glyph> getGlyph(uint32_t code, const FontInfo&, FT_Face face);
+        // Get the face for a font, or the default if it is not found, with
+        // the font's pixel size active. The caller must hold ft.mutex.
+        FT_Face getFace(const FontInfo&);
+
+        // Make the given pixel size the active one for a face. Each size has
+        // its own FT_Size, created the first time it is used, so switching
+        // between sizes does not recompute the scaled metrics. The caller
+        // must hold ft.mutex.
+        bool setSize(FT_Face, int size);
 
-        // Convenience overload for single-glyph callers (resolves face internally).
+        // Get a glyph from the cache, rasterizing it if necessary.
         std::shared_ptr<Glyph> getGlyph(uint32_t code, const FontInfo&);
 
+        // Load a glyph from the face, or the first fallback face that has
+        // it. The caller must hold ft.mutex, and the face must have the
+        // font's pixel size active.
+        FT_GlyphSlot loadGlyph(uint32_t code, const FontInfo&, FT_Face, FT_Int32 flags);
+
+        std::shared_ptr<Image> copyBitmap(const FT_Bitmap&);
+
+        // Rasterize a glyph. The caller must hold ft.mutex, and the face
+        // must have the font's pixel size active.
+        std::shared_ptr<Glyph> rasterize(uint32_t code, const FontInfo&, FT_Face);
+
+        // Get a glyph in the SDF mode. The caller must hold ft.mutex.
+        std::shared_ptr<Glyph> rasterizeSDF(uint32_t code, const FontInfo&);
+
+        // Get a glyph run from the cache, creating it if necessary.
+        std::shared_ptr<const GlyphRun> getGlyphRun(
+            const std::string&,
+            const FontInfo&,
+            int maxLineWidth);
+
+        FontMetrics getMetrics(const FontInfo&);
+
         void measure(
             const std::basic_string<ftk_char_t>& utf32,
-            const FontInfo&,
+            const std::vector<std::shared_ptr<Glyph> >&,
+            int lineHeight,
             int maxLineWidth,
             Size2I&,
-            std::vector<Box2I>* = nullptr);
+            std::vector<Box2I>&);
 
-        FT_Library ftLibrary = nullptr;
         std::shared_ptr<ObservableList<std::string> > fonts;
         std::shared_ptr<Observable<size_t> > glyphCacheSize;
         std::shared_ptr<Observable<float> > glyphCachePercentage;
 
-        std::mutex mutex;
-        std::map<std::string, std::vector<uint8_t> > fontData;
-        std::map<std::string, FT_Face> faces;
-        // Faces consulted, in order, for glyphs the requested face lacks (e.g.
-        // a CJK font behind the Latin default).
-        std::vector<std::string> fallbackFonts;
-        LRUCache<GlyphInfo, std::shared_ptr<Glyph> > glyphCache;
+        // FreeType faces cannot be used from more than one thread at a time,
+        // so everything that touches them is behind this lock. It is only
+        // taken to rasterize glyphs and look up metrics that are not yet
+        // cached; measuring and drawing cached text does not wait on it.
+        struct FreeType
+        {
+            FT_Library library = nullptr;
+            std::map<std::string, std::vector<uint8_t> > fontData;
+            std::map<std::string, FT_Face> faces;
+            std::map<std::pair<FT_Face, int>, FT_Size> sizes;
+            // Faces consulted, in order, for glyphs the requested face lacks
+            // (e.g. a CJK font behind the Latin default).
+            std::vector<std::string> fallbackFonts;
+            // Distance fields at the reference size.
+            struct SDFGlyph
+            {
+                std::shared_ptr<Image> image;
+                V2F offset;
+                float advance = 0.F;
+            };
+            LRUCache<GlyphInfo, SDFGlyph> sdfGlyphs;
+            std::mutex mutex;
+        };
+        typedef FreeType::SDFGlyph SDFGlyph;
+        FreeType ft;
+        std::atomic<GlyphMode> glyphMode;
+
+        // The glyph cache is split by hash, each part with its own lock, so
+        // threads looking up different glyphs do not contend, and a thread
+        // rasterizing a glyph holds only the part that glyph goes in.
+        struct GlyphShard
+        {
+            LRUCache<GlyphInfo, std::shared_ptr<Glyph> > cache;
+            std::mutex mutex;
+        };
+        static constexpr size_t glyphShardCount = 16;
+        std::array<GlyphShard, glyphShardCount> glyphShards;
+
+        GlyphShard& glyphShard(const GlyphInfo& info)
+        {
+            return glyphShards[std::hash<GlyphInfo>{}(info) % glyphShardCount];
+        }
+
+        // Whole strings, so static text is not decoded, looked up glyph by
+        // glyph, and measured again every time it is drawn, and the metrics
+        // of each font. Cleared when the fonts change.
+        struct Runs
+        {
+            LRUCache<GlyphRunKey, std::shared_ptr<const GlyphRun> > cache;
+            std::unordered_map<FontInfo, FontMetrics> metrics;
+            // Bumped by each clear. A run or metrics built across a clear
+            // may use the old fonts or glyph mode and is not cached.
+            uint64_t generation = 0;
+            std::mutex mutex;
+        };
+        Runs runs;
+
+        // Strings to get ready ahead of being drawn.
+        struct Prefetch
+        {
+            std::list<std::pair<std::string, FontInfo> > requests;
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::thread thread;
+            std::atomic<bool> running;
+
+            // Wakes the event loop once the glyphs are ready, so text
+            // waiting on them is drawn without polling.
+            std::function<void(void)> wakeup;
+        };
+        Prefetch prefetch;
+
+        void clearRuns();
     };
 
     FontSystem::FontSystem(const std::shared_ptr<Context>& context) :
@@ -149,20 +313,20 @@ namespace ftk
     {
         FTK_P();
 
-        p.fontData[getDefaultFont(FontType::Regular)] = ftk_resource::NotoSans_Regular;
-        p.fontData[getDefaultFont(FontType::Bold)] = ftk_resource::NotoSans_Bold;
-        p.fontData[getDefaultFont(FontType::Mono)] = ftk_resource::NotoMono_Regular;
-        p.fontData[getDefaultFont(FontType::Symbols)] = ftk_resource::NotoSansSymbols2_Regular;
+        p.ft.fontData[getDefaultFont(FontType::Regular)] = ftk_resource::NotoSans_Regular;
+        p.ft.fontData[getDefaultFont(FontType::Bold)] = ftk_resource::NotoSans_Bold;
+        p.ft.fontData[getDefaultFont(FontType::Mono)] = ftk_resource::NotoMono_Regular;
+        p.ft.fontData[getDefaultFont(FontType::Symbols)] = ftk_resource::NotoSansSymbols2_Regular;
 #if defined(FTK_CJK)
         // Bundle a pan-CJK font and register it as a fallback so Chinese,
         // Japanese, and Korean glyphs the Latin defaults lack still render
         // (e.g. file names). It is loaded as a normal face below.
         const std::string cjkFont = "NotoSansCJK-Regular";
-        p.fontData[cjkFont] = ftk_resource::NotoSansCJK_Regular;
-        p.fallbackFonts.push_back(cjkFont);
+        p.ft.fontData[cjkFont] = ftk_resource::NotoSansCJK_Regular;
+        p.ft.fallbackFonts.push_back(cjkFont);
 #endif // FTK_CJK
 
-        if (FT_Init_FreeType(&p.ftLibrary))
+        if (FT_Init_FreeType(&p.ft.library))
         {
             auto logSystem = context->getSystem<LogSystem>();
             logSystem->print(
@@ -170,21 +334,28 @@ namespace ftk
                 "FreeType cannot be initialized",
                 LogType::Error);
         }
+        else
+        {
+            const FT_Int spread = sdfSpread;
+            FT_Property_Set(p.ft.library, "sdf", "spread", &spread);
+            FT_Property_Set(p.ft.library, "bsdf", "spread", &spread);
+        }
+        p.glyphMode = GlyphMode::Bitmap;
 
         p.fonts = ObservableList<std::string>::create();
         p.glyphCacheSize = Observable<size_t>::create();
         p.glyphCachePercentage = Observable<float>::create();
 
-        if (p.ftLibrary)
+        if (p.ft.library)
         {
-            for (const auto& i : p.fontData)
+            for (const auto& i : p.ft.fontData)
             {
                 if (FT_New_Memory_Face(
-                    p.ftLibrary,
+                    p.ft.library,
                     i.second.data(),
                     i.second.size(),
                     0,
-                    &p.faces[i.first]))
+                    &p.ft.faces[i.first]))
                 {
                     auto logSystem = context->getSystem<LogSystem>();
                     logSystem->print(
@@ -196,18 +367,77 @@ namespace ftk
                 p.fonts->pushBack(i.first);
             }
         }
+
+        // The same total size as the single cache this replaces.
+        const size_t glyphCacheMax = p.glyphShards[0].cache.getMax();
+        for (auto& shard : p.glyphShards)
+        {
+            shard.cache.setMax(glyphCacheMax / Private::glyphShardCount);
+        }
+
+        // A distance field is bigger than most bitmap glyphs, but one serves
+        // every size of its glyph.
+        p.ft.sdfGlyphs.setMax(glyphCacheMax / 4);
+
+        p.prefetch.wakeup = context->getWakeup();
+        p.prefetch.running = true;
+        p.prefetch.thread = std::thread(
+            [this]
+            {
+                FTK_P();
+                while (p.prefetch.running)
+                {
+                    std::list<std::pair<std::string, FontInfo> > requests;
+                    {
+                        // Asleep until there is something to do, or it is
+                        // time to stop.
+                        std::unique_lock<std::mutex> lock(p.prefetch.mutex);
+                        p.prefetch.cv.wait(
+                            lock,
+                            [this]
+                            {
+                                return
+                                    !_p->prefetch.requests.empty() ||
+                                    !_p->prefetch.running;
+                            });
+                        std::swap(requests, p.prefetch.requests);
+                    }
+                    for (const auto& request : requests)
+                    {
+                        try
+                        {
+                            p.getGlyphRun(request.first, request.second, 0);
+                        }
+                        catch (const std::exception&)
+                        {}
+                    }
+                    if (!requests.empty())
+                    {
+                        p.prefetch.wakeup();
+                    }
+                }
+            });
     }
 
     FontSystem::~FontSystem()
     {
         FTK_P();
-        if (p.ftLibrary)
         {
-            for (const auto& i : p.faces)
+            std::unique_lock<std::mutex> lock(p.prefetch.mutex);
+            p.prefetch.running = false;
+        }
+        p.prefetch.cv.notify_one();
+        if (p.prefetch.thread.joinable())
+        {
+            p.prefetch.thread.join();
+        }
+        if (p.ft.library)
+        {
+            for (const auto& i : p.ft.faces)
             {
                 FT_Done_Face(i.second);
             }
-            FT_Done_FreeType(p.ftLibrary);
+            FT_Done_FreeType(p.ft.library);
         }
     }
 
@@ -246,19 +476,20 @@ namespace ftk
         FTK_P();
         bool out = false;
         {
-            std::unique_lock<std::mutex> lock(p.mutex);
-            p.fontData[name].resize(size);
-            memcpy(p.fontData[name].data(), data, size);
+            std::unique_lock<std::mutex> lock(p.ft.mutex);
+            p.ft.fontData[name].resize(size);
+            memcpy(p.ft.fontData[name].data(), data, size);
             if (0 == FT_New_Memory_Face(
-                p.ftLibrary,
-                p.fontData[name].data(),
+                p.ft.library,
+                p.ft.fontData[name].data(),
                 size,
                 0,
-                &p.faces[name]))
+                &p.ft.faces[name]))
             {
                 out = true;
                 p.fonts->pushBack(name);
             }
+            p.clearRuns();
         }
         return out;
     }
@@ -267,14 +498,15 @@ namespace ftk
     {
         FTK_P();
         {
-            std::unique_lock<std::mutex> lock(p.mutex);
-            if (auto i = p.fontData.find(name); i != p.fontData.end())
+            std::unique_lock<std::mutex> lock(p.ft.mutex);
+            if (auto i = p.ft.fontData.find(name); i != p.ft.fontData.end())
             {
-                p.fontData.erase(i);
+                p.ft.fontData.erase(i);
             }
-            p.fallbackFonts.erase(
-                std::remove(p.fallbackFonts.begin(), p.fallbackFonts.end(), name),
-                p.fallbackFonts.end());
+            p.ft.fallbackFonts.erase(
+                std::remove(p.ft.fallbackFonts.begin(), p.ft.fallbackFonts.end(), name),
+                p.ft.fallbackFonts.end());
+            p.clearRuns();
         }
         const size_t j = p.fonts->indexOf(name);
         if (j != ObservableListInvalidIndex)
@@ -286,12 +518,36 @@ namespace ftk
     void FontSystem::addFallbackFont(const std::string& name)
     {
         FTK_P();
-        std::unique_lock<std::mutex> lock(p.mutex);
-        if (std::find(p.fallbackFonts.begin(), p.fallbackFonts.end(), name) ==
-            p.fallbackFonts.end())
+        std::unique_lock<std::mutex> lock(p.ft.mutex);
+        if (std::find(p.ft.fallbackFonts.begin(), p.ft.fallbackFonts.end(), name) ==
+            p.ft.fallbackFonts.end())
+        {
+            p.ft.fallbackFonts.push_back(name);
+            p.clearRuns();
+        }
+    }
+
+    GlyphMode FontSystem::getGlyphMode() const
+    {
+        return _p->glyphMode;
+    }
+
+    void FontSystem::setGlyphMode(GlyphMode value)
+    {
+        FTK_P();
+#if defined(FTK_API_GLES_2)
+        value = GlyphMode::Bitmap;
+#endif // FTK_API_GLES_2
+        std::unique_lock<std::mutex> lock(p.ft.mutex);
+        if (value == p.glyphMode)
+            return;
+        p.glyphMode = value;
+        for (auto& shard : p.glyphShards)
         {
-            p.fallbackFonts.push_back(name);
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            shard.cache.clear();
         }
+        p.clearRuns();
     }
 
     size_t FontSystem::getGlyphCacheSize() const
@@ -316,24 +572,7 @@ namespace ftk
 
     FontMetrics FontSystem::getMetrics(const FontInfo& info)
     {
-        FTK_P();
-        FontMetrics out;
-        {
-            std::unique_lock<std::mutex> lock(p.mutex);
-            auto faceIt = p.faces.find(info.name);
-            if (faceIt == p.faces.end())
-            {
-                faceIt = p.faces.find(getDefaultFont(FontType::Regular));
-            }
-            if (faceIt != p.faces.end())
-            {
-                FT_Set_Pixel_Sizes(faceIt->second, 0, info.size);
-                out.ascender = static_cast<int>(faceIt->second->size->metrics.ascender / 64);
-                out.descender = static_cast<int>(faceIt->second->size->metrics.descender / 64);
-                out.lineHeight = static_cast<int>(faceIt->second->size->metrics.height / 64);
-            }
-        }
-        return out;
+        return _p->getMetrics(info);
     }
 
     Size2I FontSystem::getSize(
@@ -341,193 +580,364 @@ namespace ftk
         const FontInfo& fontInfo,
         int maxLineWidth)
     {
-        FTK_P();
-        Size2I out;
-        try
-        {
-            std::unique_lock<std::mutex> lock(p.mutex);
-            const auto utf32 = utf8ToUtf32(text);
-            p.measure(utf32, fontInfo, maxLineWidth, out);
-        }
-        catch (const std::exception&)
-        {}
-        return out;
+        const auto run = getGlyphRun(text, fontInfo, maxLineWidth);
+        return run ? run->size : Size2I();
     }
 
     std::vector<Box2I> FontSystem::getBoxes(
         const std::string& text,
         const FontInfo& fontInfo,
         int maxLineWidth)
+    {
+        const auto run = getGlyphRun(text, fontInfo, maxLineWidth);
+        return run ? run->boxes : std::vector<Box2I>();
+    }
+
+    std::vector<std::shared_ptr<Glyph> > FontSystem::getGlyphs(
+        const std::string& text,
+        const FontInfo& fontInfo)
+    {
+        const auto run = getGlyphRun(text, fontInfo);
+        return run ? run->glyphs : std::vector<std::shared_ptr<Glyph> >();
+    }
+
+    std::shared_ptr<const GlyphRun> FontSystem::getGlyphRun(
+        const std::string& text,
+        const FontInfo& fontInfo,
+        int maxLineWidth)
     {
         FTK_P();
-        std::vector<Box2I> out;
+        std::shared_ptr<const GlyphRun> out;
         try
         {
-            std::unique_lock<std::mutex> lock(p.mutex);
-            const auto utf32 = utf8ToUtf32(text);
-            Size2I size;
-            p.measure(utf32, fontInfo, maxLineWidth, size, &out);
+            out = p.getGlyphRun(text, fontInfo, maxLineWidth);
         }
         catch (const std::exception&)
         {}
         return out;
     }
 
-    std::vector<std::shared_ptr<Glyph> > FontSystem::getGlyphs(
-        const std::string& text,
-        const FontInfo& fontInfo)
+    void FontSystem::prefetchGlyphs(const std::string& text, const FontInfo& fontInfo)
     {
         FTK_P();
-        std::vector<std::shared_ptr<Glyph> > out;
-        try
         {
-            std::unique_lock<std::mutex> lock(p.mutex);
-            const auto utf32 = utf8ToUtf32(text);
-            // Resolve the face and set the pixel size once for the whole
-            // string; Private::getGlyph(code, fontInfo, face) skips both.
-            auto faceIt = p.faces.find(fontInfo.name);
-            if (faceIt == p.faces.end())
+            std::unique_lock<std::mutex> lock(p.prefetch.mutex);
+            p.prefetch.requests.push_back(std::make_pair(text, fontInfo));
+        }
+        p.prefetch.cv.notify_one();
+    }
+
+    FT_Face FontSystem::Private::getFace(const FontInfo& fontInfo)
+    {
+        auto faceIt = ft.faces.find(fontInfo.name);
+        if (faceIt == ft.faces.end())
+        {
+            faceIt = ft.faces.find(getDefaultFont(FontType::Regular));
+        }
+        if (faceIt == ft.faces.end() ||
+            !setSize(faceIt->second, static_cast<int>(fontInfo.size)))
+        {
+            return nullptr;
+        }
+        return faceIt->second;
+    }
+
+    bool FontSystem::Private::setSize(FT_Face face, int size)
+    {
+        const auto key = std::make_pair(face, size);
+        const auto i = ft.sizes.find(key);
+        if (i != ft.sizes.end())
+        {
+            return 0 == FT_Activate_Size(i->second);
+        }
+        FT_Size ftSize = nullptr;
+        if (FT_New_Size(face, &ftSize))
+        {
+            return false;
+        }
+        if (FT_Activate_Size(ftSize) || FT_Set_Pixel_Sizes(face, 0, size))
+        {
+            FT_Done_Size(ftSize);
+            return false;
+        }
+        ft.sizes[key] = ftSize;
+        return true;
+    }
+
+    FontMetrics FontSystem::Private::getMetrics(const FontInfo& fontInfo)
+    {
+        FontMetrics out;
+        uint64_t generation = 0;
+        {
+            std::unique_lock<std::mutex> lock(runs.mutex);
+            const auto i = runs.metrics.find(fontInfo);
+            if (i != runs.metrics.end())
             {
-                faceIt = p.faces.find(getDefaultFont(FontType::Regular));
+                return i->second;
             }
-            if (faceIt != p.faces.end() &&
-                0 == FT_Set_Pixel_Sizes(faceIt->second, 0, static_cast<int>(fontInfo.size)))
+            generation = runs.generation;
+        }
+        {
+            std::unique_lock<std::mutex> lock(ft.mutex);
+            if (FT_Face face = getFace(fontInfo))
             {
-                out.reserve(utf32.size());
-                for (const auto& i : utf32)
-                {
-                    out.push_back(p.getGlyph(i, fontInfo, faceIt->second));
-                }
+                out.ascender = static_cast<int>(face->size->metrics.ascender / 64);
+                out.descender = static_cast<int>(face->size->metrics.descender / 64);
+                out.lineHeight = static_cast<int>(face->size->metrics.height / 64);
+            }
+            else
+            {
+                return out;
+            }
+        }
+        {
+            std::unique_lock<std::mutex> lock(runs.mutex);
+            if (generation == runs.generation)
+            {
+                runs.metrics[fontInfo] = out;
             }
         }
-        catch (const std::exception&)
-        {}
         return out;
     }
 
-    std::shared_ptr<Glyph> FontSystem::Private::getGlyph(uint32_t code, const FontInfo& fontInfo)
+    std::shared_ptr<const GlyphRun> FontSystem::Private::getGlyphRun(
+        const std::string& text,
+        const FontInfo& fontInfo,
+        int maxLineWidth)
     {
-        auto faceIt = faces.find(fontInfo.name);
-        if (faceIt == faces.end())
+        const GlyphRunKey key(text, fontInfo, maxLineWidth);
+        std::shared_ptr<const GlyphRun> out;
+        uint64_t generation = 0;
         {
-            faceIt = faces.find(getDefaultFont(FontType::Regular));
+            std::unique_lock<std::mutex> lock(runs.mutex);
+            if (runs.cache.get(key, out))
+            {
+                return out;
+            }
+            generation = runs.generation;
         }
-        if (faceIt == faces.end())
+
+        // No lock is held while the run is built; two threads asking for
+        // the same new string both build it, and the second replaces the
+        // first in the cache. If the runs were cleared in the meantime the
+        // run is returned but not cached.
+        auto run = std::make_shared<GlyphRun>();
+        const int lineHeight = getMetrics(fontInfo).lineHeight;
+        const auto utf32 = utf8ToUtf32(text);
+        run->glyphs.reserve(utf32.size());
+        for (const auto& i : utf32)
         {
-            return nullptr;
+            run->glyphs.push_back(getGlyph(i, fontInfo));
         }
-        if (FT_Set_Pixel_Sizes(faceIt->second, 0, static_cast<int>(fontInfo.size)))
+        measure(utf32, run->glyphs, lineHeight, maxLineWidth, run->size, run->boxes);
+        out = run;
         {
-            return nullptr;
+            std::unique_lock<std::mutex> lock(runs.mutex);
+            if (generation == runs.generation)
+            {
+                runs.cache.add(key, out);
+            }
         }
-        return getGlyph(code, fontInfo, faceIt->second);
+        return out;
     }
 
-    std::shared_ptr<Glyph> FontSystem::Private::getGlyph(
-        uint32_t code,
-        const FontInfo& fontInfo,
-        FT_Face face)
+    std::shared_ptr<Glyph> FontSystem::Private::getGlyph(uint32_t code, const FontInfo& fontInfo)
     {
+        const GlyphInfo info(code, fontInfo);
+        GlyphShard& shard = glyphShard(info);
         std::shared_ptr<Glyph> out;
-        do
         {
-            if (glyphCache.get(GlyphInfo(code, fontInfo), out))
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            if (shard.cache.get(info, out))
             {
-                break;
+                return out;
             }
+        }
+        {
+            std::unique_lock<std::mutex> ftLock(ft.mutex);
+            {
+                // Another thread may have rasterized it while this one was
+                // waiting.
+                std::unique_lock<std::mutex> lock(shard.mutex);
+                if (shard.cache.get(info, out))
+                {
+                    return out;
+                }
+            }
+            if (GlyphMode::SDF == glyphMode)
+            {
+                out = rasterizeSDF(code, fontInfo);
+            }
+            else if (FT_Face face = getFace(fontInfo))
+            {
+                out = rasterize(code, fontInfo, face);
+            }
+            if (out)
+            {
+                std::unique_lock<std::mutex> lock(shard.mutex);
+                shard.cache.add(info, out);
+            }
+        }
+        return out;
+    }
 
-            out = std::make_shared<Glyph>();
-            out->info = GlyphInfo(code, fontInfo);
-
-            FT_Face glyphFace = face;
-            FT_UInt ftGlyphIndex = FT_Get_Char_Index(face, code);
-            if (!ftGlyphIndex)
+    FT_GlyphSlot FontSystem::Private::loadGlyph(
+        uint32_t code,
+        const FontInfo& fontInfo,
+        FT_Face face,
+        FT_Int32 flags)
+    {
+        FT_Face glyphFace = face;
+        FT_UInt ftGlyphIndex = FT_Get_Char_Index(face, code);
+        if (!ftGlyphIndex)
+        {
+            // The requested face lacks this glyph; try the fallback faces
+            // (e.g. a bundled CJK font) and render from the first that has
+            // it. Each fallback face needs its own pixel size set, since
+            // the caller only sized the requested face.
+            for (const auto& name : ft.fallbackFonts)
             {
-                // The requested face lacks this glyph; try the fallback faces
-                // (e.g. a bundled CJK font) and render from the first that has
-                // it. Each fallback face needs its own pixel size set, since
-                // the caller only sized the requested face.
-                for (const auto& name : fallbackFonts)
+                auto i = ft.faces.find(name);
+                if (i == ft.faces.end() || i->second == face)
                 {
-                    auto i = faces.find(name);
-                    if (i == faces.end() || i->second == face)
-                    {
-                        continue;
-                    }
-                    const FT_UInt fallbackIndex = FT_Get_Char_Index(i->second, code);
-                    if (fallbackIndex &&
-                        0 == FT_Set_Pixel_Sizes(i->second, 0, static_cast<int>(fontInfo.size)))
-                    {
-                        glyphFace = i->second;
-                        ftGlyphIndex = fallbackIndex;
-                        break;
-                    }
+                    continue;
                 }
-                if (!ftGlyphIndex)
+                const FT_UInt fallbackIndex = FT_Get_Char_Index(i->second, code);
+                if (fallbackIndex &&
+                    setSize(i->second, static_cast<int>(fontInfo.size)))
                 {
+                    glyphFace = i->second;
+                    ftGlyphIndex = fallbackIndex;
                     break;
                 }
             }
-            if (FT_Load_Glyph(glyphFace, ftGlyphIndex, FT_LOAD_FORCE_AUTOHINT))
+            if (!ftGlyphIndex)
             {
-                break;
+                return nullptr;
             }
-            if (FT_Render_Glyph(glyphFace->glyph, FT_RENDER_MODE_NORMAL))
+        }
+        if (FT_Load_Glyph(glyphFace, ftGlyphIndex, flags))
+        {
+            return nullptr;
+        }
+        return glyphFace->glyph;
+    }
+
+    std::shared_ptr<Image> FontSystem::Private::copyBitmap(const FT_Bitmap& ftBitmap)
+    {
+        const ImageInfo imageInfo(ftBitmap.width, ftBitmap.rows, imageType);
+        auto out = Image::create(imageInfo);
+        for (size_t y = 0; y < ftBitmap.rows; ++y)
+        {
+            const int channelCount = getChannelCount(imageInfo.type);
+            uint8_t* dataP = out->getData() + y * imageInfo.size.w * channelCount;
+            const unsigned char* bitmapP = ftBitmap.buffer + y * ftBitmap.pitch;
+            switch (channelCount)
             {
+            case 1:
+                memcpy(dataP, bitmapP, imageInfo.size.w);
+                break;
+            case 2:
+                for (int x = 0; x < imageInfo.size.w; ++x)
+                {
+                    dataP[x * 2 + 0] = bitmapP[x];
+                    dataP[x * 2 + 1] = bitmapP[x];
+                }
+                break;
+            case 3:
+                for (int x = 0; x < imageInfo.size.w; ++x)
+                {
+                    dataP[x * 3 + 0] = bitmapP[x];
+                    dataP[x * 3 + 1] = bitmapP[x];
+                    dataP[x * 3 + 2] = bitmapP[x];
+                }
+                break;
+            case 4:
+                for (int x = 0; x < imageInfo.size.w; ++x)
+                {
+                    dataP[x * 4 + 0] = bitmapP[x];
+                    dataP[x * 4 + 1] = bitmapP[x];
+                    dataP[x * 4 + 2] = bitmapP[x];
+                    dataP[x * 4 + 3] = bitmapP[x];
+                }
                 break;
+            default: break;
             }
+        }
+        return out;
+    }
 
-            const FT_Bitmap ftBitmap = glyphFace->glyph->bitmap;
-            const ImageInfo imageInfo(ftBitmap.width, ftBitmap.rows, imageType);
-            out->image = Image::create(imageInfo);
-            for (size_t y = 0; y < ftBitmap.rows; ++y)
+    std::shared_ptr<Glyph> FontSystem::Private::rasterize(
+        uint32_t code,
+        const FontInfo& fontInfo,
+        FT_Face face)
+    {
+        auto out = std::make_shared<Glyph>();
+        out->info = GlyphInfo(code, fontInfo);
+        out->imageInfo = out->info;
+        FT_GlyphSlot slot = loadGlyph(code, fontInfo, face, FT_LOAD_FORCE_AUTOHINT);
+        if (!slot || FT_Render_Glyph(slot, FT_RENDER_MODE_NORMAL))
+        {
+            return out;
+        }
+        out->image    = copyBitmap(slot->bitmap);
+        out->offset   = V2I(slot->bitmap_left, slot->bitmap_top);
+        out->advance  = static_cast<int>(slot->advance.x / 64);
+        out->lsbDelta = static_cast<int32_t>(slot->lsb_delta);
+        out->rsbDelta = static_cast<int32_t>(slot->rsb_delta);
+        return out;
+    }
+
+    std::shared_ptr<Glyph> FontSystem::Private::rasterizeSDF(
+        uint32_t code,
+        const FontInfo& fontInfo)
+    {
+        // The distance field is made once at the reference size, unhinted
+        // since hinting for one size is wrong for the others, and each size
+        // gets a glyph that shares it.
+        const GlyphInfo imageInfo(code, FontInfo(fontInfo.name, sdfSize));
+        SDFGlyph sdf;
+        if (!ft.sdfGlyphs.get(imageInfo, sdf))
+        {
+            if (FT_Face face = getFace(imageInfo.fontInfo))
             {
-                const int channelCount = getChannelCount(imageInfo.type);
-                uint8_t* dataP = out->image->getData() + y * imageInfo.size.w * channelCount;
-                const unsigned char* bitmapP = ftBitmap.buffer + y * ftBitmap.pitch;
-                switch (channelCount)
+                if (FT_GlyphSlot slot = loadGlyph(code, imageInfo.fontInfo, face, FT_LOAD_NO_HINTING))
                 {
-                case 1:
-                    memcpy(dataP, bitmapP, imageInfo.size.w);
-                    break;
-                case 2:
-                    for (int x = 0; x < imageInfo.size.w; ++x)
-                    {
-                        dataP[x * 2 + 0] = bitmapP[x];
-                        dataP[x * 2 + 1] = bitmapP[x];
-                    }
-                    break;
-                case 3:
-                    for (int x = 0; x < imageInfo.size.w; ++x)
-                    {
-                        dataP[x * 3 + 0] = bitmapP[x];
-                        dataP[x * 3 + 1] = bitmapP[x];
-                        dataP[x * 3 + 2] = bitmapP[x];
-                    }
-                    break;
-                case 4:
-                    for (int x = 0; x < imageInfo.size.w; ++x)
+                    sdf.advance = slot->advance.x / 64.F;
+                    // Nothing to draw for white space, and the SDF renderers
+                    // do not accept an empty outline.
+                    if ((slot->format != FT_GLYPH_FORMAT_OUTLINE || slot->outline.n_contours > 0) &&
+                        0 == FT_Render_Glyph(slot, FT_RENDER_MODE_SDF))
                     {
-                        dataP[x * 4 + 0] = bitmapP[x];
-                        dataP[x * 4 + 1] = bitmapP[x];
-                        dataP[x * 4 + 2] = bitmapP[x];
-                        dataP[x * 4 + 3] = bitmapP[x];
+                        sdf.image = copyBitmap(slot->bitmap);
+                        sdf.offset = V2F(slot->bitmap_left, slot->bitmap_top);
                     }
-                    break;
-                default: break;
                 }
             }
-            out->offset   = V2I(glyphFace->glyph->bitmap_left, glyphFace->glyph->bitmap_top);
-            out->advance  = static_cast<int>(glyphFace->glyph->advance.x / 64);
-            out->lsbDelta = static_cast<int32_t>(glyphFace->glyph->lsb_delta);
-            out->rsbDelta = static_cast<int32_t>(glyphFace->glyph->rsb_delta);
-
-            glyphCache.add(out->info, out);
-        } while (0);
+            ft.sdfGlyphs.add(imageInfo, sdf);
+        }
 
+        auto out = std::make_shared<Glyph>();
+        out->info = GlyphInfo(code, fontInfo);
+        out->imageInfo = imageInfo;
+        out->mode = GlyphMode::SDF;
+        out->scale = fontInfo.size / static_cast<float>(sdfSize);
+        out->image = sdf.image;
+        out->offset = V2I(
+            std::round(sdf.offset.x * out->scale),
+            std::round(sdf.offset.y * out->scale));
+        out->advance = std::round(sdf.advance * out->scale);
         return out;
     }
 
+    void FontSystem::Private::clearRuns()
+    {
+        std::unique_lock<std::mutex> lock(runs.mutex);
+        runs.cache.clear();
+        runs.metrics.clear();
+        ++runs.generation;
+    }
+
     namespace
     {
         constexpr bool isSpace(ftk_char_t c)
@@ -538,51 +948,31 @@ namespace ftk
 
     void FontSystem::Private::measure(
         const std::basic_string<ftk_char_t>& utf32,
-        const FontInfo& fontInfo,
+        const std::vector<std::shared_ptr<Glyph> >& glyphs,
+        int lineHeight,
         int maxLineWidth,
         Size2I& size,
-        std::vector<Box2I>* glyphGeom)
+        std::vector<Box2I>& glyphGeom)
     {
-        auto faceIt = faces.find(fontInfo.name);
-        if (faceIt == faces.end())
-        {
-            faceIt = faces.find(getDefaultFont(FontType::Regular));
-        }
-        if (faceIt == faces.end())
-        {
-            return;
-        }
-        if (FT_Set_Pixel_Sizes(
-            faceIt->second,
-            0,
-            static_cast<int>(fontInfo.size)))
-        {
-            return;
-        }
-
-        const int h = static_cast<int>(faceIt->second->size->metrics.height / 64);
-        const FT_Face face = faceIt->second;
+        const int h = lineHeight;
         V2I pos(0, h);
         auto textLineIt = utf32.end();
         int textLineX = 0;
         int32_t rsbDeltaPrev = 0;
         for (auto utf32It = utf32.begin(); utf32It != utf32.end(); ++utf32It)
         {
-            const auto glyph = getGlyph(*utf32It, fontInfo, face);
+            const auto& glyph = glyphs[utf32It - utf32.begin()];
 
-            if (glyphGeom)
+            Box2I box;
+            if (glyph)
             {
-                Box2I box;
-                if (glyph)
-                {
-                    box = Box2I(
-                        pos.x,
-                        pos.y - h,
-                        glyph->advance,
-                        h);
-                }
-                glyphGeom->push_back(box);
+                box = Box2I(
+                    pos.x,
+                    pos.y - h,
+                    glyph->advance,
+                    h);
             }
+            glyphGeom.push_back(box);
 
             int32_t x = 0;
             if (glyph)
@@ -655,14 +1045,17 @@ namespace ftk
     {
         FTK_P();
         size_t glyphCacheSize = 0;
-        float glyphCachePercentage = 0.F;
+        size_t glyphCacheMax = 0;
+        for (auto& shard : p.glyphShards)
         {
-            std::unique_lock<std::mutex> lock(p.mutex);
-            glyphCacheSize = p.glyphCache.getCount();
-            glyphCachePercentage = p.glyphCache.getPercentage();
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            glyphCacheSize += shard.cache.getCount();
+            glyphCacheMax += shard.cache.getMax();
         }
         p.glyphCacheSize->setIfChanged(glyphCacheSize);
-        p.glyphCachePercentage->setIfChanged(glyphCachePercentage);
+        p.glyphCachePercentage->setIfChanged(glyphCacheMax > 0 ?
+            (glyphCacheSize / static_cast<float>(glyphCacheMax) * 100.F) :
+            0.F);
     }
 
     std::chrono::milliseconds FontSystem::getTickTime() const
@@ -32,6 +32,24 @@ namespace ftk
     //! Get a built-in font.
     FTK_API std::string getDefaultFont(FontType);
 
+    //! Glyph modes.
+    enum class FTK_API_TYPE GlyphMode
+    {
+        //! Coverage bitmaps, rasterized and hinted for each font size.
+        Bitmap,
+
+        //! Signed distance fields, generated once for each character at a
+        //! reference size and scaled to every font size. This saves
+        //! rasterizing and storing each character again for every size and
+        //! display scale, at the cost of hinting; small text is softer than
+        //! with bitmaps.
+        SDF,
+
+        Count,
+        First = Bitmap
+    };
+    FTK_ENUM(GlyphMode);
+
     //! Font information.
     struct FTK_API_TYPE FontInfo
     {
@@ -77,6 +95,31 @@ namespace ftk
         int                    advance  = 0;
         int32_t                lsbDelta = 0;
         int32_t                rsbDelta = 0;
+
+        //! What the image holds.
+        GlyphMode              mode     = GlyphMode::Bitmap;
+
+        //! The image is drawn at this scale. SDF images are shared by every
+        //! size of a font, and scaled from the reference size.
+        float                  scale    = 1.F;
+
+        //! Identifies the image: the same as the glyph information for
+        //! bitmaps, and the character at the reference size for SDF glyphs.
+        GlyphInfo              imageInfo;
+    };
+
+    //! Font glyph run: a string's glyphs and measurements, wrapped to a
+    //! maximum line width.
+    struct FTK_API_TYPE GlyphRun
+    {
+        //! The glyphs, one for each character. These are not wrapped.
+        std::vector<std::shared_ptr<Glyph> > glyphs;
+
+        //! The size of the string.
+        Size2I size;
+
+        //! The character boxes.
+        std::vector<Box2I> boxes;
     };
 
     //! Font system.
@@ -114,6 +157,14 @@ namespace ftk
         //! cover.
         FTK_API void addFallbackFont(const std::string& name);
 
+        //! Get the glyph mode.
+        FTK_API GlyphMode getGlyphMode() const;
+
+        //! Set the glyph mode. Changing the mode empties the glyph caches.
+        //! SDF glyphs need a renderer that draws them, currently the
+        //! OpenGL 4.1 renderer; with OpenGL ES 2 the mode stays Bitmap.
+        FTK_API void setGlyphMode(GlyphMode);
+
         ///@}
 
         //! \name Information
@@ -154,6 +205,23 @@ namespace ftk
             const std::string&,
             const FontInfo&);
 
+        //! Get the glyphs and measurements for the given string.
+        //!
+        //! Runs are cached by string, font, and maximum line width, so for
+        //! text that has not changed since it was last drawn or measured
+        //! this is a single lookup. The run is shared rather than copied;
+        //! getSize(), getBoxes(), and getGlyphs() use the same cache.
+        FTK_API std::shared_ptr<const GlyphRun> getGlyphRun(
+            const std::string&,
+            const FontInfo&,
+            int maxLineWidth = 0);
+
+        //! Rasterize the glyphs for the given string on a background thread,
+        //! so they are ready before it is first measured or drawn. This is
+        //! for text that is about to be shown, for example when a dialog is
+        //! opened.
+        FTK_API void prefetchGlyphs(const std::string&, const FontInfo&);
+
         ///@}
 
         FTK_API void tick() override;
@@ -25,4 +25,13 @@ namespace ftk
     {
         return std::chrono::milliseconds(0);
     }
+
+    std::chrono::steady_clock::time_point IBaseSystem::getNextTick(
+        const std::chrono::steady_clock::time_point& lastTick) const
+    {
+        const auto tickTime = getTickTime();
+        return tickTime > std::chrono::milliseconds(0) ?
+            lastTick + tickTime :
+            std::chrono::steady_clock::time_point::max();
+    }
 }
\ No newline at end of file
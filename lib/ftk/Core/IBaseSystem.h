@@ -52,6 +52,14 @@ namespace ftk
         //! Get the system tick time interval.
         FTK_API virtual std::chrono::milliseconds getTickTime() const;
 
+        //! Get when the system next needs a tick, given when it was last
+        //! ticked. The default is the last tick plus the tick time, or never
+        //! if the tick time is zero. The event loop sleeps until the earliest
+        //! of these, so a system that knows it has nothing to do for a while
+        //! should say so.
+        FTK_API virtual std::chrono::steady_clock::time_point getNextTick(
+            const std::chrono::steady_clock::time_point& lastTick) const;
+
     protected:
         std::weak_ptr<Context> _context;
         std::string _name;
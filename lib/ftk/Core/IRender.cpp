@@ -16,6 +16,9 @@ namespace ftk
     IRender::~IRender()
     {}
 
+    void IRender::flush()
+    {}
+
     void IRender::drawRect(
         const Box2I& rect,
         const Color4F& color)
@@ -39,6 +39,37 @@ namespace ftk
         int64_t triangles = 0;
         int64_t textures = 0;
         int64_t glyphs = 0;
+
+        //! Draw calls issued to the graphics API.
+        int64_t drawCalls = 0;
+
+        //! Batches flushed: the primitives recorded between flushes, drawn
+        //! together with one draw call for each run of the same texture and
+        //! shader, so drawCalls counts at least as many. With
+        //! RenderOptions::batch off this stays zero and every primitive is a
+        //! draw call of its own.
+        int64_t batches = 0;
+
+        //! Glyph atlas pages in use.
+        int64_t glyphAtlasPages = 0;
+
+        //! Percentage of the glyph atlas pages that is occupied.
+        int64_t glyphAtlasPercentage = 0;
+
+        //! Glyph atlas pages emptied to make room.
+        int64_t glyphAtlasEvictions = 0;
+
+        //! Glyphs copied to the glyph atlas.
+        int64_t glyphUploads = 0;
+
+        //! Images that are not cached drawn with textures from the pool.
+        int64_t texturePoolHits = 0;
+
+        //! Images that are not cached that needed new textures.
+        int64_t texturePoolMisses = 0;
+
+        //! Texture sets the pool released to stay under its byte count.
+        int64_t texturePoolEvictions = 0;
     };
 
     //! Base class for renderers.
@@ -64,6 +95,11 @@ namespace ftk
         //! Finish a render.
         FTK_API virtual void end() = 0;
 
+        //! Draw anything recorded but not yet drawn. Call this before drawing
+        //! with the graphics API directly, so what was drawn through the
+        //! renderer ends up underneath.
+        FTK_API virtual void flush();
+
         //! Get the render size.
         FTK_API virtual Size2I getRenderSize() const = 0;
 
@@ -1,16 +1,23 @@
 // SPDX-License-Identifier: BSD-3-Clause
 // Copyright Contributors to the feather-tk project.
 
-#include <ftk/Core/Image.h>
+#include <ftk/Core/ImagePrivate.h>
 
 #include <ftk/Core/Error.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/String.h>
 
+#include <algorithm>
 #include <atomic>
 #include <array>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 namespace ftk
 {
@@ -202,6 +209,123 @@ namespace ftk
         // Sixteen was the value before, and a build with a checked heap
         // caught a write thirty-two bytes past the end of it.
         constexpr size_t dataPadding = 64;
+
+        // Size classes have eight steps between powers of two, so a block
+        // is at most an eighth larger than asked for. Frames from a decoder
+        // are the same size each time and always land in the same class.
+        const size_t blockMinByteCount = 64;
+
+        size_t getBlockByteCount(size_t byteCount)
+        {
+            size_t out = blockMinByteCount;
+            while (out < byteCount)
+            {
+                out *= 2;
+            }
+            if (out > blockMinByteCount)
+            {
+                const size_t step = out / 16;
+                out = (byteCount + step - 1) / step * step;
+            }
+            return out;
+        }
+
+        struct Pool
+        {
+            std::mutex mutex;
+            ImagePoolOptions options;
+
+            // Blocks kept for reuse, the most recently released at the
+            // front, and for each size class the blocks of that size, the
+            // oldest first.
+            std::list<ImageBlock> blocks;
+            std::map<size_t, std::deque<std::list<ImageBlock>::iterator> > sizes;
+
+            size_t byteCount = 0;
+            size_t allocations = 0;
+            size_t reuses = 0;
+
+            // Remove the oldest blocks until the pool fits. The caller
+            // frees them after letting go of the mutex.
+            void trim(std::vector<ImageBlock>& out)
+            {
+                while (byteCount > options.maxByteCount && !blocks.empty())
+                {
+                    const ImageBlock block = blocks.back();
+                    auto i = sizes.find(block.byteCount);
+                    i->second.pop_front();
+                    if (i->second.empty())
+                    {
+                        sizes.erase(i);
+                    }
+                    blocks.pop_back();
+                    byteCount -= block.byteCount;
+                    out.push_back(block);
+                }
+            }
+        };
+
+        // Never destroyed: images held in static objects may be released
+        // after the pool would be.
+        Pool& getPool()
+        {
+            static Pool* pool = new Pool;
+            return *pool;
+        }
+
+        ImageBlock acquireBlock(size_t byteCount)
+        {
+            const size_t blockByteCount = getBlockByteCount(byteCount);
+            Pool& pool = getPool();
+            bool hugePages = false;
+            {
+                std::unique_lock<std::mutex> lock(pool.mutex);
+                auto i = pool.sizes.find(blockByteCount);
+                if (i != pool.sizes.end())
+                {
+                    // The most recently released block is the most likely
+                    // to still be in the cache.
+                    const auto j = i->second.back();
+                    const ImageBlock out = *j;
+                    i->second.pop_back();
+                    if (i->second.empty())
+                    {
+                        pool.sizes.erase(i);
+                    }
+                    pool.blocks.erase(j);
+                    pool.byteCount -= out.byteCount;
+                    ++pool.reuses;
+                    return out;
+                }
+                ++pool.allocations;
+                hugePages = pool.options.hugePages;
+            }
+            return allocImageBlock(blockByteCount, hugePages);
+        }
+
+        void releaseBlock(const ImageBlock& block)
+        {
+            Pool& pool = getPool();
+            std::vector<ImageBlock> blocks;
+            {
+                std::unique_lock<std::mutex> lock(pool.mutex);
+                if (block.byteCount <= pool.options.maxByteCount)
+                {
+                    pool.blocks.push_front(block);
+                    pool.sizes[block.byteCount].push_back(pool.blocks.begin());
+                    pool.byteCount += block.byteCount;
+                    pool.trim(blocks);
+                }
+                else
+                {
+                    blocks.push_back(block);
+                }
+            }
+            for (const auto& i : blocks)
+            {
+                freeImageBlock(i);
+            }
+        }
     }
 
     Image::Image(const ImageInfo& info, uint8_t* externalData) :
@@ -209,24 +333,31 @@ namespace ftk
         _byteCount(info.getByteCount()),
         _externalData(externalData)
     {
-        ++objectCount;
-        totalByteCount += _byteCount;
-
         if (externalData)
         {
             _data = externalData;
         }
         else
         {
-            _data = new uint8_t[_byteCount + dataPadding];
+            const ImageBlock block = acquireBlock(_byteCount + dataPadding);
+            _data = block.data;
+            _blockByteCount = block.byteCount;
+            _blockMapped = block.mapped;
         }
+
+        ++objectCount;
+        totalByteCount += _byteCount;
     }
 
     Image::~Image()
     {
         if (!_externalData)
         {
-            delete[] _data;
+            ImageBlock block;
+            block.data = _data;
+            block.byteCount = _blockByteCount;
+            block.mapped = _blockMapped;
+            releaseBlock(block);
         }
 
         --objectCount;
@@ -273,6 +404,56 @@ namespace ftk
         return totalByteCount;
     }
 
+    void Image::setPoolOptions(const ImagePoolOptions& options)
+    {
+        Pool& pool = getPool();
+        std::vector<ImageBlock> blocks;
+        {
+            std::unique_lock<std::mutex> lock(pool.mutex);
+            pool.options = options;
+            pool.trim(blocks);
+        }
+        for (const auto& block : blocks)
+        {
+            freeImageBlock(block);
+        }
+    }
+
+    ImagePoolOptions Image::getPoolOptions()
+    {
+        Pool& pool = getPool();
+        std::unique_lock<std::mutex> lock(pool.mutex);
+        return pool.options;
+    }
+
+    ImagePoolStats Image::getPoolStats()
+    {
+        ImagePoolStats out;
+        Pool& pool = getPool();
+        std::unique_lock<std::mutex> lock(pool.mutex);
+        out.byteCount = pool.byteCount;
+        out.blockCount = pool.blocks.size();
+        out.allocations = pool.allocations;
+        out.reuses = pool.reuses;
+        return out;
+    }
+
+    void Image::clearPool()
+    {
+        Pool& pool = getPool();
+        std::list<ImageBlock> blocks;
+        {
+            std::unique_lock<std::mutex> lock(pool.mutex);
+            std::swap(blocks, pool.blocks);
+            pool.sizes.clear();
+            pool.byteCount = 0;
+        }
+        for (const auto& block : blocks)
+        {
+            freeImageBlock(block);
+        }
+    }
+
     void to_json(nlohmann::json& json, const ImageMirror& in)
     {
         json["X"] = in.x;
@@ -284,4 +465,567 @@ namespace ftk
         json.at("X").get_to(out.x);
         json.at("Y").get_to(out.y);
     }
+
+    ImageData getImageData(ImageType type)
+    {
+        ImageData out = ImageData::U8;
+        switch (type)
+        {
+        case ImageType::RGB_U10:
+            out = ImageData::U10;
+            break;
+        case ImageType::L_U16:
+        case ImageType::LA_U16:
+        case ImageType::RGB_U16:
+        case ImageType::RGBA_U16:
+        case ImageType::YUV_420P_U16:
+        case ImageType::YUV_422P_U16:
+        case ImageType::YUV_444P_U16:
+        case ImageType::YUV_420SP_U16:
+            out = ImageData::U16;
+            break;
+        case ImageType::L_U32:
+        case ImageType::LA_U32:
+        case ImageType::RGB_U32:
+        case ImageType::RGBA_U32:
+            out = ImageData::U32;
+            break;
+        case ImageType::L_F16:
+        case ImageType::LA_F16:
+        case ImageType::RGB_F16:
+        case ImageType::RGBA_F16:
+            out = ImageData::F16;
+            break;
+        case ImageType::L_F32:
+        case ImageType::LA_F32:
+        case ImageType::RGB_F32:
+        case ImageType::RGBA_F32:
+            out = ImageData::F32;
+            break;
+        default: break;
+        }
+        return out;
+    }
+
+    size_t getSampleByteCount(ImageData data)
+    {
+        size_t out = 1;
+        switch (data)
+        {
+        case ImageData::U16:
+        case ImageData::F16: out = 2; break;
+        case ImageData::U10:
+        case ImageData::U32:
+        case ImageData::F32: out = 4; break;
+        default: break;
+        }
+        return out;
+    }
+
+    std::vector<ImagePlane> getImagePlanes(const ImageInfo& info)
+    {
+        std::vector<ImagePlane> out;
+        const int w = info.size.w;
+        const int h = info.size.h;
+        const ImageData data = getImageData(info.type);
+        const size_t sampleByteCount = getSampleByteCount(data);
+        Size2I chromaSize(w, h);
+        switch (info.type)
+        {
+        case ImageType::YUV_420P_U8:
+        case ImageType::YUV_420P_U16:
+        case ImageType::YUV_420SP_U8:
+        case ImageType::YUV_420SP_U16:
+            chromaSize = Size2I((w + 1) / 2, (h + 1) / 2);
+            break;
+        case ImageType::YUV_422P_U8:
+        case ImageType::YUV_422P_U16:
+            chromaSize.w = (w + 1) / 2;
+            break;
+        default: break;
+        }
+        auto add = [&out, sampleByteCount](const Size2I& size, int channels)
+        {
+            ImagePlane plane;
+            if (!out.empty())
+            {
+                plane.offset = out.back().offset +
+                    out.back().rowByteCount * out.back().size.h;
+            }
+            plane.size = size;
+            plane.channels = channels;
+            plane.pixelByteCount = sampleByteCount * channels;
+            plane.rowByteCount = plane.pixelByteCount * size.w;
+            out.push_back(plane);
+        };
+        switch (info.type)
+        {
+        case ImageType::None:
+            break;
+        case ImageType::YUV_420P_U8:
+        case ImageType::YUV_422P_U8:
+        case ImageType::YUV_444P_U8:
+        case ImageType::YUV_420P_U16:
+        case ImageType::YUV_422P_U16:
+        case ImageType::YUV_444P_U16:
+            add(info.size, 1);
+            add(chromaSize, 1);
+            add(chromaSize, 1);
+            break;
+        case ImageType::YUV_420SP_U8:
+        case ImageType::YUV_420SP_U16:
+            add(info.size, 1);
+            add(chromaSize, 2);
+            break;
+        default:
+        {
+            ImagePlane plane;
+            plane.size = info.size;
+            plane.channels = getChannelCount(info.type);
+            plane.pixelByteCount = ImageData::U10 == data ?
+                4 :
+                sampleByteCount * plane.channels;
+            plane.rowByteCount = getAlignedByteCount(
+                plane.pixelByteCount * w,
+                info.layout.alignment);
+            out.push_back(plane);
+            break;
+        }
+        }
+        return out;
+    }
+
+    float halfToFloat(uint16_t value)
+    {
+        const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+        const uint32_t exponent = (value >> 10) & 0x1f;
+        uint32_t mantissa = value & 0x3ff;
+        uint32_t bits = sign;
+        if (0 == exponent)
+        {
+            if (mantissa != 0)
+            {
+                // Subnormal; normalize it.
+                int shift = -1;
+                do
+                {
+                    ++shift;
+                    mantissa <<= 1;
+                } while (!(mantissa & 0x400));
+                bits |= ((127 - 15 - shift) << 23) | ((mantissa & 0x3ff) << 13);
+            }
+        }
+        else if (0x1f == exponent)
+        {
+            bits |= 0x7f800000 | (mantissa << 13);
+        }
+        else
+        {
+            bits |= ((exponent + 127 - 15) << 23) | (mantissa << 13);
+        }
+        float out = 0.F;
+        memcpy(&out, &bits, sizeof(float));
+        return out;
+    }
+
+    uint16_t floatToHalf(float value)
+    {
+        uint32_t bits = 0;
+        memcpy(&bits, &value, sizeof(float));
+        const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        const uint32_t exponent = (bits >> 23) & 0xff;
+        const uint32_t mantissa = bits & 0x7fffff;
+        if (0xff == exponent)
+        {
+            // Infinity, or NaN keeping a bit of the payload.
+            return sign | 0x7c00 | (mantissa ? 0x200 | (mantissa >> 13) : 0);
+        }
+        const int e = static_cast<int>(exponent) - 127 + 15;
+        if (e >= 0x1f)
+        {
+            return sign | 0x7c00;
+        }
+        if (e <= 0)
+        {
+            // Subnormal, or too small and flushed to zero.
+            if (e < -10)
+                return sign;
+            const uint32_t m = mantissa | 0x800000;
+            const int shift = 14 - e;
+            uint32_t out = m >> shift;
+            const uint32_t rest = m & ((1U << shift) - 1);
+            const uint32_t half = 1U << (shift - 1);
+            if (rest > half || (rest == half && (out & 1)))
+            {
+                ++out;
+            }
+            return sign | static_cast<uint16_t>(out);
+        }
+        // Round to nearest even; a carry out of the mantissa rolls into the
+        // exponent, which is what it should do.
+        uint32_t out = (static_cast<uint32_t>(e) << 10) | (mantissa >> 13);
+        const uint32_t rest = mantissa & 0x1fff;
+        if (rest > 0x1000 || (rest == 0x1000 && (out & 1)))
+        {
+            ++out;
+        }
+        return sign | static_cast<uint16_t>(out);
+    }
+
+    namespace
+    {
+        // Every half float as a float, for converting runs of them.
+        const std::vector<float>& getHalfTable()
+        {
+            static const std::vector<float> table = []
+            {
+                std::vector<float> out(65536);
+                for (size_t i = 0; i < out.size(); ++i)
+                {
+                    out[i] = halfToFloat(static_cast<uint16_t>(i));
+                }
+                return out;
+            }();
+            return table;
+        }
+
+        inline uint16_t swap16(uint16_t value)
+        {
+            return static_cast<uint16_t>((value >> 8) | (value << 8));
+        }
+
+        inline uint32_t swap32(uint32_t value)
+        {
+            return
+                ((value >> 24) & 0xff) |
+                ((value >> 8) & 0xff00) |
+                ((value << 8) & 0xff0000) |
+                ((value << 24) & 0xff000000);
+        }
+    }
+
+    // The loops below are kept simple so the compiler vectorizes them:
+    // arithmetic first, then any clamping, then the conversion.
+    void readSamples(
+        const uint8_t* in,
+        ImageData data,
+        bool swap,
+        size_t count,
+        float* out)
+    {
+        switch (data)
+        {
+        case ImageData::U8:
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = in[i] / 255.F;
+            }
+            break;
+        case ImageData::U10:
+            for (size_t i = 0; i < count / 3; ++i)
+            {
+                const uint32_t v = readU32(in + i * 4, swap);
+                out[i * 3 + 0] = ((v >> 22) & 0x3ff) / 1023.F;
+                out[i * 3 + 1] = ((v >> 12) & 0x3ff) / 1023.F;
+                out[i * 3 + 2] = ((v >> 2) & 0x3ff) / 1023.F;
+            }
+            break;
+        case ImageData::U16:
+        {
+            const uint16_t* p = reinterpret_cast<const uint16_t*>(in);
+            if (swap)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    out[i] = static_cast<int32_t>(swap16(p[i])) / 65535.F;
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    out[i] = static_cast<int32_t>(p[i]) / 65535.F;
+                }
+            }
+            break;
+        }
+        case ImageData::U32:
+        {
+            const uint32_t* p = reinterpret_cast<const uint32_t*>(in);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const uint32_t v = swap ? swap32(p[i]) : p[i];
+                out[i] = static_cast<float>(v / 4294967295.0);
+            }
+            break;
+        }
+        case ImageData::F16:
+        {
+            const float* table = getHalfTable().data();
+            const uint16_t* p = reinterpret_cast<const uint16_t*>(in);
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = table[swap ? swap16(p[i]) : p[i]];
+            }
+            break;
+        }
+        case ImageData::F32:
+            if (swap)
+            {
+                const uint32_t* p = reinterpret_cast<const uint32_t*>(in);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const uint32_t v = swap32(p[i]);
+                    memcpy(out + i, &v, sizeof(float));
+                }
+            }
+            else
+            {
+                memcpy(out, in, count * sizeof(float));
+            }
+            break;
+        }
+    }
+
+    void writeSamples(
+        const float* in,
+        size_t count,
+        ImageData data,
+        bool swap,
+        uint8_t* out)
+    {
+        switch (data)
+        {
+        case ImageData::U8:
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float v = std::min(std::max(in[i] * 255.F + .5F, 0.F), 255.F);
+                out[i] = static_cast<uint8_t>(static_cast<int32_t>(v));
+            }
+            break;
+        case ImageData::U10:
+            for (size_t i = 0; i < count / 3; ++i)
+            {
+                uint32_t v = 0;
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    const float c = std::min(std::max(in[i * 3 + k] * 1023.F + .5F, 0.F), 1023.F);
+                    v |= static_cast<uint32_t>(static_cast<int32_t>(c)) << (22 - k * 10);
+                }
+                v = swap ? swap32(v) : v;
+                memcpy(out + i * 4, &v, sizeof(uint32_t));
+            }
+            break;
+        case ImageData::U16:
+        {
+            uint16_t* p = reinterpret_cast<uint16_t*>(out);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float v = std::min(std::max(in[i] * 65535.F + .5F, 0.F), 65535.F);
+                const uint16_t u = static_cast<uint16_t>(static_cast<int32_t>(v));
+                p[i] = swap ? swap16(u) : u;
+            }
+            break;
+        }
+        case ImageData::U32:
+        {
+            uint32_t* p = reinterpret_cast<uint32_t*>(out);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const double v = std::min(std::max(in[i] * 4294967295.0 + .5, 0.0), 4294967295.0);
+                const uint32_t u = static_cast<uint32_t>(v);
+                p[i] = swap ? swap32(u) : u;
+            }
+            break;
+        }
+        case ImageData::F16:
+        {
+            uint16_t* p = reinterpret_cast<uint16_t*>(out);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const uint16_t u = floatToHalf(in[i]);
+                p[i] = swap ? swap16(u) : u;
+            }
+            break;
+        }
+        case ImageData::F32:
+            if (swap)
+            {
+                uint32_t* p = reinterpret_cast<uint32_t*>(out);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    uint32_t v = 0;
+                    memcpy(&v, in + i, sizeof(float));
+                    p[i] = swap32(v);
+                }
+            }
+            else
+            {
+                memcpy(out, in, count * sizeof(float));
+            }
+            break;
+        }
+    }
+
+    namespace
+    {
+        // Threads kept for the image jobs of the whole process. Any number
+        // of callers can share them, including jobs that run jobs of their
+        // own: each caller works through its own jobs too, so it never
+        // waits on a thread that is busy elsewhere, only on the jobs other
+        // threads have already started.
+        class ImageThreads
+        {
+        public:
+            ImageThreads();
+            ~ImageThreads();
+
+            size_t getCount() const;
+
+            void run(
+                size_t count,
+                size_t threads,
+                const std::function<void(size_t)>&);
+
+        private:
+            struct Run
+            {
+                const std::function<void(size_t)>* job = nullptr;
+                size_t count = 0;
+                std::atomic<size_t> next;
+                size_t helpers = 0;
+                size_t active = 0;
+            };
+
+            void _work();
+            static void _drain(Run&);
+
+            std::vector<std::thread> _threads;
+            std::mutex _mutex;
+            std::condition_variable _cv;
+            std::condition_variable _cvDone;
+            std::list<Run*> _runs;
+            bool _running = true;
+        };
+
+        ImageThreads::ImageThreads()
+        {
+            const size_t count = std::max(std::thread::hardware_concurrency(), 1U) - 1;
+            for (size_t i = 0; i < count; ++i)
+            {
+                _threads.emplace_back([this] { _work(); });
+            }
+        }
+
+        ImageThreads::~ImageThreads()
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _running = false;
+            }
+            _cv.notify_all();
+            for (auto& thread : _threads)
+            {
+                if (thread.joinable())
+                {
+                    thread.join();
+                }
+            }
+        }
+
+        size_t ImageThreads::getCount() const
+        {
+            return _threads.size() + 1;
+        }
+
+        void ImageThreads::run(
+            size_t count,
+            size_t threads,
+            const std::function<void(size_t)>& job)
+        {
+            if (0 == threads)
+            {
+                threads = getCount();
+            }
+            const size_t helpers = std::min(std::min(threads, count), getCount());
+            if (helpers < 2)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    job(i);
+                }
+                return;
+            }
+            Run run;
+            run.job = &job;
+            run.count = count;
+            run.next = 0;
+            run.helpers = helpers - 1;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _runs.push_back(&run);
+            }
+            _cv.notify_all();
+            _drain(run);
+
+            // Every job has been started once the drain returns; wait for
+            // the ones the other threads took.
+            std::unique_lock<std::mutex> lock(_mutex);
+            _runs.remove(&run);
+            _cvDone.wait(lock, [&run] { return 0 == run.active; });
+        }
+
+        void ImageThreads::_work()
+        {
+            while (true)
+            {
+                Run* run = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _cv.wait(lock, [this, &run]
+                        {
+                            for (auto i : _runs)
+                            {
+                                if (i->helpers > 0 && i->next < i->count)
+                                {
+                                    run = i;
+                                    break;
+                                }
+                            }
+                            return !_running || run;
+                        });
+                    if (!_running)
+                        break;
+                    --run->helpers;
+                    ++run->active;
+                }
+                _drain(*run);
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    --run->active;
+                }
+                _cvDone.notify_all();
+            }
+        }
+
+        void ImageThreads::_drain(Run& run)
+        {
+            for (size_t i = run.next++; i < run.count; i = run.next++)
+            {
+                (*run.job)(i);
+            }
+        }
+    }
+
+    void runImageJobs(
+        size_t count,
+        size_t threads,
+        const std::function<void(size_t)>& job)
+    {
+        // Never destroyed; joining threads while a shared library unloads
+        // can hang, and the waiting threads hold nothing that needs
+        // releasing.
+        static ImageThreads* imageThreads = new ImageThreads;
+        imageThreads->run(count, threads, job);
+    }
 }
@@ -160,6 +160,35 @@ namespace ftk
     //! Image tags.
     typedef std::map<std::string, std::string> ImageTags;
 
+    //! Image memory pool options.
+    //!
+    //! Image data is allocated in size classes and aligned to 64 bytes, or
+    //! to pages for large images. The memory of a destroyed image is kept
+    //! for the next image of the same size class, so a loop that decodes a
+    //! frame at a time does not go back to the system allocator.
+    struct FTK_API_TYPE ImagePoolOptions
+    {
+        //! The maximum number of bytes kept for reuse. Zero disables the
+        //! pool.
+        size_t maxByteCount = 256 * megabyte;
+
+        //! Back large images with huge pages where the system supports
+        //! them.
+        bool hugePages = false;
+
+        bool operator == (const ImagePoolOptions&) const;
+        bool operator != (const ImagePoolOptions&) const;
+    };
+
+    //! Image memory pool statistics.
+    struct FTK_API_TYPE ImagePoolStats
+    {
+        size_t byteCount   = 0; //!< The number of bytes kept for reuse
+        size_t blockCount  = 0; //!< The number of blocks kept for reuse
+        size_t allocations = 0; //!< The number of blocks allocated from the system
+        size_t reuses      = 0; //!< The number of blocks reused from the pool
+    };
+
     //! Image.
     class FTK_API_TYPE Image : public std::enable_shared_from_this<Image>
     {
@@ -228,12 +257,26 @@ namespace ftk
         //! Get the total number of bytes currently used.
         FTK_API static size_t getTotalByteCount();
 
+        //! Set the memory pool options.
+        FTK_API static void setPoolOptions(const ImagePoolOptions&);
+
+        //! Get the memory pool options.
+        FTK_API static ImagePoolOptions getPoolOptions();
+
+        //! Get the memory pool statistics.
+        FTK_API static ImagePoolStats getPoolStats();
+
+        //! Release the memory kept for reuse.
+        FTK_API static void clearPool();
+
     private:
         ImageInfo _info;
         ImageTags _tags;
-        size_t    _byteCount    = 0;
-        uint8_t*  _data         = nullptr;
-        bool      _externalData = false;
+        size_t    _byteCount      = 0;
+        uint8_t*  _data           = nullptr;
+        bool      _externalData   = false;
+        size_t    _blockByteCount = 0;
+        bool      _blockMapped    = false;
     };
 
     FTK_API void to_json(nlohmann::json&, const ImageMirror&);
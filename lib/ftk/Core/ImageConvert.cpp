@@ -0,0 +1,599 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/ImageConvert.h>
+
+#include <ftk/Core/Format.h>
+#include <ftk/Core/ImagePrivate.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace ftk
+{
+    namespace
+    {
+        bool isYUV(ImageType type)
+        {
+            return type >= ImageType::YUV_420P_U8 && type <= ImageType::YUV_420SP_U16;
+        }
+
+        // Rows converted by one job. This is even so the rows of 4:2:0
+        // chroma are not split between jobs.
+        const int jobRows = 16;
+
+        // Below this many pixels the threads cost more than they save.
+        const size_t threadPixels = 256 * 256;
+
+        // Where a luma column or row falls in a chroma plane: the two
+        // samples either side and the weight of the second, as linear
+        // filtering would sample the plane at that coordinate.
+        struct Tap
+        {
+            int i0 = 0;
+            int i1 = 0;
+            float f = 0.F;
+        };
+
+        Tap getTap(int i, int size, int chromaSize)
+        {
+            Tap out;
+            const float c = (i + .5F) / size * chromaSize - .5F;
+            const float c0 = std::floor(c);
+            out.i0 = std::min(std::max(static_cast<int>(c0), 0), chromaSize - 1);
+            out.i1 = std::min(std::max(static_cast<int>(c0) + 1, 0), chromaSize - 1);
+            out.f = c - c0;
+            return out;
+        }
+
+        // Copy 8-bit pixels between the L, LA, RGB, and RGBA types without
+        // going through floating point. Only conversions that do not need
+        // the luma weights are handled here.
+        template<int CI, int CO>
+        void convertU8(const uint8_t* in, size_t count, uint8_t* out)
+        {
+            for (size_t i = 0; i < count; ++i, in += CI, out += CO)
+            {
+                const uint8_t a = (2 == CI || 4 == CI) ? in[CI - 1] : 255;
+                out[0] = in[0];
+                if (CO >= 3)
+                {
+                    out[1] = in[CI >= 3 ? 1 : 0];
+                    out[2] = in[CI >= 3 ? 2 : 0];
+                }
+                if (2 == CO || 4 == CO)
+                {
+                    out[CO - 1] = a;
+                }
+            }
+        }
+
+        typedef void (*ConvertU8)(const uint8_t*, size_t, uint8_t*);
+
+        ConvertU8 getConvertU8(ImageType in, ImageType out)
+        {
+            switch (in)
+            {
+            case ImageType::L_U8:
+                switch (out)
+                {
+                case ImageType::LA_U8: return convertU8<1, 2>;
+                case ImageType::RGB_U8: return convertU8<1, 3>;
+                case ImageType::RGBA_U8: return convertU8<1, 4>;
+                default: break;
+                }
+                break;
+            case ImageType::LA_U8:
+                switch (out)
+                {
+                case ImageType::L_U8: return convertU8<2, 1>;
+                case ImageType::RGB_U8: return convertU8<2, 3>;
+                case ImageType::RGBA_U8: return convertU8<2, 4>;
+                default: break;
+                }
+                break;
+            case ImageType::RGB_U8:
+                if (ImageType::RGBA_U8 == out)
+                    return convertU8<3, 4>;
+                break;
+            case ImageType::RGBA_U8:
+                if (ImageType::RGB_U8 == out)
+                    return convertU8<4, 3>;
+                break;
+            default: break;
+            }
+            return nullptr;
+        }
+
+        // Read rows of an interleaved image as RGBA.
+        void readRows(
+            const Image& image,
+            int y0,
+            int y1,
+            float* out)
+        {
+            const ImageInfo& info = image.getInfo();
+            const size_t w = info.size.w;
+            const int channels = getChannelCount(info.type);
+            const ImageData data = getImageData(info.type);
+            const ImagePlane plane = getImagePlanes(info).front();
+            const bool swap = info.layout.endian != getEndian() && getSampleByteCount(data) > 1;
+            std::vector<float> row(w * channels);
+            for (int y = y0; y < y1; ++y, out += w * 4)
+            {
+                readSamples(
+                    image.getData() + y * plane.rowByteCount,
+                    data,
+                    swap,
+                    row.size(),
+                    row.data());
+                const float* p = row.data();
+                float* o = out;
+                switch (channels)
+                {
+                case 1:
+                    for (size_t x = 0; x < w; ++x, p += 1, o += 4)
+                    {
+                        o[0] = o[1] = o[2] = p[0];
+                        o[3] = 1.F;
+                    }
+                    break;
+                case 2:
+                    for (size_t x = 0; x < w; ++x, p += 2, o += 4)
+                    {
+                        o[0] = o[1] = o[2] = p[0];
+                        o[3] = p[1];
+                    }
+                    break;
+                case 3:
+                    for (size_t x = 0; x < w; ++x, p += 3, o += 4)
+                    {
+                        o[0] = p[0];
+                        o[1] = p[1];
+                        o[2] = p[2];
+                        o[3] = 1.F;
+                    }
+                    break;
+                case 4:
+                    memcpy(o, p, w * 4 * sizeof(float));
+                    break;
+                default: break;
+                }
+            }
+        }
+
+        // Write rows of RGBA to an interleaved image.
+        void writeRows(
+            const float* in,
+            const V3F& luma,
+            int y0,
+            int y1,
+            Image& image)
+        {
+            const ImageInfo& info = image.getInfo();
+            const size_t w = info.size.w;
+            const int channels = getChannelCount(info.type);
+            const ImageData data = getImageData(info.type);
+            const ImagePlane plane = getImagePlanes(info).front();
+            const bool swap = info.layout.endian != getEndian() && getSampleByteCount(data) > 1;
+            const float kr = luma.x;
+            const float kg = luma.y;
+            const float kb = luma.z;
+            std::vector<float> row(w * channels);
+            for (int y = y0; y < y1; ++y, in += w * 4)
+            {
+                const float* p = in;
+                float* o = row.data();
+                switch (channels)
+                {
+                case 1:
+                    for (size_t x = 0; x < w; ++x, p += 4, o += 1)
+                    {
+                        o[0] = p[0] * kr + p[1] * kg + p[2] * kb;
+                    }
+                    break;
+                case 2:
+                    for (size_t x = 0; x < w; ++x, p += 4, o += 2)
+                    {
+                        o[0] = p[0] * kr + p[1] * kg + p[2] * kb;
+                        o[1] = p[3];
+                    }
+                    break;
+                case 3:
+                    for (size_t x = 0; x < w; ++x, p += 4, o += 3)
+                    {
+                        o[0] = p[0];
+                        o[1] = p[1];
+                        o[2] = p[2];
+                    }
+                    break;
+                case 4:
+                    memcpy(o, p, w * 4 * sizeof(float));
+                    break;
+                default: break;
+                }
+                writeSamples(
+                    row.data(),
+                    row.size(),
+                    data,
+                    swap,
+                    image.getData() + y * plane.rowByteCount);
+            }
+        }
+
+        // Write rows of RGBA to a YUV image. The first row must be at the
+        // start of a block of chroma, and the last either at the end of one
+        // or of the image.
+        void writeYUVRows(
+            const float* in,
+            int y0,
+            int y1,
+            Image& image)
+        {
+            const ImageInfo& info = image.getInfo();
+            const int w = info.size.w;
+            const int h = info.size.h;
+            const ImageData data = getImageData(info.type);
+            const bool swap = info.layout.endian != getEndian() && getSampleByteCount(data) > 1;
+            const auto planes = getImagePlanes(info);
+            const bool semiPlanar = 2 == planes.size();
+            const Size2I& cs = planes[1].size;
+            const int fx = cs.w < w ? 2 : 1;
+            const int fy = cs.h < h ? 2 : 1;
+            const V4F k = getYUVCoefficients(info.yuvCoefficients);
+            const float kr = 1.F - k.x / 2.F;
+            const float kb = 1.F - k.w / 2.F;
+            const float kg = 1.F - kr - kb;
+            const float dr = 1.F / k.x;
+            const float db = 1.F / k.w;
+            const bool legal = VideoLevels::LegalRange == info.videoLevels;
+            const float lScale = legal ? (235.F - 16.F) / 255.F : 1.F;
+            const float cScale = legal ? (240.F - 16.F) / 255.F : 1.F;
+            const float lo = legal ? 16.F / 255.F : 0.F;
+
+            // Luma is written a row at a time; the chroma is kept at full
+            // resolution until the rows of a block are done.
+            const size_t rows = y1 - y0;
+            std::vector<float> l(w);
+            std::vector<float> cb(rows * w);
+            std::vector<float> cr(rows * w);
+            for (int y = y0; y < y1; ++y)
+            {
+                const float* p = in + static_cast<size_t>(y - y0) * w * 4;
+                float* cbRow = cb.data() + static_cast<size_t>(y - y0) * w;
+                float* crRow = cr.data() + static_cast<size_t>(y - y0) * w;
+                for (int x = 0; x < w; ++x, p += 4)
+                {
+                    const float v = p[0] * kr + p[1] * kg + p[2] * kb;
+                    l[x] = v * lScale + lo;
+                    cbRow[x] = (p[2] - v) * db;
+                    crRow[x] = (p[0] - v) * dr;
+                }
+                writeSamples(
+                    l.data(),
+                    w,
+                    data,
+                    swap,
+                    image.getData() + planes[0].offset + y * planes[0].rowByteCount);
+            }
+
+            std::vector<float> cbOut(cs.w);
+            std::vector<float> crOut(cs.w);
+            std::vector<float> cbcr(semiPlanar ? cs.w * 2 : 0);
+            for (int cy = y0 / fy; cy < (y1 + fy - 1) / fy; ++cy)
+            {
+                const int r0 = cy * fy - y0;
+                const int r1 = std::min(cy * fy + fy, y1) - y0;
+                for (int cx = 0; cx < cs.w; ++cx)
+                {
+                    const int c0 = cx * fx;
+                    const int c1 = std::min(c0 + fx, w);
+                    float sumB = 0.F;
+                    float sumR = 0.F;
+                    for (int r = r0; r < r1; ++r)
+                    {
+                        for (int c = c0; c < c1; ++c)
+                        {
+                            sumB += cb[static_cast<size_t>(r) * w + c];
+                            sumR += cr[static_cast<size_t>(r) * w + c];
+                        }
+                    }
+                    const float n = static_cast<float>((r1 - r0) * (c1 - c0));
+                    cbOut[cx] = (sumB / n + .5F) * cScale + lo;
+                    crOut[cx] = (sumR / n + .5F) * cScale + lo;
+                }
+                if (semiPlanar)
+                {
+                    for (int cx = 0; cx < cs.w; ++cx)
+                    {
+                        cbcr[cx * 2] = cbOut[cx];
+                        cbcr[cx * 2 + 1] = crOut[cx];
+                    }
+                    writeSamples(
+                        cbcr.data(),
+                        cbcr.size(),
+                        data,
+                        swap,
+                        image.getData() + planes[1].offset + cy * planes[1].rowByteCount);
+                }
+                else
+                {
+                    writeSamples(
+                        cbOut.data(),
+                        cs.w,
+                        data,
+                        swap,
+                        image.getData() + planes[1].offset + cy * planes[1].rowByteCount);
+                    writeSamples(
+                        crOut.data(),
+                        cs.w,
+                        data,
+                        swap,
+                        image.getData() + planes[2].offset + cy * planes[2].rowByteCount);
+                }
+            }
+        }
+    }
+
+    void readYUVRows(
+        const Image& image,
+        VideoLevels videoLevels,
+        int y0,
+        int y1,
+        float* out)
+    {
+        const ImageInfo& info = image.getInfo();
+        const int w = info.size.w;
+        const int h = info.size.h;
+        const ImageData data = getImageData(info.type);
+        const bool swap = info.layout.endian != getEndian() && getSampleByteCount(data) > 1;
+        const auto planes = getImagePlanes(info);
+        const bool semiPlanar = 2 == planes.size();
+        const Size2I& cs = planes[1].size;
+        std::vector<Tap> xTaps(w);
+        for (int x = 0; x < w; ++x)
+        {
+            xTaps[x] = getTap(x, w, cs.w);
+        }
+        const V4F k = getYUVCoefficients(info.yuvCoefficients);
+        const float kx = k.x;
+        const float ky = k.y;
+        const float kz = k.z;
+        const float kw = k.w;
+        const bool legal = VideoLevels::LegalRange == videoLevels;
+
+        std::vector<float> l(w);
+        std::vector<float> cb(w);
+        std::vector<float> cr(w);
+        std::vector<float> cb0(cs.w);
+        std::vector<float> cr0(cs.w);
+        std::vector<float> cb1(cs.w);
+        std::vector<float> cr1(cs.w);
+        std::vector<float> cbcr(semiPlanar ? cs.w * 2 : 0);
+        auto readChroma = [&](int row, float* cbRow, float* crRow)
+        {
+            const uint8_t* p = image.getData() + planes[1].offset + row * planes[1].rowByteCount;
+            if (semiPlanar)
+            {
+                readSamples(p, data, swap, cbcr.size(), cbcr.data());
+                for (int x = 0; x < cs.w; ++x)
+                {
+                    cbRow[x] = cbcr[x * 2];
+                    crRow[x] = cbcr[x * 2 + 1];
+                }
+            }
+            else
+            {
+                readSamples(p, data, swap, cs.w, cbRow);
+                readSamples(
+                    image.getData() + planes[2].offset + row * planes[2].rowByteCount,
+                    data,
+                    swap,
+                    cs.w,
+                    crRow);
+            }
+        };
+
+        for (int y = y0; y < y1; ++y, out += static_cast<size_t>(w) * 4)
+        {
+            readSamples(
+                image.getData() + planes[0].offset + y * planes[0].rowByteCount,
+                data,
+                swap,
+                w,
+                l.data());
+
+            // Filter the chroma down, then across.
+            const Tap yTap = getTap(y, h, cs.h);
+            readChroma(yTap.i0, cb0.data(), cr0.data());
+            readChroma(yTap.i1, cb1.data(), cr1.data());
+            const float fy = yTap.f;
+            for (int x = 0; x < cs.w; ++x)
+            {
+                cb0[x] += (cb1[x] - cb0[x]) * fy;
+                cr0[x] += (cr1[x] - cr0[x]) * fy;
+            }
+            for (int x = 0; x < w; ++x)
+            {
+                const Tap& t = xTaps[x];
+                cb[x] = cb0[t.i0] + (cb0[t.i1] - cb0[t.i0]) * t.f;
+                cr[x] = cr0[t.i0] + (cr0[t.i1] - cr0[t.i0]) * t.f;
+            }
+
+            if (legal)
+            {
+                for (int x = 0; x < w; ++x)
+                {
+                    l[x] = legalRange(l[x]);
+                    cb[x] = legalRangeChroma(cb[x]);
+                    cr[x] = legalRangeChroma(cr[x]);
+                }
+            }
+            float* o = out;
+            for (int x = 0; x < w; ++x, o += 4)
+            {
+                const float b = cb[x] - .5F;
+                const float r = cr[x] - .5F;
+                o[0] = std::min(std::max(l[x] + kx * r, 0.F), 1.F);
+                o[1] = std::min(std::max(l[x] - ky * r - kz * b, 0.F), 1.F);
+                o[2] = std::min(std::max(l[x] + kw * b, 0.F), 1.F);
+                o[3] = 1.F;
+            }
+        }
+    }
+
+    std::shared_ptr<Image> convert(
+        const Image& image,
+        ImageType type,
+        const ConvertOptions& options)
+    {
+        ImageInfo info = image.getInfo();
+        info.type = type;
+        if (isYUV(image.getType()) != isYUV(type))
+        {
+            info.videoLevels = VideoLevels::FullRange;
+        }
+        auto out = Image::create(info);
+        out->setTags(image.getTags());
+        convert(image, *out, options);
+        return out;
+    }
+
+    void convert(
+        const Image& in,
+        Image& out,
+        const ConvertOptions& options)
+    {
+        const ImageInfo& inInfo = in.getInfo();
+        const ImageInfo& outInfo = out.getInfo();
+        if (inInfo.size != outInfo.size)
+        {
+            throw std::runtime_error(Format("Cannot convert image: {0} does not match {1}").
+                arg(inInfo.size).
+                arg(outInfo.size));
+        }
+        if (!in.isValid())
+            return;
+
+        const int w = inInfo.size.w;
+        const int h = inInfo.size.h;
+        const size_t threads =
+            static_cast<size_t>(w) * h < threadPixels ?
+            1 :
+            options.threads;
+        const int jobs = (h + jobRows - 1) / jobRows;
+
+        if (!options.premultiply &&
+            inInfo.type == outInfo.type &&
+            inInfo.layout == outInfo.layout &&
+            inInfo.videoLevels == outInfo.videoLevels &&
+            inInfo.yuvCoefficients == outInfo.yuvCoefficients)
+        {
+            memcpy(out.getData(), in.getData(), std::min(in.getByteCount(), out.getByteCount()));
+            return;
+        }
+
+        if (!options.premultiply &&
+            inInfo.layout.mirror == outInfo.layout.mirror)
+        {
+            if (const ConvertU8 fnc = getConvertU8(inInfo.type, outInfo.type))
+            {
+                const size_t inRow = getImagePlanes(inInfo).front().rowByteCount;
+                const size_t outRow = getImagePlanes(outInfo).front().rowByteCount;
+                runImageJobs(
+                    jobs,
+                    threads,
+                    [&in, &out, fnc, inRow, outRow, w, h](size_t job)
+                    {
+                        const int y0 = static_cast<int>(job) * jobRows;
+                        const int y1 = std::min(y0 + jobRows, h);
+                        for (int y = y0; y < y1; ++y)
+                        {
+                            fnc(in.getData() + y * inRow, w, out.getData() + y * outRow);
+                        }
+                    });
+                return;
+            }
+        }
+
+        // The luma weights for reducing color to luminance.
+        const V4F k = getYUVCoefficients(inInfo.yuvCoefficients);
+        const float kr = 1.F - k.x / 2.F;
+        const float kb = 1.F - k.w / 2.F;
+        const V3F luma(kr, 1.F - kr - kb, kb);
+
+        const bool inYUV = isYUV(inInfo.type);
+        const bool outYUV = isYUV(outInfo.type);
+        const bool premultiply = options.premultiply;
+        const bool flip = inInfo.layout.mirror.y != outInfo.layout.mirror.y;
+        const bool flop = inInfo.layout.mirror.x != outInfo.layout.mirror.x;
+        runImageJobs(
+            jobs,
+            threads,
+            [&in, &out, &inInfo, &luma, inYUV, outYUV, premultiply, flip, flop, w, h](size_t job)
+            {
+                const int y0 = static_cast<int>(job) * jobRows;
+                const int y1 = std::min(y0 + jobRows, h);
+                const size_t rowSize = static_cast<size_t>(w) * 4;
+                std::vector<float> rgba((y1 - y0) * rowSize);
+
+                // The rows are read in the order of the output, so a change
+                // of mirroring is applied here.
+                const int inY0 = flip ? h - y1 : y0;
+                const int inY1 = flip ? h - y0 : y1;
+                if (inYUV)
+                {
+                    readYUVRows(in, inInfo.videoLevels, inY0, inY1, rgba.data());
+                }
+                else
+                {
+                    readRows(in, inY0, inY1, rgba.data());
+                }
+                if (flip)
+                {
+                    for (int y = 0; y < (y1 - y0) / 2; ++y)
+                    {
+                        std::swap_ranges(
+                            rgba.begin() + y * rowSize,
+                            rgba.begin() + (y + 1) * rowSize,
+                            rgba.begin() + (y1 - y0 - 1 - y) * rowSize);
+                    }
+                }
+                if (flop)
+                {
+                    for (int y = 0; y < y1 - y0; ++y)
+                    {
+                        float* row = rgba.data() + y * rowSize;
+                        for (int x = 0; x < w / 2; ++x)
+                        {
+                            std::swap_ranges(
+                                row + x * 4,
+                                row + x * 4 + 4,
+                                row + (w - 1 - x) * 4);
+                        }
+                    }
+                }
+                if (premultiply)
+                {
+                    float* p = rgba.data();
+                    for (size_t i = 0; i < rgba.size(); i += 4)
+                    {
+                        const float a = p[i + 3];
+                        p[i] *= a;
+                        p[i + 1] *= a;
+                        p[i + 2] *= a;
+                    }
+                }
+                if (outYUV)
+                {
+                    writeYUVRows(rgba.data(), y0, y1, out);
+                }
+                else
+                {
+                    writeRows(rgba.data(), luma, y0, y1, out);
+                }
+            });
+    }
+}
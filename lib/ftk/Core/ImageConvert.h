@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/Image.h>
+
+namespace ftk
+{
+    //! \name Images
+    ///@{
+
+    //! Image conversion options.
+    struct FTK_API_TYPE ConvertOptions
+    {
+        //! Multiply the color channels by alpha.
+        bool premultiply = false;
+
+        //! The maximum number of threads, or zero for one for each core.
+        size_t threads = 0;
+
+        bool operator == (const ConvertOptions&) const;
+        bool operator != (const ConvertOptions&) const;
+    };
+
+    //! Convert an image to another type.
+    //!
+    //! The result has the same size and layout. Samples are converted
+    //! through floating point, integer types clamped and rounded; a few
+    //! common 8-bit conversions copy bytes directly. Missing channels are
+    //! filled as the renderer would: luminance is repeated across the color
+    //! channels and alpha is one. Color is reduced to luminance with the
+    //! weights of the image YUV coefficients. YUV images are converted to
+    //! full range RGB, the chroma filtered linearly; converting to YUV
+    //! averages the chroma over each subsampled block. The video levels are
+    //! kept unless converting to or from YUV, which gives full range.
+    FTK_API std::shared_ptr<Image> convert(
+        const Image&,
+        ImageType,
+        const ConvertOptions& = ConvertOptions());
+
+    //! Convert an image into another image of the same size, which may also
+    //! have a different layout. Throws an exception if the sizes do not
+    //! match.
+    FTK_API void convert(
+        const Image&,
+        Image&,
+        const ConvertOptions& = ConvertOptions());
+
+    ///@}
+}
+
+#include <ftk/Core/ImageConvertInline.h>
@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+namespace ftk
+{
+    inline bool ConvertOptions::operator == (const ConvertOptions& other) const
+    {
+        return
+            premultiply == other.premultiply &&
+            threads == other.threads;
+    }
+
+    inline bool ConvertOptions::operator != (const ConvertOptions& other) const
+    {
+        return !(*this == other);
+    }
+}
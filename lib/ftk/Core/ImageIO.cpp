@@ -3,9 +3,18 @@
 
 #include <ftk/Core/ImageIO.h>
 
+#include <ftk/Core/Context.h>
+#include <ftk/Core/Format.h>
+#include <ftk/Core/ImageConvert.h>
+#include <ftk/Core/ImagePrivate.h>
+#include <ftk/Core/LogSystem.h>
 #include <ftk/Core/PNG.h>
 
 #include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
 
 namespace ftk
 {
@@ -29,6 +38,49 @@ namespace ftk
     IImageReader::~IImageReader()
     {}
 
+    std::shared_ptr<Image> IImageReader::read(const Box2I& region)
+    {
+        auto image = read();
+        const ImageInfo& info = image->getInfo();
+        const Box2I box = intersect(region, Box2I(0, 0, info.size.w, info.size.h));
+        const auto planes = getImagePlanes(info);
+        if (!box.isValid() || planes.size() != 1)
+        {
+            throw std::runtime_error(Format("Cannot read region: \"{0}\"").arg(_path.u8string()));
+        }
+        ImageInfo outInfo = info;
+        outInfo.size = box.size();
+        auto out = Image::create(outInfo);
+        out->setTags(image->getTags());
+        const ImagePlane& plane = planes.front();
+        const ImagePlane outPlane = getImagePlanes(outInfo).front();
+        for (int y = 0; y < outInfo.size.h; ++y)
+        {
+            // The region is from the top, the rows may be stored from the
+            // bottom.
+            const int inY = box.min.y + y;
+            const int inRow = info.layout.mirror.y ? inY : info.size.h - 1 - inY;
+            const int outRow = info.layout.mirror.y ? y : outInfo.size.h - 1 - y;
+            memcpy(
+                out->getData() + outRow * outPlane.rowByteCount,
+                image->getData() + inRow * plane.rowByteCount + box.min.x * plane.pixelByteCount,
+                outPlane.size.w * plane.pixelByteCount);
+        }
+        return out;
+    }
+
+    void IImageReader::read(const std::shared_ptr<Image>& out)
+    {
+        const ImageInfo& info = getInfo();
+        if (!out || out->getSize() != info.size || out->getType() != info.type)
+        {
+            throw std::runtime_error(Format("Cannot read into image: \"{0}\"").arg(_path.u8string()));
+        }
+        auto image = read();
+        convert(*image, *out);
+        out->setTags(image->getTags());
+    }
+
     IImageWriter::IImageWriter(
         const std::filesystem::path& path,
         const ImageIOOptions&) :
@@ -116,14 +168,98 @@ namespace ftk
         return nullptr;
     }
 
+    struct ImageIO::Private
+    {
+        // The plugins are read from the worker threads.
+        std::list<std::shared_ptr<IImagePlugin> > plugins;
+        std::mutex pluginsMutex;
+        std::list<std::shared_ptr<IImagePlugin> > getPlugins();
+
+        // A request is cancelled by fulfilling its promise without running
+        // it. Requests without a cancel function, the writes, are always
+        // run.
+        struct Request
+        {
+            uint64_t id = 0;
+            std::function<void(void)> run;
+            std::function<void(void)> cancel;
+        };
+        struct Mutex
+        {
+            uint64_t id = 0;
+            std::list<std::shared_ptr<Request> > requests;
+            bool running = false;
+            std::mutex mutex;
+        };
+        Mutex mutex;
+
+        // Wakes the event loop when a request finishes, so its future is
+        // seen without polling.
+        std::function<void(void)> wakeup;
+
+        // The workers are started by the first request, which may come from
+        // any thread.
+        struct Thread
+        {
+            size_t count = 0;
+            std::condition_variable cv;
+            std::vector<std::thread> threads;
+            std::mutex mutex;
+        };
+        Thread thread;
+
+        uint64_t addRequest(const std::shared_ptr<Request>&);
+    };
+
+    std::list<std::shared_ptr<IImagePlugin> > ImageIO::Private::getPlugins()
+    {
+        std::unique_lock<std::mutex> lock(pluginsMutex);
+        return plugins;
+    }
+
+    uint64_t ImageIO::Private::addRequest(const std::shared_ptr<Request>& request)
+    {
+        uint64_t out = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex.mutex);
+            out = mutex.id++;
+            request->id = out;
+            mutex.requests.push_back(request);
+        }
+        thread.cv.notify_one();
+        return out;
+    }
+
     ImageIO::ImageIO(const std::shared_ptr<Context>& context) :
-        ISystem(context, "ftk::ImageIO")
+        ISystem(context, "ftk::ImageIO"),
+        _p(new Private)
     {
-        _plugins.push_front(std::shared_ptr<IImagePlugin>(new png::ImagePlugin));
+        FTK_P();
+        p.plugins.push_front(std::shared_ptr<IImagePlugin>(new png::ImagePlugin));
+        p.wakeup = context->getWakeup();
     }
 
     ImageIO::~ImageIO()
-    {}
+    {
+        FTK_P();
+        _stopThreads();
+        std::list<std::shared_ptr<Private::Request> > requests;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            requests = std::move(p.mutex.requests);
+        }
+        for (const auto& request : requests)
+        {
+            if (request->cancel)
+            {
+                request->cancel();
+            }
+            else
+            {
+                request->run();
+            }
+        }
+    }
 
     std::shared_ptr<ImageIO> ImageIO::create(const std::shared_ptr<Context>& context)
     {
@@ -132,12 +268,14 @@ namespace ftk
 
     const std::list<std::shared_ptr<IImagePlugin> >& ImageIO::getPlugins() const
     {
-        return _plugins;
+        return _p->plugins;
     }
 
     void ImageIO::addPlugin(const std::shared_ptr<IImagePlugin>& plugin)
     {
-        _plugins.push_front(plugin);
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.pluginsMutex);
+        p.plugins.push_front(plugin);
     }
 
     std::shared_ptr<IImageReader> ImageIO::read(
@@ -145,7 +283,7 @@ namespace ftk
         const ImageIOOptions& options)
     {
         std::shared_ptr<IImageReader> out;
-        for (const auto& plugin : _plugins)
+        for (const auto& plugin : _p->getPlugins())
         {
             if (plugin->canRead(path, options))
             {
@@ -162,7 +300,7 @@ namespace ftk
         const ImageIOOptions& options)
     {
         std::shared_ptr<IImageReader> out;
-        for (const auto& plugin : _plugins)
+        for (const auto& plugin : _p->getPlugins())
         {
             if (plugin->canRead(path, options))
             {
@@ -173,13 +311,199 @@ namespace ftk
         return out;
     }
 
+    std::vector<std::shared_ptr<Image> > ImageIO::readImages(
+        const std::vector<std::filesystem::path>& paths,
+        const ImageIOOptions& options,
+        size_t threads)
+    {
+        std::vector<std::shared_ptr<Image> > out(paths.size());
+        runImageJobs(
+            paths.size(),
+            threads,
+            [this, &paths, &options, &out](size_t i)
+            {
+                try
+                {
+                    if (auto reader = read(paths[i], options))
+                    {
+                        out[i] = reader->read();
+                    }
+                    else
+                    {
+                        _log(
+                            Format("Cannot read: \"{0}\"").arg(paths[i].u8string()),
+                            LogType::Error);
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    _log(e.what(), LogType::Error);
+                }
+            });
+        return out;
+    }
+
+    ImageRequest ImageIO::readAsync(
+        const std::filesystem::path& path,
+        const ImageIOOptions& options)
+    {
+        return readAsync(path, nullptr, options);
+    }
+
+    ImageRequest ImageIO::readAsync(
+        const std::filesystem::path& path,
+        const std::function<void(const std::shared_ptr<Image>&)>& callback,
+        const ImageIOOptions& options)
+    {
+        FTK_P();
+        ImageRequest out;
+        auto promise = std::make_shared<std::promise<std::shared_ptr<Image> > >();
+        out.future = promise->get_future();
+        auto request = std::make_shared<Private::Request>();
+        request->run = [this, path, callback, options, promise]
+            {
+                std::shared_ptr<Image> image;
+                try
+                {
+                    if (auto reader = read(path, options))
+                    {
+                        image = reader->read();
+                    }
+                    else
+                    {
+                        _log(
+                            Format("Cannot read: \"{0}\"").arg(path.u8string()),
+                            LogType::Error);
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    _log(e.what(), LogType::Error);
+                }
+                if (callback)
+                {
+                    callback(image);
+                }
+                promise->set_value(image);
+                _p->wakeup();
+            };
+        request->cancel = [callback, promise]
+            {
+                if (callback)
+                {
+                    callback(nullptr);
+                }
+                promise->set_value(nullptr);
+            };
+        _startThreads();
+        out.id = p.addRequest(request);
+        return out;
+    }
+
+    std::future<bool> ImageIO::writeAsync(
+        const std::filesystem::path& path,
+        const std::shared_ptr<Image>& image,
+        const ImageIOOptions& options)
+    {
+        FTK_P();
+        auto promise = std::make_shared<std::promise<bool> >();
+        auto out = promise->get_future();
+        if (!image)
+        {
+            promise->set_value(false);
+            return out;
+        }
+        auto request = std::make_shared<Private::Request>();
+        request->run = [this, path, image, options, promise]
+            {
+                bool out = false;
+                try
+                {
+                    if (auto writer = write(path, image->getInfo(), options))
+                    {
+                        writer->write(image);
+                        out = true;
+                    }
+                    else
+                    {
+                        _log(
+                            Format("Cannot write: \"{0}\"").arg(path.u8string()),
+                            LogType::Error);
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    _log(e.what(), LogType::Error);
+                }
+                promise->set_value(out);
+                _p->wakeup();
+            };
+        _startThreads();
+        p.addRequest(request);
+        return out;
+    }
+
+    void ImageIO::cancelRequests(const std::vector<uint64_t>& ids)
+    {
+        FTK_P();
+        std::list<std::shared_ptr<Private::Request> > requests;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            auto i = p.mutex.requests.begin();
+            while (i != p.mutex.requests.end())
+            {
+                const auto j = std::find(ids.begin(), ids.end(), (*i)->id);
+                if (j != ids.end() && (*i)->cancel)
+                {
+                    requests.push_back(*i);
+                    i = p.mutex.requests.erase(i);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+        for (const auto& request : requests)
+        {
+            request->cancel();
+        }
+    }
+
+    size_t ImageIO::getThreadCount() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.thread.mutex);
+        return p.thread.count;
+    }
+
+    void ImageIO::setThreadCount(size_t value)
+    {
+        FTK_P();
+        bool restart = false;
+        {
+            std::unique_lock<std::mutex> lock(p.thread.mutex);
+            if (value == p.thread.count)
+                return;
+            p.thread.count = value;
+            restart = !p.thread.threads.empty();
+        }
+        if (restart)
+        {
+            // Requests that are waiting stay in the queue for the new
+            // workers.
+            _stopThreads();
+            _startThreads();
+        }
+    }
+
     std::shared_ptr<IImageWriter> ImageIO::write(
         const std::filesystem::path& path,
         const ImageInfo& info,
         const ImageIOOptions& options)
     {
         std::shared_ptr<IImageWriter> out;
-        for (const auto& plugin : _plugins)
+        for (const auto& plugin : _p->getPlugins())
         {
             if (plugin->canWrite(path, info, options))
             {
@@ -189,4 +513,67 @@ namespace ftk
         }
         return out;
     }
-}
\ No newline at end of file
+
+    void ImageIO::_startThreads()
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> threadLock(p.thread.mutex);
+        if (!p.thread.threads.empty())
+            return;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            p.mutex.running = true;
+        }
+        const size_t count = p.thread.count > 0 ?
+            p.thread.count :
+            std::max(std::thread::hardware_concurrency(), 1U);
+        for (size_t i = 0; i < count; ++i)
+        {
+            p.thread.threads.push_back(std::thread(
+                [this]
+                {
+                    FTK_P();
+                    while (true)
+                    {
+                        std::shared_ptr<Private::Request> request;
+                        {
+                            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+                            p.thread.cv.wait(
+                                lock,
+                                [this]
+                                {
+                                    return
+                                        !_p->mutex.running ||
+                                        !_p->mutex.requests.empty();
+                                });
+                            if (!p.mutex.running)
+                                break;
+                            request = p.mutex.requests.front();
+                            p.mutex.requests.pop_front();
+                        }
+
+                        request->run();
+                    }
+                }));
+        }
+    }
+
+    void ImageIO::_stopThreads()
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> threadLock(p.thread.mutex);
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            p.mutex.running = false;
+        }
+        p.thread.cv.notify_all();
+        for (auto& thread : p.thread.threads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+        p.thread.threads.clear();
+    }
+}
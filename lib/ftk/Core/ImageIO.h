@@ -3,10 +3,13 @@
 
 #pragma once
 
+#include <ftk/Core/Box.h>
 #include <ftk/Core/FileIO.h>
 #include <ftk/Core/ISystem.h>
 #include <ftk/Core/Image.h>
 
+#include <functional>
+#include <future>
 #include <list>
 
 namespace ftk
@@ -15,12 +18,21 @@ namespace ftk
         ///@{
 
         //! Image I/O options.
+        //!
+        //! PNG writer options:
+        //! * "PNG/Compression" - The zlib compression level, from "0" (none)
+        //!   to "9" (smallest)
+        //! * "PNG/Strategy" - The zlib strategy: "Default", "Filtered",
+        //!   "HuffmanOnly", "RLE", or "Fixed"
+        //! * "PNG/Filter" - The row filter: "None", "Sub", "Up", "Average",
+        //!   "Paeth", or "All" to choose for each row
         typedef std::map<std::string, std::string> ImageIOOptions;
 
         //! Merge image I/O options.
         FTK_API ImageIOOptions merge(const ImageIOOptions&, const ImageIOOptions&);
         
-        //! Base class for image readers.
+        //! Base class for image readers. A reader may only be able to read
+        //! once; create another one to read the image again.
         class FTK_API_TYPE IImageReader
         {
         public:
@@ -37,6 +49,18 @@ namespace ftk
             //! Read the image.
             FTK_API virtual std::shared_ptr<Image> read() = 0;
 
+            //! Read a region of the image, in pixels from the top left. The
+            //! region is clipped to the image. The default implementation
+            //! reads the whole image and copies the region out of it.
+            FTK_API virtual std::shared_ptr<Image> read(const Box2I&);
+
+            //! Read the image into an existing image, for example one whose
+            //! memory belongs to the caller. The image must have the same
+            //! size and type; the layout, mirroring, alignment, and
+            //! endianness, may differ. The default implementation reads a
+            //! new image and converts it.
+            FTK_API virtual void read(const std::shared_ptr<Image>&);
+
         protected:
             std::filesystem::path _path;
         };
@@ -103,9 +127,18 @@ namespace ftk
             std::vector<std::string> _exts;
         };
         
+        //! Asynchronous image read request.
+        struct FTK_API_TYPE ImageRequest
+        {
+            uint64_t id = 0;
+            std::future<std::shared_ptr<Image> > future;
+        };
+
         //! Image I/O system.
         class FTK_API_TYPE ImageIO : public ISystem
         {
+            FTK_NON_COPYABLE(ImageIO);
+
         protected:
             ImageIO(const std::shared_ptr<Context>&);
 
@@ -115,7 +148,8 @@ namespace ftk
             //! Create a new system.
             FTK_API static std::shared_ptr<ImageIO> create(const std::shared_ptr<Context>&);
 
-            //! Get the plugins.
+            //! Get the plugins. The list is not locked, so this is for the
+            //! thread that adds the plugins.
             FTK_API const std::list<std::shared_ptr<IImagePlugin> >& getPlugins() const;
             
             //! Add a plugin.
@@ -132,6 +166,54 @@ namespace ftk
                 const MemFile&,
                 const ImageIOOptions& = ImageIOOptions());
             
+            //! Read images, decoding them in parallel. Images that cannot
+            //! be read are null, and the error is logged.
+            FTK_API std::vector<std::shared_ptr<Image> > readImages(
+                const std::vector<std::filesystem::path>&,
+                const ImageIOOptions& = ImageIOOptions(),
+                size_t threads = 0);
+
+            //! Request an image to be read on a worker thread. Requests are
+            //! handled in the order they are made. The future carries a null
+            //! image when the file cannot be read, and the error is logged.
+            //! Once the future is ready the application's event loop is woken
+            //! (Context::wakeup()).
+            FTK_API ImageRequest readAsync(
+                const std::filesystem::path&,
+                const ImageIOOptions& = ImageIOOptions());
+
+            //! Request an image to be read on a worker thread, and call a
+            //! function with it when the read finishes or is cancelled. The
+            //! function is called on the worker thread, or on the thread
+            //! that cancels the request; use App::post() to hand the image
+            //! to the main thread.
+            FTK_API ImageRequest readAsync(
+                const std::filesystem::path&,
+                const std::function<void(const std::shared_ptr<Image>&)>&,
+                const ImageIOOptions& = ImageIOOptions());
+
+            //! Cancel async requests. The futures of requests that have not
+            //! started carry a null image; requests already being read are
+            //! finished.
+            FTK_API void cancelRequests(const std::vector<uint64_t>&);
+
+            //! Request an image to be written on a worker thread. The future
+            //! is false when the file cannot be written, and the error is
+            //! logged. Writes are not cancelled; those still waiting when the
+            //! system is destroyed are finished first.
+            FTK_API std::future<bool> writeAsync(
+                const std::filesystem::path&,
+                const std::shared_ptr<Image>&,
+                const ImageIOOptions& = ImageIOOptions());
+
+            //! Get the number of worker threads for async requests.
+            FTK_API size_t getThreadCount() const;
+
+            //! Set the number of worker threads for async requests. Zero
+            //! uses the number of hardware threads. The workers are started
+            //! with the first request.
+            FTK_API void setThreadCount(size_t);
+
             //! Get an image writer.
             FTK_API std::shared_ptr<IImageWriter> write(
                 const std::filesystem::path&,
@@ -139,7 +221,10 @@ namespace ftk
                 const ImageIOOptions& = ImageIOOptions());
 
         private:
-            std::list<std::shared_ptr<IImagePlugin> > _plugins;
+            void _startThreads();
+            void _stopThreads();
+
+            FTK_PRIVATE();
         };
         
         ///@}
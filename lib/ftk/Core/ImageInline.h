@@ -77,6 +77,18 @@ namespace ftk
         return !(*this == other);
     }
 
+    inline bool ImagePoolOptions::operator == (const ImagePoolOptions& other) const
+    {
+        return
+            maxByteCount == other.maxByteCount &&
+            hugePages == other.hugePages;
+    }
+
+    inline bool ImagePoolOptions::operator != (const ImagePoolOptions& other) const
+    {
+        return !(*this == other);
+    }
+
     inline const ImageInfo& Image::getInfo() const
     {
         return _info;
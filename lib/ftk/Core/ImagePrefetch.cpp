@@ -0,0 +1,245 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/ImagePrefetch.h>
+
+#include <ftk/Core/Context.h>
+#include <ftk/Core/Math.h>
+
+#include <map>
+
+namespace ftk
+{
+    struct ImagePrefetch::Private
+    {
+        std::weak_ptr<ImageIO> io;
+        Path path;
+        ImageIOOptions ioOptions;
+        RangeI64 range;
+        ImagePrefetchOptions options;
+        int64_t frame = 0;
+
+        struct Entry
+        {
+            ImageRequest request;
+            std::shared_ptr<Image> image;
+        };
+        std::map<int64_t, Entry> entries;
+
+        bool hasFrame(int64_t) const;
+        std::filesystem::path getFileName(int64_t) const;
+        void collect(Entry&);
+    };
+
+    bool ImagePrefetch::Private::hasFrame(int64_t value) const
+    {
+        bool out = false;
+        const auto& seq = path.getSeq();
+        if (seq.empty())
+        {
+            out = contains(range, value);
+        }
+        else
+        {
+            // Partial sequences are missing frames within the range.
+            for (const auto& i : seq)
+            {
+                if (contains(i.range, value) && 0 == (value - i.range.min()) % i.inc)
+                {
+                    out = true;
+                    break;
+                }
+            }
+        }
+        return out;
+    }
+
+    std::filesystem::path ImagePrefetch::Private::getFileName(int64_t value) const
+    {
+        return std::filesystem::u8path(path.hasNum() ?
+            path.getFrame(value, true) :
+            path.get());
+    }
+
+    void ImagePrefetch::Private::collect(Entry& entry)
+    {
+        if (entry.request.future.valid() &&
+            entry.request.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            entry.image = entry.request.future.get();
+        }
+    }
+
+    void ImagePrefetch::_init(
+        const std::shared_ptr<Context>& context,
+        const Path& path,
+        const ImageIOOptions& ioOptions)
+    {
+        FTK_P();
+        p.io = context->getSystem<ImageIO>();
+        p.path = path;
+        p.ioOptions = ioOptions;
+        p.range = path.hasNum() && path.getFrames().has_value() ?
+            path.getFrames().value() :
+            RangeI64(0, 0);
+        p.frame = p.range.min();
+        _update();
+    }
+
+    ImagePrefetch::ImagePrefetch() :
+        _p(new Private)
+    {}
+
+    ImagePrefetch::~ImagePrefetch()
+    {
+        FTK_P();
+        std::vector<uint64_t> ids;
+        for (const auto& i : p.entries)
+        {
+            if (i.second.request.future.valid())
+            {
+                ids.push_back(i.second.request.id);
+            }
+        }
+        if (auto io = p.io.lock())
+        {
+            io->cancelRequests(ids);
+        }
+    }
+
+    std::shared_ptr<ImagePrefetch> ImagePrefetch::create(
+        const std::shared_ptr<Context>& context,
+        const Path& path,
+        const ImageIOOptions& ioOptions)
+    {
+        auto out = std::shared_ptr<ImagePrefetch>(new ImagePrefetch);
+        out->_init(context, path, ioOptions);
+        return out;
+    }
+
+    const Path& ImagePrefetch::getPath() const
+    {
+        return _p->path;
+    }
+
+    const RangeI64& ImagePrefetch::getRange() const
+    {
+        return _p->range;
+    }
+
+    const ImagePrefetchOptions& ImagePrefetch::getOptions() const
+    {
+        return _p->options;
+    }
+
+    void ImagePrefetch::setOptions(const ImagePrefetchOptions& value)
+    {
+        FTK_P();
+        if (value == p.options)
+            return;
+        p.options = value;
+        _update();
+    }
+
+    int64_t ImagePrefetch::getFrame() const
+    {
+        return _p->frame;
+    }
+
+    void ImagePrefetch::setFrame(int64_t value)
+    {
+        FTK_P();
+        const int64_t tmp = clamp(value, p.range.min(), p.range.max());
+        if (tmp == p.frame)
+            return;
+        p.frame = tmp;
+        _update();
+    }
+
+    std::shared_ptr<Image> ImagePrefetch::getImage(int64_t value)
+    {
+        FTK_P();
+        std::shared_ptr<Image> out;
+        const auto i = p.entries.find(value);
+        if (i != p.entries.end())
+        {
+            p.collect(i->second);
+            out = i->second.image;
+        }
+        return out;
+    }
+
+    std::vector<int64_t> ImagePrefetch::getCachedFrames()
+    {
+        FTK_P();
+        std::vector<int64_t> out;
+        for (auto& i : p.entries)
+        {
+            p.collect(i.second);
+            if (i.second.image)
+            {
+                out.push_back(i.first);
+            }
+        }
+        return out;
+    }
+
+    void ImagePrefetch::_update()
+    {
+        FTK_P();
+        auto io = p.io.lock();
+        if (!io)
+            return;
+        const RangeI64 window(
+            std::max(p.frame - std::max(p.options.behind, int64_t(0)), p.range.min()),
+            std::min(p.frame + std::max(p.options.ahead, int64_t(0)), p.range.max()));
+
+        // Cancel the frames that left the window.
+        std::vector<uint64_t> cancel;
+        auto i = p.entries.begin();
+        while (i != p.entries.end())
+        {
+            if (!contains(window, i->first))
+            {
+                if (i->second.request.future.valid())
+                {
+                    cancel.push_back(i->second.request.id);
+                }
+                i = p.entries.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        if (!cancel.empty())
+        {
+            io->cancelRequests(cancel);
+        }
+
+        // Request the frames in the window nearest first, the frame ahead
+        // before the frame behind at the same distance.
+        std::vector<int64_t> frames;
+        const int64_t distance = std::max(window.max() - p.frame, p.frame - window.min());
+        for (int64_t i = 0; i <= distance; ++i)
+        {
+            if (p.frame + i <= window.max())
+            {
+                frames.push_back(p.frame + i);
+            }
+            if (i > 0 && p.frame - i >= window.min())
+            {
+                frames.push_back(p.frame - i);
+            }
+        }
+        for (const int64_t frame : frames)
+        {
+            if (p.hasFrame(frame) && p.entries.find(frame) == p.entries.end())
+            {
+                Private::Entry entry;
+                entry.request = io->readAsync(p.getFileName(frame), p.ioOptions);
+                p.entries[frame] = std::move(entry);
+            }
+        }
+    }
+}
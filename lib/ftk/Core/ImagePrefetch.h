@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/ImageIO.h>
+#include <ftk/Core/Path.h>
+
+namespace ftk
+{
+    class Context;
+
+    //! \name Image I/O
+    ///@{
+
+    //! Image prefetch options.
+    struct FTK_API_TYPE ImagePrefetchOptions
+    {
+        //! Number of frames to read ahead of the current frame.
+        int64_t ahead = 8;
+
+        //! Number of frames to keep behind the current frame.
+        int64_t behind = 2;
+
+        bool operator == (const ImagePrefetchOptions&) const;
+        bool operator != (const ImagePrefetchOptions&) const;
+    };
+
+    //! Read ahead along an image sequence.
+    //!
+    //! The frames in a window around the current frame are requested from
+    //! ImageIO::readAsync(), nearest first. When the current frame changes,
+    //! requests for frames that left the window are cancelled and their
+    //! images released. Each finished read wakes the application's event
+    //! loop, so a frame can be checked for again without a timer.
+    class FTK_API_TYPE ImagePrefetch : public std::enable_shared_from_this<ImagePrefetch>
+    {
+        FTK_NON_COPYABLE(ImagePrefetch);
+
+    protected:
+        void _init(
+            const std::shared_ptr<Context>&,
+            const Path&,
+            const ImageIOOptions&);
+
+        ImagePrefetch();
+
+    public:
+        FTK_API ~ImagePrefetch();
+
+        //! Create a new prefetch.
+        FTK_API static std::shared_ptr<ImagePrefetch> create(
+            const std::shared_ptr<Context>&,
+            const Path&,
+            const ImageIOOptions& = ImageIOOptions());
+
+        //! Get the path.
+        FTK_API const Path& getPath() const;
+
+        //! Get the frame range. A path without a frame number is a single
+        //! frame, zero.
+        FTK_API const RangeI64& getRange() const;
+
+        //! Get the options.
+        FTK_API const ImagePrefetchOptions& getOptions() const;
+
+        //! Set the options.
+        FTK_API void setOptions(const ImagePrefetchOptions&);
+
+        //! Get the current frame.
+        FTK_API int64_t getFrame() const;
+
+        //! Set the current frame. The frame is clamped to the range.
+        FTK_API void setFrame(int64_t);
+
+        //! Get the image for a frame, or null if it has not been read yet.
+        //! This does not wait; frames outside of the window are not read.
+        FTK_API std::shared_ptr<Image> getImage(int64_t);
+
+        //! Get the frames that have been read.
+        FTK_API std::vector<int64_t> getCachedFrames();
+
+    private:
+        void _update();
+
+        FTK_PRIVATE();
+    };
+
+    ///@}
+}
+
+#include <ftk/Core/ImagePrefetchInline.h>
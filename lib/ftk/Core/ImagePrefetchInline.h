@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+namespace ftk
+{
+    inline bool ImagePrefetchOptions::operator == (const ImagePrefetchOptions& other) const
+    {
+        return
+            ahead == other.ahead &&
+            behind == other.behind;
+    }
+
+    inline bool ImagePrefetchOptions::operator != (const ImagePrefetchOptions& other) const
+    {
+        return !(*this == other);
+    }
+}
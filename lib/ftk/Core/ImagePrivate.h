@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/Image.h>
+
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace ftk
+{
+    //! How the samples of an image are stored.
+    enum class ImageData
+    {
+        U8,
+        U10, //!< Three samples packed in 32 bits
+        U16,
+        U32,
+        F16,
+        F32
+    };
+
+    //! Get how the samples of an image type are stored.
+    ImageData getImageData(ImageType);
+
+    //! Get the number of bytes in a sample. U10 samples are stored three
+    //! to a four byte word.
+    size_t getSampleByteCount(ImageData);
+
+    //! A plane of image data: rows of pixels, the channels interleaved.
+    struct ImagePlane
+    {
+        size_t offset = 0;
+        Size2I size;
+        int channels = 0;
+        size_t pixelByteCount = 0;
+        size_t rowByteCount = 0;
+    };
+
+    //! A block of image memory.
+    struct ImageBlock
+    {
+        uint8_t* data = nullptr;
+        size_t byteCount = 0;
+        bool mapped = false;
+    };
+
+    //! Blocks of at least this size are mapped from the system a page at a
+    //! time rather than taken from the heap.
+    const size_t imageBlockMapByteCount = 2 * megabyte;
+
+    //! Allocate a block of image memory, aligned to 64 bytes, or to pages
+    //! for a mapped block. Throws an exception if the memory cannot be
+    //! allocated.
+    ImageBlock allocImageBlock(size_t byteCount, bool hugePages);
+
+    //! Free a block of image memory.
+    void freeImageBlock(const ImageBlock&);
+
+    //! Get the planes of an image. Interleaved types have one, planar YUV
+    //! types three (Y, Cb, Cr), and semi-planar YUV types two (Y, CbCr).
+    std::vector<ImagePlane> getImagePlanes(const ImageInfo&);
+
+    float halfToFloat(uint16_t);
+    uint16_t floatToHalf(float);
+
+    inline uint16_t readU16(const uint8_t* p, bool swap)
+    {
+        uint16_t out = 0;
+        memcpy(&out, p, sizeof(uint16_t));
+        return swap ? static_cast<uint16_t>((out >> 8) | (out << 8)) : out;
+    }
+
+    inline uint32_t readU32(const uint8_t* p, bool swap)
+    {
+        uint32_t out = 0;
+        memcpy(&out, p, sizeof(uint32_t));
+        if (swap)
+        {
+            out =
+                ((out >> 24) & 0xff) |
+                ((out >> 8) & 0xff00) |
+                ((out << 8) & 0xff0000) |
+                ((out << 24) & 0xff000000);
+        }
+        return out;
+    }
+
+    //! Read a sample, integer types normalized to 0-1.
+    inline float readSample(const uint8_t* p, ImageData data, bool swap)
+    {
+        float out = 0.F;
+        switch (data)
+        {
+        case ImageData::U8: out = *p / 255.F; break;
+        case ImageData::U16: out = readU16(p, swap) / 65535.F; break;
+        case ImageData::U32: out = static_cast<float>(readU32(p, swap) / 4294967295.0); break;
+        case ImageData::F16: out = halfToFloat(readU16(p, swap)); break;
+        case ImageData::F32:
+        {
+            const uint32_t bits = readU32(p, swap);
+            memcpy(&out, &bits, sizeof(float));
+            break;
+        }
+        default: break;
+        }
+        return out;
+    }
+
+    //! Read a run of samples, integer types normalized to 0-1. U10 counts
+    //! are in samples, three to a pixel.
+    void readSamples(
+        const uint8_t*,
+        ImageData,
+        bool swap,
+        size_t count,
+        float*);
+
+    //! Write a run of samples, integer types clamped and rounded.
+    void writeSamples(
+        const float*,
+        size_t count,
+        ImageData,
+        bool swap,
+        uint8_t*);
+
+    //! Expand a legal range luma or color sample to full range.
+    inline float legalRange(float value)
+    {
+        return (value - (16.F / 255.F)) * (255.F / (235.F - 16.F));
+    }
+
+    //! Expand a legal range chroma sample to full range.
+    inline float legalRangeChroma(float value)
+    {
+        return (value - (16.F / 255.F)) * (255.F / (240.F - 16.F));
+    }
+
+    //! Read rows of a YUV image as full range RGBA, the chroma filtered
+    //! linearly as a texture would be. The first row is written to the
+    //! start of the output.
+    void readYUVRows(
+        const Image&,
+        VideoLevels,
+        int y0,
+        int y1,
+        float*);
+
+    //! Call the function with each job index, shared out over the threads,
+    //! returning when every call has. The threads are kept for the life of
+    //! the process and shared by every caller, with the calling thread
+    //! taking its share. Zero threads uses one for each core.
+    void runImageJobs(
+        size_t count,
+        size_t threads,
+        const std::function<void(size_t)>&);
+}
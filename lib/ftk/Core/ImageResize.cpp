@@ -0,0 +1,353 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/ImageResize.h>
+
+#include <ftk/Core/Error.h>
+#include <ftk/Core/ImagePrivate.h>
+#include <ftk/Core/Math.h>
+#include <ftk/Core/String.h>
+
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <mutex>
+#include <sstream>
+
+namespace ftk
+{
+    FTK_ENUM_IMPL(
+        ResizeFilter,
+        "Box",
+        "Mitchell",
+        "Lanczos3");
+
+    namespace
+    {
+        // The kernels are the ones the OpenGL renderer scales with, so an
+        // image resized here looks like one drawn scaled.
+        const float boxSupport = .5F;
+
+        float box(float x)
+        {
+            return std::fabs(x) <= boxSupport ? 1.F : 0.F;
+        }
+
+        const float mitchellSupport = 2.F;
+
+        float mitchell(float x)
+        {
+            const float b = 1.F / 3.F;
+            const float c = 1.F / 3.F;
+            x = std::fabs(x);
+            const float x2 = x * x;
+            const float x3 = x2 * x;
+            if (x < 1.F)
+            {
+                return (
+                    (12.F - 9.F * b - 6.F * c) * x3 +
+                    (-18.F + 12.F * b + 6.F * c) * x2 +
+                    (6.F - 2.F * b)) / 6.F;
+            }
+            if (x < mitchellSupport)
+            {
+                return (
+                    (-b - 6.F * c) * x3 +
+                    (6.F * b + 30.F * c) * x2 +
+                    (-12.F * b - 48.F * c) * x +
+                    (8.F * b + 24.F * c)) / 6.F;
+            }
+            return 0.F;
+        }
+
+        const float lanczos3Support = 3.F;
+
+        float lanczos3(float x)
+        {
+            x = std::fabs(x);
+            if (x < 0.0001F)
+                return 1.F;
+            if (x >= lanczos3Support)
+                return 0.F;
+            const float pix = pi * x;
+            return
+                (std::sin(pix) / pix) *
+                (std::sin(pix / lanczos3Support) / (pix / lanczos3Support));
+        }
+
+        // For each output pixel along an axis, the input pixels it is made
+        // from and their weights, the same number of taps for each.
+        struct Contrib
+        {
+            int in = 0;
+            int out = 0;
+            ResizeFilter filter = ResizeFilter::Box;
+            int taps = 0;
+            std::vector<int> index;
+            std::vector<float> weight;
+        };
+
+        std::shared_ptr<Contrib> createContrib(int in, int out, ResizeFilter filter)
+        {
+            auto contrib = std::make_shared<Contrib>();
+            contrib->in = in;
+            contrib->out = out;
+            contrib->filter = filter;
+
+            float (*fnc)(float) = box;
+            float support = boxSupport;
+            switch (filter)
+            {
+            case ResizeFilter::Mitchell:
+                fnc = mitchell;
+                support = mitchellSupport;
+                break;
+            case ResizeFilter::Lanczos3:
+                fnc = lanczos3;
+                support = lanczos3Support;
+                break;
+            default: break;
+            }
+            const float scale = out / static_cast<float>(in);
+            const bool reducing = scale < 1.F;
+            const float radius = reducing ? support / scale : support;
+            const int taps = static_cast<int>(std::ceil(radius * 2.F + 1.F));
+            contrib->taps = taps;
+            contrib->index.resize(static_cast<size_t>(out) * taps);
+            contrib->weight.resize(static_cast<size_t>(out) * taps);
+            for (int i = 0; i < out; ++i)
+            {
+                int* index = contrib->index.data() + static_cast<size_t>(i) * taps;
+                float* weight = contrib->weight.data() + static_cast<size_t>(i) * taps;
+                const float center = (i + .5F) / scale - .5F;
+                const int left = static_cast<int>(std::ceil(center - radius));
+                float sum = 0.F;
+                for (int j = 0; j < taps; ++j)
+                {
+                    // Outside the image the edge pixel is repeated, so the
+                    // weights of a pixel on the border still cover it.
+                    const int k = left + j;
+                    index[j] = std::clamp(k, 0, in - 1);
+                    const float x = (center - k) * (reducing ? scale : 1.F);
+                    weight[j] = fnc(x);
+                    sum += weight[j];
+                }
+
+                // The taps are a finite sample of the kernel at whatever
+                // phase the pixel lands on, so their sum drifts; dividing
+                // by it keeps a flat area flat.
+                if (sum > 0.F)
+                {
+                    for (int j = 0; j < taps; ++j)
+                    {
+                        weight[j] /= sum;
+                    }
+                }
+                else
+                {
+                    weight[0] = 1.F;
+                }
+            }
+            return contrib;
+        }
+
+        // Thumbnails of a directory ask for the same few sizes over and
+        // over, so the tables are kept.
+        const size_t contribCacheMax = 16;
+
+        std::shared_ptr<const Contrib> getContrib(int in, int out, ResizeFilter filter)
+        {
+            static std::mutex mutex;
+            static std::list<std::shared_ptr<Contrib> > cache;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                for (auto i = cache.begin(); i != cache.end(); ++i)
+                {
+                    if ((*i)->in == in && (*i)->out == out && (*i)->filter == filter)
+                    {
+                        cache.splice(cache.begin(), cache, i);
+                        return cache.front();
+                    }
+                }
+            }
+            auto contrib = createContrib(in, out, filter);
+            std::unique_lock<std::mutex> lock(mutex);
+            cache.push_front(contrib);
+            while (cache.size() > contribCacheMax)
+            {
+                cache.pop_back();
+            }
+            return contrib;
+        }
+
+        // Filter a row across. The channels are a template parameter so the
+        // inner loop is unrolled and the taps are summed for all of them
+        // together.
+        template<int C>
+        void filterRow(
+            const float* in,
+            const Contrib& contrib,
+            float* out)
+        {
+            const int taps = contrib.taps;
+            const int* index = contrib.index.data();
+            const float* weight = contrib.weight.data();
+            for (int x = 0; x < contrib.out; ++x, index += taps, weight += taps, out += C)
+            {
+                float sum[C] = {};
+                for (int j = 0; j < taps; ++j)
+                {
+                    const float* p = in + index[j] * C;
+                    for (int c = 0; c < C; ++c)
+                    {
+                        sum[c] += p[c] * weight[j];
+                    }
+                }
+                for (int c = 0; c < C; ++c)
+                {
+                    out[c] = sum[c];
+                }
+            }
+        }
+
+        void filterRow(
+            int channels,
+            const float* in,
+            const Contrib& contrib,
+            float* out)
+        {
+            switch (channels)
+            {
+            case 1: filterRow<1>(in, contrib, out); break;
+            case 2: filterRow<2>(in, contrib, out); break;
+            case 3: filterRow<3>(in, contrib, out); break;
+            case 4: filterRow<4>(in, contrib, out); break;
+            default: break;
+            }
+        }
+
+        // Rows handled by one job.
+        const size_t jobRows = 16;
+
+        // Below this many output samples the threads cost more than they
+        // save.
+        const size_t threadSamples = 256 * 256;
+
+        void resizePlane(
+            const uint8_t* inData,
+            const ImagePlane& inPlane,
+            uint8_t* outData,
+            const ImagePlane& outPlane,
+            ImageData data,
+            bool swap,
+            const ResizeOptions& options,
+            size_t threads)
+        {
+            const Size2I& inSize = inPlane.size;
+            const Size2I& outSize = outPlane.size;
+            const int channels = inPlane.channels;
+            auto contribX = getContrib(
+                inSize.w,
+                outSize.w,
+                outSize.w < inSize.w ? options.reduce : options.enlarge);
+            auto contribY = getContrib(
+                inSize.h,
+                outSize.h,
+                outSize.h < inSize.h ? options.reduce : options.enlarge);
+
+            // Across first, into rows of the output width; then down.
+            const size_t inRowSamples = static_cast<size_t>(inSize.w) * channels;
+            const size_t outRowSamples = static_cast<size_t>(outSize.w) * channels;
+            std::vector<float> across(outRowSamples * inSize.h);
+            if (static_cast<size_t>(outSize.w) * inSize.h * channels < threadSamples)
+            {
+                threads = 1;
+            }
+            runImageJobs(
+                (inSize.h + jobRows - 1) / jobRows,
+                threads,
+                [&](size_t job)
+                {
+                    std::vector<float> row(inRowSamples);
+                    const int y1 = std::min(static_cast<int>((job + 1) * jobRows), inSize.h);
+                    for (int y = static_cast<int>(job * jobRows); y < y1; ++y)
+                    {
+                        readSamples(
+                            inData + inPlane.offset + y * inPlane.rowByteCount,
+                            data,
+                            swap,
+                            inRowSamples,
+                            row.data());
+                        filterRow(
+                            channels,
+                            row.data(),
+                            *contribX,
+                            across.data() + y * outRowSamples);
+                    }
+                });
+            runImageJobs(
+                (outSize.h + jobRows - 1) / jobRows,
+                threads,
+                [&](size_t job)
+                {
+                    std::vector<float> row(outRowSamples);
+                    const int taps = contribY->taps;
+                    const int y1 = std::min(static_cast<int>((job + 1) * jobRows), outSize.h);
+                    for (int y = static_cast<int>(job * jobRows); y < y1; ++y)
+                    {
+                        const int* index = contribY->index.data() + y * taps;
+                        const float* weight = contribY->weight.data() + y * taps;
+                        std::fill(row.begin(), row.end(), 0.F);
+                        float* r = row.data();
+                        for (int j = 0; j < taps; ++j)
+                        {
+                            const float* p = across.data() + index[j] * outRowSamples;
+                            const float w = weight[j];
+                            for (size_t i = 0; i < outRowSamples; ++i)
+                            {
+                                r[i] += p[i] * w;
+                            }
+                        }
+                        writeSamples(
+                            row.data(),
+                            outRowSamples,
+                            data,
+                            swap,
+                            outData + outPlane.offset + y * outPlane.rowByteCount);
+                    }
+                });
+        }
+    }
+
+    std::shared_ptr<Image> resize(
+        const std::shared_ptr<Image>& image,
+        const Size2I& size,
+        const ResizeOptions& options)
+    {
+        if (!image || !image->isValid() || !size.isValid())
+            return nullptr;
+
+        ImageInfo info = image->getInfo();
+        info.size = size;
+        auto out = Image::create(info);
+        out->setTags(image->getTags());
+
+        const ImageData data = getImageData(info.type);
+        const bool swap = info.layout.endian != getEndian() && getSampleByteCount(data) > 1;
+        const auto inPlanes = getImagePlanes(image->getInfo());
+        const auto outPlanes = getImagePlanes(info);
+        for (size_t i = 0; i < inPlanes.size() && i < outPlanes.size(); ++i)
+        {
+            resizePlane(
+                image->getData(),
+                inPlanes[i],
+                out->getData(),
+                outPlanes[i],
+                data,
+                swap,
+                options,
+                options.threads);
+        }
+        return out;
+    }
+}
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/Image.h>
+
+namespace ftk
+{
+    //! \name Images
+    ///@{
+
+    //! Image resize filters.
+    enum class FTK_API_TYPE ResizeFilter
+    {
+        Box,      //!< Averages the pixels under the output pixel
+        Mitchell, //!< Mitchell-Netravali cubic, soft without ringing
+        Lanczos3, //!< Lanczos windowed at three lobes, sharp with some ringing
+
+        Count,
+        First = Box
+    };
+    FTK_ENUM(ResizeFilter);
+
+    //! Image resize options.
+    struct FTK_API_TYPE ResizeOptions
+    {
+        //! The filter for an axis that is reduced.
+        ResizeFilter reduce = ResizeFilter::Lanczos3;
+
+        //! The filter for an axis that is enlarged.
+        ResizeFilter enlarge = ResizeFilter::Mitchell;
+
+        //! The maximum number of threads, or zero for one for each core.
+        size_t threads = 0;
+
+        bool operator == (const ResizeOptions&) const;
+        bool operator != (const ResizeOptions&) const;
+    };
+
+    //! Resize an image.
+    //!
+    //! The result has the same type, layout, and video levels. Each plane is
+    //! filtered separately, across then down, in floating point; planar and
+    //! semi-planar YUV chroma is resized with its plane, so it stays
+    //! subsampled. Integer types are clamped, floating point types are not.
+    //! Returns null if the image or the size is not valid.
+    FTK_API std::shared_ptr<Image> resize(
+        const std::shared_ptr<Image>&,
+        const Size2I&,
+        const ResizeOptions& = ResizeOptions());
+
+    ///@}
+}
+
+#include <ftk/Core/ImageResizeInline.h>
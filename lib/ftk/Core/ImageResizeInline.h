@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+namespace ftk
+{
+    inline bool ResizeOptions::operator == (const ResizeOptions& other) const
+    {
+        return
+            reduce == other.reduce &&
+            enlarge == other.enlarge &&
+            threads == other.threads;
+    }
+
+    inline bool ResizeOptions::operator != (const ResizeOptions& other) const
+    {
+        return !(*this == other);
+    }
+}
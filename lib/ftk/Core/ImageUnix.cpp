@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/ImagePrivate.h>
+
+#include <ftk/Core/Format.h>
+
+#include <cstdlib>
+#include <stdexcept>
+
+#include <sys/mman.h>
+
+namespace ftk
+{
+    ImageBlock allocImageBlock(size_t byteCount, bool hugePages)
+    {
+        ImageBlock out;
+        out.byteCount = byteCount;
+        if (byteCount >= imageBlockMapByteCount)
+        {
+            void* p = mmap(
+                nullptr,
+                byteCount,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS,
+                -1,
+                0);
+            if (MAP_FAILED == p)
+            {
+                throw std::runtime_error(Format("Cannot allocate image memory: {0} bytes").
+                    arg(byteCount));
+            }
+#if defined(MADV_HUGEPAGE)
+            // Transparent huge pages; the kernel uses them where it can
+            // and falls back to normal pages where it cannot.
+            if (hugePages)
+            {
+                madvise(p, byteCount, MADV_HUGEPAGE);
+            }
+#endif // MADV_HUGEPAGE
+            out.data = static_cast<uint8_t*>(p);
+            out.mapped = true;
+        }
+        else
+        {
+            void* p = nullptr;
+            if (posix_memalign(&p, 64, byteCount) != 0)
+            {
+                throw std::runtime_error(Format("Cannot allocate image memory: {0} bytes").
+                    arg(byteCount));
+            }
+            out.data = static_cast<uint8_t*>(p);
+        }
+        return out;
+    }
+
+    void freeImageBlock(const ImageBlock& block)
+    {
+        if (block.mapped)
+        {
+            munmap(block.data, block.byteCount);
+        }
+        else
+        {
+            free(block.data);
+        }
+    }
+}
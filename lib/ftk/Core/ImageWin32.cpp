@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/ImagePrivate.h>
+
+#include <ftk/Core/Format.h>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // WIN32_LEAN_AND_MEAN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include <windows.h>
+#include <malloc.h>
+
+#include <stdexcept>
+
+namespace ftk
+{
+    ImageBlock allocImageBlock(size_t byteCount, bool hugePages)
+    {
+        ImageBlock out;
+        out.byteCount = byteCount;
+        if (byteCount >= imageBlockMapByteCount)
+        {
+            void* p = nullptr;
+
+            // Large pages need the "Lock pages in memory" privilege and a
+            // multiple of the large page size; without them the allocation
+            // fails and normal pages are used.
+            const size_t largePage = hugePages ? GetLargePageMinimum() : 0;
+            if (largePage > 0 && 0 == byteCount % largePage)
+            {
+                p = VirtualAlloc(
+                    nullptr,
+                    byteCount,
+                    MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                    PAGE_READWRITE);
+            }
+            if (!p)
+            {
+                p = VirtualAlloc(
+                    nullptr,
+                    byteCount,
+                    MEM_RESERVE | MEM_COMMIT,
+                    PAGE_READWRITE);
+            }
+            if (!p)
+            {
+                throw std::runtime_error(Format("Cannot allocate image memory: {0} bytes").
+                    arg(byteCount));
+            }
+            out.data = static_cast<uint8_t*>(p);
+            out.mapped = true;
+        }
+        else
+        {
+            void* p = _aligned_malloc(byteCount, 64);
+            if (!p)
+            {
+                throw std::runtime_error(Format("Cannot allocate image memory: {0} bytes").
+                    arg(byteCount));
+            }
+            out.data = static_cast<uint8_t*>(p);
+        }
+        return out;
+    }
+
+    void freeImageBlock(const ImageBlock& block)
+    {
+        if (block.mapped)
+        {
+            VirtualFree(block.data, 0, MEM_RELEASE);
+        }
+        else
+        {
+            _aligned_free(block.data);
+        }
+    }
+}
@@ -5,29 +5,223 @@
 
 #include <ftk/Core/Math.h>
 
+#include <unordered_map>
+
 namespace ftk
 {
-    Box3F bbox(const TriMesh3F& mesh)
+    namespace
+    {
+        // Merging vertices: the key is the triangle mesh's indices for a
+        // vertex, so vertices are only merged when the mesh already shares
+        // them, which keeps this exact and cheap.
+        struct VertexKey
+        {
+            std::array<size_t, 4> i = { 0, 0, 0, 0 };
+
+            bool operator == (const VertexKey& other) const
+            {
+                return i == other.i;
+            }
+        };
+
+        struct VertexKeyHash
+        {
+            size_t operator () (const VertexKey& key) const
+            {
+                size_t out = 0;
+                for (size_t i : key.i)
+                {
+                    out ^= std::hash<size_t>()(i) + 0x9e3779b9 + (out << 6) + (out >> 2);
+                }
+                return out;
+            }
+        };
+
+        template<typename T>
+        void copyAttribute(
+            const std::vector<T>& in,
+            size_t index,
+            const T& defaultValue,
+            std::vector<T>& out)
+        {
+            out.push_back(index && index <= in.size() ? in[index - 1] : defaultValue);
+        }
+    }
+
+    IdxMesh2F indexed(const TriMesh2F& mesh)
+    {
+        IdxMesh2F out;
+        const bool hasC = !mesh.c.empty();
+        const bool hasT = !mesh.t.empty();
+        std::unordered_map<VertexKey, uint32_t, VertexKeyHash> keys;
+        keys.reserve(mesh.v.size());
+        out.indices.reserve(mesh.triangles.size() * 3);
+        for (const auto& triangle : mesh.triangles)
+        {
+            for (const auto& vertex : triangle.v)
+            {
+                VertexKey key;
+                key.i[0] = vertex.v;
+                key.i[1] = hasC ? vertex.c : 0;
+                key.i[2] = hasT ? vertex.t : 0;
+                const auto i = keys.find(key);
+                if (i != keys.end())
+                {
+                    out.indices.push_back(i->second);
+                }
+                else
+                {
+                    const uint32_t index = static_cast<uint32_t>(out.v.size());
+                    keys[key] = index;
+                    out.indices.push_back(index);
+                    copyAttribute(mesh.v, vertex.v, V2F(), out.v);
+                    if (hasC)
+                    {
+                        copyAttribute(mesh.c, vertex.c, V4F(1.F, 1.F, 1.F, 1.F), out.c);
+                    }
+                    if (hasT)
+                    {
+                        copyAttribute(mesh.t, vertex.t, V2F(), out.t);
+                    }
+                }
+            }
+        }
+        return out;
+    }
+
+    IdxMesh3F indexed(const TriMesh3F& mesh)
+    {
+        IdxMesh3F out;
+        const bool hasC = !mesh.c.empty();
+        const bool hasT = !mesh.t.empty();
+        const bool hasN = !mesh.n.empty();
+        std::unordered_map<VertexKey, uint32_t, VertexKeyHash> keys;
+        keys.reserve(mesh.v.size());
+        out.indices.reserve(mesh.triangles.size() * 3);
+        for (const auto& triangle : mesh.triangles)
+        {
+            for (const auto& vertex : triangle.v)
+            {
+                VertexKey key;
+                key.i[0] = vertex.v;
+                key.i[1] = hasC ? vertex.c : 0;
+                key.i[2] = hasT ? vertex.t : 0;
+                key.i[3] = hasN ? vertex.n : 0;
+                const auto i = keys.find(key);
+                if (i != keys.end())
+                {
+                    out.indices.push_back(i->second);
+                }
+                else
+                {
+                    const uint32_t index = static_cast<uint32_t>(out.v.size());
+                    keys[key] = index;
+                    out.indices.push_back(index);
+                    copyAttribute(mesh.v, vertex.v, V3F(), out.v);
+                    if (hasC)
+                    {
+                        copyAttribute(mesh.c, vertex.c, V4F(1.F, 1.F, 1.F, 1.F), out.c);
+                    }
+                    if (hasT)
+                    {
+                        copyAttribute(mesh.t, vertex.t, V2F(), out.t);
+                    }
+                    if (hasN)
+                    {
+                        copyAttribute(mesh.n, vertex.n, V3F(), out.n);
+                    }
+                }
+            }
+        }
+        return out;
+    }
+
+    TriMesh2F unindexed(const IdxMesh2F& mesh)
+    {
+        TriMesh2F out;
+        out.v = mesh.v;
+        out.c = mesh.c;
+        out.t = mesh.t;
+        const size_t cSize = mesh.c.size();
+        const size_t tSize = mesh.t.size();
+        const size_t size = mesh.indices.size() / 3;
+        out.triangles.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            Triangle2 triangle;
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const size_t index = mesh.indices[i * 3 + k];
+                triangle.v[k].v = index + 1;
+                triangle.v[k].c = index < cSize ? (index + 1) : 0;
+                triangle.v[k].t = index < tSize ? (index + 1) : 0;
+            }
+            out.triangles.push_back(triangle);
+        }
+        return out;
+    }
+
+    TriMesh3F unindexed(const IdxMesh3F& mesh)
     {
-        Box3F out;
-        const size_t size = mesh.v.size();
-        if (size > 0)
+        TriMesh3F out;
+        out.v = mesh.v;
+        out.c = mesh.c;
+        out.t = mesh.t;
+        out.n = mesh.n;
+        const size_t cSize = mesh.c.size();
+        const size_t tSize = mesh.t.size();
+        const size_t nSize = mesh.n.size();
+        const size_t size = mesh.indices.size() / 3;
+        out.triangles.reserve(size);
+        for (size_t i = 0; i < size; ++i)
         {
-            out.min = out.max = mesh.v.front();
-            for (size_t i = 1; i < size; ++i)
+            Triangle3 triangle;
+            for (size_t k = 0; k < 3; ++k)
             {
-                const V3F& v = mesh.v[i];
-                out.min.x = std::min(out.min.x, v.x);
-                out.min.y = std::min(out.min.y, v.y);
-                out.min.z = std::min(out.min.z, v.z);
-                out.max.x = std::max(out.max.x, v.x);
-                out.max.y = std::max(out.max.y, v.y);
-                out.max.z = std::max(out.max.z, v.z);
+                const size_t index = mesh.indices[i * 3 + k];
+                triangle.v[k].v = index + 1;
+                triangle.v[k].c = index < cSize ? (index + 1) : 0;
+                triangle.v[k].t = index < tSize ? (index + 1) : 0;
+                triangle.v[k].n = index < nSize ? (index + 1) : 0;
             }
+            out.triangles.push_back(triangle);
         }
         return out;
     }
 
+    namespace
+    {
+        Box3F bbox(const std::vector<V3F>& v)
+        {
+            Box3F out;
+            const size_t size = v.size();
+            if (size > 0)
+            {
+                out.min = out.max = v.front();
+                for (size_t i = 1; i < size; ++i)
+                {
+                    out.min.x = std::min(out.min.x, v[i].x);
+                    out.min.y = std::min(out.min.y, v[i].y);
+                    out.min.z = std::min(out.min.z, v[i].z);
+                    out.max.x = std::max(out.max.x, v[i].x);
+                    out.max.y = std::max(out.max.y, v[i].y);
+                    out.max.z = std::max(out.max.z, v[i].z);
+                }
+            }
+            return out;
+        }
+    }
+
+    Box3F bbox(const TriMesh3F& mesh)
+    {
+        return bbox(mesh.v);
+    }
+
+    Box3F bbox(const IdxMesh3F& mesh)
+    {
+        return bbox(mesh.v);
+    }
+
     TriMesh2F mesh(const Box2I& box, bool mirrorV)
     {
         TriMesh2F out;
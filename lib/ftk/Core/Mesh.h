@@ -8,6 +8,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace ftk
@@ -90,12 +91,68 @@ namespace ftk
     typedef TriangleMesh2<float> TriMesh2F;
     typedef TriangleMesh3<float> TriMesh3F;
 
+    //! Two-dimensional indexed triangle mesh.
+    //!
+    //! The colors and texture coordinates are either empty or one for each
+    //! position, and each triangle is three zero-based indices into them.
+    //! Unlike TriangleMesh2 the vertices are shared between the triangles
+    //! that use them, and a triangle is three 32-bit indices rather than
+    //! three sets of size_t indices, so a mesh is several times smaller
+    //! and can be drawn with an index buffer.
+    template<typename T>
+    struct IndexedMesh2
+    {
+        std::vector<Vector<2, T> > v;
+        std::vector<Vector<4, T> > c;
+        std::vector<Vector<2, T> > t;
+        std::vector<uint32_t> indices;
+
+        size_t getByteCount() const;
+    };
+
+    //! Three-dimensional indexed triangle mesh.
+    //!
+    //! The colors, texture coordinates, and normals are either empty or one
+    //! for each position, and each triangle is three zero-based indices into
+    //! them.
+    template<typename T>
+    struct IndexedMesh3
+    {
+        std::vector<Vector<3, T> > v;
+        std::vector<Vector<4, T> > c;
+        std::vector<Vector<2, T> > t;
+        std::vector<Vector<3, T> > n;
+        std::vector<uint32_t> indices;
+
+        size_t getByteCount() const;
+    };
+
+    typedef IndexedMesh2<float> IdxMesh2F;
+    typedef IndexedMesh3<float> IdxMesh3F;
+
+    //! Convert a triangle mesh to an indexed mesh. Vertices with the same
+    //! position, color, and texture coordinate indices are merged.
+    FTK_API IdxMesh2F indexed(const TriMesh2F&);
+
+    //! Convert a triangle mesh to an indexed mesh. Vertices with the same
+    //! position, color, texture coordinate, and normal indices are merged.
+    FTK_API IdxMesh3F indexed(const TriMesh3F&);
+
+    //! Convert an indexed mesh to a triangle mesh.
+    FTK_API TriMesh2F unindexed(const IdxMesh2F&);
+
+    //! Convert an indexed mesh to a triangle mesh.
+    FTK_API TriMesh3F unindexed(const IdxMesh3F&);
+
     //! Edge function.
     FTK_API float edge(const V2F& p, const V2F& v0, const V2F& v1);
 
     //! Compute the bounding box of a mesh.
     FTK_API Box3F bbox(const TriMesh3F&);
 
+    //! Compute the bounding box of a mesh.
+    FTK_API Box3F bbox(const IdxMesh3F&);
+
     //! Create a mesh from a box.
     FTK_API TriMesh2F mesh(const Box2I&, bool mirrorV = false);
 
@@ -51,6 +51,27 @@ namespace ftk
             triangles.size() * sizeof(Triangle3);
     }
 
+    template<typename T>
+    inline size_t IndexedMesh2<T>::getByteCount() const
+    {
+        return
+            v.size() * sizeof(Vector<2, T>) +
+            c.size() * sizeof(Vector<4, T>) +
+            t.size() * sizeof(Vector<2, T>) +
+            indices.size() * sizeof(uint32_t);
+    }
+
+    template<typename T>
+    inline size_t IndexedMesh3<T>::getByteCount() const
+    {
+        return
+            v.size() * sizeof(Vector<3, T>) +
+            c.size() * sizeof(Vector<4, T>) +
+            t.size() * sizeof(Vector<2, T>) +
+            n.size() * sizeof(Vector<3, T>) +
+            indices.size() * sizeof(uint32_t);
+    }
+
     inline float edge(const V2F& p, const V2F& v0, const V2F& v1)
     {
         return
@@ -13,6 +13,9 @@ namespace ftk
         ///@{
 
         //! PNG image reader.
+        //!
+        //! The file is decoded as it is read, so a reader reads once, with
+        //! any one of the read methods; reading again throws an exception.
         class FTK_API_TYPE ImageReader : public IImageReader
         {
         public:
@@ -25,6 +28,8 @@ namespace ftk
 
             FTK_API const ImageInfo& getInfo() const override;
             FTK_API std::shared_ptr<Image> read() override;
+            FTK_API std::shared_ptr<Image> read(const Box2I&) override;
+            FTK_API void read(const std::shared_ptr<Image>&) override;
 
         private:
             FTK_PRIVATE();
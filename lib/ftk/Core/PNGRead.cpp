@@ -8,6 +8,7 @@
 #include <ftk/Core/String.h>
 
 #include <cstring>
+#include <vector>
 
 namespace ftk
 {
@@ -157,8 +158,16 @@ namespace ftk
             FILE*       f = nullptr;
             MemFile     memFile;
             ErrorStruct error;
+            size_t      sampleByteCount = 0;
+            size_t      pixelByteCount = 0;
             size_t      scanlineSize = 0;
             ImageInfo   info;
+            bool        read = false;
+
+            // Read the rows of a region, from the top, into an image the
+            // size of the region. The rows above it are decoded and thrown
+            // away; the rows below it are not decoded at all.
+            void readRegion(const std::filesystem::path&, const Box2I&, Image&);
 
             ~Private()
             {
@@ -228,7 +237,9 @@ namespace ftk
             {
                 throw std::runtime_error(Format("Cannot open: \"{0}\": {1}").arg(path.u8string()).arg(p.error.message));
             }
-            p.scanlineSize = width * channels * bitDepth / 8;
+            p.sampleByteCount = bitDepth / 8;
+            p.pixelByteCount = channels * p.sampleByteCount;
+            p.scanlineSize = width * p.pixelByteCount;
 
             ImageType type = ImageType::None;
             switch (channels)
@@ -288,20 +299,90 @@ namespace ftk
         {
             FTK_P();
             auto out = Image::create(p.info);
-            uint8_t* data = out->getData();
-            for (uint16_t y = 0; y < p.info.size.h; ++y, data += p.scanlineSize)
+            p.readRegion(_path, Box2I(0, 0, p.info.size.w, p.info.size.h), *out);
+            return out;
+        }
+
+        std::shared_ptr<Image> ImageReader::read(const Box2I& region)
+        {
+            FTK_P();
+            const Box2I box = intersect(region, Box2I(0, 0, p.info.size.w, p.info.size.h));
+            if (!box.isValid())
             {
+                throw std::runtime_error(Format("Cannot read region: \"{0}\"").arg(_path.u8string()));
+            }
+            ImageInfo info = p.info;
+            info.size = box.size();
+            auto out = Image::create(info);
+            p.readRegion(_path, box, *out);
+            return out;
+        }
+
+        void ImageReader::read(const std::shared_ptr<Image>& image)
+        {
+            FTK_P();
+            if (!image || image->getSize() != p.info.size || image->getType() != p.info.type)
+            {
+                throw std::runtime_error(Format("Cannot read into image: \"{0}\"").arg(_path.u8string()));
+            }
+            p.readRegion(_path, Box2I(0, 0, p.info.size.w, p.info.size.h), *image);
+        }
+
+        void ImageReader::Private::readRegion(
+            const std::filesystem::path& path,
+            const Box2I& box,
+            Image& image)
+        {
+            // libpng reads through the file once.
+            if (read)
+            {
+                throw std::runtime_error(Format("Cannot read again: \"{0}\"").arg(path.u8string()));
+            }
+            read = true;
+
+            const ImageInfo& outInfo = image.getInfo();
+            const size_t rowByteCount = getAlignedByteCount(
+                outInfo.size.w * pixelByteCount,
+                outInfo.layout.alignment);
+            const bool whole = box.w() == info.size.w;
+
+            // The samples are decoded in the machine's byte order.
+            const bool swap =
+                sampleByteCount > 1 &&
+                outInfo.layout.endian != getEndian();
+            std::vector<uint8_t> row(scanlineSize);
+            for (int y = 0; y <= box.max.y; ++y)
+            {
+                uint8_t* out = nullptr;
+                if (y >= box.min.y)
+                {
+                    const int outY = y - box.min.y;
+                    out = image.getData() + rowByteCount *
+                        (outInfo.layout.mirror.y ? outY : outInfo.size.h - 1 - outY);
+                }
+
                 // A truncated file used to stop here and return the image
                 // anyway, with everything past this row never written to.
                 // A caller has no way to tell that from a picture.
-                if (!scanline(p.png, data))
+                uint8_t* data = out && whole ? out : row.data();
+                if (!scanline(png, data))
                 {
                     throw std::runtime_error(Format("Cannot read: \"{0}\": {1}").
-                        arg(_path.u8string()).arg(p.error.message));
+                        arg(path.u8string()).arg(error.message));
+                }
+                if (out && data != out)
+                {
+                    memcpy(out, data + box.min.x * pixelByteCount, box.w() * pixelByteCount);
+                }
+                if (out && swap)
+                {
+                    swapEndian(out, box.w() * pixelByteCount / sampleByteCount, sampleByteCount);
                 }
             }
-            end(p.png, p.pngInfoEnd);
-            return out;
+            if (box.max.y == info.size.h - 1)
+            {
+                end(png, pngInfoEnd);
+            }
         }
     }
 }
@@ -8,17 +8,101 @@
 #include <ftk/Core/Memory.h>
 #include <ftk/Core/String.h>
 
+#include <zlib.h>
+
+#include <vector>
+
 namespace ftk
 {
     namespace png
     {
         namespace
         {
+            // Compression settings from the options; -1 leaves the libpng
+            // default.
+            struct Compression
+            {
+                int level = -1;
+                int strategy = -1;
+                int filter = -1;
+            };
+
+            Compression getCompression(
+                const std::filesystem::path& path,
+                const ImageIOOptions& options)
+            {
+                Compression out;
+                auto i = options.find("PNG/Compression");
+                if (i != options.end())
+                {
+                    const std::string& level = i->second;
+                    if (level.size() != 1 || level[0] < '0' || level[0] > '9')
+                    {
+                        throw std::runtime_error(Format("Invalid compression level: \"{0}\": {1}").
+                            arg(path.u8string()).arg(i->second));
+                    }
+                    out.level = level[0] - '0';
+                }
+                i = options.find("PNG/Strategy");
+                if (i != options.end())
+                {
+                    const std::vector<std::pair<std::string, int> > strategies =
+                    {
+                        { "Default", Z_DEFAULT_STRATEGY },
+                        { "Filtered", Z_FILTERED },
+                        { "HuffmanOnly", Z_HUFFMAN_ONLY },
+                        { "RLE", Z_RLE },
+                        { "Fixed", Z_FIXED }
+                    };
+                    for (const auto& strategy : strategies)
+                    {
+                        if (compare(i->second, strategy.first, CaseCompare::Insensitive))
+                        {
+                            out.strategy = strategy.second;
+                            break;
+                        }
+                    }
+                    if (-1 == out.strategy)
+                    {
+                        throw std::runtime_error(Format("Invalid compression strategy: \"{0}\": {1}").
+                            arg(path.u8string()).arg(i->second));
+                    }
+                }
+                i = options.find("PNG/Filter");
+                if (i != options.end())
+                {
+                    const std::vector<std::pair<std::string, int> > filters =
+                    {
+                        { "None", PNG_FILTER_NONE },
+                        { "Sub", PNG_FILTER_SUB },
+                        { "Up", PNG_FILTER_UP },
+                        { "Average", PNG_FILTER_AVG },
+                        { "Paeth", PNG_FILTER_PAETH },
+                        { "All", PNG_ALL_FILTERS }
+                    };
+                    for (const auto& filter : filters)
+                    {
+                        if (compare(i->second, filter.first, CaseCompare::Insensitive))
+                        {
+                            out.filter = filter.second;
+                            break;
+                        }
+                    }
+                    if (-1 == out.filter)
+                    {
+                        throw std::runtime_error(Format("Invalid filter: \"{0}\": {1}").
+                            arg(path.u8string()).arg(i->second));
+                    }
+                }
+                return out;
+            }
+
             bool open(
                 FILE* f,
                 png_structp png,
                 png_infop* pngInfo,
-                const ImageInfo& info)
+                const ImageInfo& info,
+                const Compression& compression)
             {
                 if (setjmp(png_jmpbuf(png)))
                 {
@@ -31,6 +115,19 @@ namespace ftk
                 }
                 png_init_io(png, f);
 
+                if (compression.level >= 0)
+                {
+                    png_set_compression_level(png, compression.level);
+                }
+                if (compression.strategy >= 0)
+                {
+                    png_set_compression_strategy(png, compression.strategy);
+                }
+                if (compression.filter >= 0)
+                {
+                    png_set_filter(png, PNG_FILTER_TYPE_BASE, compression.filter);
+                }
+
                 int colorType = 0;
                 switch (info.type)
                 {
@@ -97,6 +194,7 @@ namespace ftk
             png_infop   pngInfo = nullptr;
             FILE* f = nullptr;
             ErrorStruct error;
+            Compression compression;
 
             ~Private()
             {
@@ -121,6 +219,7 @@ namespace ftk
             _p(new Private)
         {
             FTK_P();
+            p.compression = getCompression(path, options);
             p.png = png_create_write_struct(
                 PNG_LIBPNG_VER_STRING,
                 &p.error,
@@ -149,7 +248,7 @@ namespace ftk
         {
             FTK_P();
             const ImageInfo& info = image->getInfo();
-            if (!open(p.f, p.png, &p.pngInfo, info))
+            if (!open(p.f, p.png, &p.pngInfo, info, p.compression))
             {
                 throw std::runtime_error(Format("Cannot open: \"{0}\": {1}").arg(_path.u8string()).arg(p.error.message));
             }
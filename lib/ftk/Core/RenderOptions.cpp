@@ -36,7 +36,8 @@ namespace ftk
         ImageFilter,
         "Nearest",
         "Linear",
-        "High Quality");
+        "High Quality",
+        "Mipmap");
 
     void to_json(nlohmann::json& json, const ImageFilters& in)
     {
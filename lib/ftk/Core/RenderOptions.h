@@ -39,6 +39,20 @@ namespace ftk
             4096;
 #endif // FTK_API_GLES_2
 
+        //! Maximum number of glyph texture atlas pages. Pages are added as
+        //! they fill; when all of them are full the least recently used one
+        //! is emptied.
+        size_t glyphAtlasPages = 4;
+
+        //! Record rectangles, lines, meshes and text into batches and draw
+        //! each batch with one call, rather than one call per primitive. A
+        //! batch is drawn when the clipping, transform or viewport changes,
+        //! before an image or texture, and at the end of the render. With
+        //! OpenGL, binding an offscreen buffer, a shader or drawing a VAO
+        //! also draws the batch; code calling the graphics API directly
+        //! calls IRender::flush() first.
+        bool batch = true;
+
         //! Enable logging.
         bool log = true;
 
@@ -106,6 +120,13 @@ namespace ftk
         //! an image down far enough that Linear misses most of it, which is
         //! what a thumbnail does and what the view does when it is zoomed out.
         HighQuality,
+        //! A chain of reduced copies built once when a cached image is
+        //! uploaded, sampled at the level that matches the reduction. For
+        //! images that are drawn small again and again, like thumbnails,
+        //! this reads a small level rather than the whole image each frame.
+        //! Only for minifying; images that are not cached, and OpenGL ES 2,
+        //! use Linear instead.
+        Mipmap,
 
         Count,
         First = Nearest
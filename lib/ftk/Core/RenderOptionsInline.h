@@ -11,6 +11,8 @@ namespace ftk
             texturePoolByteCount == other.texturePoolByteCount &&
             textureCacheByteCount == other.textureCacheByteCount &&
             glyphAtlasSize == other.glyphAtlasSize &&
+            glyphAtlasPages == other.glyphAtlasPages &&
+            batch == other.batch &&
             log == other.log;
     }
 
@@ -0,0 +1,352 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/SoftwareRenderPrivate.h>
+
+#include <ftk/Core/ImagePrivate.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ftk
+{
+    namespace
+    {
+        // Rows rasterized by one job. Small enough that the bands share out
+        // evenly over the threads, large enough that each one does more
+        // than look through the commands.
+        const int bandHeight = 32;
+    }
+
+    bool SoftwareRect::isValid() const
+    {
+        return x1 > x0 && y1 > y0;
+    }
+
+    bool SoftwareRect::operator == (const SoftwareRect& other) const
+    {
+        return
+            x0 == other.x0 &&
+            y0 == other.y0 &&
+            x1 == other.x1 &&
+            y1 == other.y1;
+    }
+
+    SoftwareRect intersect(const SoftwareRect& a, const SoftwareRect& b)
+    {
+        SoftwareRect out;
+        out.x0 = std::max(a.x0, b.x0);
+        out.y0 = std::max(a.y0, b.y0);
+        out.x1 = std::min(a.x1, b.x1);
+        out.y1 = std::min(a.y1, b.y1);
+        return out;
+    }
+
+    namespace
+    {
+        SoftwareRect toRect(const Box2I& value)
+        {
+            SoftwareRect out;
+            out.x0 = value.min.x;
+            out.y0 = value.min.y;
+            out.x1 = value.max.x + 1;
+            out.y1 = value.max.y + 1;
+            return out;
+        }
+    }
+
+    SoftwareRect SoftwareRender::Private::getClip() const
+    {
+        SoftwareRect out;
+        out.x1 = size.w;
+        out.y1 = size.h;
+        out = intersect(out, toRect(viewport));
+        if (clipRectEnabled)
+        {
+            out = intersect(out, toRect(clipRect));
+        }
+        return out;
+    }
+
+    SoftwareCommand& SoftwareRender::Private::command(
+        SoftwareShade shade,
+        SoftwareBlend blend,
+        const std::shared_ptr<SoftwareTexture>& texture,
+        const ImageOptions& imageOptions)
+    {
+        const SoftwareRect clip = getClip();
+        if (!commands.empty())
+        {
+            const SoftwareCommand& last = commands.back();
+            if (last.shade == shade &&
+                last.blend == blend &&
+                last.texture == texture &&
+                last.clip == clip &&
+                (shade != SoftwareShade::Image ||
+                    (last.filters == imageOptions.imageFilters &&
+                    last.channelDisplay == imageOptions.channelDisplay &&
+                    last.opaque == (AlphaBlend::None == imageOptions.alphaBlend))))
+            {
+                return commands.back();
+            }
+        }
+        commands.emplace_back();
+        SoftwareCommand& out = commands.back();
+        out.shade = shade;
+        out.blend = blend;
+        out.texture = texture;
+        out.filters = imageOptions.imageFilters;
+        out.channelDisplay = imageOptions.channelDisplay;
+        out.opaque = AlphaBlend::None == imageOptions.alphaBlend;
+        out.clip = clip;
+        out.bounds.x0 = clip.x1;
+        out.bounds.y0 = clip.y1;
+        out.bounds.x1 = clip.x0;
+        out.bounds.y1 = clip.y0;
+        out.first = vertices.size();
+        ++diag.drawCalls;
+        return out;
+    }
+
+    void SoftwareRender::Private::vertex(const V2F& v, const V4F& color, const V2F& t)
+    {
+        // The same mapping as OpenGL: the transform to normalized device
+        // coordinates, then the viewport to pixels, with y down.
+        const V4F c = transform * V4F(v.x, v.y, 0.F, 1.F);
+        const float w = c.w != 0.F ? c.w : 1.F;
+        SoftwareVertex out;
+        out.p.x = viewport.min.x + (c.x / w + 1.F) * .5F * viewport.w();
+        out.p.y = viewport.min.y + (1.F - c.y / w) * .5F * viewport.h();
+        out.c = color;
+        out.t = t;
+        vertices.push_back(out);
+
+        SoftwareCommand& command = commands.back();
+        ++command.count;
+        if (std::isfinite(out.p.x) && std::isfinite(out.p.y))
+        {
+            const SoftwareRect& clip = command.clip;
+            const float x = std::min(std::max(out.p.x, static_cast<float>(clip.x0)), static_cast<float>(clip.x1));
+            const float y = std::min(std::max(out.p.y, static_cast<float>(clip.y0)), static_cast<float>(clip.y1));
+            command.bounds.x0 = std::min(command.bounds.x0, static_cast<int>(std::floor(x)));
+            command.bounds.y0 = std::min(command.bounds.y0, static_cast<int>(std::floor(y)));
+            command.bounds.x1 = std::min(
+                std::max(command.bounds.x1, static_cast<int>(std::ceil(x)) + 1),
+                clip.x1);
+            command.bounds.y1 = std::min(
+                std::max(command.bounds.y1, static_cast<int>(std::ceil(y)) + 1),
+                clip.y1);
+        }
+        else
+        {
+            // Leave it to the rasterizer to skip.
+            command.bounds = command.clip;
+        }
+    }
+
+    void SoftwareRender::_init(
+        const std::shared_ptr<LogSystem>& logSystem,
+        const std::shared_ptr<FontSystem>& fontSystem)
+    {
+        IRender::_init(logSystem, fontSystem);
+        FTK_P();
+        p.glyphCache.setMax(4096);
+    }
+
+    SoftwareRender::SoftwareRender() :
+        _p(new Private)
+    {}
+
+    SoftwareRender::~SoftwareRender()
+    {}
+
+    std::shared_ptr<SoftwareRender> SoftwareRender::create(
+        const std::shared_ptr<LogSystem>& logSystem,
+        const std::shared_ptr<FontSystem>& fontSystem)
+    {
+        auto out = std::shared_ptr<SoftwareRender>(new SoftwareRender);
+        out->_init(logSystem, fontSystem);
+        return out;
+    }
+
+    const std::shared_ptr<Image>& SoftwareRender::getImage() const
+    {
+        return _p->image;
+    }
+
+    void SoftwareRender::begin(
+        const Size2I& size,
+        const RenderOptions& options)
+    {
+        FTK_P();
+
+        p.startTime = std::chrono::steady_clock::now();
+        p.diag = RenderDiag();
+        p.commands.clear();
+        p.vertices.clear();
+
+        p.size = size;
+        p.options = options;
+        p.textureCache.setMax(options.textureCacheByteCount);
+
+        if (!p.image || p.image->getSize() != size)
+        {
+            ImageInfo info(size, ImageType::RGBA_U8);
+            info.layout.mirror.y = true;
+            p.image = Image::create(info);
+        }
+
+        setViewport(Box2I(0, 0, size.w, size.h));
+        if (options.clear)
+        {
+            clearViewport(options.clearColor);
+        }
+        setTransform(ortho(
+            0.F,
+            static_cast<float>(size.w),
+            static_cast<float>(size.h),
+            0.F,
+            -1.F,
+            1.F));
+    }
+
+    void SoftwareRender::end()
+    {
+        FTK_P();
+        flush();
+        const auto now = std::chrono::steady_clock::now();
+        const auto diff = std::chrono::duration_cast<std::chrono::microseconds>(
+            now - p.startTime);
+        p.frameTimes[p.frameTimePos] = diff.count();
+        p.frameTimePos = (p.frameTimePos + 1) % p.frameTimes.size();
+        p.frameTimeCount = std::min(p.frameTimeCount + 1, p.frameTimes.size());
+        int64_t total = 0;
+        int64_t peak = 0;
+        for (size_t i = 0; i < p.frameTimeCount; ++i)
+        {
+            total += p.frameTimes[i];
+            peak = std::max(peak, p.frameTimes[i]);
+        }
+        p.diag.time = total / static_cast<int64_t>(p.frameTimeCount);
+        p.diag.timePeak = peak;
+    }
+
+    void SoftwareRender::flush()
+    {
+        FTK_P();
+        if (p.commands.empty() || !p.image || !p.image->isValid())
+        {
+            p.commands.clear();
+            p.vertices.clear();
+            return;
+        }
+
+        uint8_t* canvas = p.image->getData();
+        const Size2I& size = p.size;
+        const size_t bands = (size.h + bandHeight - 1) / bandHeight;
+        runImageJobs(
+            bands,
+            0,
+            [&p, canvas, &size](size_t band)
+            {
+                const int y0 = static_cast<int>(band) * bandHeight;
+                const int y1 = std::min(y0 + bandHeight, size.h);
+                for (const auto& command : p.commands)
+                {
+                    softwareRasterize(command, p.vertices, canvas, size, y0, y1);
+                }
+            });
+        ++p.diag.batches;
+
+        p.commands.clear();
+        p.vertices.clear();
+    }
+
+    Size2I SoftwareRender::getRenderSize() const
+    {
+        return _p->size;
+    }
+
+    void SoftwareRender::setRenderSize(const Size2I& value)
+    {
+        _p->size = value;
+    }
+
+    RenderOptions SoftwareRender::getRenderOptions() const
+    {
+        return _p->options;
+    }
+
+    Box2I SoftwareRender::getViewport() const
+    {
+        return _p->viewport;
+    }
+
+    void SoftwareRender::setViewport(const Box2I& value)
+    {
+        _p->viewport = value;
+    }
+
+    void SoftwareRender::clearViewport(const Color4F& value)
+    {
+        FTK_P();
+        // Like glClear(), this ignores the viewport but not the clipping
+        // rectangle.
+        SoftwareRect clip;
+        clip.x1 = p.size.w;
+        clip.y1 = p.size.h;
+        if (p.clipRectEnabled)
+        {
+            clip = intersect(clip, toRect(p.clipRect));
+        }
+        p.commands.emplace_back();
+        SoftwareCommand& command = p.commands.back();
+        command.shade = SoftwareShade::Clear;
+        command.clearColor = value;
+        command.clip = clip;
+        command.bounds = clip;
+        command.first = p.vertices.size();
+    }
+
+    bool SoftwareRender::getClipRectEnabled() const
+    {
+        return _p->clipRectEnabled;
+    }
+
+    void SoftwareRender::setClipRectEnabled(bool value)
+    {
+        _p->clipRectEnabled = value;
+    }
+
+    Box2I SoftwareRender::getClipRect() const
+    {
+        return _p->clipRect;
+    }
+
+    void SoftwareRender::setClipRect(const Box2I& value)
+    {
+        _p->clipRect = value;
+    }
+
+    M44F SoftwareRender::getTransform() const
+    {
+        return _p->transform;
+    }
+
+    void SoftwareRender::setTransform(const M44F& value)
+    {
+        _p->transform = value;
+    }
+
+    RenderDiag SoftwareRender::getDiag() const
+    {
+        return _p->diag;
+    }
+
+    std::shared_ptr<IRender> SoftwareRenderFactory::createRender(
+        const std::shared_ptr<LogSystem>& logSystem,
+        const std::shared_ptr<FontSystem>& fontSystem)
+    {
+        return SoftwareRender::create(logSystem, fontSystem);
+    }
+}
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/IRender.h>
+
+namespace ftk
+{
+    //! \name Rendering
+    ///@{
+
+    //! Software renderer.
+    //!
+    //! Draws on the CPU into an image, for machines without a GPU: servers,
+    //! continuous integration, and screenshots. Triangles cover the pixels
+    //! whose centers they contain and are blended the way the OpenGL
+    //! renderer blends them, so the results match it, including the
+    //! anti-aliasing the user interface draws with feathered color meshes.
+    //!
+    //! Drawing is recorded, then rasterized when the render is flushed in
+    //! horizontal bands spread over a pool of threads. Each band replays the
+    //! whole recording clipped to its own rows, so no two threads write the
+    //! same pixels.
+    //!
+    //! Textures are graphics API objects, which this renderer does not have;
+    //! drawTexture() and drawTextureScaled() draw nothing.
+    class FTK_API_TYPE SoftwareRender : public IRender
+    {
+    protected:
+        void _init(
+            const std::shared_ptr<LogSystem>&,
+            const std::shared_ptr<FontSystem>&);
+
+        SoftwareRender();
+
+    public:
+        FTK_API virtual ~SoftwareRender();
+
+        //! Create a new renderer.
+        FTK_API static std::shared_ptr<SoftwareRender> create(
+            const std::shared_ptr<LogSystem>&,
+            const std::shared_ptr<FontSystem>&);
+
+        //! Get the image that is drawn into. The image is RGBA_U8, the size
+        //! of the render, and starts with the top row. It is reused from one
+        //! render to the next while the size stays the same, so copy it to
+        //! keep a frame.
+        FTK_API const std::shared_ptr<Image>& getImage() const;
+
+        FTK_API void begin(
+            const Size2I&,
+            const RenderOptions& = RenderOptions()) override;
+        FTK_API void end() override;
+        FTK_API void flush() override;
+        FTK_API Size2I getRenderSize() const override;
+        FTK_API void setRenderSize(const Size2I&) override;
+        FTK_API RenderOptions getRenderOptions() const override;
+        FTK_API Box2I getViewport() const override;
+        FTK_API void setViewport(const Box2I&) override;
+        FTK_API void clearViewport(const Color4F&) override;
+        FTK_API bool getClipRectEnabled() const override;
+        FTK_API void setClipRectEnabled(bool) override;
+        FTK_API Box2I getClipRect() const override;
+        FTK_API void setClipRect(const Box2I&) override;
+        FTK_API M44F getTransform() const override;
+        FTK_API void setTransform(const M44F&) override;
+        FTK_API void drawRect(
+            const Box2F&,
+            const Color4F&) override;
+        FTK_API void drawRects(
+            const std::vector<Box2F>&,
+            const Color4F&) override;
+        FTK_API void drawLine(
+            const V2F&,
+            const V2F&,
+            const Color4F&,
+            const LineOptions& = LineOptions()) override;
+        FTK_API void drawLines(
+            const std::vector<std::pair<V2F, V2F> >&,
+            const Color4F&,
+            const LineOptions& = LineOptions()) override;
+        FTK_API void drawMesh(
+            const TriMesh2F&,
+            const Color4F& = Color4F(1.F, 1.F, 1.F, 1.F),
+            const V2F& pos = V2F()) override;
+        FTK_API void drawColorMesh(
+            const TriMesh2F&,
+            const Color4F& = Color4F(1.F, 1.F, 1.F, 1.F),
+            const V2F& pos = V2F()) override;
+        FTK_API void drawTextureScaled(
+            unsigned int,
+            const Size2I& sourceSize,
+            const Box2I&,
+            bool mirrorV = true) override;
+        FTK_API void drawTexture(
+            unsigned int,
+            const Box2I&,
+            bool mirrorV = false,
+            const Color4F& = Color4F(1.F, 1.F, 1.F),
+            AlphaBlend = AlphaBlend::Straight) override;
+        FTK_API void drawText(
+            const std::vector<std::shared_ptr<Glyph> >&,
+            const FontMetrics&,
+            const V2F& position,
+            const Color4F& = Color4F(1.F, 1.F, 1.F, 1.F)) override;
+        FTK_API void drawImage(
+            const std::shared_ptr<Image>&,
+            const TriMesh2F&,
+            const Color4F& = Color4F(1.F, 1.F, 1.F, 1.F),
+            const ImageOptions& = ImageOptions()) override;
+        FTK_API void drawImage(
+            const std::shared_ptr<Image>&,
+            const Box2F&,
+            const Color4F& = Color4F(1.F, 1.F, 1.F, 1.F),
+            const ImageOptions& = ImageOptions()) override;
+        FTK_API RenderDiag getDiag() const override;
+
+    private:
+        FTK_PRIVATE();
+    };
+
+    //! Software render factory.
+    class FTK_API_TYPE SoftwareRenderFactory : public IRenderFactory
+    {
+    public:
+        FTK_API std::shared_ptr<IRender> createRender(
+            const std::shared_ptr<LogSystem>&,
+            const std::shared_ptr<FontSystem>&) override;
+    };
+
+    ///@}
+}
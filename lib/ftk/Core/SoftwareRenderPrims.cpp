@@ -0,0 +1,337 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/SoftwareRenderPrivate.h>
+
+#include <cmath>
+
+namespace ftk
+{
+    namespace
+    {
+        inline V4F toV4F(const Color4F& value)
+        {
+            return V4F(value.r, value.g, value.b, value.a);
+        }
+
+        inline Size2I glyphSize(const Glyph& glyph)
+        {
+            const Size2I& size = glyph.image->getSize();
+            return GlyphMode::SDF == glyph.mode ?
+                Size2I(std::round(size.w * glyph.scale), std::round(size.h * glyph.scale)) :
+                size;
+        }
+    }
+
+    void SoftwareRender::drawRect(
+        const Box2F& rect,
+        const Color4F& color)
+    {
+        drawRects({ rect }, color);
+    }
+
+    void SoftwareRender::drawRects(
+        const std::vector<Box2F>& rects,
+        const Color4F& color)
+    {
+        FTK_P();
+        if (rects.empty())
+            return;
+        p.command(SoftwareShade::Color);
+        const V4F c = toV4F(color);
+        for (const auto& rect : rects)
+        {
+            const V2F v1(rect.max.x, rect.min.y);
+            const V2F v3(rect.min.x, rect.max.y);
+            p.vertex(rect.min, c);
+            p.vertex(rect.max, c);
+            p.vertex(v1, c);
+            p.vertex(rect.max, c);
+            p.vertex(rect.min, c);
+            p.vertex(v3, c);
+        }
+        p.diag.triangles += rects.size() * 2;
+    }
+
+    void SoftwareRender::drawLine(
+        const V2F& v0,
+        const V2F& v1,
+        const Color4F& color,
+        const LineOptions& options)
+    {
+        drawLines({ std::make_pair(v0, v1) }, color, options);
+    }
+
+    void SoftwareRender::drawLines(
+        const std::vector<std::pair<V2F, V2F> >& lines,
+        const Color4F& color,
+        const LineOptions& options)
+    {
+        FTK_P();
+        if (lines.empty())
+            return;
+        p.command(SoftwareShade::Color);
+        const V4F c = toV4F(color);
+        for (const auto& i : lines)
+        {
+            const V2F v2 = normalize(i.second - i.first);
+            const V2F v2CW = perpCW(v2) * options.width / 2.F;
+            const V2F v2CCW = perpCCW(v2) * options.width / 2.F;
+            const V2F q0 = i.first + v2CCW;
+            const V2F q1 = i.first + v2CW;
+            const V2F q2 = i.second + v2CW;
+            const V2F q3 = i.second + v2CCW;
+            p.vertex(q0, c);
+            p.vertex(q2, c);
+            p.vertex(q1, c);
+            p.vertex(q2, c);
+            p.vertex(q0, c);
+            p.vertex(q3, c);
+        }
+        p.diag.triangles += lines.size() * 2;
+    }
+
+    void SoftwareRender::drawMesh(
+        const TriMesh2F& mesh,
+        const Color4F& color,
+        const V2F& pos)
+    {
+        FTK_P();
+        if (mesh.triangles.empty())
+            return;
+        p.command(SoftwareShade::Color);
+        const V4F c = toV4F(color);
+        const size_t vSize = mesh.v.size();
+        for (const auto& triangle : mesh.triangles)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const size_t v = triangle.v[k].v;
+                p.vertex(v && v <= vSize ? mesh.v[v - 1] + pos : pos, c);
+            }
+        }
+        p.diag.triangles += mesh.triangles.size();
+    }
+
+    void SoftwareRender::drawColorMesh(
+        const TriMesh2F& mesh,
+        const Color4F& color,
+        const V2F& pos)
+    {
+        FTK_P();
+        if (mesh.triangles.empty())
+            return;
+        p.command(SoftwareShade::Color);
+        const size_t vSize = mesh.v.size();
+        const size_t cSize = mesh.c.size();
+        for (const auto& triangle : mesh.triangles)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const size_t v = triangle.v[k].v;
+                const size_t c = triangle.v[k].c;
+                V4F vColor = toV4F(color);
+                if (c && c <= cSize)
+                {
+                    const V4F& mc = mesh.c[c - 1];
+                    vColor = V4F(
+                        mc.x * color.r,
+                        mc.y * color.g,
+                        mc.z * color.b,
+                        mc.w * color.a);
+                }
+                p.vertex(v && v <= vSize ? mesh.v[v - 1] + pos : pos, vColor);
+            }
+        }
+        p.diag.triangles += mesh.triangles.size();
+    }
+
+    void SoftwareRender::drawTextureScaled(
+        unsigned int,
+        const Size2I&,
+        const Box2I&,
+        bool)
+    {}
+
+    void SoftwareRender::drawTexture(
+        unsigned int,
+        const Box2I&,
+        bool,
+        const Color4F&,
+        AlphaBlend)
+    {}
+
+    void SoftwareRender::drawText(
+        const std::vector<std::shared_ptr<Glyph> >& glyphs,
+        const FontMetrics& fontMetrics,
+        const V2F& pos,
+        const Color4F& color)
+    {
+        FTK_P();
+        const V4F c = toV4F(color);
+        int x = 0;
+        int y = 0;
+        int32_t rsbDeltaPrev = 0;
+        Box2I lineRect(
+            p.clipRect.min.x,
+            static_cast<int>(pos.y),
+            p.clipRect.w(),
+            fontMetrics.lineHeight);
+        for (auto glyphIt = glyphs.begin(); glyphIt != glyphs.end(); ++glyphIt)
+        {
+            if (!*glyphIt)
+                continue;
+            const Glyph& glyph = **glyphIt;
+            if ('\n' == glyph.info.code)
+            {
+                auto crIt = glyphIt + 1;
+                if (crIt != glyphs.end() && *crIt && '\r' == (*crIt)->info.code)
+                {
+                    ++glyphIt;
+                }
+                x = 0;
+                y += fontMetrics.lineHeight;
+                rsbDeltaPrev = 0;
+                lineRect = Box2I(
+                    p.clipRect.min.x,
+                    static_cast<int>(pos.y) + y,
+                    p.clipRect.w(),
+                    fontMetrics.lineHeight);
+            }
+            else if (!p.clipRectEnabled || intersects(p.clipRect, lineRect))
+            {
+                if (rsbDeltaPrev - glyph.lsbDelta > 32)
+                {
+                    x -= 1;
+                }
+                else if (rsbDeltaPrev - glyph.lsbDelta < -31)
+                {
+                    x += 1;
+                }
+                rsbDeltaPrev = glyph.rsbDelta;
+
+                if (glyph.image && glyph.image->isValid())
+                {
+                    ++p.diag.glyphs;
+                    std::shared_ptr<SoftwareTexture> texture;
+                    if (!p.glyphCache.get(glyph.image, texture))
+                    {
+                        texture = softwareGlyphTexture(*glyph.image);
+                        p.glyphCache.add(glyph.image, texture);
+                        ++p.diag.glyphUploads;
+                    }
+                    p.command(
+                        GlyphMode::SDF == glyph.mode ? SoftwareShade::GlyphSDF : SoftwareShade::Glyph,
+                        SoftwareBlend::Over,
+                        texture);
+
+                    //! \bug Off by one? The same as the OpenGL renderer.
+                    const int extraOffset = 1;
+                    const Size2I size = glyphSize(glyph);
+                    const V2F v0(
+                        pos.x + x + glyph.offset.x,
+                        pos.y + y + fontMetrics.ascender - glyph.offset.y - extraOffset);
+                    const V2F v1(v0.x + size.w, v0.y);
+                    const V2F v2(v0.x + size.w, v0.y + size.h);
+                    const V2F v3(v0.x, v0.y + size.h);
+                    p.vertex(v0, c, V2F(0.F, 0.F));
+                    p.vertex(v2, c, V2F(1.F, 1.F));
+                    p.vertex(v1, c, V2F(1.F, 0.F));
+                    p.vertex(v2, c, V2F(1.F, 1.F));
+                    p.vertex(v0, c, V2F(0.F, 0.F));
+                    p.vertex(v3, c, V2F(0.F, 1.F));
+                    p.diag.triangles += 2;
+                }
+                x += glyph.advance;
+            }
+        }
+    }
+
+    void SoftwareRender::drawImage(
+        const std::shared_ptr<Image>& image,
+        const TriMesh2F& mesh,
+        const Color4F& color,
+        const ImageOptions& imageOptions)
+    {
+        FTK_P();
+
+        const auto& info = image->getInfo();
+        if (!info.isValid() || mesh.triangles.empty())
+            return;
+
+        VideoLevels videoLevels = info.videoLevels;
+        switch (imageOptions.videoLevels)
+        {
+        case InputVideoLevels::FullRange:
+            videoLevels = VideoLevels::FullRange;
+            break;
+        case InputVideoLevels::LegalRange:
+            videoLevels = VideoLevels::LegalRange;
+            break;
+        default: break;
+        }
+
+        // The video levels are applied when the image is converted, so a
+        // cached conversion is only good for the same levels.
+        std::shared_ptr<SoftwareTexture> texture;
+        if (!imageOptions.cache ||
+            !p.textureCache.get(image, texture) ||
+            texture->videoLevels != videoLevels)
+        {
+            texture = softwareTexture(*image, videoLevels);
+        }
+        const ImageFilter minify = imageOptions.imageFilters.minify;
+        if (ImageFilter::HighQuality == minify || ImageFilter::Mipmap == minify)
+        {
+            texture->mipmaps();
+        }
+        if (imageOptions.cache)
+        {
+            p.textureCache.add(image, texture, texture->getByteCount());
+        }
+        ++p.diag.textures;
+
+        SoftwareBlend blend = SoftwareBlend::Over;
+        switch (imageOptions.alphaBlend)
+        {
+        case AlphaBlend::Straight: blend = SoftwareBlend::Straight; break;
+        case AlphaBlend::Premultiplied: blend = SoftwareBlend::Premultiplied; break;
+        default: break;
+        }
+        p.command(SoftwareShade::Image, blend, texture, imageOptions);
+
+        // The same orientation as the OpenGL image shader: images start
+        // with the bottom row unless they are mirrored.
+        const V4F c = toV4F(color);
+        const size_t vSize = mesh.v.size();
+        const size_t tSize = mesh.t.size();
+        for (const auto& triangle : mesh.triangles)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const size_t v = triangle.v[k].v;
+                const size_t t = triangle.v[k].t;
+                V2F tc = t && t <= tSize ? mesh.t[t - 1] : V2F();
+                if (info.layout.mirror.x)
+                {
+                    tc.x = 1.F - tc.x;
+                }
+                if (!info.layout.mirror.y)
+                {
+                    tc.y = 1.F - tc.y;
+                }
+                p.vertex(v && v <= vSize ? mesh.v[v - 1] : V2F(), c, tc);
+            }
+        }
+        p.diag.triangles += mesh.triangles.size();
+    }
+
+    void SoftwareRender::drawImage(
+        const std::shared_ptr<Image>& image,
+        const Box2F& box,
+        const Color4F& color,
+        const ImageOptions& imageOptions)
+    {
+        drawImage(image, mesh(box), color, imageOptions);
+    }
+}
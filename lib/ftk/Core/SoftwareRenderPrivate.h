@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/SoftwareRender.h>
+
+#include <ftk/Core/LRUCache.h>
+
+#include <array>
+#include <chrono>
+
+namespace ftk
+{
+    //! An image converted for sampling: floating point texels, one channel
+    //! for glyphs and four for everything else, with any reduced levels
+    //! following the full size one.
+    struct SoftwareTexture
+    {
+        int channels = 4;
+
+        //! The video levels the image was converted with.
+        VideoLevels videoLevels = VideoLevels::FullRange;
+
+        std::vector<Size2I> sizes;
+        std::vector<std::vector<float> > levels;
+
+        size_t getByteCount() const;
+
+        //! Add the reduced levels, if they are not there already.
+        void mipmaps();
+    };
+
+    //! Convert an image for sampling. This does what the OpenGL image
+    //! shader does to each texel, the video levels, YUV conversion and
+    //! swizzle for the channel count, once for the whole image.
+    std::shared_ptr<SoftwareTexture> softwareTexture(
+        const Image&,
+        VideoLevels);
+
+    //! Convert a glyph image for sampling.
+    std::shared_ptr<SoftwareTexture> softwareGlyphTexture(const Image&);
+
+    //! What a command draws.
+    enum class SoftwareShade
+    {
+        Clear,
+        Color,
+        Image,
+        Glyph,
+        GlyphSDF
+    };
+
+    //! How a command blends. Over is how meshes and text are blended,
+    //! source alpha for all four channels; the others are the image
+    //! AlphaBlend modes.
+    enum class SoftwareBlend
+    {
+        Over,
+        Straight,
+        Premultiplied
+    };
+
+    //! A rectangle of pixels, the maximum exclusive.
+    struct SoftwareRect
+    {
+        int x0 = 0;
+        int y0 = 0;
+        int x1 = 0;
+        int y1 = 0;
+
+        bool isValid() const;
+        bool operator == (const SoftwareRect&) const;
+    };
+
+    SoftwareRect intersect(const SoftwareRect&, const SoftwareRect&);
+
+    //! A vertex, already in pixels.
+    struct SoftwareVertex
+    {
+        V2F p;
+        V4F c;
+        V2F t;
+    };
+
+    //! A run of triangles drawn the same way, or a clear.
+    struct SoftwareCommand
+    {
+        SoftwareShade shade = SoftwareShade::Color;
+        SoftwareBlend blend = SoftwareBlend::Over;
+        std::shared_ptr<SoftwareTexture> texture;
+        ImageFilters filters;
+        ChannelDisplay channelDisplay = ChannelDisplay::Color;
+        bool opaque = false;
+        Color4F clearColor;
+
+        //! Where the command may draw: the canvas, viewport, and clipping
+        //! rectangle.
+        SoftwareRect clip;
+
+        //! What the triangles cover, within the clip.
+        SoftwareRect bounds;
+
+        //! The triangles' vertices, three for each.
+        size_t first = 0;
+        size_t count = 0;
+    };
+
+    //! Draw the part of a command that falls in the given rows of an
+    //! RGBA_U8 canvas.
+    void softwareRasterize(
+        const SoftwareCommand&,
+        const std::vector<SoftwareVertex>&,
+        uint8_t* canvas,
+        const Size2I&,
+        int y0,
+        int y1);
+
+    struct SoftwareRender::Private
+    {
+        Size2I size;
+        RenderOptions options;
+        Box2I viewport;
+        bool clipRectEnabled = false;
+        Box2I clipRect;
+        M44F transform;
+        std::shared_ptr<Image> image;
+
+        std::vector<SoftwareCommand> commands;
+        std::vector<SoftwareVertex> vertices;
+
+        LRUCache<std::shared_ptr<Image>, std::shared_ptr<SoftwareTexture> > textureCache;
+        LRUCache<std::shared_ptr<Image>, std::shared_ptr<SoftwareTexture> > glyphCache;
+
+        RenderDiag diag;
+        std::chrono::time_point<std::chrono::steady_clock> startTime;
+        std::array<int64_t, 60> frameTimes;
+        size_t frameTimePos = 0;
+        size_t frameTimeCount = 0;
+
+        //! Get where drawing may go now.
+        SoftwareRect getClip() const;
+
+        //! Get the command to add triangles to, continuing the last one if
+        //! it draws the same way.
+        SoftwareCommand& command(
+            SoftwareShade,
+            SoftwareBlend = SoftwareBlend::Over,
+            const std::shared_ptr<SoftwareTexture>& = nullptr,
+            const ImageOptions& = ImageOptions());
+
+        //! Add a triangle's vertex to the last command, transforming it to
+        //! pixels.
+        void vertex(const V2F&, const V4F& color, const V2F& t = V2F());
+    };
+}
@@ -0,0 +1,960 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/SoftwareRenderPrivate.h>
+
+#include <ftk/Core/ImagePrivate.h>
+
+#include <ftk/Core/Memory.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ftk
+{
+    namespace
+    {
+        // Rows converted by one job.
+        const int convertJobRows = 16;
+
+        inline float clamp01(float value)
+        {
+            return std::min(std::max(value, 0.F), 1.F);
+        }
+
+        // Convert rows of an RGBA, RGB, LA or L image.
+        void convertRows(
+            const Image& image,
+            VideoLevels videoLevels,
+            int y0,
+            int y1,
+            float* out)
+        {
+            const ImageInfo& info = image.getInfo();
+            const int w = info.size.w;
+            const int channels = getChannelCount(info.type);
+            const ImageData data = getImageData(info.type);
+            const ImagePlane plane = getImagePlanes(info).front();
+            const bool swap = info.layout.endian != getEndian() && getSampleByteCount(data) > 1;
+            const bool legal = VideoLevels::LegalRange == videoLevels;
+            const bool clamp = data != ImageData::F16 && data != ImageData::F32;
+            std::vector<float> row(static_cast<size_t>(w) * channels);
+            for (int y = y0; y < y1; ++y)
+            {
+                readSamples(
+                    image.getData() + y * plane.rowByteCount,
+                    data,
+                    swap,
+                    row.size(),
+                    row.data());
+                const float* p = row.data();
+                float* o = out + static_cast<size_t>(y) * w * 4;
+                for (int x = 0; x < w; ++x, p += channels, o += 4)
+                {
+                    // What the texture would return: the missing channels
+                    // are zero, and alpha one.
+                    float c[4] = { 0.F, 0.F, 0.F, 1.F };
+                    for (int k = 0; k < channels; ++k)
+                    {
+                        c[k] = p[k];
+                    }
+                    if (legal)
+                    {
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            c[k] = legalRange(c[k]);
+                            if (clamp)
+                            {
+                                c[k] = clamp01(c[k]);
+                            }
+                        }
+                    }
+                    switch (channels)
+                    {
+                    case 1:
+                        o[0] = o[1] = o[2] = c[0];
+                        o[3] = 1.F;
+                        break;
+                    case 2:
+                        o[0] = o[1] = o[2] = c[0];
+                        o[3] = c[1];
+                        break;
+                    case 3:
+                        o[0] = c[0];
+                        o[1] = c[1];
+                        o[2] = c[2];
+                        o[3] = 1.F;
+                        break;
+                    default:
+                        o[0] = c[0];
+                        o[1] = c[1];
+                        o[2] = c[2];
+                        o[3] = c[3];
+                        break;
+                    }
+                }
+            }
+        }
+
+        bool isYUV(ImageType type)
+        {
+            return type >= ImageType::YUV_420P_U8 && type <= ImageType::YUV_420SP_U16;
+        }
+    }
+
+    size_t SoftwareTexture::getByteCount() const
+    {
+        size_t out = 0;
+        for (const auto& level : levels)
+        {
+            out += level.size() * sizeof(float);
+        }
+        return out;
+    }
+
+    void SoftwareTexture::mipmaps()
+    {
+        if (levels.size() != 1)
+            return;
+        Size2I size = sizes[0];
+        while (size.w > 1 || size.h > 1)
+        {
+            const Size2I next(std::max(size.w / 2, 1), std::max(size.h / 2, 1));
+            std::vector<float> level(static_cast<size_t>(next.w) * next.h * channels);
+            const float* src = levels.back().data();
+            float* dst = level.data();
+            for (int y = 0; y < next.h; ++y)
+            {
+                const float* row0 = src + static_cast<size_t>(std::min(y * 2, size.h - 1)) * size.w * channels;
+                const float* row1 = src + static_cast<size_t>(std::min(y * 2 + 1, size.h - 1)) * size.w * channels;
+                for (int x = 0; x < next.w; ++x)
+                {
+                    const int x0 = std::min(x * 2, size.w - 1) * channels;
+                    const int x1 = std::min(x * 2 + 1, size.w - 1) * channels;
+                    for (int c = 0; c < channels; ++c, ++dst)
+                    {
+                        *dst = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]) * .25F;
+                    }
+                }
+            }
+            sizes.push_back(next);
+            levels.push_back(std::move(level));
+            size = next;
+        }
+    }
+
+    std::shared_ptr<SoftwareTexture> softwareTexture(
+        const Image& image,
+        VideoLevels videoLevels)
+    {
+        auto out = std::make_shared<SoftwareTexture>();
+        const ImageInfo& info = image.getInfo();
+        out->videoLevels = videoLevels;
+        out->sizes.push_back(info.size);
+        out->levels.push_back(std::vector<float>(
+            static_cast<size_t>(info.size.w) * info.size.h * 4));
+        float* data = out->levels[0].data();
+        const bool yuv = isYUV(info.type);
+        runImageJobs(
+            (info.size.h + convertJobRows - 1) / convertJobRows,
+            0,
+            [&image, videoLevels, data, yuv, &info](size_t job)
+            {
+                const int y0 = static_cast<int>(job) * convertJobRows;
+                const int y1 = std::min(y0 + convertJobRows, info.size.h);
+                if (yuv)
+                {
+                    readYUVRows(
+                        image,
+                        videoLevels,
+                        y0,
+                        y1,
+                        data + static_cast<size_t>(y0) * info.size.w * 4);
+                }
+                else
+                {
+                    convertRows(image, videoLevels, y0, y1, data);
+                }
+            });
+        return out;
+    }
+
+    std::shared_ptr<SoftwareTexture> softwareGlyphTexture(const Image& image)
+    {
+        auto out = std::make_shared<SoftwareTexture>();
+        const ImageInfo& info = image.getInfo();
+        const int w = info.size.w;
+        const int h = info.size.h;
+        out->channels = 1;
+        out->sizes.push_back(info.size);
+        out->levels.push_back(std::vector<float>(static_cast<size_t>(w) * h));
+        float* o = out->levels[0].data();
+        if (ImageType::L_U8 == info.type)
+        {
+            const size_t rowBytes = getAlignedByteCount(w, info.layout.alignment);
+            for (int y = 0; y < h; ++y)
+            {
+                const uint8_t* p = image.getData() + y * rowBytes;
+                for (int x = 0; x < w; ++x)
+                {
+                    *o++ = p[x] / 255.F;
+                }
+            }
+        }
+        else
+        {
+            std::vector<float> rgba(static_cast<size_t>(w) * h * 4);
+            if (isYUV(info.type))
+            {
+                readYUVRows(image, info.videoLevels, 0, h, rgba.data());
+            }
+            else
+            {
+                convertRows(image, info.videoLevels, 0, h, rgba.data());
+            }
+            for (size_t i = 0; i < rgba.size(); i += 4)
+            {
+                *o++ = rgba[i];
+            }
+        }
+        return out;
+    }
+
+    namespace
+    {
+        // Sample a texture, clamping to the edges.
+        template<int C>
+        inline void sampleNearest(
+            const float* data,
+            int w,
+            int h,
+            float u,
+            float v,
+            float* out)
+        {
+            const int x = static_cast<int>(std::min(std::max(u * w, 0.F), w - 1.F));
+            const int y = static_cast<int>(std::min(std::max(v * h, 0.F), h - 1.F));
+            const float* p = data + (static_cast<size_t>(y) * w + x) * C;
+            for (int c = 0; c < C; ++c)
+            {
+                out[c] = p[c];
+            }
+        }
+
+        template<int C>
+        inline void sampleLinear(
+            const float* data,
+            int w,
+            int h,
+            float u,
+            float v,
+            float* out)
+        {
+            // Clamping the position rather than the texels gives the same
+            // result at the edges, and keeps it positive so truncating it
+            // is the floor.
+            const float fx = std::min(std::max(u * w - .5F, 0.F), w - 1.F);
+            const float fy = std::min(std::max(v * h - .5F, 0.F), h - 1.F);
+            const int x0 = static_cast<int>(fx);
+            const int y0 = static_cast<int>(fy);
+            const int x1 = std::min(x0 + 1, w - 1);
+            const int y1 = std::min(y0 + 1, h - 1);
+            const float ax = fx - x0;
+            const float ay = fy - y0;
+            const float* p00 = data + (static_cast<size_t>(y0) * w + x0) * C;
+            const float* p01 = data + (static_cast<size_t>(y0) * w + x1) * C;
+            const float* p10 = data + (static_cast<size_t>(y1) * w + x0) * C;
+            const float* p11 = data + (static_cast<size_t>(y1) * w + x1) * C;
+            for (int c = 0; c < C; ++c)
+            {
+                const float c0 = p00[c] + (p01[c] - p00[c]) * ax;
+                const float c1 = p10[c] + (p11[c] - p10[c]) * ax;
+                out[c] = c0 + (c1 - c0) * ay;
+            }
+        }
+
+        enum class Filter
+        {
+            Nearest,
+            Linear,
+            Trilinear
+        };
+
+        // A texture lookup, with the filter and level picked once for the
+        // triangle; with screen space interpolation the reduction is the
+        // same over the whole of it.
+        struct Sampler
+        {
+            int channels = 4;
+            Filter filter = Filter::Linear;
+            std::array<const float*, 2> data = { nullptr, nullptr };
+            std::array<int, 2> w = { 0, 0 };
+            std::array<int, 2> h = { 0, 0 };
+            float levelBlend = 0.F;
+
+            void setLevel(const SoftwareTexture&, size_t);
+
+            //! Sample a span of positions, one output array for each
+            //! channel.
+            void span(
+                const float* u,
+                const float* v,
+                size_t n,
+                float* const* out) const;
+        };
+
+        void Sampler::setLevel(const SoftwareTexture& texture, size_t level)
+        {
+            channels = texture.channels;
+            for (size_t i = 0; i < 2; ++i)
+            {
+                const size_t l = std::min(level + i, texture.levels.size() - 1);
+                data[i] = texture.levels[l].data();
+                w[i] = texture.sizes[l].w;
+                h[i] = texture.sizes[l].h;
+            }
+        }
+
+        template<int C, Filter F>
+        void sampleSpan(
+            const Sampler& s,
+            const float* u,
+            const float* v,
+            size_t n,
+            float* const* out)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                float c[C];
+                switch (F)
+                {
+                case Filter::Nearest:
+                    sampleNearest<C>(s.data[0], s.w[0], s.h[0], u[i], v[i], c);
+                    break;
+                case Filter::Linear:
+                    sampleLinear<C>(s.data[0], s.w[0], s.h[0], u[i], v[i], c);
+                    break;
+                case Filter::Trilinear:
+                {
+                    float next[C];
+                    sampleLinear<C>(s.data[0], s.w[0], s.h[0], u[i], v[i], c);
+                    sampleLinear<C>(s.data[1], s.w[1], s.h[1], u[i], v[i], next);
+                    for (int k = 0; k < C; ++k)
+                    {
+                        c[k] += (next[k] - c[k]) * s.levelBlend;
+                    }
+                    break;
+                }
+                }
+                for (int k = 0; k < C; ++k)
+                {
+                    out[k][i] = c[k];
+                }
+            }
+        }
+
+        void Sampler::span(
+            const float* u,
+            const float* v,
+            size_t n,
+            float* const* out) const
+        {
+            if (1 == channels)
+            {
+                switch (filter)
+                {
+                case Filter::Nearest: sampleSpan<1, Filter::Nearest>(*this, u, v, n, out); break;
+                case Filter::Linear: sampleSpan<1, Filter::Linear>(*this, u, v, n, out); break;
+                case Filter::Trilinear: sampleSpan<1, Filter::Trilinear>(*this, u, v, n, out); break;
+                }
+            }
+            else
+            {
+                switch (filter)
+                {
+                case Filter::Nearest: sampleSpan<4, Filter::Nearest>(*this, u, v, n, out); break;
+                case Filter::Linear: sampleSpan<4, Filter::Linear>(*this, u, v, n, out); break;
+                case Filter::Trilinear: sampleSpan<4, Filter::Trilinear>(*this, u, v, n, out); break;
+                }
+            }
+        }
+
+        // The text gamma, pow(coverage, 1 / 1.3), as a table.
+        const size_t gammaTableSize = 1024;
+
+        const std::array<float, gammaTableSize + 1>& getGammaTable()
+        {
+            static const std::array<float, gammaTableSize + 1> out = []
+            {
+                std::array<float, gammaTableSize + 1> table;
+                for (size_t i = 0; i <= gammaTableSize; ++i)
+                {
+                    table[i] = std::pow(i / static_cast<float>(gammaTableSize), 1.F / 1.3F);
+                }
+                return table;
+            }();
+            return out;
+        }
+
+        inline float gamma(const std::array<float, gammaTableSize + 1>& table, float value)
+        {
+            const float f = clamp01(value) * gammaTableSize;
+            const size_t i = std::min(static_cast<size_t>(f), gammaTableSize - 1);
+            return table[i] + (table[i + 1] - table[i]) * (f - i);
+        }
+
+        // A value interpolated over a triangle: at the center of the pixel
+        // at x, y it is a + dx * x + dy * y.
+        struct Gradient
+        {
+            float a = 0.F;
+            float dx = 0.F;
+            float dy = 0.F;
+        };
+
+        Gradient gradient(
+            const V2F& p0,
+            const V2F& p1,
+            const V2F& p2,
+            float a0,
+            float a1,
+            float a2,
+            float area2)
+        {
+            Gradient out;
+            const float x1 = p1.x - p0.x;
+            const float y1 = p1.y - p0.y;
+            const float x2 = p2.x - p0.x;
+            const float y2 = p2.y - p0.y;
+            out.dx = ((a1 - a0) * y2 - (a2 - a0) * y1) / area2;
+            out.dy = ((a2 - a0) * x1 - (a1 - a0) * x2) / area2;
+            out.a = a0 + out.dx * (.5F - p0.x) + out.dy * (.5F - p0.y);
+            return out;
+        }
+
+        // Fill a span with a gradient.
+        inline void span(const Gradient& g, int x, int y, size_t n, float* out)
+        {
+            const float a = g.a + g.dx * x + g.dy * y;
+            for (size_t i = 0; i < n; ++i)
+            {
+                out[i] = a + g.dx * i;
+            }
+        }
+
+        // The canvas is read and written a pixel at a time as 32-bit words;
+        // where each channel is in the word depends on the byte order.
+        struct Shifts
+        {
+            uint32_t r = 0;
+            uint32_t g = 8;
+            uint32_t b = 16;
+            uint32_t a = 24;
+        };
+
+        Shifts getShifts()
+        {
+            Shifts out;
+            if (Endian::MSB == getEndian())
+            {
+                out.r = 24;
+                out.g = 16;
+                out.b = 8;
+                out.a = 0;
+            }
+            return out;
+        }
+
+        const Shifts shifts = getShifts();
+
+        // Pack channel values in 0-255 into a word. The shifts are passed by
+        // value so the compiler knows that writing the canvas does not change
+        // them.
+        inline uint32_t toWord(const Shifts s, float r, float g, float b, float a)
+        {
+            return
+                (static_cast<uint32_t>(static_cast<int32_t>(std::min(r + .5F, 255.F))) << s.r) |
+                (static_cast<uint32_t>(static_cast<int32_t>(std::min(g + .5F, 255.F))) << s.g) |
+                (static_cast<uint32_t>(static_cast<int32_t>(std::min(b + .5F, 255.F))) << s.b) |
+                (static_cast<uint32_t>(static_cast<int32_t>(std::min(a + .5F, 255.F))) << s.a);
+        }
+
+        inline float channel(uint32_t value, uint32_t shift)
+        {
+            return static_cast<float>(static_cast<int32_t>((value >> shift) & 0xff));
+        }
+
+        // Blend a span of colors, one array for each channel, into the
+        // canvas. The loops are kept to the same arithmetic on every element
+        // so that the compiler vectorizes them: the colors are clamped in a
+        // pass of their own, and the only comparison in the blend is the one
+        // just before the result is stored.
+        template<SoftwareBlend blend>
+        void blendSpan(
+            uint32_t* dst,
+            size_t n,
+            float* r,
+            float* g,
+            float* b,
+            float* a)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                r[i] = clamp01(r[i]);
+                g[i] = clamp01(g[i]);
+                b[i] = clamp01(b[i]);
+                a[i] = clamp01(a[i]);
+            }
+            const Shifts s = shifts;
+            for (size_t i = 0; i < n; ++i)
+            {
+                const uint32_t d = dst[i];
+                const float sa = a[i];
+                const float ia = 1.F - sa;
+                const float k = (SoftwareBlend::Premultiplied == blend ? 1.F : sa) * 255.F;
+                dst[i] = toWord(
+                    s,
+                    r[i] * k + channel(d, s.r) * ia,
+                    g[i] * k + channel(d, s.g) * ia,
+                    b[i] * k + channel(d, s.b) * ia,
+                    (SoftwareBlend::Over == blend ? sa * sa : sa) * 255.F + channel(d, s.a) * ia);
+            }
+        }
+
+        void blendSpan(
+            SoftwareBlend blend,
+            uint32_t* dst,
+            size_t n,
+            float* r,
+            float* g,
+            float* b,
+            float* a)
+        {
+            switch (blend)
+            {
+            case SoftwareBlend::Over:
+                blendSpan<SoftwareBlend::Over>(dst, n, r, g, b, a);
+                break;
+            case SoftwareBlend::Straight:
+                blendSpan<SoftwareBlend::Straight>(dst, n, r, g, b, a);
+                break;
+            case SoftwareBlend::Premultiplied:
+                blendSpan<SoftwareBlend::Premultiplied>(dst, n, r, g, b, a);
+                break;
+            }
+        }
+
+        // Blend one color over a span. Opaque colors are copied.
+        void blendSpan(
+            SoftwareBlend blend,
+            uint32_t* dst,
+            size_t n,
+            const V4F& c)
+        {
+            const float sa = clamp01(c.w);
+            if (sa >= 1.F)
+            {
+                std::fill(dst, dst + n, toWord(
+                    shifts,
+                    clamp01(c.x) * 255.F,
+                    clamp01(c.y) * 255.F,
+                    clamp01(c.z) * 255.F,
+                    255.F));
+                return;
+            }
+            const Shifts s = shifts;
+            const float k = (SoftwareBlend::Premultiplied == blend ? 1.F : sa) * 255.F;
+            const float sr = clamp01(c.x) * k;
+            const float sg = clamp01(c.y) * k;
+            const float sb = clamp01(c.z) * k;
+            const float alpha = (SoftwareBlend::Over == blend ? sa * sa : sa) * 255.F;
+            const float ia = 1.F - sa;
+            for (size_t i = 0; i < n; ++i)
+            {
+                const uint32_t d = dst[i];
+                dst[i] = toWord(
+                    s,
+                    sr + channel(d, s.r) * ia,
+                    sg + channel(d, s.g) * ia,
+                    sb + channel(d, s.b) * ia,
+                    alpha + channel(d, s.a) * ia);
+            }
+        }
+
+        // Per thread room for the spans.
+        struct Scratch
+        {
+            std::vector<float> data;
+
+            float* get(size_t n, size_t arrays)
+            {
+                if (data.size() < n * arrays)
+                {
+                    data.resize(n * arrays);
+                }
+                return data.data();
+            }
+        };
+
+        thread_local Scratch scratch;
+
+        // The edge of a triangle, for finding where each row of pixels goes
+        // in and out of it.
+        struct Edge
+        {
+            double x = 0.0;
+            double y = 0.0;
+            double a = 0.0;
+            double b = 0.0;
+            bool topLeft = false;
+        };
+
+        Edge edge(const V2F& v0, const V2F& v1)
+        {
+            // Positive inside, for a triangle with a positive area.
+            Edge out;
+            out.x = v0.x;
+            out.y = v0.y;
+            out.a = static_cast<double>(v0.y) - v1.y;
+            out.b = static_cast<double>(v1.x) - v0.x;
+            // The rule that decides which of two triangles sharing an edge
+            // covers a pixel centered on it, so it is drawn once.
+            out.topLeft = out.a > 0.0 || (0.0 == out.a && out.b > 0.0);
+            return out;
+        }
+
+        struct Triangle
+        {
+            const SoftwareCommand* command = nullptr;
+            const SoftwareVertex* v[3] = { nullptr, nullptr, nullptr };
+            float area2 = 0.F;
+            Edge edges[3];
+        };
+
+        void shadeSpan(
+            const Triangle& triangle,
+            const Gradient* color,
+            bool constantColor,
+            const Gradient* t,
+            const Sampler& sampler,
+            int x,
+            int y,
+            size_t n,
+            uint32_t* dst)
+        {
+            const SoftwareCommand& command = *triangle.command;
+            if (SoftwareShade::Color == command.shade && constantColor)
+            {
+                blendSpan(command.blend, dst, n, triangle.v[0]->c);
+                return;
+            }
+
+            float* data = scratch.get(n, 12);
+            float* r = data;
+            float* g = data + n;
+            float* b = data + n * 2;
+            float* a = data + n * 3;
+            float* u = data + n * 4;
+            float* v = data + n * 5;
+            float* const s[4] = { data + n * 6, data + n * 7, data + n * 8, data + n * 9 };
+            span(color[0], x, y, n, r);
+            span(color[1], x, y, n, g);
+            span(color[2], x, y, n, b);
+            span(color[3], x, y, n, a);
+            if (command.texture)
+            {
+                span(t[0], x, y, n, u);
+                span(t[1], x, y, n, v);
+                sampler.span(u, v, n, s);
+            }
+            switch (command.shade)
+            {
+            case SoftwareShade::Image:
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    r[i] *= s[0][i];
+                    g[i] *= s[1][i];
+                    b[i] *= s[2][i];
+                    a[i] *= s[3][i];
+                }
+                if (command.opaque)
+                {
+                    std::fill(a, a + n, 1.F);
+                }
+                switch (command.channelDisplay)
+                {
+                case ChannelDisplay::Red:
+                    std::copy(r, r + n, g);
+                    std::copy(r, r + n, b);
+                    break;
+                case ChannelDisplay::Green:
+                    std::copy(g, g + n, r);
+                    std::copy(g, g + n, b);
+                    break;
+                case ChannelDisplay::Blue:
+                    std::copy(b, b + n, r);
+                    std::copy(b, b + n, g);
+                    break;
+                case ChannelDisplay::Alpha:
+                    std::copy(a, a + n, r);
+                    std::copy(a, a + n, g);
+                    std::copy(a, a + n, b);
+                    break;
+                default: break;
+                }
+                break;
+            }
+            case SoftwareShade::Glyph:
+            {
+                const auto& table = getGammaTable();
+                for (size_t i = 0; i < n; ++i)
+                {
+                    a[i] = gamma(table, s[0][i] * a[i]);
+                }
+                break;
+            }
+            case SoftwareShade::GlyphSDF:
+            {
+                // The change in distance to the next pixel across and down,
+                // what fwidth() gives the shader.
+                float* ux = data + n * 10;
+                float* vx = data + n * 11;
+                float* const dx[1] = { s[1] };
+                float* const dy[1] = { s[2] };
+                for (size_t i = 0; i < n; ++i)
+                {
+                    ux[i] = u[i] + t[0].dx;
+                    vx[i] = v[i] + t[1].dx;
+                }
+                sampler.span(ux, vx, n, dx);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    ux[i] = u[i] + t[0].dy;
+                    vx[i] = v[i] + t[1].dy;
+                }
+                sampler.span(ux, vx, n, dy);
+                const auto& table = getGammaTable();
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const float d = s[0][i];
+                    const float width = std::max(
+                        (std::abs(dx[0][i] - d) + std::abs(dy[0][i] - d)) * .5F,
+                        .0001F);
+                    const float k = clamp01((d - (.5F - width)) / (width * 2.F));
+                    a[i] = gamma(table, k * k * (3.F - 2.F * k) * a[i]);
+                }
+                break;
+            }
+            default: break;
+            }
+            blendSpan(command.blend, dst, n, r, g, b, a);
+        }
+
+        void rasterizeTriangle(
+            Triangle& triangle,
+            const SoftwareRect& rect,
+            uint8_t* canvas,
+            const Size2I& size)
+        {
+            const SoftwareVertex& v0 = *triangle.v[0];
+            const SoftwareVertex& v1 = *triangle.v[1];
+            const SoftwareVertex& v2 = *triangle.v[2];
+            const float area2 = triangle.area2;
+
+            // Rows the triangle may cover.
+            const float minY = std::min(std::min(v0.p.y, v1.p.y), v2.p.y);
+            const float maxY = std::max(std::max(v0.p.y, v1.p.y), v2.p.y);
+            const float minX = std::min(std::min(v0.p.x, v1.p.x), v2.p.x);
+            const float maxX = std::max(std::max(v0.p.x, v1.p.x), v2.p.x);
+            const int yStart = std::max(rect.y0, static_cast<int>(std::floor(std::max(minY, static_cast<float>(rect.y0)))));
+            const int yEnd = std::min(rect.y1, static_cast<int>(std::ceil(std::min(maxY, static_cast<float>(rect.y1)))) + 1);
+            const int xStart = std::max(rect.x0, static_cast<int>(std::floor(std::max(minX, static_cast<float>(rect.x0)))));
+            const int xEnd = std::min(rect.x1, static_cast<int>(std::ceil(std::min(maxX, static_cast<float>(rect.x1)))) + 1);
+            if (yStart >= yEnd || xStart >= xEnd)
+                return;
+
+            const SoftwareCommand& command = *triangle.command;
+            Gradient color[4];
+            const bool constantColor =
+                v0.c == v1.c &&
+                v0.c == v2.c;
+            for (int c = 0; c < 4; ++c)
+            {
+                if (constantColor)
+                {
+                    color[c].a = v0.c[c];
+                }
+                else
+                {
+                    color[c] = gradient(v0.p, v1.p, v2.p, v0.c[c], v1.c[c], v2.c[c], area2);
+                }
+            }
+            Gradient t[2];
+            Sampler sampler;
+            if (command.texture)
+            {
+                for (int c = 0; c < 2; ++c)
+                {
+                    t[c] = gradient(v0.p, v1.p, v2.p, v0.t[c], v1.t[c], v2.t[c], area2);
+                }
+                const SoftwareTexture& texture = *command.texture;
+                sampler.setLevel(texture, 0);
+
+                // How many texels one pixel spans, to tell minifying from
+                // magnifying and pick the level.
+                const Size2I& textureSize = texture.sizes[0];
+                const float ux = t[0].dx * textureSize.w;
+                const float vx = t[1].dx * textureSize.h;
+                const float uy = t[0].dy * textureSize.w;
+                const float vy = t[1].dy * textureSize.h;
+                const float rho = std::max(
+                    std::sqrt(ux * ux + vx * vx),
+                    std::sqrt(uy * uy + vy * vy));
+                const bool minify = rho > 1.F;
+                const ImageFilter filter = minify ?
+                    command.filters.minify :
+                    command.filters.magnify;
+                switch (filter)
+                {
+                case ImageFilter::Nearest:
+                    sampler.filter = Filter::Nearest;
+                    break;
+                case ImageFilter::HighQuality:
+                case ImageFilter::Mipmap:
+                    if (minify && texture.levels.size() > 1)
+                    {
+                        const float lambda = std::min(
+                            std::log2(rho),
+                            static_cast<float>(texture.levels.size() - 1));
+                        const size_t level = static_cast<size_t>(lambda);
+                        sampler.setLevel(texture, level);
+                        sampler.levelBlend = lambda - level;
+                        sampler.filter = level + 1 < texture.levels.size() ?
+                            Filter::Trilinear :
+                            Filter::Linear;
+                    }
+                    else
+                    {
+                        sampler.filter = Filter::Linear;
+                    }
+                    break;
+                default:
+                    sampler.filter = Filter::Linear;
+                    break;
+                }
+            }
+
+            uint32_t* pixels = reinterpret_cast<uint32_t*>(canvas);
+            for (int y = yStart; y < yEnd; ++y)
+            {
+                // Where the row of pixel centers goes in and out of each
+                // edge.
+                const double cy = y + .5;
+                int x0 = xStart;
+                int x1 = xEnd - 1;
+                bool empty = false;
+                for (const auto& e : triangle.edges)
+                {
+                    const double c = e.b * (cy - e.y) - e.a * e.x;
+                    if (e.a != 0.0)
+                    {
+                        const double limit = std::min(
+                            std::max(-c / e.a - .5, static_cast<double>(xStart - 1)),
+                            static_cast<double>(xEnd + 1));
+                        if (e.a > 0.0)
+                        {
+                            x0 = std::max(x0, static_cast<int>(e.topLeft ?
+                                std::ceil(limit) :
+                                std::floor(limit) + 1.0));
+                        }
+                        else
+                        {
+                            x1 = std::min(x1, static_cast<int>(e.topLeft ?
+                                std::floor(limit) :
+                                std::ceil(limit) - 1.0));
+                        }
+                    }
+                    else if (!(c > 0.0 || (0.0 == c && e.topLeft)))
+                    {
+                        empty = true;
+                        break;
+                    }
+                }
+                if (empty || x0 > x1)
+                    continue;
+                shadeSpan(
+                    triangle,
+                    color,
+                    constantColor,
+                    t,
+                    sampler,
+                    x0,
+                    y,
+                    static_cast<size_t>(x1 - x0 + 1),
+                    pixels + static_cast<size_t>(y) * size.w + x0);
+            }
+        }
+    }
+
+    void softwareRasterize(
+        const SoftwareCommand& command,
+        const std::vector<SoftwareVertex>& vertices,
+        uint8_t* canvas,
+        const Size2I& size,
+        int y0,
+        int y1)
+    {
+        SoftwareRect band;
+        band.x1 = size.w;
+        band.y0 = y0;
+        band.y1 = y1;
+        const SoftwareRect rect = intersect(command.bounds, band);
+        if (!rect.isValid())
+            return;
+
+        if (SoftwareShade::Clear == command.shade)
+        {
+            const uint32_t color = toWord(
+                shifts,
+                clamp01(command.clearColor.r) * 255.F,
+                clamp01(command.clearColor.g) * 255.F,
+                clamp01(command.clearColor.b) * 255.F,
+                clamp01(command.clearColor.a) * 255.F);
+            uint32_t* pixels = reinterpret_cast<uint32_t*>(canvas);
+            for (int y = rect.y0; y < rect.y1; ++y)
+            {
+                uint32_t* p = pixels + static_cast<size_t>(y) * size.w;
+                std::fill(p + rect.x0, p + rect.x1, color);
+            }
+            return;
+        }
+
+        const size_t end = command.first + command.count;
+        for (size_t i = command.first; i + 3 <= end && i + 3 <= vertices.size(); i += 3)
+        {
+            Triangle triangle;
+            triangle.command = &command;
+            triangle.v[0] = &vertices[i];
+            triangle.v[1] = &vertices[i + 1];
+            triangle.v[2] = &vertices[i + 2];
+            const V2F& p0 = triangle.v[0]->p;
+            const V2F& p1 = triangle.v[1]->p;
+            const V2F& p2 = triangle.v[2]->p;
+            float area2 = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+            if (!std::isfinite(area2) || 0.F == area2)
+                continue;
+            if (area2 < 0.F)
+            {
+                std::swap(triangle.v[1], triangle.v[2]);
+                area2 = -area2;
+            }
+            triangle.area2 = area2;
+            triangle.edges[0] = edge(triangle.v[0]->p, triangle.v[1]->p);
+            triangle.edges[1] = edge(triangle.v[1]->p, triangle.v[2]->p);
+            triangle.edges[2] = edge(triangle.v[2]->p, triangle.v[0]->p);
+            rasterizeTriangle(triangle, rect, canvas, size);
+        }
+    }
+}
@@ -5,6 +5,7 @@
 
 #include <ftk/Core/Context.h>
 
+#include <algorithm>
 #include <vector>
 
 namespace ftk
@@ -94,6 +95,11 @@ namespace ftk
         return _p->timeout;
     }
 
+    std::chrono::steady_clock::time_point Timer::getDeadline() const
+    {
+        return _p->start + _p->timeout;
+    }
+
     void Timer::tick()
     {
         FTK_P();
@@ -189,4 +195,26 @@ namespace ftk
     {
         return std::chrono::milliseconds(1);
     }
+
+    std::chrono::steady_clock::time_point TimerSystem::getNextTick(
+        const std::chrono::steady_clock::time_point& lastTick) const
+    {
+        FTK_P();
+        auto out = std::chrono::steady_clock::time_point::max();
+        for (const auto& i : p.timers)
+        {
+            if (auto timer = i.lock())
+            {
+                if (timer->isActive())
+                {
+                    out = std::min(out, timer->getDeadline());
+                }
+            }
+        }
+        if (out != std::chrono::steady_clock::time_point::max())
+        {
+            out = std::max(out, lastTick + getTickTime());
+        }
+        return out;
+    }
 }
\ No newline at end of file
@@ -56,6 +56,9 @@ namespace ftk
         //! Get the timeout.
         FTK_API const std::chrono::microseconds& getTimeout() const;
 
+        //! Get when the timer next times out.
+        FTK_API std::chrono::steady_clock::time_point getDeadline() const;
+
         FTK_API void tick();
 
     private:
@@ -79,6 +82,11 @@ namespace ftk
         FTK_API void tick() override;
         FTK_API std::chrono::milliseconds getTickTime() const override;
 
+        //! The next tick is when the first active timer times out, so an
+        //! application with no timers running is not woken for them.
+        FTK_API std::chrono::steady_clock::time_point getNextTick(
+            const std::chrono::steady_clock::time_point& lastTick) const override;
+
     private:
         FTK_PRIVATE();
     };
@@ -25,6 +25,11 @@ namespace ftk
                 .value("Symbols", FontType::Symbols);
             FTK_ENUM_BIND(m, FontType);
 
+            py::enum_<GlyphMode>(m, "GlyphMode")
+                .value("Bitmap", GlyphMode::Bitmap)
+                .value("SDF", GlyphMode::SDF);
+            FTK_ENUM_BIND(m, GlyphMode);
+
             py::class_<FontInfo>(m, "FontInfo")
                 .def(py::init<>())
                 .def(py::init<std::string, int>())
@@ -54,13 +59,25 @@ namespace ftk
                 .def_readwrite("offset", &Glyph::offset)
                 .def_readwrite("advance", &Glyph::advance)
                 .def_readwrite("lsbDelta", &Glyph::lsbDelta)
-                .def_readwrite("rsbDelta", &Glyph::rsbDelta);
+                .def_readwrite("rsbDelta", &Glyph::rsbDelta)
+                .def_readwrite("mode", &Glyph::mode)
+                .def_readwrite("scale", &Glyph::scale)
+                .def_readwrite("imageInfo", &Glyph::imageInfo);
+
+            py::class_<GlyphRun, std::shared_ptr<GlyphRun> >(m, "GlyphRun")
+                .def_readonly("glyphs", &GlyphRun::glyphs)
+                .def_readonly("size", &GlyphRun::size)
+                .def_readonly("boxes", &GlyphRun::boxes);
 
             py::class_<FontSystem, ISystem, std::shared_ptr<FontSystem> >(m, "FontSystem")
                 .def(
                     py::init(&FontSystem::create),
                     py::arg("context"))
                 .def_property_readonly("fonts", &FontSystem::getFonts)
+                .def_property(
+                    "glyphMode",
+                    &FontSystem::getGlyphMode,
+                    &FontSystem::setGlyphMode)
                 .def_property_readonly("glyphCacheSize", &FontSystem::getGlyphCacheSize)
                 .def("observeGlyphCacheSize", &FontSystem::observeGlyphCacheSize)
                 .def_property_readonly("glyphCachePercentage", &FontSystem::getGlyphCachePercentage)
@@ -81,6 +98,21 @@ namespace ftk
                     "getGlyphs",
                     &FontSystem::getGlyphs,
                     py::arg("text"),
+                    py::arg("fontInfo"))
+                .def(
+                    "getGlyphRun",
+                    [](FontSystem& self, const std::string& text, const FontInfo& fontInfo, int maxLineWidth)
+                    {
+                        return std::const_pointer_cast<GlyphRun>(
+                            self.getGlyphRun(text, fontInfo, maxLineWidth));
+                    },
+                    py::arg("text"),
+                    py::arg("fontInfo"),
+                    py::arg("maxLineWidth") = 0)
+                .def(
+                    "prefetchGlyphs",
+                    &FontSystem::prefetchGlyphs,
+                    py::arg("text"),
                     py::arg("fontInfo"));
         }
     }
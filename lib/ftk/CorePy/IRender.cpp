@@ -4,6 +4,7 @@
 #include <ftk/CorePy/Bindings.h>
 
 #include <ftk/Core/IRender.h>
+#include <ftk/Core/SoftwareRender.h>
 
 #include <pybind11/pybind11.h>
 #include <pybind11/operators.h>
@@ -24,6 +25,7 @@ namespace ftk
                     py::arg("size"),
                     py::arg("options"))
                 .def("end", &IRender::end)
+                .def("flush", &IRender::flush)
                 .def_property("renderSize", &IRender::getRenderSize, &IRender::setRenderSize)
                 .def_property("viewport", &IRender::getViewport, &IRender::setViewport)
                 .def("clearViewport", &IRender::clearViewport)
@@ -61,6 +63,13 @@ namespace ftk
                     py::arg("fontMetrics"),
                     py::arg("position"),
                     py::arg("color") = Color4F(1.F, 1.F, 1.F, 1.F));
+
+            py::class_<SoftwareRender, IRender, std::shared_ptr<SoftwareRender> >(m, "SoftwareRender")
+                .def(
+                    py::init(&SoftwareRender::create),
+                    py::arg("logSystem"),
+                    py::arg("fontSystem"))
+                .def_property_readonly("image", &SoftwareRender::getImage);
         }
     }
 }
@@ -4,6 +4,8 @@
 #include <ftk/CorePy/Bindings.h>
 
 #include <ftk/Core/Image.h>
+#include <ftk/Core/ImageConvert.h>
+#include <ftk/Core/ImageResize.h>
 
 #include <pybind11/pybind11.h>
 #include <pybind11/operators.h>
@@ -113,6 +115,47 @@ namespace ftk
                 .def_property("tags", &Image::getTags, &Image::setTags, py::return_value_policy::copy)
                 .def_property_readonly("byteCount", &Image::getByteCount)
                 .def("zero", &Image::zero);
+
+            py::enum_<ResizeFilter>(m, "ResizeFilter")
+                .value("Box", ResizeFilter::Box)
+                .value("Mitchell", ResizeFilter::Mitchell)
+                .value("Lanczos3", ResizeFilter::Lanczos3);
+            FTK_ENUM_BIND(m, ResizeFilter);
+
+            py::class_<ResizeOptions>(m, "ResizeOptions")
+                .def(py::init<>())
+                .def_readwrite("reduce", &ResizeOptions::reduce)
+                .def_readwrite("enlarge", &ResizeOptions::enlarge)
+                .def_readwrite("threads", &ResizeOptions::threads)
+                .def(py::self == py::self)
+                .def(py::self != py::self);
+
+            m.def(
+                "resize",
+                &resize,
+                py::arg("image"),
+                py::arg("size"),
+                py::arg("options") = ResizeOptions());
+
+            py::class_<ConvertOptions>(m, "ConvertOptions")
+                .def(py::init<>())
+                .def_readwrite("premultiply", &ConvertOptions::premultiply)
+                .def_readwrite("threads", &ConvertOptions::threads)
+                .def(py::self == py::self)
+                .def(py::self != py::self);
+
+            m.def(
+                "convert",
+                py::overload_cast<const Image&, ImageType, const ConvertOptions&>(&convert),
+                py::arg("image"),
+                py::arg("type"),
+                py::arg("options") = ConvertOptions());
+            m.def(
+                "convert",
+                py::overload_cast<const Image&, Image&, const ConvertOptions&>(&convert),
+                py::arg("input"),
+                py::arg("output"),
+                py::arg("options") = ConvertOptions());
         }
     }
 }
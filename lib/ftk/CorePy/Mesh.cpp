@@ -63,9 +63,32 @@ namespace ftk
                 .def_readwrite("triangles", &TriMesh3F::triangles)
                 .def("getByteCount", &TriMesh3F::getByteCount);
 
+            py::class_<IdxMesh2F>(m, "IdxMesh2F")
+                .def(py::init<>())
+                .def_readwrite("v", &IdxMesh2F::v)
+                .def_readwrite("c", &IdxMesh2F::c)
+                .def_readwrite("t", &IdxMesh2F::t)
+                .def_readwrite("indices", &IdxMesh2F::indices)
+                .def("getByteCount", &IdxMesh2F::getByteCount);
+
+            py::class_<IdxMesh3F>(m, "IdxMesh3F")
+                .def(py::init<>())
+                .def_readwrite("v", &IdxMesh3F::v)
+                .def_readwrite("c", &IdxMesh3F::c)
+                .def_readwrite("t", &IdxMesh3F::t)
+                .def_readwrite("n", &IdxMesh3F::n)
+                .def_readwrite("indices", &IdxMesh3F::indices)
+                .def("getByteCount", &IdxMesh3F::getByteCount);
+
+            m.def("indexed", [](const TriMesh2F& v) { return indexed(v); });
+            m.def("indexed", [](const TriMesh3F& v) { return indexed(v); });
+            m.def("unindexed", [](const IdxMesh2F& v) { return unindexed(v); });
+            m.def("unindexed", [](const IdxMesh3F& v) { return unindexed(v); });
+
             m.def("edge", [](const V2F& p, const V2F& v0, const V2F& v1) { return edge(p, v0, v1); });
 
             m.def("bbox", [](const TriMesh3F& v) { return bbox(v); });
+            m.def("bbox", [](const IdxMesh3F& v) { return bbox(v); });
 
             m.def("mesh", [](const Box2I& v) { return ftk::mesh(v); });
             m.def("mesh", [](const Box2I& v, bool mirrorV) { return ftk::mesh(v, mirrorV); });
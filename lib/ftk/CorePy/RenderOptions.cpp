@@ -24,6 +24,8 @@ namespace ftk
                 .def_readwrite("texturePoolByteCount", &RenderOptions::texturePoolByteCount)
                 .def_readwrite("textureCacheByteCount", &RenderOptions::textureCacheByteCount)
                 .def_readwrite("glyphAtlasSize", &RenderOptions::glyphAtlasSize)
+                .def_readwrite("glyphAtlasPages", &RenderOptions::glyphAtlasPages)
+                .def_readwrite("batch", &RenderOptions::batch)
                 .def_readwrite("log", &RenderOptions::log)
                 .def(py::self == py::self)
                 .def(py::self != py::self);
@@ -57,7 +59,8 @@ namespace ftk
             py::enum_<ImageFilter>(m, "ImageFilter")
                 .value("Nearest", ImageFilter::Nearest)
                 .value("Linear", ImageFilter::Linear)
-                .value("HighQuality", ImageFilter::HighQuality);
+                .value("HighQuality", ImageFilter::HighQuality)
+                .value("Mipmap", ImageFilter::Mipmap);
             FTK_ENUM_BIND(m, ImageFilter);
 
             py::class_<ImageFilters>(m, "ImageFilters")
@@ -47,9 +47,11 @@ namespace ftk
                 auto pack = BoxPack::create(Size2I(100, 100));
                 for (size_t i = 0; i < 5; ++i)
                 {
+                    FTK_CHECK(pack->hasRoom(Size2I(50, 50)) == (i < 4));
                     auto node = pack->insert(Size2I(50, 50));
                     FTK_CHECK(node);
                 }
+                FTK_CHECK(!pack->hasRoom(Size2I(101, 1)));
                 _printPack(pack);
             }
             {
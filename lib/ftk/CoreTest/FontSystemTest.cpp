@@ -8,6 +8,9 @@
 #include <ftk/Core/FontSystem.h>
 #include <ftk/Core/Format.h>
 
+#include <atomic>
+#include <thread>
+
 namespace ftk
 {
     namespace core_test
@@ -29,6 +32,8 @@ namespace ftk
         {
             _info();
             _size();
+            _threads();
+            _sdf();
             _add();
         }
 
@@ -86,6 +91,14 @@ namespace ftk
                     _print(Format("{0} size: {1}").arg(s).arg(size));
                     boxes = fontSystem->getBoxes(s, info, 1);
 
+                    auto run = fontSystem->getGlyphRun(s, info, 1);
+                    FTK_CHECK(run);
+                    FTK_CHECK(run == fontSystem->getGlyphRun(s, info, 1));
+                    FTK_CHECK(run != fontSystem->getGlyphRun(s, info));
+                    FTK_CHECK(size == run->size);
+                    FTK_CHECK(boxes == run->boxes);
+                    FTK_CHECK(s.size() == run->glyphs.size());
+
                     _print(Format("Glyph cache: {0} {1}%").
                         arg(fontSystem->getGlyphCacheSize()).
                         arg(fontSystem->getGlyphCachePercentage()));
@@ -93,6 +106,98 @@ namespace ftk
             }
         }
 
+        void FontSystemTest::_threads()
+        {
+            {
+                auto fontSystem = _context->getSystem<FontSystem>();
+                const FontInfo info(getDefaultFont(FontType::Regular), 17);
+                const std::string s = "The quick brown fox";
+                fontSystem->prefetchGlyphs(s, info);
+
+                std::vector<Size2I> sizes(4);
+                std::vector<std::thread> threads;
+                for (size_t i = 0; i < sizes.size(); ++i)
+                {
+                    threads.push_back(std::thread(
+                        [fontSystem, info, s, &sizes, i]
+                        {
+                            const FontInfo info2(info.name, info.size + static_cast<int>(i));
+                            fontSystem->getMetrics(info2);
+                            sizes[i] = fontSystem->getSize(s, info);
+                            fontSystem->getGlyphs(s, info2);
+                        }));
+                }
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                const Size2I size = fontSystem->getSize(s, info);
+                for (const auto& i : sizes)
+                {
+                    FTK_CHECK(size == i);
+                }
+            }
+        }
+
+        void FontSystemTest::_sdf()
+        {
+            FTK_TEST_ENUM(GlyphMode);
+            {
+                auto fontSystem = _context->getSystem<FontSystem>();
+                fontSystem->setGlyphMode(GlyphMode::SDF);
+#if defined(FTK_API_GLES_2)
+                FTK_CHECK(GlyphMode::Bitmap == fontSystem->getGlyphMode());
+#else // FTK_API_GLES_2
+                FTK_CHECK(GlyphMode::SDF == fontSystem->getGlyphMode());
+                const FontInfo a(getDefaultFont(FontType::Regular), 12);
+                const FontInfo b(getDefaultFont(FontType::Regular), 24);
+                const auto glyphsA = fontSystem->getGlyphs("Ag ", a);
+                const auto glyphsB = fontSystem->getGlyphs("Ag ", b);
+                FTK_CHECK(3 == glyphsA.size());
+                FTK_CHECK(3 == glyphsB.size());
+                for (size_t i = 0; i < glyphsA.size(); ++i)
+                {
+                    FTK_CHECK(GlyphMode::SDF == glyphsA[i]->mode);
+                    FTK_CHECK(glyphsA[i]->image == glyphsB[i]->image);
+                    FTK_CHECK(glyphsA[i]->imageInfo == glyphsB[i]->imageInfo);
+                    FTK_CHECK(glyphsA[i]->scale * 2.F == glyphsB[i]->scale);
+                }
+                FTK_CHECK(glyphsA[0]->image);
+                FTK_CHECK(!glyphsA[2]->image);
+                FTK_CHECK(glyphsA[2]->advance > 0);
+#endif // FTK_API_GLES_2
+                fontSystem->setGlyphMode(GlyphMode::Bitmap);
+                FTK_CHECK(GlyphMode::Bitmap == fontSystem->getGlyphMode());
+                FTK_CHECK(GlyphMode::Bitmap == fontSystem->getGlyphs("A", FontInfo())[0]->mode);
+            }
+            {
+                // Runs built while the glyph mode changes are not cached.
+                auto fontSystem = _context->getSystem<FontSystem>();
+                std::atomic<bool> running(true);
+                std::thread thread(
+                    [fontSystem, &running]
+                    {
+                        while (running)
+                        {
+                            fontSystem->getGlyphRun("Glyph run", FontInfo());
+                        }
+                    });
+                for (size_t i = 0; i < 10; ++i)
+                {
+                    fontSystem->setGlyphMode(GlyphMode::SDF);
+                    fontSystem->setGlyphMode(GlyphMode::Bitmap);
+                }
+                running = false;
+                thread.join();
+                const auto run = fontSystem->getGlyphRun("Glyph run", FontInfo());
+                FTK_CHECK(run);
+                for (const auto& glyph : run->glyphs)
+                {
+                    FTK_CHECK(GlyphMode::Bitmap == glyph->mode);
+                }
+            }
+        }
+
         void FontSystemTest::_add()
         {
             {
@@ -25,6 +25,8 @@ namespace ftk
         private:
             void _info();
             void _size();
+            void _threads();
+            void _sdf();
             void _add();
         };
     }
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/CoreTest/ImageConvertTest.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Format.h>
+#include <ftk/Core/ImageConvert.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        ImageConvertTest::ImageConvertTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::core_test::ImageConvertTest")
+        {}
+
+        ImageConvertTest::~ImageConvertTest()
+        {}
+
+        std::shared_ptr<ImageConvertTest> ImageConvertTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<ImageConvertTest>(new ImageConvertTest(context));
+        }
+
+        void ImageConvertTest::run()
+        {
+            _options();
+            _convert();
+            _yuv();
+        }
+
+        void ImageConvertTest::_options()
+        {
+            ConvertOptions a;
+            ConvertOptions b;
+            FTK_CHECK(a == b);
+            b.premultiply = true;
+            FTK_CHECK(a != b);
+        }
+
+        namespace
+        {
+            std::shared_ptr<Image> createRGBA(int w, int h, float r, float g, float b, float a)
+            {
+                auto out = Image::create(w, h, ImageType::RGBA_F32);
+                float* p = reinterpret_cast<float*>(out->getData());
+                for (size_t i = 0; i < static_cast<size_t>(w) * h; ++i, p += 4)
+                {
+                    p[0] = r;
+                    p[1] = g;
+                    p[2] = b;
+                    p[3] = a;
+                }
+                return out;
+            }
+
+            bool isRGBA(const Image& image, float r, float g, float b, float a, float tolerance)
+            {
+                auto rgba = convert(image, ImageType::RGBA_F32);
+                const float* p = reinterpret_cast<const float*>(rgba->getData());
+                bool out = true;
+                for (size_t i = 0; i < rgba->getByteCount() / sizeof(float); i += 4)
+                {
+                    out &=
+                        std::fabs(p[i] - r) <= tolerance &&
+                        std::fabs(p[i + 1] - g) <= tolerance &&
+                        std::fabs(p[i + 2] - b) <= tolerance &&
+                        std::fabs(p[i + 3] - a) <= tolerance;
+                }
+                return out;
+            }
+        }
+
+        void ImageConvertTest::_convert()
+        {
+            try
+            {
+                auto a = Image::create(10, 10, ImageType::L_U8);
+                auto b = Image::create(20, 10, ImageType::RGBA_U8);
+                convert(*a, *b);
+                FTK_CHECK(false);
+            }
+            catch (const std::exception&)
+            {}
+            {
+                // White goes to and from every type.
+                auto white = createRGBA(37, 21, 1.F, 1.F, 1.F, 1.F);
+                for (auto type : getImageTypeEnums())
+                {
+                    if (ImageType::None == type)
+                        continue;
+                    auto image = convert(*white, type);
+                    FTK_CHECK(type == image->getType());
+                    FTK_CHECK(white->getSize() == image->getSize());
+                    FTK_CHECK(isRGBA(*image, 1.F, 1.F, 1.F, 1.F, .01F));
+                    for (auto type2 : getImageTypeEnums())
+                    {
+                        if (ImageType::None == type2)
+                            continue;
+                        FTK_CHECK(isRGBA(*convert(*image, type2), 1.F, 1.F, 1.F, 1.F, .01F));
+                    }
+                }
+            }
+            {
+                // Luminance is repeated and alpha filled.
+                auto image = Image::create(3, 2, ImageType::L_U8);
+                memset(image->getData(), 0, image->getByteCount());
+                image->getData()[1] = 100;
+                auto out = convert(*image, ImageType::RGBA_U8);
+                const uint8_t* p = out->getData();
+                FTK_CHECK(0 == p[0] && 0 == p[1] && 0 == p[2] && 255 == p[3]);
+                FTK_CHECK(100 == p[4] && 100 == p[5] && 100 == p[6] && 255 == p[7]);
+                out = convert(*out, ImageType::LA_U8);
+                p = out->getData();
+                FTK_CHECK(100 == p[2] && 255 == p[3]);
+            }
+            {
+                // Color is reduced with the luma weights.
+                auto red = convert(*createRGBA(2, 2, 1.F, 0.F, 0.F, 1.F), ImageType::RGB_U8);
+                auto out = convert(*red, ImageType::L_U8);
+                FTK_CHECK(54 == out->getData()[0]);
+                out = convert(*red, ImageType::L_U16);
+                FTK_CHECK(isRGBA(*out, .2126F, .2126F, .2126F, 1.F, .0001F));
+            }
+            {
+                ConvertOptions options;
+                options.premultiply = true;
+                auto image = createRGBA(2, 2, 1.F, .5F, 0.F, .5F);
+                auto out = convert(*image, ImageType::RGBA_U8, options);
+                const uint8_t* p = out->getData();
+                FTK_CHECK(128 == p[0] && 64 == p[1] && 0 == p[2] && 128 == p[3]);
+            }
+            {
+                // A change of mirroring flips the rows.
+                auto image = Image::create(2, 2, ImageType::L_U8);
+                const uint8_t data[] = { 1, 2, 3, 4 };
+                memcpy(image->getData(), data, 4);
+                ImageInfo info(2, 2, ImageType::RGBA_U16);
+                info.layout.mirror.y = true;
+                auto out = Image::create(info);
+                convert(*image, *out);
+                const uint16_t* p = reinterpret_cast<const uint16_t*>(out->getData());
+                FTK_CHECK(3 * 257 == p[0]);
+                FTK_CHECK(2 * 257 == p[12]);
+            }
+            {
+                // Enough work to be shared out over the threads.
+                auto image = createRGBA(1024, 512, .25F, .5F, .75F, 1.F);
+                for (auto type : {
+                    ImageType::RGB_U8,
+                    ImageType::RGB_U10,
+                    ImageType::RGBA_F16,
+                    ImageType::YUV_444P_U16 })
+                {
+                    auto out = convert(*image, type);
+                    FTK_CHECK(isRGBA(*out, .25F, .5F, .75F, 1.F, .01F));
+                }
+            }
+        }
+
+        void ImageConvertTest::_yuv()
+        {
+            for (auto type : {
+                ImageType::YUV_420P_U8,
+                ImageType::YUV_422P_U8,
+                ImageType::YUV_444P_U8,
+                ImageType::YUV_420P_U16,
+                ImageType::YUV_422P_U16,
+                ImageType::YUV_444P_U16,
+                ImageType::YUV_420SP_U8,
+                ImageType::YUV_420SP_U16 })
+            {
+                for (const auto& size : { Size2I(16, 16), Size2I(17, 9) })
+                {
+                    auto image = createRGBA(size.w, size.h, .8F, .4F, .2F, 1.F);
+                    auto yuv = convert(*image, type);
+                    FTK_CHECK(VideoLevels::FullRange == yuv->getInfo().videoLevels);
+                    FTK_CHECK(isRGBA(*yuv, .8F, .4F, .2F, 1.F, .01F));
+                }
+            }
+            {
+                // Legal range white.
+                ImageInfo info(4, 4, ImageType::YUV_420P_U8);
+                info.videoLevels = VideoLevels::LegalRange;
+                auto image = Image::create(info);
+                memset(image->getData(), 235, 16);
+                memset(image->getData() + 16, 128, 8);
+                auto out = convert(*image, ImageType::RGB_U8);
+                FTK_CHECK(VideoLevels::FullRange == out->getInfo().videoLevels);
+                FTK_CHECK(255 == out->getData()[0]);
+                FTK_CHECK(255 == out->getData()[1]);
+                FTK_CHECK(255 == out->getData()[2]);
+
+                // Legal range is kept between YUV types.
+                auto yuv = convert(*image, ImageType::YUV_444P_U16);
+                FTK_CHECK(VideoLevels::LegalRange == yuv->getInfo().videoLevels);
+                FTK_CHECK(isRGBA(*yuv, 1.F, 1.F, 1.F, 1.F, .01F));
+            }
+        }
+    }
+}
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/TestLib/ITest.h>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        class ImageConvertTest : public test::ITest
+        {
+        protected:
+            ImageConvertTest(const std::shared_ptr<Context>&);
+
+        public:
+            virtual ~ImageConvertTest();
+
+            static std::shared_ptr<ImageConvertTest> create(
+                const std::shared_ptr<Context>&);
+
+            void run() override;
+            
+        private:
+            void _options();
+            void _convert();
+            void _yuv();
+        };
+    }
+}
@@ -7,6 +7,11 @@
 #include <ftk/Core/Context.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/ImageIO.h>
+#include <ftk/Core/ImagePrefetch.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
 
 namespace ftk
 {
@@ -29,10 +34,49 @@ namespace ftk
         {
             _members();
             _functions();
+            _reader();
+            _async();
+            _prefetch();
         }
         
         namespace
         {
+            // A reader with only the required functions, each pixel the
+            // row from the top.
+            class DummyReader : public IImageReader
+            {
+            public:
+                DummyReader(
+                    const ImageInfo& info,
+                    const std::filesystem::path& path = "Dummy.dum") :
+                    IImageReader(path, nullptr, ImageIOOptions()),
+                    _info(info)
+                {}
+
+                const ImageInfo& getInfo() const override
+                {
+                    return _info;
+                }
+
+                std::shared_ptr<Image> read() override
+                {
+                    if (_path.stem() == "Slow")
+                    {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    }
+                    auto out = Image::create(_info);
+                    for (int y = 0; y < _info.size.h; ++y)
+                    {
+                        memset(out->getData() + (_info.size.h - 1 - y) * _info.size.w, y, _info.size.w);
+                    }
+                    out->setTags({ { "Path", _path.filename().u8string() } });
+                    return out;
+                }
+
+            private:
+                ImageInfo _info;
+            };
+
             class DummyPlugin : public IImagePlugin
             {
             protected:
@@ -48,6 +92,15 @@ namespace ftk
                 {
                     return std::shared_ptr<DummyPlugin>(new DummyPlugin);
                 }
+
+                std::shared_ptr<IImageReader> read(
+                    const std::filesystem::path& path,
+                    const ImageIOOptions&) override
+                {
+                    return std::make_shared<DummyReader>(
+                        ImageInfo(16, 8, ImageType::L_U8),
+                        path);
+                }
             };
         }
         
@@ -75,6 +128,201 @@ namespace ftk
             FTK_CHECK(options3["Layer"] == "1");
             FTK_CHECK(options3["Compression"] == "RLE");
         }
+
+        void ImageIOTest::_reader()
+        {
+            const ImageInfo info(16, 8, ImageType::L_U8);
+            {
+                std::shared_ptr<IImageReader> reader = std::make_shared<DummyReader>(info);
+                auto image = reader->read(Box2I(4, 2, 100, 3));
+                FTK_CHECK(Size2I(12, 3) == image->getSize());
+                FTK_CHECK(2 == image->getData()[2 * 12]);
+                FTK_CHECK(4 == image->getData()[0]);
+            }
+            try
+            {
+                std::shared_ptr<IImageReader> reader = std::make_shared<DummyReader>(info);
+                reader->read(Box2I(-10, -10, 5, 5));
+                FTK_CHECK(false);
+            }
+            catch (const std::exception&)
+            {}
+            {
+                std::shared_ptr<IImageReader> reader = std::make_shared<DummyReader>(info);
+                ImageInfo info2 = info;
+                info2.layout.mirror.y = true;
+                auto image = Image::create(info2);
+                reader->read(image);
+                FTK_CHECK(0 == image->getData()[0]);
+                FTK_CHECK(7 == image->getData()[7 * 16]);
+            }
+            try
+            {
+                std::shared_ptr<IImageReader> reader = std::make_shared<DummyReader>(info);
+                reader->read(Image::create(8, 8, ImageType::L_U8));
+                FTK_CHECK(false);
+            }
+            catch (const std::exception&)
+            {}
+        }
+
+        void ImageIOTest::_async()
+        {
+            auto io = _context->getSystem<ImageIO>();
+            io->setThreadCount(2);
+            FTK_CHECK(2 == io->getThreadCount());
+            {
+                std::vector<ImageRequest> requests;
+                for (int i = 0; i < 4; ++i)
+                {
+                    requests.push_back(io->readAsync(Format("Async{0}.dum").arg(i).str()));
+                }
+                for (int i = 0; i < 4; ++i)
+                {
+                    auto image = requests[i].future.get();
+                    FTK_CHECK(image);
+                    FTK_CHECK(Size2I(16, 8) == image->getSize());
+                    FTK_CHECK(Format("Async{0}.dum").arg(i).str() == image->getTags().at("Path"));
+                }
+            }
+            {
+                auto request = io->readAsync("Missing.png");
+                FTK_CHECK(!request.future.get());
+            }
+            {
+                // The callback is given the image, or null when the file
+                // cannot be read.
+                auto promise = std::make_shared<std::promise<std::shared_ptr<Image> > >();
+                auto future = promise->get_future();
+                io->readAsync(
+                    "Callback.dum",
+                    [promise](const std::shared_ptr<Image>& value)
+                    {
+                        promise->set_value(value);
+                    });
+                auto image = future.get();
+                FTK_CHECK(image);
+                FTK_CHECK("Callback.dum" == image->getTags().at("Path"));
+                promise = std::make_shared<std::promise<std::shared_ptr<Image> > >();
+                future = promise->get_future();
+                io->readAsync(
+                    "Missing.png",
+                    [promise](const std::shared_ptr<Image>& value)
+                    {
+                        promise->set_value(value);
+                    });
+                FTK_CHECK(!future.get());
+            }
+            {
+                // A finished request wakes the event loop.
+                auto wakeups = std::make_shared<std::atomic<int> >(0);
+                _context->setWakeup([wakeups] { ++(*wakeups); });
+                FTK_CHECK(io->readAsync("Wakeup.dum").future.get());
+                for (int i = 0; i < 1000 && 0 == *wakeups; ++i)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                FTK_CHECK(*wakeups > 0);
+                _context->setWakeup(nullptr);
+            }
+            {
+                const std::filesystem::path path = _getTempDir() / "ImageIOTest_Async.png";
+                auto image = Image::create(16, 8, ImageType::RGBA_U8);
+                image->zero();
+                FTK_CHECK(io->writeAsync(path, image).get());
+                auto image2 = io->readAsync(path).future.get();
+                FTK_CHECK(image2);
+                FTK_CHECK(image->getInfo().size == image2->getInfo().size);
+                FTK_CHECK(!io->writeAsync(path, nullptr).get());
+                FTK_CHECK(!io->writeAsync(_getTempDir() / "ImageIOTest_Async.dum", image).get());
+            }
+            {
+                // With one worker busy on slow reads, the requests at the
+                // end of the queue are cancelled before they start.
+                io->setThreadCount(1);
+                std::vector<ImageRequest> requests;
+                std::vector<uint64_t> ids;
+                for (int i = 0; i < 10; ++i)
+                {
+                    requests.push_back(io->readAsync("Slow.dum"));
+                    ids.push_back(requests.back().id);
+                }
+                io->cancelRequests(ids);
+                std::vector<std::shared_ptr<Image> > images;
+                for (auto& request : requests)
+                {
+                    images.push_back(request.future.get());
+                }
+                FTK_CHECK(!images.back());
+            }
+            io->setThreadCount(0);
+        }
+
+        namespace
+        {
+            void waitCached(
+                const std::shared_ptr<ImagePrefetch>& prefetch,
+                size_t count)
+            {
+                for (int i = 0; i < 1000 && prefetch->getCachedFrames().size() < count; ++i)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        }
+
+        void ImageIOTest::_prefetch()
+        {
+            {
+                ImagePrefetchOptions a;
+                ImagePrefetchOptions b;
+                FTK_CHECK(a == b);
+                b.ahead = 1;
+                FTK_CHECK(a != b);
+            }
+            {
+                Path path("render.0001.dum");
+                path.setFrames(RangeI64(1, 20));
+                auto prefetch = ImagePrefetch::create(_context, path);
+                FTK_CHECK(path == prefetch->getPath());
+                FTK_CHECK(RangeI64(1, 20) == prefetch->getRange());
+                ImagePrefetchOptions options;
+                options.ahead = 4;
+                options.behind = 1;
+                prefetch->setOptions(options);
+                FTK_CHECK(options == prefetch->getOptions());
+                FTK_CHECK(1 == prefetch->getFrame());
+                waitCached(prefetch, 5);
+                FTK_CHECK(std::vector<int64_t>({ 1, 2, 3, 4, 5 }) == prefetch->getCachedFrames());
+                auto image = prefetch->getImage(3);
+                FTK_CHECK(image);
+                FTK_CHECK("render.0003.dum" == image->getTags().at("Path"));
+
+                prefetch->setFrame(10);
+                FTK_CHECK(10 == prefetch->getFrame());
+                FTK_CHECK(!prefetch->getImage(3));
+                waitCached(prefetch, 6);
+                FTK_CHECK(std::vector<int64_t>({ 9, 10, 11, 12, 13, 14 }) == prefetch->getCachedFrames());
+
+                prefetch->setFrame(100);
+                FTK_CHECK(20 == prefetch->getFrame());
+                waitCached(prefetch, 2);
+                FTK_CHECK(std::vector<int64_t>({ 19, 20 }) == prefetch->getCachedFrames());
+            }
+            {
+                // Frames missing from a partial sequence are not read.
+                Path path("render.0001.dum");
+                path.setSeq({ FrameSeq(1, 3), FrameSeq(6, 8) });
+                auto prefetch = ImagePrefetch::create(_context, path);
+                waitCached(prefetch, 6);
+                FTK_CHECK(std::vector<int64_t>({ 1, 2, 3, 6, 7, 8 }) == prefetch->getCachedFrames());
+            }
+            {
+                auto prefetch = ImagePrefetch::create(_context, Path("image.dum"));
+                FTK_CHECK(RangeI64(0, 0) == prefetch->getRange());
+                waitCached(prefetch, 1);
+                FTK_CHECK(prefetch->getImage(0));
+            }
+        }
     }
 }
-
@@ -25,6 +25,9 @@ namespace ftk
         private:
             void _members();
             void _functions();
+            void _reader();
+            void _async();
+            void _prefetch();
         };
     }
 }
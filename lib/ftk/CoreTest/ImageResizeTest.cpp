@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/CoreTest/ImageResizeTest.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Format.h>
+#include <ftk/Core/ImageResize.h>
+
+#include <cstring>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        ImageResizeTest::ImageResizeTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::core_test::ImageResizeTest")
+        {}
+
+        ImageResizeTest::~ImageResizeTest()
+        {}
+
+        std::shared_ptr<ImageResizeTest> ImageResizeTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<ImageResizeTest>(new ImageResizeTest(context));
+        }
+
+        void ImageResizeTest::run()
+        {
+            _enums();
+            _options();
+            _resize();
+        }
+
+        void ImageResizeTest::_enums()
+        {
+            FTK_TEST_ENUM(ResizeFilter);
+        }
+
+        void ImageResizeTest::_options()
+        {
+            ResizeOptions a;
+            ResizeOptions b;
+            FTK_CHECK(a == b);
+            b.reduce = ResizeFilter::Box;
+            FTK_CHECK(a != b);
+        }
+
+        void ImageResizeTest::_resize()
+        {
+            FTK_CHECK(!resize(nullptr, Size2I(10, 10)));
+            FTK_CHECK(!resize(Image::create(10, 10, ImageType::L_U8), Size2I()));
+            for (auto type : getImageTypeEnums())
+            {
+                if (ImageType::None == type)
+                    continue;
+                for (auto filter : getResizeFilterEnums())
+                {
+                    ResizeOptions options;
+                    options.reduce = filter;
+                    options.enlarge = filter;
+                    auto image = Image::create(37, 21, type);
+                    image->zero();
+                    for (const auto& size : { Size2I(10, 7), Size2I(80, 50), Size2I(1, 1) })
+                    {
+                        auto out = resize(image, size, options);
+                        FTK_CHECK(out);
+                        FTK_CHECK(size == out->getSize());
+                        FTK_CHECK(type == out->getType());
+                        std::vector<uint8_t> zero(out->getByteCount(), 0);
+                        FTK_CHECK(0 == memcmp(out->getData(), zero.data(), zero.size()));
+                    }
+                }
+            }
+            {
+                // A flat image stays flat, whatever the filter rings.
+                auto image = Image::create(64, 32, ImageType::RGBA_U8);
+                memset(image->getData(), 128, image->getByteCount());
+                for (auto filter : getResizeFilterEnums())
+                {
+                    ResizeOptions options;
+                    options.reduce = filter;
+                    options.enlarge = filter;
+                    for (const auto& size : { Size2I(7, 5), Size2I(200, 100) })
+                    {
+                        auto out = resize(image, size, options);
+                        bool flat = true;
+                        for (size_t i = 0; i < out->getByteCount(); ++i)
+                        {
+                            flat &= 128 == out->getData()[i];
+                        }
+                        FTK_CHECK(flat);
+                    }
+                }
+            }
+            {
+                // Halving with the box filter averages pairs.
+                auto image = Image::create(8, 2, ImageType::L_U8);
+                for (int y = 0; y < 2; ++y)
+                {
+                    for (int x = 0; x < 8; ++x)
+                    {
+                        image->getData()[y * 8 + x] = x * 32;
+                    }
+                }
+                ResizeOptions options;
+                options.reduce = ResizeFilter::Box;
+                options.threads = 1;
+                auto out = resize(image, Size2I(4, 1), options);
+                FTK_CHECK(16 == out->getData()[0]);
+                FTK_CHECK(80 == out->getData()[1]);
+                FTK_CHECK(144 == out->getData()[2]);
+                FTK_CHECK(208 == out->getData()[3]);
+            }
+            {
+                // Enough work to be shared out over the threads.
+                auto image = Image::create(1024, 512, ImageType::RGB_U8);
+                memset(image->getData(), 200, image->getByteCount());
+                auto out = resize(image, Size2I(640, 480));
+                FTK_CHECK(200 == out->getData()[0]);
+                FTK_CHECK(200 == out->getData()[out->getByteCount() - 1]);
+            }
+        }
+    }
+}
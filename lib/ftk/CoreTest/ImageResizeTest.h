@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/TestLib/ITest.h>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        class ImageResizeTest : public test::ITest
+        {
+        protected:
+            ImageResizeTest(const std::shared_ptr<Context>&);
+
+        public:
+            virtual ~ImageResizeTest();
+
+            static std::shared_ptr<ImageResizeTest> create(
+                const std::shared_ptr<Context>&);
+
+            void run() override;
+            
+        private:
+            void _enums();
+            void _options();
+            void _resize();
+        };
+    }
+}
+
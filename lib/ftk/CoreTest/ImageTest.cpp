@@ -30,6 +30,7 @@ namespace ftk
             _info();
             _members();
             _functions();
+            _pool();
         }
         
         void ImageTest::_enums()
@@ -117,6 +118,73 @@ namespace ftk
                     arg(getYUVCoefficients(i)));
             }
         }
+
+        void ImageTest::_pool()
+        {
+            {
+                ImagePoolOptions a;
+                ImagePoolOptions b;
+                FTK_CHECK(a == b);
+                b.hugePages = true;
+                FTK_CHECK(a != b);
+            }
+            const ImagePoolOptions options = Image::getPoolOptions();
+            Image::clearPool();
+            {
+                // A frame the same size as the last one reuses its memory.
+                const ImagePoolStats stats = Image::getPoolStats();
+                FTK_CHECK(0 == stats.byteCount);
+                FTK_CHECK(0 == stats.blockCount);
+                const uint8_t* data = nullptr;
+                {
+                    auto image = Image::create(1920, 1080, ImageType::RGBA_U8);
+                    data = image->getData();
+                    FTK_CHECK(0 == reinterpret_cast<uintptr_t>(data) % 64);
+                }
+                FTK_CHECK(Image::getPoolStats().blockCount == 1);
+                FTK_CHECK(Image::getPoolStats().byteCount >= 1920 * 1080 * 4);
+                {
+                    auto image = Image::create(1918, 1080, ImageType::RGBA_U8);
+                    FTK_CHECK(data == image->getData());
+                    FTK_CHECK(0 == Image::getPoolStats().blockCount);
+                }
+                FTK_CHECK(Image::getPoolStats().reuses == stats.reuses + 1);
+            }
+            {
+                // Small images are aligned too.
+                std::vector<std::shared_ptr<Image> > images;
+                for (int i = 1; i < 100; ++i)
+                {
+                    images.push_back(Image::create(i, 1, ImageType::L_U8));
+                    FTK_CHECK(0 == reinterpret_cast<uintptr_t>(images.back()->getData()) % 64);
+                }
+            }
+            {
+                // The pool does not grow past its limit.
+                ImagePoolOptions small;
+                small.maxByteCount = megabyte;
+                Image::setPoolOptions(small);
+                FTK_CHECK(small == Image::getPoolOptions());
+                FTK_CHECK(Image::getPoolStats().byteCount <= megabyte);
+                Image::clearPool();
+                {
+                    auto image = Image::create(1024, 1024, ImageType::RGBA_U8);
+                    auto image2 = Image::create(100, 100, ImageType::RGBA_U8);
+                }
+                FTK_CHECK(Image::getPoolStats().byteCount <= megabyte);
+                FTK_CHECK(1 == Image::getPoolStats().blockCount);
+            }
+            {
+                ImagePoolOptions huge;
+                huge.hugePages = true;
+                Image::setPoolOptions(huge);
+                auto image = Image::create(3840, 2160, ImageType::RGBA_F16);
+                image->zero();
+                FTK_CHECK(0 == reinterpret_cast<uintptr_t>(image->getData()) % 4096);
+            }
+            Image::setPoolOptions(options);
+            Image::clearPool();
+            FTK_CHECK(0 == Image::getPoolStats().byteCount);
+        }
     }
 }
-
@@ -26,6 +26,7 @@ namespace ftk
         void MeshTest::run()
         {
             _members();
+            _functions();
         }
         
         void MeshTest::_members()
@@ -57,6 +58,49 @@ namespace ftk
                 FTK_CHECK(4 == v.c);
             }
         }
+
+        void MeshTest::_functions()
+        {
+            {
+                const TriMesh2F mesh = ftk::mesh(Box2F(0.F, 0.F, 1.F, 1.F));
+                const IdxMesh2F idx = indexed(mesh);
+                FTK_CHECK(4 == idx.v.size());
+                FTK_CHECK(4 == idx.t.size());
+                FTK_CHECK(idx.c.empty());
+                FTK_CHECK(6 == idx.indices.size());
+                FTK_CHECK(idx.getByteCount() < mesh.getByteCount());
+                const TriMesh2F mesh2 = unindexed(idx);
+                FTK_CHECK(mesh2.triangles.size() == mesh.triangles.size());
+                for (size_t i = 0; i < mesh.triangles.size(); ++i)
+                {
+                    for (size_t k = 0; k < 3; ++k)
+                    {
+                        const auto& a = mesh.triangles[i].v[k];
+                        const auto& b = mesh2.triangles[i].v[k];
+                        FTK_CHECK(mesh.v[a.v - 1] == mesh2.v[b.v - 1]);
+                        FTK_CHECK(mesh.t[a.t - 1] == mesh2.t[b.t - 1]);
+                    }
+                }
+            }
+            {
+                const TriMesh3F mesh = sphere(1.F, 8, 8);
+                const IdxMesh3F idx = indexed(mesh);
+                FTK_CHECK(idx.v.size() <= mesh.triangles.size() * 3);
+                FTK_CHECK(idx.indices.size() == mesh.triangles.size() * 3);
+                FTK_CHECK(bbox(idx) == bbox(mesh));
+                const TriMesh3F mesh2 = unindexed(idx);
+                FTK_CHECK(mesh2.triangles.size() == mesh.triangles.size());
+                for (size_t i = 0; i < mesh.triangles.size(); ++i)
+                {
+                    for (size_t k = 0; k < 3; ++k)
+                    {
+                        const auto& a = mesh.triangles[i].v[k];
+                        const auto& b = mesh2.triangles[i].v[k];
+                        FTK_CHECK(mesh.v[a.v - 1] == mesh2.v[b.v - 1]);
+                    }
+                }
+            }
+        }
     }
 }
 
@@ -24,6 +24,7 @@ namespace ftk
 
         private:
             void _members();
+            void _functions();
         };
     }
 }
@@ -8,6 +8,9 @@
 #include <ftk/Core/FileIO.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/ImageIO.h>
+#include <ftk/Core/Memory.h>
+
+#include <cstring>
 
 namespace ftk
 {
@@ -27,6 +30,14 @@ namespace ftk
         }
         
         void PNGTest::run()
+        {
+            _io();
+            _region();
+            _options();
+            _readImages();
+        }
+
+        void PNGTest::_io()
         {
             {
                 auto io = _context->getSystem<ImageIO>();
@@ -102,6 +113,180 @@ namespace ftk
                 }
             }
         }
+
+        namespace
+        {
+            // An image where each pixel holds its position from the top
+            // left, stored from the bottom as the writer expects.
+            std::shared_ptr<Image> createGradient(const Size2I& size)
+            {
+                auto out = Image::create(size, ImageType::RGBA_U8);
+                for (int y = 0; y < size.h; ++y)
+                {
+                    uint8_t* p = out->getData() + (size.h - 1 - y) * size.w * 4;
+                    for (int x = 0; x < size.w; ++x, p += 4)
+                    {
+                        p[0] = x;
+                        p[1] = y;
+                        p[2] = 0;
+                        p[3] = 255;
+                    }
+                }
+                return out;
+            }
+        }
+
+        void PNGTest::_region()
+        {
+            auto io = _context->getSystem<ImageIO>();
+            const Size2I size(64, 32);
+            auto image = createGradient(size);
+            const std::filesystem::path path = _getTempDir() / "PNGTest_Region.png";
+            io->write(path, image->getInfo())->write(image);
+            {
+                auto read = io->read(path);
+                auto region = read->read(Box2I(10, 5, 20, 8));
+                FTK_CHECK(Size2I(20, 8) == region->getSize());
+                FTK_CHECK(region->getInfo().layout.mirror.y);
+                bool match = true;
+                for (int y = 0; y < 8; ++y)
+                {
+                    const uint8_t* p = region->getData() + y * 20 * 4;
+                    for (int x = 0; x < 20; ++x, p += 4)
+                    {
+                        match &= 10 + x == p[0] && 5 + y == p[1];
+                    }
+                }
+                FTK_CHECK(match);
+            }
+            {
+                // Clipped to the image.
+                auto read = io->read(path);
+                auto region = read->read(Box2I(60, 30, 10, 10));
+                FTK_CHECK(Size2I(4, 2) == region->getSize());
+                FTK_CHECK(60 == region->getData()[0]);
+                FTK_CHECK(30 == region->getData()[1]);
+            }
+            try
+            {
+                auto read = io->read(path);
+                read->read(Box2I(100, 100, 10, 10));
+                FTK_CHECK(false);
+            }
+            catch (const std::exception&)
+            {}
+            {
+                // Into an image stored from the bottom.
+                auto read = io->read(path);
+                auto out = Image::create(size, ImageType::RGBA_U8);
+                read->read(out);
+                FTK_CHECK(0 == memcmp(out->getData(), image->getData(), image->getByteCount()));
+            }
+            try
+            {
+                auto read = io->read(path);
+                read->read(Image::create(size, ImageType::RGB_U8));
+                FTK_CHECK(false);
+            }
+            catch (const std::exception&)
+            {}
+            try
+            {
+                // A reader reads once.
+                auto read = io->read(path);
+                read->read();
+                read->read();
+                FTK_CHECK(false);
+            }
+            catch (const std::exception&)
+            {}
+            {
+                // Into an image with the other byte order.
+                auto image16 = Image::create(size, ImageType::L_U16);
+                uint16_t* p = reinterpret_cast<uint16_t*>(image16->getData());
+                for (int i = 0; i < size.w * size.h; ++i)
+                {
+                    p[i] = static_cast<uint16_t>(i * 31);
+                }
+                const std::filesystem::path path16 = _getTempDir() / "PNGTest_Region16.png";
+                io->write(path16, image16->getInfo())->write(image16);
+                ImageInfo info(size, ImageType::L_U16);
+                info.layout.endian = opposite(getEndian());
+                auto out = Image::create(info);
+                io->read(path16)->read(out);
+                std::vector<uint8_t> swapped(image16->getByteCount());
+                swapEndian(image16->getData(), swapped.data(), size.w * size.h, 2);
+                FTK_CHECK(0 == memcmp(out->getData(), swapped.data(), swapped.size()));
+            }
+        }
+
+        void PNGTest::_options()
+        {
+            auto io = _context->getSystem<ImageIO>();
+            auto image = createGradient(Size2I(64, 32));
+            const std::filesystem::path path = _getTempDir() / "PNGTest_Options.png";
+            const std::vector<std::pair<std::string, std::string> > options =
+            {
+                { "PNG/Compression", "0" },
+                { "PNG/Compression", "9" },
+                { "PNG/Strategy", "Default" },
+                { "PNG/Strategy", "Filtered" },
+                { "PNG/Strategy", "HuffmanOnly" },
+                { "PNG/Strategy", "RLE" },
+                { "PNG/Strategy", "Fixed" },
+                { "PNG/Filter", "None" },
+                { "PNG/Filter", "Sub" },
+                { "PNG/Filter", "Up" },
+                { "PNG/Filter", "Average" },
+                { "PNG/Filter", "Paeth" },
+                { "PNG/Filter", "All" }
+            };
+            for (const auto& option : options)
+            {
+                ImageIOOptions ioOptions;
+                ioOptions[option.first] = option.second;
+                io->write(path, image->getInfo(), ioOptions)->write(image);
+                auto image2 = Image::create(image->getInfo());
+                io->read(path)->read(image2);
+                FTK_CHECK(0 == memcmp(image->getData(), image2->getData(), image->getByteCount()));
+            }
+            for (const auto& option : {
+                std::make_pair("PNG/Compression", "10"),
+                std::make_pair("PNG/Compression", "fast"),
+                std::make_pair("PNG/Strategy", "Zip"),
+                std::make_pair("PNG/Filter", "Left") })
+            {
+                try
+                {
+                    ImageIOOptions ioOptions;
+                    ioOptions[option.first] = option.second;
+                    io->write(path, image->getInfo(), ioOptions);
+                    FTK_CHECK(false);
+                }
+                catch (const std::exception&)
+                {}
+            }
+        }
+
+        void PNGTest::_readImages()
+        {
+            auto io = _context->getSystem<ImageIO>();
+            std::vector<std::filesystem::path> paths;
+            for (int i = 0; i < 8; ++i)
+            {
+                auto image = createGradient(Size2I(16 + i, 16));
+                paths.push_back(_getTempDir() / Format("PNGTest_Batch_{0}.png").arg(i).str());
+                io->write(paths.back(), image->getInfo())->write(image);
+            }
+            paths.push_back(_getTempDir() / "PNGTest_Batch_Missing.png");
+            const auto images = io->readImages(paths);
+            FTK_CHECK(images.size() == paths.size());
+            for (int i = 0; i < 8; ++i)
+            {
+                FTK_CHECK(images[i]);
+                FTK_CHECK(Size2I(16 + i, 16) == images[i]->getSize());
+            }
+            FTK_CHECK(!images.back());
+        }
     }
 }
-
@@ -21,6 +21,12 @@ namespace ftk
                 const std::shared_ptr<Context>&);
 
             void run() override;
+
+        private:
+            void _io();
+            void _region();
+            void _options();
+            void _readImages();
         };
     }
 }
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/CoreTest/SoftwareRenderTest.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Context.h>
+#include <ftk/Core/FontSystem.h>
+#include <ftk/Core/SoftwareRender.h>
+
+#include <iostream>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        SoftwareRenderTest::SoftwareRenderTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::core_test::SoftwareRenderTest")
+        {}
+
+        SoftwareRenderTest::~SoftwareRenderTest()
+        {}
+
+        std::shared_ptr<SoftwareRenderTest> SoftwareRenderTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<SoftwareRenderTest>(new SoftwareRenderTest(context));
+        }
+
+        namespace
+        {
+            Color4F pixel(const std::shared_ptr<Image>& image, int x, int y)
+            {
+                const uint8_t* p = image->getData() + (y * image->getWidth() + x) * 4;
+                return Color4F(p[0] / 255.F, p[1] / 255.F, p[2] / 255.F, p[3] / 255.F);
+            }
+
+            bool equal(const Color4F& a, const Color4F& b)
+            {
+                return
+                    std::abs(a.r - b.r) < .01F &&
+                    std::abs(a.g - b.g) < .01F &&
+                    std::abs(a.b - b.b) < .01F &&
+                    std::abs(a.a - b.a) < .01F;
+            }
+        }
+
+        void SoftwareRenderTest::run()
+        {
+            auto logSystem = _context->getLogSystem();
+            auto fontSystem = _context->getSystem<FontSystem>();
+            {
+                SoftwareRenderFactory factory;
+                auto render = factory.createRender(logSystem, fontSystem);
+                FTK_CHECK(std::dynamic_pointer_cast<SoftwareRender>(render));
+            }
+            {
+                auto render = SoftwareRender::create(logSystem, fontSystem);
+                RenderOptions options;
+                options.clearColor = Color4F(0.F, 0.F, 0.F, 1.F);
+                const Size2I size(100, 100);
+                render->begin(size, options);
+                FTK_CHECK(size == render->getRenderSize());
+                FTK_CHECK(Box2I(0, 0, 100, 100) == render->getViewport());
+
+                render->drawRect(Box2F(10.F, 10.F, 20.F, 20.F), Color4F(1.F, 0.F, 0.F));
+                render->drawLine(V2F(0.F, 50.5F), V2F(100.F, 50.5F), Color4F(1.F, 1.F, 1.F));
+
+                render->setClipRectEnabled(true);
+                render->setClipRect(Box2I(60, 60, 10, 10));
+                render->drawRect(Box2F(0.F, 0.F, 100.F, 100.F), Color4F(0.F, 0.F, 1.F, .5F));
+                render->setClipRectEnabled(false);
+
+                auto image = Image::create(2, 2, ImageType::L_U8);
+                image->getData()[0] = 0;
+                image->getData()[1] = 255;
+                image->getData()[2] = 128;
+                image->getData()[3] = 64;
+                ImageOptions imageOptions;
+                imageOptions.imageFilters.magnify = ImageFilter::Nearest;
+                render->drawImage(image, Box2F(80.F, 0.F, 20.F, 20.F), Color4F(1.F, 1.F, 1.F), imageOptions);
+                render->end();
+
+                auto out = render->getImage();
+                FTK_CHECK(out);
+                FTK_CHECK(size == out->getSize());
+                FTK_CHECK(ImageType::RGBA_U8 == out->getType());
+                FTK_CHECK(equal(Color4F(0.F, 0.F, 0.F, 1.F), pixel(out, 9, 10)));
+                FTK_CHECK(equal(Color4F(1.F, 0.F, 0.F, 1.F), pixel(out, 10, 10)));
+                FTK_CHECK(equal(Color4F(1.F, 0.F, 0.F, 1.F), pixel(out, 29, 29)));
+                FTK_CHECK(equal(Color4F(0.F, 0.F, 0.F, 1.F), pixel(out, 30, 30)));
+
+                // A line one pixel wide through the middle of a row covers
+                // that row. On a row boundary it would cover half of two rows,
+                // and which one is filled is up to the rasterizer.
+                FTK_CHECK(equal(Color4F(0.F, 0.F, 0.F, 1.F), pixel(out, 5, 49)));
+                FTK_CHECK(equal(Color4F(1.F, 1.F, 1.F, 1.F), pixel(out, 5, 50)));
+                FTK_CHECK(equal(Color4F(0.F, 0.F, 0.F, 1.F), pixel(out, 5, 51)));
+
+                // Drawing is clipped, and blended.
+                FTK_CHECK(pixel(out, 60, 60).b > .4F && pixel(out, 60, 60).b < .6F);
+                FTK_CHECK(pixel(out, 69, 69).b > .4F && pixel(out, 69, 69).b < .6F);
+                FTK_CHECK(0.F == pixel(out, 70, 70).b);
+                FTK_CHECK(0.F == pixel(out, 59, 59).b);
+
+                // Images start with the bottom row.
+                FTK_CHECK(equal(Color4F(128 / 255.F, 128 / 255.F, 128 / 255.F, 1.F), pixel(out, 80, 0)));
+                FTK_CHECK(equal(Color4F(64 / 255.F, 64 / 255.F, 64 / 255.F, 1.F), pixel(out, 99, 0)));
+                FTK_CHECK(equal(Color4F(0.F, 0.F, 0.F, 1.F), pixel(out, 80, 19)));
+                FTK_CHECK(equal(Color4F(1.F, 1.F, 1.F, 1.F), pixel(out, 99, 19)));
+
+                const RenderDiag diag = render->getDiag();
+                // Two for each rectangle, the line, and the image.
+                FTK_CHECK(8 == diag.triangles);
+                FTK_CHECK(1 == diag.textures);
+            }
+            {
+                auto render = SoftwareRender::create(logSystem, fontSystem);
+                render->begin(Size2I(64, 64));
+                for (auto type : getImageTypeEnums())
+                {
+                    if (ImageType::None == type)
+                        continue;
+                    auto image = Image::create(17, 9, type);
+                    image->zero();
+                    render->drawImage(image, Box2F(0.F, 0.F, 64.F, 64.F));
+                    ImageOptions imageOptions;
+                    imageOptions.imageFilters.minify = ImageFilter::Mipmap;
+                    render->drawImage(image, Box2F(0.F, 0.F, 4.F, 4.F), Color4F(1.F, 1.F, 1.F), imageOptions);
+                }
+                if (fontSystem)
+                {
+                    const FontInfo fontInfo;
+                    const std::string text = "Hello world";
+                    render->drawText(
+                        fontSystem->getGlyphs(text, fontInfo),
+                        fontSystem->getMetrics(fontInfo),
+                        V2F(0.F, 0.F));
+                }
+                render->end();
+                FTK_CHECK(Size2I(64, 64) == render->getImage()->getSize());
+            }
+        }
+    }
+}
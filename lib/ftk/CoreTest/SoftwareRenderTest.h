@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/TestLib/ITest.h>
+
+namespace ftk
+{
+    namespace core_test
+    {
+        class SoftwareRenderTest : public test::ITest
+        {
+        protected:
+            SoftwareRenderTest(const std::shared_ptr<Context>&);
+
+        public:
+            virtual ~SoftwareRenderTest();
+
+            static std::shared_ptr<SoftwareRenderTest> create(
+                const std::shared_ptr<Context>&);
+
+            void run() override;
+        };
+    }
+}
+
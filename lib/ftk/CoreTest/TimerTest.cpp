@@ -60,6 +60,20 @@ namespace ftk
                 sleep(std::chrono::milliseconds(5), t0, t1);
                 t0 = t1;
             }
+
+            // The timer system is due when the first active timer times out,
+            // and no sooner than its tick time allows.
+            repeatTimer->stop();
+            auto timerSystem = context->getSystem<TimerSystem>();
+            const auto now = std::chrono::steady_clock::now();
+            timer->start(std::chrono::milliseconds(100), [] {});
+            FTK_CHECK(timer->getDeadline() >= now + std::chrono::milliseconds(100));
+            FTK_CHECK(timerSystem->getNextTick(now) <= timer->getDeadline());
+            FTK_CHECK(context->getNextTick() <= timer->getDeadline());
+            FTK_CHECK(
+                timerSystem->getNextTick(timer->getDeadline()) ==
+                timer->getDeadline() + timerSystem->getTickTime());
+            timer->stop();
         }
 
         TimerTest::~TimerTest()
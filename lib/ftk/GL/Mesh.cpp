@@ -4,6 +4,7 @@
 #include <ftk/GL/Mesh.h>
 
 #include <ftk/GL/GL.h>
+#include <ftk/GL/Render.h>
 
 #include <ftk/Core/Error.h>
 #include <ftk/Core/Math.h>
@@ -22,13 +23,20 @@ namespace ftk
             "Pos2 F32",
             "Pos2 F32 UV U16",
             "Pos2 F32 Color F32",
+            "Pos2 F32 UV F32 Color F32",
             "Pos3 F32",
             "Pos3 F32 UV U16",
             "Pos3 F32 UV U16 Normal U10",
             "Pos3 F32 UV U16 Normal U10 Color U8",
             "Pos3 F32 UV F32 Normal F32",
             "Pos3 F32 UV F32 Normal F32 Color F32",
-            "Pos3 F32 Color U8");
+            "Pos3 F32 Color U8",
+            "Quad F32 UV F32 Color U8");
+
+        FTK_ENUM_IMPL(
+            IndexType,
+            "U16",
+            "U32");
 
         namespace
         {
@@ -56,17 +64,34 @@ namespace ftk
                 2 * sizeof(float),
                 2 * sizeof(float) + 2 * sizeof(uint16_t),
                 2 * sizeof(float) + 4 * sizeof(float),
+                2 * sizeof(float) + 2 * sizeof(float) + 4 * sizeof(float),
                 3 * sizeof(float),
                 3 * sizeof(float) + 2 * sizeof(uint16_t),
                 3 * sizeof(float) + 2 * sizeof(uint16_t) + sizeof(PackedNormal),
                 3 * sizeof(float) + 2 * sizeof(uint16_t) + sizeof(PackedNormal) + sizeof(PackedColor),
                 3 * sizeof(float) + 2 * sizeof(float) + 3 * sizeof(float),
                 3 * sizeof(float) + 2 * sizeof(float) + 3 * sizeof(float) + 4 * sizeof(float),
-                3 * sizeof(float) + sizeof(PackedColor)
+                3 * sizeof(float) + sizeof(PackedColor),
+                4 * sizeof(float) + 4 * sizeof(float) + sizeof(PackedColor)
             };
             return data[static_cast<size_t>(value)];
         }
 
+        std::size_t getByteCount(IndexType value)
+        {
+            const std::array<size_t, static_cast<size_t>(IndexType::Count)> data =
+            {
+                sizeof(uint16_t),
+                sizeof(uint32_t)
+            };
+            return data[static_cast<size_t>(value)];
+        }
+
+        IndexType getIndexType(std::size_t vertexCount)
+        {
+            return vertexCount <= 65536 ? IndexType::U16 : IndexType::U32;
+        }
+
         std::vector<uint8_t> convert(const TriMesh2F& mesh, VBOType type)
         {
             return convert(
@@ -80,12 +105,20 @@ namespace ftk
             VBOType type,
             const RangeSizeT& range)
         {
-            const size_t vertexByteCount = getByteCount(type);
-            std::vector<uint8_t> out((range.max() - range.min() + 1) * 3 * vertexByteCount);
+            std::vector<uint8_t> out((range.max() - range.min() + 1) * 3 * getByteCount(type));
+            convert(mesh, type, range, out.data());
+            return out;
+        }
+
+        void convert(
+            const TriMesh2F& mesh,
+            VBOType type,
+            const RangeSizeT& range,
+            uint8_t* p)
+        {
             const size_t vSize = mesh.v.size();
             const size_t tSize = mesh.t.size();
             const size_t cSize = mesh.c.size();
-            uint8_t* p = out.data();
             switch (type)
             {
             case VBOType::Pos2_F32:
@@ -189,9 +222,62 @@ namespace ftk
                 }
                 break;
             }
+            case VBOType::Pos2_F32_UV_F32_Color_F32:
+            {
+                float* pf = reinterpret_cast<float*>(p);
+                for (size_t i = range.min(); i <= range.max(); ++i)
+                {
+                    const Triangle2* tri = &mesh.triangles[i];
+                    for (size_t k = 0; k < 3; ++k)
+                    {
+                        const size_t v = tri->v[k].v;
+                        if (v && v <= vSize)
+                        {
+                            pf[0] = mesh.v[v - 1].x;
+                            pf[1] = mesh.v[v - 1].y;
+                        }
+                        else
+                        {
+                            pf[0] = 0.F;
+                            pf[1] = 0.F;
+                        }
+                        pf += 2;
+
+                        const size_t t = tri->v[k].t;
+                        if (t && t <= tSize)
+                        {
+                            pf[0] = mesh.t[t - 1].x;
+                            pf[1] = mesh.t[t - 1].y;
+                        }
+                        else
+                        {
+                            pf[0] = 0.F;
+                            pf[1] = 0.F;
+                        }
+                        pf += 2;
+
+                        const size_t c = tri->v[k].c;
+                        if (c && c <= cSize)
+                        {
+                            pf[0] = mesh.c[c - 1].x;
+                            pf[1] = mesh.c[c - 1].y;
+                            pf[2] = mesh.c[c - 1].z;
+                            pf[3] = mesh.c[c - 1].w;
+                        }
+                        else
+                        {
+                            pf[0] = 1.F;
+                            pf[1] = 1.F;
+                            pf[2] = 1.F;
+                            pf[3] = 1.F;
+                        }
+                        pf += 4;
+                    }
+                }
+                break;
+            }
             default: break;
             }
-            return out;
         }
 
         std::vector<uint8_t> convert(const TriMesh3F& mesh, VBOType type)
@@ -207,13 +293,21 @@ namespace ftk
             VBOType type,
             const RangeSizeT& range)
         {
-            const size_t vertexByteCount = getByteCount(type);
-            std::vector<uint8_t> out((range.max() - range.min() + 1) * 3 * vertexByteCount);
+            std::vector<uint8_t> out((range.max() - range.min() + 1) * 3 * getByteCount(type));
+            convert(mesh, type, range, out.data());
+            return out;
+        }
+
+        void convert(
+            const TriMesh3F& mesh,
+            VBOType type,
+            const RangeSizeT& range,
+            uint8_t* p)
+        {
             const size_t vSize = mesh.v.size();
             const size_t tSize = mesh.t.size();
             const size_t nSize = mesh.n.size();
             const size_t cSize = mesh.c.size();
-            uint8_t* p = out.data();
             switch (type)
             {
             case VBOType::Pos3_F32:
@@ -556,6 +650,152 @@ namespace ftk
                 break;
             default: break;
             }
+        }
+
+        namespace
+        {
+            template<typename T>
+            const T* getAttribute(const std::vector<T>& value, size_t index)
+            {
+                return index < value.size() ? &value[index] : nullptr;
+            }
+
+            void writeF32(const V2F* value, float*& pf)
+            {
+                pf[0] = value ? value->x : 0.F;
+                pf[1] = value ? value->y : 0.F;
+                pf += 2;
+            }
+
+            void writeF32(const V3F* value, float*& pf)
+            {
+                pf[0] = value ? value->x : 0.F;
+                pf[1] = value ? value->y : 0.F;
+                pf[2] = value ? value->z : 0.F;
+                pf += 3;
+            }
+
+            void writeF32(const V4F* value, float*& pf)
+            {
+                pf[0] = value ? value->x : 1.F;
+                pf[1] = value ? value->y : 1.F;
+                pf[2] = value ? value->z : 1.F;
+                pf[3] = value ? value->w : 1.F;
+                pf += 4;
+            }
+
+            void writeU16(const V2F* value, uint8_t*& p)
+            {
+                uint16_t* pu16 = reinterpret_cast<uint16_t*>(p);
+                pu16[0] = value ? clamp(static_cast<int>(value->x * 65535.F), 0, 65535) : 0;
+                pu16[1] = value ? clamp(static_cast<int>(value->y * 65535.F), 0, 65535) : 0;
+                p += 2 * sizeof(uint16_t);
+            }
+
+            void writeU10(const V3F* value, uint8_t*& p)
+            {
+                auto packedNormal = reinterpret_cast<PackedNormal*>(p);
+                packedNormal->x = value ? clamp(static_cast<int>(value->x * 511.F), -512, 511) : 0;
+                packedNormal->y = value ? clamp(static_cast<int>(value->y * 511.F), -512, 511) : 0;
+                packedNormal->z = value ? clamp(static_cast<int>(value->z * 511.F), -512, 511) : 0;
+                p += sizeof(PackedNormal);
+            }
+
+            void writeU8(const V4F* value, uint8_t*& p)
+            {
+                auto packedColor = reinterpret_cast<PackedColor*>(p);
+                packedColor->r = value ? clamp(static_cast<int>(value->x * 255.F), 0, 255) : 255;
+                packedColor->g = value ? clamp(static_cast<int>(value->y * 255.F), 0, 255) : 255;
+                packedColor->b = value ? clamp(static_cast<int>(value->z * 255.F), 0, 255) : 255;
+                packedColor->a = value ? clamp(static_cast<int>(value->w * 255.F), 0, 255) : 255;
+                p += sizeof(PackedColor);
+            }
+
+            template<typename T>
+            void writeF32(const T* value, uint8_t*& p)
+            {
+                float* pf = reinterpret_cast<float*>(p);
+                writeF32(value, pf);
+                p = reinterpret_cast<uint8_t*>(pf);
+            }
+        }
+
+        std::vector<uint8_t> convert(const IdxMesh2F& mesh, VBOType type)
+        {
+            const size_t size = mesh.v.size();
+            std::vector<uint8_t> out(size * getByteCount(type));
+            uint8_t* p = out.data();
+            for (size_t i = 0; i < size; ++i)
+            {
+                switch (type)
+                {
+                case VBOType::Pos2_F32:
+                    writeF32(&mesh.v[i], p);
+                    break;
+                case VBOType::Pos2_F32_UV_U16:
+                    writeF32(&mesh.v[i], p);
+                    writeU16(getAttribute(mesh.t, i), p);
+                    break;
+                case VBOType::Pos2_F32_Color_F32:
+                    writeF32(&mesh.v[i], p);
+                    writeF32(getAttribute(mesh.c, i), p);
+                    break;
+                case VBOType::Pos2_F32_UV_F32_Color_F32:
+                    writeF32(&mesh.v[i], p);
+                    writeF32(getAttribute(mesh.t, i), p);
+                    writeF32(getAttribute(mesh.c, i), p);
+                    break;
+                default: break;
+                }
+            }
+            return out;
+        }
+
+        std::vector<uint8_t> convert(const IdxMesh3F& mesh, VBOType type)
+        {
+            const size_t size = mesh.v.size();
+            std::vector<uint8_t> out(size * getByteCount(type));
+            uint8_t* p = out.data();
+            for (size_t i = 0; i < size; ++i)
+            {
+                switch (type)
+                {
+                case VBOType::Pos3_F32:
+                    writeF32(&mesh.v[i], p);
+                    break;
+                case VBOType::Pos3_F32_UV_U16:
+                    writeF32(&mesh.v[i], p);
+                    writeU16(getAttribute(mesh.t, i), p);
+                    break;
+                case VBOType::Pos3_F32_UV_U16_Normal_U10:
+                    writeF32(&mesh.v[i], p);
+                    writeU16(getAttribute(mesh.t, i), p);
+                    writeU10(getAttribute(mesh.n, i), p);
+                    break;
+                case VBOType::Pos3_F32_UV_U16_Normal_U10_Color_U8:
+                    writeF32(&mesh.v[i], p);
+                    writeU16(getAttribute(mesh.t, i), p);
+                    writeU10(getAttribute(mesh.n, i), p);
+                    writeU8(getAttribute(mesh.c, i), p);
+                    break;
+                case VBOType::Pos3_F32_UV_F32_Normal_F32:
+                    writeF32(&mesh.v[i], p);
+                    writeF32(getAttribute(mesh.t, i), p);
+                    writeF32(getAttribute(mesh.n, i), p);
+                    break;
+                case VBOType::Pos3_F32_UV_F32_Normal_F32_Color_F32:
+                    writeF32(&mesh.v[i], p);
+                    writeF32(getAttribute(mesh.t, i), p);
+                    writeF32(getAttribute(mesh.n, i), p);
+                    writeF32(getAttribute(mesh.c, i), p);
+                    break;
+                case VBOType::Pos3_F32_Color_U8:
+                    writeF32(&mesh.v[i], p);
+                    writeU8(getAttribute(mesh.c, i), p);
+                    break;
+                default: break;
+                }
+            }
             return out;
         }
 
@@ -661,9 +901,397 @@ namespace ftk
             return totalByteCount;
         }
 
+        namespace
+        {
+            // The ring is fenced in quarters: a quarter is fenced once the
+            // draws reading it have been issued, and waited on when the
+            // ring next reaches it.
+            const size_t streamSegmentCount = 4;
+        }
+
+        struct VBOStream::Private
+        {
+            std::size_t size = 0;
+            VBOType type = VBOType::First;
+            GLuint vbo = 0;
+            std::size_t pos = 0;
+            std::size_t mapOffset = 0;
+            std::size_t mapByteCount = 0;
+#if defined(FTK_API_GL_4_1)
+            struct Segment
+            {
+                bool open = false;
+                GLsync fence = nullptr;
+            };
+            std::array<Segment, streamSegmentCount> segments;
+#elif defined(FTK_API_GLES_2)
+            std::vector<uint8_t> scratch;
+#endif // FTK_API_GL_4_1
+        };
+
+        VBOStream::VBOStream(std::size_t size, VBOType type) :
+            _p(new Private)
+        {
+            FTK_P();
+
+            ++objectCount;
+            totalByteCount += size * getByteCount(type);
+
+            p.size = size;
+            p.type = type;
+            glGenBuffers(1, &p.vbo);
+            glBindBuffer(GL_ARRAY_BUFFER, p.vbo);
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizei>(p.size * getByteCount(type)), NULL, GL_STREAM_DRAW);
+        }
+
+        VBOStream::~VBOStream()
+        {
+            FTK_P();
+#if defined(FTK_API_GL_4_1)
+            for (auto& segment : p.segments)
+            {
+                if (segment.fence)
+                {
+                    glDeleteSync(segment.fence);
+                }
+            }
+#endif // FTK_API_GL_4_1
+            if (p.vbo)
+            {
+                glDeleteBuffers(1, &p.vbo);
+                p.vbo = 0;
+            }
+
+            --objectCount;
+            totalByteCount -= p.size * getByteCount(p.type);
+        }
+
+        std::shared_ptr<VBOStream> VBOStream::create(std::size_t size, VBOType type)
+        {
+            return std::shared_ptr<VBOStream>(new VBOStream(size, type));
+        }
+
+        std::size_t VBOStream::getSize() const
+        {
+            return _p->size;
+        }
+
+        VBOType VBOStream::getType() const
+        {
+            return _p->type;
+        }
+
+        unsigned int VBOStream::getID() const
+        {
+            return _p->vbo;
+        }
+
+        uint8_t* VBOStream::map(std::size_t count, std::size_t& first)
+        {
+            FTK_P();
+            if (0 == count || count > p.size)
+                return nullptr;
+
+            // Back to the start rather than splitting the vertices across
+            // the end; a draw needs them in one piece.
+            const bool wrap = p.pos + count > p.size;
+            const size_t byteCount = getByteCount(p.type);
+#if defined(FTK_API_GL_4_1)
+            const size_t segmentByteCount =
+                (p.size * byteCount + streamSegmentCount - 1) / streamSegmentCount;
+
+            // Everything drawn from the earlier maps has been issued by now,
+            // so the segments the write position has moved past can be
+            // fenced. Going back to the start moves past all of them.
+            const size_t current = wrap ?
+                streamSegmentCount :
+                p.pos * byteCount / segmentByteCount;
+            for (size_t i = 0; i < streamSegmentCount && i < current; ++i)
+            {
+                auto& segment = p.segments[i];
+                if (segment.open)
+                {
+                    segment.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                    segment.open = false;
+                }
+            }
+#endif // FTK_API_GL_4_1
+            if (wrap)
+            {
+                p.pos = 0;
+            }
+            p.mapOffset = p.pos * byteCount;
+            p.mapByteCount = count * byteCount;
+            first = p.pos;
+            p.pos += count;
+
+            uint8_t* out = nullptr;
+            glBindBuffer(GL_ARRAY_BUFFER, p.vbo);
+#if defined(FTK_API_GL_4_1)
+            // A segment that was fenced is written again only once the GPU
+            // has finished with it. A segment that is still open is only
+            // being written further along.
+            const size_t s0 = p.mapOffset / segmentByteCount;
+            const size_t s1 = (p.mapOffset + p.mapByteCount - 1) / segmentByteCount;
+            for (size_t i = s0; i <= s1 && i < streamSegmentCount; ++i)
+            {
+                auto& segment = p.segments[i];
+                if (segment.fence)
+                {
+                    GLenum result = GL_TIMEOUT_EXPIRED;
+                    while (GL_TIMEOUT_EXPIRED == result)
+                    {
+                        result = glClientWaitSync(
+                            segment.fence,
+                            GL_SYNC_FLUSH_COMMANDS_BIT,
+                            1000000000);
+                    }
+                    glDeleteSync(segment.fence);
+                    segment.fence = nullptr;
+                }
+                segment.open = true;
+            }
+            out = reinterpret_cast<uint8_t*>(glMapBufferRange(
+                GL_ARRAY_BUFFER,
+                static_cast<GLintptr>(p.mapOffset),
+                static_cast<GLsizeiptr>(p.mapByteCount),
+                GL_MAP_WRITE_BIT |
+                GL_MAP_INVALIDATE_RANGE_BIT |
+                GL_MAP_UNSYNCHRONIZED_BIT));
+#elif defined(FTK_API_GLES_2)
+            if (p.scratch.size() < p.mapByteCount)
+            {
+                p.scratch.resize(p.mapByteCount);
+            }
+            out = p.scratch.data();
+#endif // FTK_API_GL_4_1
+            return out;
+        }
+
+        void VBOStream::unmap()
+        {
+            FTK_P();
+            glBindBuffer(GL_ARRAY_BUFFER, p.vbo);
+#if defined(FTK_API_GL_4_1)
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+#elif defined(FTK_API_GLES_2)
+            glBufferSubData(
+                GL_ARRAY_BUFFER,
+                static_cast<GLintptr>(p.mapOffset),
+                static_cast<GLsizeiptr>(p.mapByteCount),
+                p.scratch.data());
+#endif // FTK_API_GL_4_1
+        }
+
+        bool VBOStream::copy(const TriMesh2F& mesh, std::size_t& first)
+        {
+            const size_t size = mesh.triangles.size();
+            if (0 == size)
+                return false;
+            uint8_t* data = map(size * 3, first);
+            if (!data)
+                return false;
+            convert(mesh, _p->type, RangeSizeT(0, size - 1), data);
+            unmap();
+            return true;
+        }
+
+        struct IBO::Private
+        {
+            std::size_t size = 0;
+            IndexType type = IndexType::First;
+            GLuint ibo = 0;
+            std::vector<uint16_t> u16;
+        };
+
+        IBO::IBO(std::size_t size, IndexType type) :
+            _p(new Private)
+        {
+            FTK_P();
+
+            ++objectCount;
+            totalByteCount += size * getByteCount(type);
+
+            p.size = size;
+            p.type = type;
+            glGenBuffers(1, &p.ibo);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, p.ibo);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizei>(p.size * getByteCount(type)), NULL, GL_DYNAMIC_DRAW);
+        }
+
+        IBO::~IBO()
+        {
+            FTK_P();
+            if (p.ibo)
+            {
+                glDeleteBuffers(1, &p.ibo);
+                p.ibo = 0;
+            }
+
+            --objectCount;
+            totalByteCount -= p.size * getByteCount(p.type);
+        }
+
+        std::shared_ptr<IBO> IBO::create(std::size_t size, IndexType type)
+        {
+            return std::shared_ptr<IBO>(new IBO(size, type));
+        }
+
+        std::size_t IBO::getSize() const
+        {
+            return _p->size;
+        }
+
+        IndexType IBO::getType() const
+        {
+            return _p->type;
+        }
+
+        unsigned int IBO::getID() const
+        {
+            return _p->ibo;
+        }
+
+        void IBO::bind()
+        {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _p->ibo);
+        }
+
+        void IBO::copy(const std::vector<uint32_t>& data)
+        {
+            FTK_P();
+
+            // Discard the previous contents first, see VBO::copy().
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, p.ibo);
+            glBufferData(
+                GL_ELEMENT_ARRAY_BUFFER,
+                static_cast<GLsizei>(p.size * getByteCount(p.type)),
+                NULL,
+                GL_DYNAMIC_DRAW);
+
+            copy(data, 0, std::min(data.size(), p.size));
+        }
+
+        void IBO::copy(const std::vector<uint32_t>& data, std::size_t offset, std::size_t size)
+        {
+            FTK_P();
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, p.ibo);
+            switch (p.type)
+            {
+            case IndexType::U16:
+                p.u16.resize(size);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    p.u16[i] = static_cast<uint16_t>(data[i]);
+                }
+                glBufferSubData(
+                    GL_ELEMENT_ARRAY_BUFFER,
+                    offset * sizeof(uint16_t),
+                    size * sizeof(uint16_t),
+                    p.u16.data());
+                break;
+            case IndexType::U32:
+                glBufferSubData(
+                    GL_ELEMENT_ARRAY_BUFFER,
+                    offset * sizeof(uint32_t),
+                    size * sizeof(uint32_t),
+                    data.data());
+                break;
+            default: break;
+            }
+        }
+
+        namespace
+        {
+            // Point the attributes of the bound vertex array object at the
+            // bound buffer, starting the given number of bytes in.
+            void setAttributes(VBOType type, size_t offset)
+            {
+                const GLsizei stride = static_cast<GLsizei>(getByteCount(type));
+                switch (type)
+                {
+                case VBOType::Pos2_F32:
+                    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 0));
+                    glEnableVertexAttribArray(0);
+                    break;
+                case VBOType::Pos2_F32_UV_U16:
+                    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 0));
+                    glEnableVertexAttribArray(0);
+                    glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, (GLvoid*)(offset + 8));
+                    glEnableVertexAttribArray(1);
+                    break;
+                case VBOType::Pos2_F32_Color_F32:
+                    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 0));
+                    glEnableVertexAttribArray(0);
+                    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 8));
+                    glEnableVertexAttribArray(1);
+                    break;
+                case VBOType::Pos2_F32_UV_F32_Color_F32:
+                    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 0));
+                    glEnableVertexAttribArray(0);
+                    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 8));
+                    glEnableVertexAttribArray(1);
+                    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 16));
+                    glEnableVertexAttribArray(2);
+                    break;
+                case VBOType::Pos3_F32:
+                    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 0));
+                    glEnableVertexAttribArray(0);
+                    break;
+                case VBOType::Pos3_F32_UV_U16:
+                    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 0));
+                    glEnableVertexAttribArray(0);
+                    glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, (GLvoid*)(offset + 12));
+                    glEnableVertexAttribArray(1);
+                    break;
+                case VBOType::Pos3_F32_UV_F32_Normal_F32:
+                    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 0));
+                    glEnableVertexAttribArray(0);
+                    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 12));
+                    glEnableVertexAttribArray(1);
+                    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 20));
+                    glEnableVertexAttribArray(2);
+                    break;
+                case VBOType::Pos3_F32_UV_F32_Normal_F32_Color_F32:
+                    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 0));
+                    glEnableVertexAttribArray(0);
+                    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 12));
+                    glEnableVertexAttribArray(1);
+                    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 20));
+                    glEnableVertexAttribArray(2);
+                    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 32));
+                    glEnableVertexAttribArray(3);
+                    break;
+                case VBOType::Pos3_F32_Color_U8:
+                    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 0));
+                    glEnableVertexAttribArray(0);
+                    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*)(offset + 12));
+                    glEnableVertexAttribArray(1);
+                    break;
+                case VBOType::Quad_F32_UV_F32_Color_U8:
+                    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 0));
+                    glEnableVertexAttribArray(0);
+                    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 16));
+                    glEnableVertexAttribArray(1);
+                    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*)(offset + 32));
+                    glEnableVertexAttribArray(2);
+#if defined(FTK_API_GL_4_1)
+                    glVertexAttribDivisor(0, 1);
+                    glVertexAttribDivisor(1, 1);
+                    glVertexAttribDivisor(2, 1);
+#endif // FTK_API_GL_4_1
+                    break;
+                default: break;
+                }
+            }
+        }
+
         struct VAO::Private
         {
+            VBOType type = VBOType::First;
+            GLuint vbo = 0;
             GLuint vao = 0;
+            size_t instanceOffset = 0;
         };
 
         VAO::VAO(VBOType type, unsigned int vbo) :
@@ -671,6 +1299,8 @@ namespace ftk
         {
             FTK_P();
 
+            p.type = type;
+            p.vbo = vbo;
 #if defined(FTK_API_GL_4_1)
             glGenVertexArrays(1, &p.vao);
             glBindVertexArray(p.vao);
@@ -679,61 +1309,7 @@ namespace ftk
             glBindVertexArrayOES(p.vao);
 #endif // FTK_API_GL_4_1
             glBindBuffer(GL_ARRAY_BUFFER, vbo);
-            const std::size_t byteCount = getByteCount(type);
-            switch (type)
-            {
-            case VBOType::Pos2_F32:
-                glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)0);
-                glEnableVertexAttribArray(0);
-                break;
-            case VBOType::Pos2_F32_UV_U16:
-                glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)0);
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, static_cast<GLsizei>(byteCount), (GLvoid*)8);
-                glEnableVertexAttribArray(1);
-                break;
-            case VBOType::Pos2_F32_Color_F32:
-                glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)0);
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)8);
-                glEnableVertexAttribArray(1);
-                break;
-            case VBOType::Pos3_F32:
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)0);
-                glEnableVertexAttribArray(0);
-                break;
-            case VBOType::Pos3_F32_UV_U16:
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)0);
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, static_cast<GLsizei>(byteCount), (GLvoid*)12);
-                glEnableVertexAttribArray(1);
-                break;
-            case VBOType::Pos3_F32_UV_F32_Normal_F32:
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)0);
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)12);
-                glEnableVertexAttribArray(1);
-                glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)20);
-                glEnableVertexAttribArray(2);
-                break;
-            case VBOType::Pos3_F32_UV_F32_Normal_F32_Color_F32:
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)0);
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)12);
-                glEnableVertexAttribArray(1);
-                glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)20);
-                glEnableVertexAttribArray(2);
-                glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)32);
-                glEnableVertexAttribArray(3);
-                break;
-            case VBOType::Pos3_F32_Color_U8:
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(byteCount), (GLvoid*)0);
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, static_cast<GLsizei>(byteCount), (GLvoid*)12);
-                glEnableVertexAttribArray(1);
-                break;
-            default: break;
-            }
+            setAttributes(type, 0);
         }
 
         VAO::~VAO()
@@ -771,7 +1347,48 @@ namespace ftk
 
         void VAO::draw(unsigned int mode, std::size_t offset, std::size_t size)
         {
+            flushRender();
             glDrawArrays(mode, static_cast<GLsizei>(offset), static_cast<GLsizei>(size));
         }
+
+        void VAO::drawElements(
+            unsigned int mode,
+            std::size_t offset,
+            std::size_t size,
+            IndexType type)
+        {
+            flushRender();
+            glDrawElements(
+                mode,
+                static_cast<GLsizei>(size),
+                IndexType::U16 == type ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                reinterpret_cast<const void*>(offset * getByteCount(type)));
+        }
+
+        void VAO::drawInstances(
+            unsigned int mode,
+            std::size_t offset,
+            std::size_t size,
+            std::size_t instanceOffset,
+            std::size_t instanceCount)
+        {
+#if defined(FTK_API_GL_4_1)
+            FTK_P();
+            flushRender();
+            // There is no base instance before OpenGL 4.2, so the
+            // attributes are pointed at the first instance instead.
+            if (instanceOffset != p.instanceOffset)
+            {
+                p.instanceOffset = instanceOffset;
+                glBindBuffer(GL_ARRAY_BUFFER, p.vbo);
+                setAttributes(p.type, instanceOffset * getByteCount(p.type));
+            }
+            glDrawArraysInstanced(
+                mode,
+                static_cast<GLint>(offset),
+                static_cast<GLsizei>(size),
+                static_cast<GLsizei>(instanceCount));
+#endif // FTK_API_GL_4_1
+        }
     }
 }
@@ -23,6 +23,7 @@ namespace ftk
             Pos2_F32,
             Pos2_F32_UV_U16,
             Pos2_F32_Color_F32,
+            Pos2_F32_UV_F32_Color_F32,
             Pos3_F32,
             Pos3_F32_UV_U16,
             Pos3_F32_UV_U16_Normal_U10,
@@ -31,6 +32,11 @@ namespace ftk
             Pos3_F32_UV_F32_Normal_F32_Color_F32,
             Pos3_F32_Color_U8,
 
+            //! A quad for each instance rather than a vertex: a box, a
+            //! texture coordinate box, and a color. Attributes advance once
+            //! for each instance on OpenGL 4.1.
+            Quad_F32_UV_F32_Color_U8,
+
             Count,
             First = Pos2_F32
         };
@@ -39,6 +45,25 @@ namespace ftk
         //! Get the number of bytes used to store vertex buffer object types.
         FTK_API std::size_t getByteCount(VBOType);
 
+        //! Index buffer object types. On OpenGL ES 2, 32-bit indices need
+        //! the OES_element_index_uint extension.
+        enum class FTK_API_TYPE IndexType
+        {
+            U16,
+            U32,
+
+            Count,
+            First = U16
+        };
+        FTK_ENUM(IndexType);
+
+        //! Get the number of bytes used to store index buffer object types.
+        FTK_API std::size_t getByteCount(IndexType);
+
+        //! Get the smallest index type that can address the given number of
+        //! vertices.
+        FTK_API IndexType getIndexType(std::size_t vertexCount);
+
         //! Convert a triangle mesh to vertex buffer data.
         FTK_API std::vector<uint8_t> convert(const TriMesh2F&, VBOType);
 
@@ -51,6 +76,24 @@ namespace ftk
         //! Convert a triangle mesh to vertex buffer data.
         FTK_API std::vector<uint8_t> convert(const TriMesh3F&, VBOType, const RangeSizeT&);
 
+        //! Convert a triangle mesh to vertex buffer data, written to memory
+        //! with room for three vertices for each triangle in the range.
+        FTK_API void convert(const TriMesh2F&, VBOType, const RangeSizeT&, uint8_t*);
+
+        //! Convert a triangle mesh to vertex buffer data, written to memory
+        //! with room for three vertices for each triangle in the range.
+        FTK_API void convert(const TriMesh3F&, VBOType, const RangeSizeT&, uint8_t*);
+
+        //! Convert the vertices of an indexed mesh to vertex buffer data,
+        //! one vertex for each position. The indices are copied to an index
+        //! buffer object separately.
+        FTK_API std::vector<uint8_t> convert(const IdxMesh2F&, VBOType);
+
+        //! Convert the vertices of an indexed mesh to vertex buffer data,
+        //! one vertex for each position. The indices are copied to an index
+        //! buffer object separately.
+        FTK_API std::vector<uint8_t> convert(const IdxMesh3F&, VBOType);
+
         //! Vertex buffer object.
         class FTK_API_TYPE VBO : public std::enable_shared_from_this<VBO>
         {
@@ -93,6 +136,96 @@ namespace ftk
             FTK_PRIVATE();
         };
 
+        //! Streaming vertex buffer object.
+        //!
+        //! For geometry that changes every draw. The buffer is a ring: each
+        //! draw is given the next free part of it to write into, and draws
+        //! only wait for the GPU when the ring comes back round to a part
+        //! the GPU may still be reading. Rather than respecifying a buffer
+        //! and copying a vector into it for every draw, the vertices are
+        //! written straight into the mapped buffer.
+        //!
+        //! OpenGL 4.1 has no persistent mapping, so each draw maps and
+        //! unmaps its own range, unsynchronized; on OpenGL ES 2, which
+        //! cannot map buffers at all, the range is written through a scratch
+        //! buffer that is kept between draws.
+        class FTK_API_TYPE VBOStream : public std::enable_shared_from_this<VBOStream>
+        {
+            FTK_NON_COPYABLE(VBOStream);
+
+        protected:
+            VBOStream(std::size_t size, VBOType);
+
+        public:
+            FTK_API ~VBOStream();
+
+            //! Create a new object.
+            FTK_API static std::shared_ptr<VBOStream> create(std::size_t size, VBOType);
+
+            //! Get the size in vertices.
+            FTK_API std::size_t getSize() const;
+
+            //! Get the type.
+            FTK_API VBOType getType() const;
+
+            //! Get the OpenGL ID.
+            FTK_API unsigned int getID() const;
+
+            //! Map room for the given number of vertices. Returns null if
+            //! they do not fit in the buffer. The index of the first vertex,
+            //! for drawing, is returned in the second argument.
+            FTK_API uint8_t* map(std::size_t count, std::size_t& first);
+
+            //! Unmap the room given by map(), before drawing it.
+            FTK_API void unmap();
+
+            //! Write a triangle mesh. Returns false if it does not fit in the
+            //! buffer.
+            FTK_API bool copy(const TriMesh2F&, std::size_t& first);
+
+        private:
+            FTK_PRIVATE();
+        };
+
+        //! Index buffer object.
+        class FTK_API_TYPE IBO : public std::enable_shared_from_this<IBO>
+        {
+            FTK_NON_COPYABLE(IBO);
+
+        protected:
+            IBO(std::size_t size, IndexType);
+
+        public:
+            FTK_API ~IBO();
+
+            //! Create a new object.
+            FTK_API static std::shared_ptr<IBO> create(std::size_t size, IndexType);
+
+            //! Get the size in indices.
+            FTK_API std::size_t getSize() const;
+
+            //! Get the type.
+            FTK_API IndexType getType() const;
+
+            //! Get the OpenGL ID.
+            FTK_API unsigned int getID() const;
+
+            //! Bind the index buffer object. This must be done with the
+            //! vertex array object bound, which then keeps the binding.
+            FTK_API void bind();
+
+            //! Copy indices to the buffer, converting them to the buffer's
+            //! type.
+            FTK_API void copy(const std::vector<uint32_t>&);
+
+            //! Copy indices to the buffer, converting them to the buffer's
+            //! type. The offset and size are in indices.
+            FTK_API void copy(const std::vector<uint32_t>&, std::size_t offset, std::size_t size);
+
+        private:
+            FTK_PRIVATE();
+        };
+
         //! Vertex array object.
         class FTK_API_TYPE VAO : public std::enable_shared_from_this<VAO>
         {
@@ -116,6 +249,25 @@ namespace ftk
             //! Draw the vertex array object.
             FTK_API void draw(unsigned int mode, std::size_t offset, std::size_t size);
 
+            //! Draw the vertex array object with the bound index buffer
+            //! object. The offset and size are in indices.
+            FTK_API void drawElements(
+                unsigned int mode,
+                std::size_t offset,
+                std::size_t size,
+                IndexType);
+
+            //! Draw instances of the vertex array object, for the
+            //! Quad_F32_UV_F32_Color_U8 type. The offset and size are in
+            //! vertices, the instance offset and count in instances. This
+            //! does nothing on OpenGL ES 2, which has no instancing.
+            FTK_API void drawInstances(
+                unsigned int mode,
+                std::size_t offset,
+                std::size_t size,
+                std::size_t instanceOffset,
+                std::size_t instanceCount);
+
         private:
             FTK_PRIVATE();
         };
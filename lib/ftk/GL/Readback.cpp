@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/GL/Readback.h>
+
+#include <ftk/GL/GL.h>
+#include <ftk/GL/Util.h>
+
+#include <cstring>
+#include <list>
+
+namespace ftk
+{
+    namespace gl
+    {
+        struct Readback::Private
+        {
+            struct Read
+            {
+                ImageInfo info;
+                std::function<void(const std::shared_ptr<Image>&)> callback;
+                std::shared_ptr<Image> image;
+#if defined(FTK_API_GL_4_1)
+                size_t pbo = 0;
+                GLsync fence = NULL;
+#endif // FTK_API_GL_4_1
+            };
+            std::list<Read> reads;
+
+#if defined(FTK_API_GL_4_1)
+            // The pixel buffers, used in turn. A buffer is grown when a read
+            // needs more than it has.
+            struct PBO
+            {
+                GLuint id = 0;
+                size_t byteCount = 0;
+            };
+            std::vector<PBO> pbos;
+            size_t pbo = 0;
+
+            void finish(Read&, bool wait);
+#endif // FTK_API_GL_4_1
+        };
+
+#if defined(FTK_API_GL_4_1)
+        void Readback::Private::finish(Read& read, bool wait)
+        {
+            const GLenum status = glClientWaitSync(
+                read.fence,
+                wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                wait ? GL_TIMEOUT_IGNORED : 0);
+            if (GL_TIMEOUT_EXPIRED == status)
+                return;
+            glDeleteSync(read.fence);
+            read.fence = NULL;
+            if (GL_WAIT_FAILED == status)
+                return;
+            read.image = Image::create(read.info);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[read.pbo].id);
+            if (const void* data = glMapBufferRange(
+                GL_PIXEL_PACK_BUFFER,
+                0,
+                read.info.getByteCount(),
+                GL_MAP_READ_BIT))
+            {
+                memcpy(read.image->getData(), data, read.info.getByteCount());
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+#endif // FTK_API_GL_4_1
+
+        Readback::Readback(size_t count) :
+            _p(new Private)
+        {
+#if defined(FTK_API_GL_4_1)
+            FTK_P();
+            p.pbos.resize(std::max(count, static_cast<size_t>(1)));
+            for (auto& pbo : p.pbos)
+            {
+                glGenBuffers(1, &pbo.id);
+            }
+#endif // FTK_API_GL_4_1
+        }
+
+        Readback::~Readback()
+        {
+            FTK_P();
+#if defined(FTK_API_GL_4_1)
+            for (auto& read : p.reads)
+            {
+                if (read.fence)
+                {
+                    glDeleteSync(read.fence);
+                }
+            }
+            for (const auto& pbo : p.pbos)
+            {
+                glDeleteBuffers(1, &pbo.id);
+            }
+#endif // FTK_API_GL_4_1
+        }
+
+        std::shared_ptr<Readback> Readback::create(size_t count)
+        {
+            return std::shared_ptr<Readback>(new Readback(count));
+        }
+
+        void Readback::read(
+            const Box2I& box,
+            const std::function<void(const std::shared_ptr<Image>&)>& callback,
+            ImageType type)
+        {
+            FTK_P();
+            Private::Read read;
+            read.info = ImageInfo(box.size(), type);
+            read.info.layout.alignment = 1;
+            read.callback = callback;
+            const GLenum format = getReadPixelsFormat(type);
+            const GLenum glType = getReadPixelsType(type);
+            if (!box.isValid() || GL_NONE == format || GL_NONE == glType)
+            {
+                p.reads.push_back(std::move(read));
+                return;
+            }
+
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+#if defined(FTK_API_GL_4_1)
+            glPixelStorei(GL_PACK_SWAP_BYTES, 0);
+
+            // Reuse the next buffer, finishing the read that has it first.
+            for (auto& i : p.reads)
+            {
+                if (i.pbo == p.pbo && i.fence)
+                {
+                    p.finish(i, true);
+                }
+            }
+            read.pbo = p.pbo;
+            p.pbo = (p.pbo + 1) % p.pbos.size();
+            Private::PBO& buffer = p.pbos[read.pbo];
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.id);
+            const size_t byteCount = read.info.getByteCount();
+            if (byteCount > buffer.byteCount)
+            {
+                glBufferData(GL_PIXEL_PACK_BUFFER, byteCount, NULL, GL_STREAM_READ);
+                buffer.byteCount = byteCount;
+            }
+            glReadPixels(box.x(), box.y(), box.w(), box.h(), format, glType, NULL);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            read.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#elif defined(FTK_API_GLES_2)
+            read.image = Image::create(read.info);
+            glReadPixels(box.x(), box.y(), box.w(), box.h(), format, glType, read.image->getData());
+#endif // FTK_API_GL_4_1
+            p.reads.push_back(std::move(read));
+        }
+
+        size_t Readback::getPending() const
+        {
+            return _p->reads.size();
+        }
+
+        void Readback::tick(bool wait)
+        {
+            FTK_P();
+            // The callbacks are called in order, so a read that is done
+            // waits for those started before it.
+            while (!p.reads.empty())
+            {
+                auto& read = p.reads.front();
+#if defined(FTK_API_GL_4_1)
+                if (read.fence)
+                {
+                    p.finish(read, wait);
+                    if (read.fence)
+                        break;
+                }
+#endif // FTK_API_GL_4_1
+                auto callback = std::move(read.callback);
+                auto image = std::move(read.image);
+                p.reads.pop_front();
+                if (callback)
+                {
+                    callback(image);
+                }
+            }
+        }
+    }
+}
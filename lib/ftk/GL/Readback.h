@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/Core/Box.h>
+#include <ftk/Core/Image.h>
+
+#include <functional>
+
+namespace ftk
+{
+    namespace gl
+    {
+        //! \name Readback
+        ///@{
+
+        //! Read pixels back from the GPU without waiting for it.
+        //!
+        //! A read starts a transfer from the bound framebuffer into one of a
+        //! ring of pixel buffers, and the callback is given the image from
+        //! tick() once the transfer has finished, usually a frame or two
+        //! later. When every buffer is in use the oldest transfer is waited
+        //! for. Without pixel buffers (OpenGL ES 2) the pixels are read
+        //! straight away and the callback is called from the next tick().
+        class FTK_API_TYPE Readback
+        {
+            FTK_NON_COPYABLE(Readback);
+
+        protected:
+            Readback(size_t count);
+
+        public:
+            FTK_API ~Readback();
+
+            //! Create a new readback with the given number of pixel buffers.
+            FTK_API static std::shared_ptr<Readback> create(size_t count = 3);
+
+            //! Start reading a region of the bound framebuffer. The image
+            //! rows are stored from the bottom, the way OpenGL reads them.
+            FTK_API void read(
+                const Box2I&,
+                const std::function<void(const std::shared_ptr<Image>&)>&,
+                ImageType = ImageType::RGBA_U8);
+
+            //! Get the number of reads that have not finished.
+            FTK_API size_t getPending() const;
+
+            //! Finish the reads whose transfers are done, in the order they
+            //! were started. Set wait to finish all of them.
+            FTK_API void tick(bool wait = false);
+
+        private:
+            FTK_PRIVATE();
+        };
+
+        ///@}
+    }
+}
@@ -8,6 +8,7 @@
 #include <ftk/Core/LogSystem.h>
 
 #include <algorithm>
+#include <cstring>
 
 namespace ftk
 {
@@ -16,6 +17,13 @@ namespace ftk
         namespace
         {
             const int pboSizeMin = 1024;
+
+            // Enough that copying the next frame does not wait on the
+            // transfer of the one before.
+            const size_t pboStreamCount = 3;
+
+            // The renderer between begin() and end() on this thread.
+            thread_local Render* currentRender = nullptr;
         }
 
         void Render::_init(
@@ -30,7 +38,12 @@ namespace ftk
         {}
 
         Render::~Render()
-        {}
+        {
+            if (this == currentRender)
+            {
+                currentRender = _p->previousRender;
+            }
+        }
 
         std::shared_ptr<Render> Render::create(
             const std::shared_ptr<LogSystem>& logSystem,
@@ -43,7 +56,24 @@ namespace ftk
 
         std::shared_ptr<Shader> Render::getShader(const std::string& value)
         {
-            return _p->shaders[value];
+            FTK_P();
+            const std::array<std::string, static_cast<size_t>(RenderShader::Count)> names =
+            {
+                "line",
+                "mesh",
+                "colorMesh",
+                "texture",
+                "text",
+                "image",
+                "batch",
+                "glyph",
+                "glyphSDF",
+                "textureScale",
+                "imageScaleX",
+                "imageScaleY"
+            };
+            const auto i = std::find(names.begin(), names.end(), value);
+            return i != names.end() ? p.shaders[i - names.begin()] : nullptr;
         }
 
         void Render::begin(
@@ -54,14 +84,21 @@ namespace ftk
 
             p.startTime = std::chrono::steady_clock::now();
             p.diag = RenderDiag();
+            p.batch.clear();
+            if (this != currentRender)
+            {
+                p.previousRender = currentRender;
+                currentRender = this;
+            }
 
             p.size = size;
             p.options = options;
-            p.texturePool.setMax(options.texturePoolByteCount);
+            p.texturePool.max = options.texturePoolByteCount;
             p.textureCache.setMax(options.textureCacheByteCount);
 
             if (!p.glyphAtlas ||
-                (p.glyphAtlas && options.glyphAtlasSize != p.glyphAtlas->getSize()))
+                (p.glyphAtlas && options.glyphAtlasSize != p.glyphAtlas->getSize()) ||
+                (p.glyphAtlas && options.glyphAtlasPages != p.glyphAtlas->getMaxPages()))
             {
                 ImageType imageType = ImageType::L_U8;
 #if defined(FTK_API_GLES_2)
@@ -71,60 +108,87 @@ namespace ftk
                 p.glyphAtlas = TextureAtlas::create(
                     options.glyphAtlasSize,
                     imageType,
-                    ImageFilter::Linear);
+                    ImageFilter::Linear,
+                    1,
+                    options.glyphAtlasPages);
+                p.glyphIDs.clear();
+                p.sdfGlyphIDs.clear();
+            }
+            p.glyphAtlasEvictions = p.glyphAtlas->getEvictionCount();
+
+            // The glyphs of the other mode are not drawn again once the mode
+            // changes, so their places in the atlas are let go.
+            if (auto fontSystem = _fontSystem.lock())
+            {
+                const GlyphMode glyphMode = fontSystem->getGlyphMode();
+                if (glyphMode != p.glyphMode)
+                {
+                    p.glyphMode = glyphMode;
+                    p.glyphIDs.clear();
+                    p.sdfGlyphIDs.clear();
+                }
             }
 
             glEnable(GL_CULL_FACE);
             glEnable(GL_BLEND);
             glBlendEquation(GL_FUNC_ADD);
 
-            if (!p.shaders["line"])
+            if (!p.shader(RenderShader::Line))
             {
-                p.shaders["line"] = Shader::create(
+                p.setShader(RenderShader::Line, Shader::create(
                     vertexSource(),
-                    meshFragmentSource());
+                    meshFragmentSource()));
             }
-            if (!p.shaders["mesh"])
+            if (!p.shader(RenderShader::Mesh))
             {
-                p.shaders["mesh"] = Shader::create(
+                p.setShader(RenderShader::Mesh, Shader::create(
                     vertexSource(),
-                    meshFragmentSource());
+                    meshFragmentSource()));
             }
-            if (!p.shaders["colorMesh"])
+            if (!p.shader(RenderShader::ColorMesh))
             {
-                p.shaders["colorMesh"] = Shader::create(
+                p.setShader(RenderShader::ColorMesh, Shader::create(
                     colorMeshVertexSource(),
-                    colorMeshFragmentSource());
+                    colorMeshFragmentSource()));
             }
-            if (!p.shaders["texture"])
+            if (!p.shader(RenderShader::Texture))
             {
-                p.shaders["texture"] = gl::Shader::create(
+                p.setShader(RenderShader::Texture, Shader::create(
                     vertexSource(),
-                    textureFragmentSource());
+                    textureFragmentSource()));
             }
-            if (!p.shaders["text"])
+            if (!p.shader(RenderShader::Text))
             {
-                p.shaders["text"] = Shader::create(
+                p.setShader(RenderShader::Text, Shader::create(
                     vertexSource(),
-                    textFragmentSource());
+                    textFragmentSource()));
             }
-            if (!p.shaders["image"])
+            if (!p.shader(RenderShader::Image))
             {
-                p.shaders["image"] = Shader::create(
+                p.setShader(RenderShader::Image, Shader::create(
                     vertexSource(),
-                    imageFragmentSource());
+                    imageFragmentSource()));
             }
-
-            if (!p.vbos["line"])
+            if (!p.shader(RenderShader::Batch))
+            {
+                p.setShader(RenderShader::Batch, Shader::create(
+                    batchVertexSource(),
+                    batchFragmentSource()));
+            }
+#if defined(FTK_API_GL_4_1)
+            if (!p.shader(RenderShader::Glyph))
             {
-                p.vbos["line"] = VBO::create(2 * 3, VBOType::Pos2_F32);
-                p.vaos["line"] = VAO::create(p.vbos["line"]->getType(), p.vbos["line"]->getID());
+                p.setShader(RenderShader::Glyph, Shader::create(
+                    glyphVertexSource(),
+                    batchFragmentSource()));
             }
-            if (!p.vbos["texture"])
+            if (!p.shader(RenderShader::GlyphSDF))
             {
-                p.vbos["texture"] = gl::VBO::create(2 * 3, gl::VBOType::Pos2_F32_UV_U16);
-                p.vaos["texture"] = gl::VAO::create(p.vbos["texture"]->getType(), p.vbos["texture"]->getID());
+                p.setShader(RenderShader::GlyphSDF, Shader::create(
+                    glyphVertexSource(),
+                    glyphSDFFragmentSource()));
             }
+#endif // FTK_API_GL_4_1
 
             setViewport(Box2I(0, 0, size.w, size.h));
             if (options.clear)
@@ -143,6 +207,12 @@ namespace ftk
         void Render::end()
         {
             FTK_P();
+            flush();
+            if (this == currentRender)
+            {
+                currentRender = p.previousRender;
+                p.previousRender = nullptr;
+            }
             const auto now = std::chrono::steady_clock::now();
             const auto diff = std::chrono::duration_cast<std::chrono::microseconds>(
                 now - p.startTime);
@@ -158,6 +228,120 @@ namespace ftk
             }
             p.diag.time = total / static_cast<int64_t>(p.frameTimeCount);
             p.diag.timePeak = peak;
+            p.diag.glyphAtlasPages = p.glyphAtlas->getPageCount();
+            p.diag.glyphAtlasPercentage = p.glyphAtlas->getPercentageUsed() * 100.F;
+            p.diag.glyphAtlasEvictions = p.glyphAtlas->getEvictionCount() - p.glyphAtlasEvictions;
+            p.diag.texturePoolEvictions += p.texturePool.release();
+        }
+
+        void Render::flush()
+        {
+            FTK_P();
+            if (p.batch.runs.empty() || p.flushing)
+                return;
+            p.flushing = true;
+
+            // Something has bound another framebuffer or set another
+            // viewport since the batch was started, without flushing first.
+            // The batch is drawn where it was recorded and the state put back
+            // afterwards, but anything drawn in between is now out of order.
+            GLint framebuffer = 0;
+            glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+            std::array<GLint, 4> viewport = { 0, 0, 0, 0 };
+            glGetIntegerv(GL_VIEWPORT, viewport.data());
+            const bool restore =
+                framebuffer != p.batch.framebuffer ||
+                viewport != p.batch.viewport;
+            if (restore)
+            {
+                if (!p.batchStateWarning)
+                {
+                    p.batchStateWarning = true;
+                    if (auto logSystem = _logSystem.lock())
+                    {
+                        logSystem->print(
+                            "ftk::gl::Render",
+                            "The framebuffer or viewport was changed without flushing the renderer first",
+                            LogType::Warning);
+                    }
+                }
+                glBindFramebuffer(GL_FRAMEBUFFER, p.batch.framebuffer);
+                glViewport(
+                    p.batch.viewport[0],
+                    p.batch.viewport[1],
+                    p.batch.viewport[2],
+                    p.batch.viewport[3]);
+            }
+
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+            p.diag.glyphUploads += p.glyphAtlas->upload();
+            glActiveTexture(static_cast<GLenum>(GL_TEXTURE0));
+            unsigned int texture = p.glyphAtlas->getTexture();
+            glBindTexture(GL_TEXTURE_2D, texture);
+
+            // Write everything to the streams first, then draw the runs.
+            const VBOType type = VBOType::Pos2_F32_UV_F32_Color_F32;
+            size_t first = 0;
+            if (p.batch.count > 0)
+            {
+                auto stream = p.stream(type, p.batch.count);
+                if (uint8_t* data = stream->map(p.batch.count, first))
+                {
+                    memcpy(data, p.batch.vertices.data(), p.batch.count * getByteCount(type));
+                    stream->unmap();
+                }
+            }
+#if defined(FTK_API_GL_4_1)
+            const VBOType glyphType = VBOType::Quad_F32_UV_F32_Color_U8;
+            size_t glyphFirst = 0;
+            if (!p.batch.glyphs.empty())
+            {
+                const size_t count = p.batch.glyphs.size();
+                auto stream = p.stream(glyphType, count);
+                if (uint8_t* data = stream->map(count, glyphFirst))
+                {
+                    memcpy(data, p.batch.glyphs.data(), count * sizeof(GlyphInstance));
+                    stream->unmap();
+                }
+            }
+#endif // FTK_API_GL_4_1
+
+            for (const auto& run : p.batch.runs)
+            {
+                if (run.texture && run.texture != texture)
+                {
+                    texture = run.texture;
+                    glBindTexture(GL_TEXTURE_2D, texture);
+                }
+                if (!run.glyphs)
+                {
+                    p.shader(RenderShader::Batch)->bind();
+                    p.shader(RenderShader::Batch)->setUniform(p.uniform(RenderShader::Batch).textureSampler, 0);
+                    p.stream(type, p.batch.count);
+                    p.streamDraw(type, first + run.first, run.count);
+                }
+#if defined(FTK_API_GL_4_1)
+                else
+                {
+                    const RenderShader shader = run.sdf ? RenderShader::GlyphSDF : RenderShader::Glyph;
+                    p.shader(shader)->bind();
+                    p.shader(shader)->setUniform(p.uniform(shader).textureSampler, 0);
+                    p.stream(glyphType, p.batch.glyphs.size());
+                    p.streamDrawGlyphs(glyphFirst + run.first, run.count);
+                }
+#endif // FTK_API_GL_4_1
+            }
+            ++p.diag.batches;
+
+            p.batch.clear();
+            p.flushing = false;
+
+            if (restore)
+            {
+                glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+                glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+            }
         }
 
         Size2I Render::getRenderSize() const
@@ -183,6 +367,7 @@ namespace ftk
         void Render::setViewport(const Box2I& value)
         {
             FTK_P();
+            flush();
             p.viewport = value;
             glViewport(
                 value.x(),
@@ -193,6 +378,7 @@ namespace ftk
 
         void Render::clearViewport(const Color4F& value)
         {
+            flush();
             glClearColor(value.r, value.g, value.b, value.a);
             glClear(GL_COLOR_BUFFER_BIT);
         }
@@ -205,6 +391,10 @@ namespace ftk
         void Render::setClipRectEnabled(bool value)
         {
             FTK_P();
+            if (value != p.clipRectEnabled)
+            {
+                flush();
+            }
             p.clipRectEnabled = value;
             if (p.clipRectEnabled)
             {
@@ -224,6 +414,10 @@ namespace ftk
         void Render::setClipRect(const Box2I& value)
         {
             FTK_P();
+            if (value != p.clipRect && p.clipRectEnabled)
+            {
+                flush();
+            }
             p.clipRect = value;
             const Size2I size = value.size();
             if (size.isValid())
@@ -244,11 +438,18 @@ namespace ftk
         void Render::setTransform(const M44F& value)
         {
             FTK_P();
+            if (value != p.transform)
+            {
+                flush();
+            }
             p.transform = value;
-            for (auto i : p.shaders)
+            for (size_t i = 0; i < p.shaders.size(); ++i)
             {
-                i.second->bind();
-                i.second->setUniform("transform.mvp", value);
+                if (p.shaders[i])
+                {
+                    p.shaders[i]->bind();
+                    p.shaders[i]->setUniform(p.uniforms[i].mvp, value);
+                }
             }
         }
 
@@ -257,9 +458,96 @@ namespace ftk
             return _p->diag;
         }
 
+        float* Render::_batchVertices(size_t count, unsigned int texture)
+        {
+            FTK_P();
+            if (p.batch.runs.empty())
+            {
+                glGetIntegerv(GL_FRAMEBUFFER_BINDING, &p.batch.framebuffer);
+                glGetIntegerv(GL_VIEWPORT, p.batch.viewport.data());
+            }
+            p.batch.run(false, texture).count += count;
+            const size_t byteCount = getByteCount(VBOType::Pos2_F32_UV_F32_Color_F32);
+            const size_t size = p.batch.vertices.size();
+            p.batch.vertices.resize(size + count * byteCount);
+            p.batch.count += count;
+            return reinterpret_cast<float*>(p.batch.vertices.data() + size);
+        }
+
+        GlyphInstance& Render::_batchGlyph(unsigned int texture, bool sdf)
+        {
+            FTK_P();
+            if (p.batch.runs.empty())
+            {
+                glGetIntegerv(GL_FRAMEBUFFER_BINDING, &p.batch.framebuffer);
+                glGetIntegerv(GL_VIEWPORT, p.batch.viewport.data());
+            }
+            ++p.batch.run(true, texture, sdf).count;
+            p.batch.glyphs.emplace_back();
+            return p.batch.glyphs.back();
+        }
+
+        namespace
+        {
+            //! Get the planes of an image, one texture each. The planes of
+            //! the YUV types follow each other in the image data.
+            std::vector<ImageInfo> getPlanes(const ImageInfo& info)
+            {
+                std::vector<ImageInfo> out;
+                const int w = info.size.w;
+                const int h = info.size.h;
+                switch (info.type)
+                {
+                case ImageType::YUV_420P_U8:
+                    out.push_back(ImageInfo(w, h, ImageType::L_U8));
+                    out.push_back(ImageInfo(w / 2, h / 2, ImageType::L_U8));
+                    out.push_back(ImageInfo(w / 2, h / 2, ImageType::L_U8));
+                    break;
+                case ImageType::YUV_422P_U8:
+                    out.push_back(ImageInfo(w, h, ImageType::L_U8));
+                    out.push_back(ImageInfo(w / 2, h, ImageType::L_U8));
+                    out.push_back(ImageInfo(w / 2, h, ImageType::L_U8));
+                    break;
+                case ImageType::YUV_444P_U8:
+                    out.push_back(ImageInfo(w, h, ImageType::L_U8));
+                    out.push_back(ImageInfo(w, h, ImageType::L_U8));
+                    out.push_back(ImageInfo(w, h, ImageType::L_U8));
+                    break;
+                case ImageType::YUV_420P_U16:
+                    out.push_back(ImageInfo(w, h, ImageType::L_U16));
+                    out.push_back(ImageInfo(w / 2, h / 2, ImageType::L_U16));
+                    out.push_back(ImageInfo(w / 2, h / 2, ImageType::L_U16));
+                    break;
+                case ImageType::YUV_422P_U16:
+                    out.push_back(ImageInfo(w, h, ImageType::L_U16));
+                    out.push_back(ImageInfo(w / 2, h, ImageType::L_U16));
+                    out.push_back(ImageInfo(w / 2, h, ImageType::L_U16));
+                    break;
+                case ImageType::YUV_444P_U16:
+                    out.push_back(ImageInfo(w, h, ImageType::L_U16));
+                    out.push_back(ImageInfo(w, h, ImageType::L_U16));
+                    out.push_back(ImageInfo(w, h, ImageType::L_U16));
+                    break;
+                case ImageType::YUV_420SP_U8:
+                    out.push_back(ImageInfo(w, h, ImageType::L_U8));
+                    out.push_back(ImageInfo(w / 2, h / 2, ImageType::LA_U8));
+                    break;
+                case ImageType::YUV_420SP_U16:
+                    out.push_back(ImageInfo(w, h, ImageType::L_U16));
+                    out.push_back(ImageInfo(w / 2, h / 2, ImageType::LA_U16));
+                    break;
+                default:
+                    out.push_back(info);
+                    break;
+                }
+                return out;
+            }
+        }
+
         std::vector<std::shared_ptr<Texture> > Render::_getTextures(
             const ImageInfo& info,
             const ImageFilters& imageFilters,
+            bool stream,
             size_t offset)
         {
             std::vector<std::shared_ptr<Texture> > out;
@@ -279,84 +567,20 @@ namespace ftk
             }
 #endif // FTK_API_GLES_2
             options.pbo = info.size.w >= pboSizeMin || info.size.h >= pboSizeMin;
-            switch (info.type)
-            {
-            case ImageType::YUV_420P_U8:
-            {
-                auto infoTmp = ImageInfo(info.size, ImageType::L_U8);
-                out.push_back(Texture::create(infoTmp, options));
-                infoTmp = ImageInfo(info.size.w / 2, info.size.h / 2, ImageType::L_U8);
-                out.push_back(Texture::create(infoTmp, options));
-                out.push_back(Texture::create(infoTmp, options));
-                break;
-            }
-            case ImageType::YUV_422P_U8:
+            if (stream)
             {
-                auto infoTmp = ImageInfo(info.size, ImageType::L_U8);
-                out.push_back(Texture::create(infoTmp, options));
-                infoTmp = ImageInfo(info.size.w / 2, info.size.h, ImageType::L_U8);
-                out.push_back(Texture::create(infoTmp, options));
-                out.push_back(Texture::create(infoTmp, options));
-                break;
-            }
-            case ImageType::YUV_444P_U8:
-            {
-                auto infoTmp = ImageInfo(info.size, ImageType::L_U8);
-                out.push_back(Texture::create(infoTmp, options));
-                infoTmp = ImageInfo(info.size, ImageType::L_U8);
-                out.push_back(Texture::create(infoTmp, options));
-                out.push_back(Texture::create(infoTmp, options));
-                break;
-            }
-            case ImageType::YUV_420P_U16:
-            {
-                auto infoTmp = ImageInfo(info.size, ImageType::L_U16);
-                out.push_back(Texture::create(infoTmp, options));
-                infoTmp = ImageInfo(info.size.w / 2, info.size.h / 2, ImageType::L_U16);
-                out.push_back(Texture::create(infoTmp, options));
-                out.push_back(Texture::create(infoTmp, options));
-                break;
-            }
-            case ImageType::YUV_422P_U16:
-            {
-                auto infoTmp = ImageInfo(info.size, ImageType::L_U16);
-                out.push_back(Texture::create(infoTmp, options));
-                infoTmp = ImageInfo(info.size.w / 2, info.size.h, ImageType::L_U16);
-                out.push_back(Texture::create(infoTmp, options));
-                out.push_back(Texture::create(infoTmp, options));
-                break;
-            }
-            case ImageType::YUV_444P_U16:
-            {
-                auto infoTmp = ImageInfo(info.size, ImageType::L_U16);
-                out.push_back(Texture::create(infoTmp, options));
-                infoTmp = ImageInfo(info.size, ImageType::L_U16);
-                out.push_back(Texture::create(infoTmp, options));
-                out.push_back(Texture::create(infoTmp, options));
-                break;
-            }
-            case ImageType::YUV_420SP_U8:
-            {
-                auto infoTmp = ImageInfo(info.size, ImageType::L_U8);
-                out.push_back(Texture::create(infoTmp, options));
-                infoTmp = ImageInfo(info.size.w / 2, info.size.h / 2, ImageType::LA_U8);
-                out.push_back(Texture::create(infoTmp, options));
-                break;
+                options.pboCount = pboStreamCount;
+
+                // The levels would be made again for every frame, and from
+                // a texture that may be bigger than the image.
+                if (ImageFilter::Mipmap == options.filters.minify)
+                {
+                    options.filters.minify = ImageFilter::Linear;
+                }
             }
-            case ImageType::YUV_420SP_U16:
+            for (const auto& plane : getPlanes(info))
             {
-                auto infoTmp = ImageInfo(info.size, ImageType::L_U16);
-                out.push_back(Texture::create(infoTmp, options));
-                infoTmp = ImageInfo(info.size.w / 2, info.size.h / 2, ImageType::LA_U16);
-                out.push_back(Texture::create(infoTmp, options));
-                break;
-            }
-            default:
-            {
-                auto texture = Texture::create(info, options);
-                out.push_back(texture);
-                break;
-            }
+                out.push_back(Texture::create(plane, options));
             }
             return out;
         }
@@ -366,115 +590,15 @@ namespace ftk
             const std::vector<std::shared_ptr<Texture> >& textures,
             size_t offset)
         {
-            const auto& info = image->getInfo();
-            switch (info.type)
-            {
-            case ImageType::YUV_420P_U8:
-            {
-                if (3 == textures.size())
-                {
-                    textures[0]->copy(image->getData(), textures[0]->getImageInfo());
-                    const std::size_t w = info.size.w;
-                    const std::size_t h = info.size.h;
-                    const std::size_t w2 = w / 2;
-                    const std::size_t h2 = h / 2;
-                    textures[1]->copy(image->getData() + (w * h), textures[1]->getImageInfo());
-                    textures[2]->copy(image->getData() + (w * h) + (w2 * h2), textures[2]->getImageInfo());
-                }
-                break;
-            }
-            case ImageType::YUV_422P_U8:
-            {
-                if (3 == textures.size())
-                {
-                    textures[0]->copy(image->getData(), textures[0]->getImageInfo());
-                    const std::size_t w = info.size.w;
-                    const std::size_t h = info.size.h;
-                    const std::size_t w2 = w / 2;
-                    textures[1]->copy(image->getData() + (w * h), textures[1]->getImageInfo());
-                    textures[2]->copy(image->getData() + (w * h) + (w2 * h), textures[2]->getImageInfo());
-                }
-                break;
-            }
-            case ImageType::YUV_444P_U8:
-            {
-                if (3 == textures.size())
-                {
-                    textures[0]->copy(image->getData(), textures[0]->getImageInfo());
-                    const std::size_t w = info.size.w;
-                    const std::size_t h = info.size.h;
-                    textures[1]->copy(image->getData() + (w * h), textures[1]->getImageInfo());
-                    textures[2]->copy(image->getData() + (w * h) + (w * h), textures[2]->getImageInfo());
-                }
-                break;
-            }
-            case ImageType::YUV_420P_U16:
+            const auto planes = getPlanes(image->getInfo());
+            if (planes.size() == textures.size())
             {
-                if (3 == textures.size())
+                const uint8_t* data = image->getData();
+                for (size_t i = 0; i < planes.size(); ++i)
                 {
-                    textures[0]->copy(image->getData(), textures[0]->getImageInfo());
-                    const std::size_t w = info.size.w;
-                    const std::size_t h = info.size.h;
-                    const std::size_t w2 = w / 2;
-                    const std::size_t h2 = h / 2;
-                    textures[1]->copy(image->getData() + (w * h) * 2, textures[1]->getImageInfo());
-                    textures[2]->copy(image->getData() + (w * h) * 2 + (w2 * h2) * 2, textures[2]->getImageInfo());
+                    textures[i]->copy(data, planes[i]);
+                    data += planes[i].getByteCount();
                 }
-                break;
-            }
-            case ImageType::YUV_422P_U16:
-            {
-                if (3 == textures.size())
-                {
-                    textures[0]->copy(image->getData(), textures[0]->getImageInfo());
-                    const std::size_t w = info.size.w;
-                    const std::size_t h = info.size.h;
-                    const std::size_t w2 = w / 2;
-                    textures[1]->copy(image->getData() + (w * h) * 2, textures[1]->getImageInfo());
-                    textures[2]->copy(image->getData() + (w * h) * 2 + (w2 * h) * 2, textures[2]->getImageInfo());
-                }
-                break;
-            }
-            case ImageType::YUV_444P_U16:
-            {
-                if (3 == textures.size())
-                {
-                    textures[0]->copy(image->getData(), textures[0]->getImageInfo());
-                    const std::size_t w = info.size.w;
-                    const std::size_t h = info.size.h;
-                    textures[1]->copy(image->getData() + (w * h) * 2, textures[1]->getImageInfo());
-                    textures[2]->copy(image->getData() + (w * h) * 2 + (w * h) * 2, textures[2]->getImageInfo());
-                }
-                break;
-            }
-            case ImageType::YUV_420SP_U8:
-            {
-                if (2 == textures.size())
-                {
-                    const std::size_t w = info.size.w;
-                    const std::size_t h = info.size.h;
-                    textures[0]->copy(image->getData(), textures[0]->getImageInfo());
-                    textures[1]->copy(image->getData() + (w * h), textures[1]->getImageInfo());
-                }
-                break;
-            }
-            case ImageType::YUV_420SP_U16:
-            {
-                if (2 == textures.size())
-                {
-                    const std::size_t w = info.size.w;
-                    const std::size_t h = info.size.h;
-                    textures[0]->copy(image->getData(), textures[0]->getImageInfo());
-                    textures[1]->copy(image->getData() + (w * h) * 2, textures[1]->getImageInfo());
-                }
-                break;
-            }
-            default:
-                if (1 == textures.size())
-                {
-                    textures[0]->copy(image);
-                }
-                break;
             }
         }
 
@@ -548,6 +672,14 @@ namespace ftk
             }
         }
         
+        void flushRender()
+        {
+            if (currentRender)
+            {
+                currentRender->flush();
+            }
+        }
+
         std::shared_ptr<IRender> RenderFactory::createRender(
             const std::shared_ptr<LogSystem>& logSystem,
             const std::shared_ptr<FontSystem>& fontSystem)
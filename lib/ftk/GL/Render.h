@@ -13,6 +13,7 @@ namespace ftk
     {
         class Shader;
         class Texture;
+        struct GlyphInstance;
 
         //! \name Renderer
         ///@{
@@ -42,6 +43,7 @@ namespace ftk
                 const Size2I&,
                 const RenderOptions& = RenderOptions()) override;
             FTK_API void end() override;
+            FTK_API void flush() override;
             FTK_API Size2I getRenderSize() const override;
             FTK_API void setRenderSize(const Size2I&) override;
             FTK_API RenderOptions getRenderOptions() const override;
@@ -106,9 +108,13 @@ namespace ftk
             FTK_API RenderDiag getDiag() const override;
 
         private:
+            //! Create textures for an image, one for each plane. Streamed
+            //! textures, the pooled ones a new image is copied to every time
+            //! it is drawn, cycle through several pixel buffers.
             std::vector<std::shared_ptr<Texture> > _getTextures(
                 const ImageInfo&,
                 const ImageFilters&,
+                bool stream = false,
                 size_t offset = 0);
             void _copyTextures(
                 const std::shared_ptr<Image>&,
@@ -124,6 +130,14 @@ namespace ftk
 
             void _drawTextMesh(const TriMesh2F&);
 
+            //! Make room for this many more vertices in the batch, returning
+            //! where the first of them goes. Text gives the glyph atlas page
+            //! texture it samples; geometry samples nothing and gives zero.
+            float* _batchVertices(size_t, unsigned int texture = 0);
+
+            //! Add a glyph instance to the batch.
+            GlyphInstance& _batchGlyph(unsigned int texture, bool sdf = false);
+
             //! Draw an image with a separable two pass resample. Returns false
             //! if the request is not one this can serve, leaving the caller to
             //! draw it the ordinary way.
@@ -132,7 +146,8 @@ namespace ftk
                 const TriMesh2F&,
                 const Color4F&,
                 const ImageOptions&,
-                const std::vector<std::shared_ptr<Texture> >&);
+                const std::vector<std::shared_ptr<Texture> >&,
+                const V2F& textureRegion);
 
             void _drawScaleQuad(const Box2F&);
 
@@ -154,6 +169,14 @@ namespace ftk
                 const std::shared_ptr<LogSystem>&,
                 const std::shared_ptr<FontSystem>&) override;
         };
+
+        //! Draw what the renderer between begin() and end() on this thread
+        //! has batched. OffscreenBuffer::bind(), OffscreenBufferBinding,
+        //! Shader::bind() and the VAO draw functions call this, so OpenGL
+        //! used through them is drawn after what was recorded before it.
+        //! Code calling OpenGL functions directly calls IRender::flush()
+        //! first.
+        FTK_API void flushRender();
         
         ///@}
     }
@@ -5,12 +5,86 @@
 
 #include <ftk/GL/Util.h>
 
-#include <sstream>
+#include <cmath>
+#include <cstring>
 
 namespace ftk
 {
     namespace gl
     {
+        namespace
+        {
+            // Write one Pos2_F32_UV_F32_Color_F32 vertex. Geometry that is not
+            // textured gets a negative texture coordinate, which is how the
+            // batch shader tells it from a glyph.
+            inline float* batchVertex(
+                float* p,
+                const V2F& v,
+                const Color4F& color,
+                float u = -1.F,
+                float t = -1.F)
+            {
+                p[0] = v.x;
+                p[1] = v.y;
+                p[2] = u;
+                p[3] = t;
+                p[4] = color.r;
+                p[5] = color.g;
+                p[6] = color.b;
+                p[7] = color.a;
+                return p + 8;
+            }
+
+            // The two triangles of a quad, wound the way the meshes below
+            // are so they survive face culling.
+            inline float* batchQuad(
+                float* p,
+                const V2F& v0,
+                const V2F& v1,
+                const V2F& v2,
+                const V2F& v3,
+                const Color4F& color)
+            {
+                p = batchVertex(p, v0, color);
+                p = batchVertex(p, v2, color);
+                p = batchVertex(p, v1, color);
+                p = batchVertex(p, v2, color);
+                p = batchVertex(p, v0, color);
+                p = batchVertex(p, v3, color);
+                return p;
+            }
+
+            // The size a glyph is drawn at.
+            inline Size2I glyphSize(const Glyph& glyph)
+            {
+                const Size2I& size = glyph.image->getSize();
+                return GlyphMode::SDF == glyph.mode ?
+                    Size2I(std::round(size.w * glyph.scale), std::round(size.h * glyph.scale)) :
+                    size;
+            }
+
+#if defined(FTK_API_GL_4_1)
+            inline void glyphInstance(
+                GlyphInstance& out,
+                const Box2I& box,
+                const TextureAtlasItem& item,
+                const Color4F& color)
+            {
+                out.box[0] = box.min.x;
+                out.box[1] = box.min.y;
+                out.box[2] = box.w();
+                out.box[3] = box.h();
+                out.uv[0] = item.u.min();
+                out.uv[1] = item.v.min();
+                out.uv[2] = item.u.max();
+                out.uv[3] = item.v.max();
+                out.color[0] = clamp(static_cast<int>(color.r * 255.F), 0, 255);
+                out.color[1] = clamp(static_cast<int>(color.g * 255.F), 0, 255);
+                out.color[2] = clamp(static_cast<int>(color.b * 255.F), 0, 255);
+                out.color[3] = clamp(static_cast<int>(color.a * 255.F), 0, 255);
+            }
+#endif // FTK_API_GL_4_1
+        }
 
         void Render::drawRect(
             const Box2F& rect,
@@ -23,6 +97,23 @@ namespace ftk
             const std::vector<Box2F>& rects,
             const Color4F& color)
         {
+            FTK_P();
+            if (p.options.batch)
+            {
+                float* pf = _batchVertices(rects.size() * 6);
+                for (const auto& rect : rects)
+                {
+                    pf = batchQuad(
+                        pf,
+                        rect.min,
+                        V2F(rect.max.x, rect.min.y),
+                        rect.max,
+                        V2F(rect.min.x, rect.max.y),
+                        color);
+                }
+                return;
+            }
+
             TriMesh2F mesh;
             mesh.v.resize(rects.size() * 4);
             mesh.triangles.resize(rects.size() * 2);
@@ -52,8 +143,23 @@ namespace ftk
         {
             FTK_P();
 
-            p.shaders["line"]->bind();
-            p.shaders["line"]->setUniform("color", color);
+            if (p.options.batch)
+            {
+                const V2F v2 = normalize(v1 - v0);
+                const V2F v2CW = perpCW(v2) * options.width / 2.F;
+                const V2F v2CCW = perpCCW(v2) * options.width / 2.F;
+                batchQuad(
+                    _batchVertices(6),
+                    v0 + v2CCW,
+                    v0 + v2CW,
+                    v1 + v2CW,
+                    v1 + v2CCW,
+                    color);
+                return;
+            }
+
+            p.shader(RenderShader::Line)->bind();
+            p.shader(RenderShader::Line)->setUniform(p.uniform(RenderShader::Line).color, color);
 
             glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
@@ -68,16 +174,7 @@ namespace ftk
             mesh.triangles.emplace_back(1, 3, 2);
             mesh.triangles.emplace_back(3, 1, 4);
 
-            if (p.vbos["line"])
-            {
-                p.vbos["line"]->copy(convert(mesh, p.vbos["line"]->getType()));
-                p.diag.triangles += mesh.triangles.size();
-            }
-            if (p.vaos["line"])
-            {
-                p.vaos["line"]->bind();
-                p.vaos["line"]->draw(GL_TRIANGLES, 0, p.vbos["line"]->getSize());
-            }
+            p.drawStream(mesh, VBOType::Pos2_F32);
         }
 
         void Render::drawLines(
@@ -86,6 +183,25 @@ namespace ftk
             const LineOptions& options)
         {
             FTK_P();
+            if (p.options.batch)
+            {
+                float* pf = _batchVertices(lines.size() * 6);
+                for (const auto& i : lines)
+                {
+                    const V2F v2 = normalize(i.second - i.first);
+                    const V2F v2CW = perpCW(v2) * options.width / 2.F;
+                    const V2F v2CCW = perpCCW(v2) * options.width / 2.F;
+                    pf = batchQuad(
+                        pf,
+                        i.first + v2CCW,
+                        i.first + v2CW,
+                        i.second + v2CW,
+                        i.second + v2CCW,
+                        color);
+                }
+                return;
+            }
+
             TriMesh2F mesh;
             mesh.v.resize(lines.size() * 4);
             mesh.triangles.resize(lines.size() * 2);
@@ -115,37 +231,36 @@ namespace ftk
         {
             FTK_P();
             const size_t size = mesh.triangles.size();
-            if (size > 0)
+            if (size > 0 && p.options.batch)
+            {
+                // The offset is applied here rather than through the
+                // transform, which every vertex in the batch shares.
+                const size_t vSize = mesh.v.size();
+                float* pf = _batchVertices(size * 3);
+                for (const auto& triangle : mesh.triangles)
+                {
+                    for (size_t k = 0; k < 3; ++k)
+                    {
+                        const size_t v = triangle.v[k].v;
+                        pf = batchVertex(
+                            pf,
+                            v && v <= vSize ? mesh.v[v - 1] + pos : pos,
+                            color);
+                    }
+                }
+            }
+            else if (size > 0)
             {
-                p.shaders["mesh"]->bind();
+                p.shader(RenderShader::Mesh)->bind();
                 const auto transform =
                     p.transform *
                     translate(V3F(pos.x, pos.y, 0.F));
-                p.shaders["mesh"]->setUniform("transform.mvp", transform);
-                p.shaders["mesh"]->setUniform("color", color);
+                p.shader(RenderShader::Mesh)->setUniform(p.uniform(RenderShader::Mesh).mvp, transform);
+                p.shader(RenderShader::Mesh)->setUniform(p.uniform(RenderShader::Mesh).color, color);
 
                 glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-                if (!p.vbos["mesh"] || (p.vbos["mesh"] && p.vbos["mesh"]->getSize() < size * 3))
-                {
-                    p.vbos["mesh"] = VBO::create(size * 3, VBOType::Pos2_F32);
-                    p.vaos["mesh"].reset();
-                }
-                if (p.vbos["mesh"])
-                {
-                    p.vbos["mesh"]->copy(convert(mesh, VBOType::Pos2_F32));
-                    p.diag.triangles += mesh.triangles.size();
-                }
-
-                if (!p.vaos["mesh"] && p.vbos["mesh"])
-                {
-                    p.vaos["mesh"] = VAO::create(p.vbos["mesh"]->getType(), p.vbos["mesh"]->getID());
-                }
-                if (p.vaos["mesh"] && p.vbos["mesh"])
-                {
-                    p.vaos["mesh"]->bind();
-                    p.vaos["mesh"]->draw(GL_TRIANGLES, 0, size * 3);
-                }
+                p.drawStream(mesh, VBOType::Pos2_F32);
             }
         }
         
@@ -156,37 +271,46 @@ namespace ftk
         {
             FTK_P();
             const size_t size = mesh.triangles.size();
-            if (size > 0)
+            if (size > 0 && p.options.batch)
+            {
+                const size_t vSize = mesh.v.size();
+                const size_t cSize = mesh.c.size();
+                float* pf = _batchVertices(size * 3);
+                for (const auto& triangle : mesh.triangles)
+                {
+                    for (size_t k = 0; k < 3; ++k)
+                    {
+                        const size_t v = triangle.v[k].v;
+                        const size_t c = triangle.v[k].c;
+                        Color4F vColor = color;
+                        if (c && c <= cSize)
+                        {
+                            const V4F& mc = mesh.c[c - 1];
+                            vColor = Color4F(
+                                mc.x * color.r,
+                                mc.y * color.g,
+                                mc.z * color.b,
+                                mc.w * color.a);
+                        }
+                        pf = batchVertex(
+                            pf,
+                            v && v <= vSize ? mesh.v[v - 1] + pos : pos,
+                            vColor);
+                    }
+                }
+            }
+            else if (size > 0)
             {
-                p.shaders["colorMesh"]->bind();
+                p.shader(RenderShader::ColorMesh)->bind();
                 const auto transform =
                     p.transform *
                     translate(V3F(pos.x, pos.y, 0.F));
-                p.shaders["colorMesh"]->setUniform("transform.mvp", transform);
-                p.shaders["colorMesh"]->setUniform("color", color);
+                p.shader(RenderShader::ColorMesh)->setUniform(p.uniform(RenderShader::ColorMesh).mvp, transform);
+                p.shader(RenderShader::ColorMesh)->setUniform(p.uniform(RenderShader::ColorMesh).color, color);
 
                 glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-                if (!p.vbos["colorMesh"] || (p.vbos["colorMesh"] && p.vbos["colorMesh"]->getSize() < size * 3))
-                {
-                    p.vbos["colorMesh"] = VBO::create(size * 3, VBOType::Pos2_F32_Color_F32);
-                    p.vaos["colorMesh"].reset();
-                }
-                if (p.vbos["colorMesh"])
-                {
-                    p.vbos["colorMesh"]->copy(convert(mesh, VBOType::Pos2_F32_Color_F32));
-                    p.diag.triangles += mesh.triangles.size();
-                }
-
-                if (!p.vaos["colorMesh"] && p.vbos["colorMesh"])
-                {
-                    p.vaos["colorMesh"] = VAO::create(p.vbos["colorMesh"]->getType(), p.vbos["colorMesh"]->getID());
-                }
-                if (p.vaos["colorMesh"] && p.vbos["colorMesh"])
-                {
-                    p.vaos["colorMesh"]->bind();
-                    p.vaos["colorMesh"]->draw(GL_TRIANGLES, 0, size * 3);
-                }
+                p.drawStream(mesh, VBOType::Pos2_F32_Color_F32);
             }
         }
 
@@ -198,10 +322,11 @@ namespace ftk
             AlphaBlend alphaBlend)
         {
             FTK_P();
-            p.shaders["texture"]->bind();
-            p.shaders["texture"]->setUniform("color", color);
-            p.shaders["texture"]->setUniform("opaque", AlphaBlend::None == alphaBlend);
-            p.shaders["texture"]->setUniform("textureSampler", 0);
+            flush();
+            p.shader(RenderShader::Texture)->bind();
+            p.shader(RenderShader::Texture)->setUniform(p.uniform(RenderShader::Texture).color, color);
+            p.shader(RenderShader::Texture)->setUniform("opaque", AlphaBlend::None == alphaBlend);
+            p.shader(RenderShader::Texture)->setUniform(p.uniform(RenderShader::Texture).textureSampler, 0);
 
             if (alphaBlend != AlphaBlend::None)
             {
@@ -215,15 +340,7 @@ namespace ftk
             glActiveTexture(static_cast<GLenum>(GL_TEXTURE0));
             glBindTexture(GL_TEXTURE_2D, id);
 
-            if (p.vbos["texture"])
-            {
-                p.vbos["texture"]->copy(convert(mesh(rect, mirrorV), p.vbos["texture"]->getType()));
-            }
-            if (p.vaos["texture"])
-            {
-                p.vaos["texture"]->bind();
-                p.vaos["texture"]->draw(GL_TRIANGLES, 0, p.vbos["texture"]->getSize());
-            }
+            p.drawStream(mesh(rect, mirrorV), VBOType::Pos2_F32_UV_U16);
         }
 
         void Render::drawText(
@@ -234,14 +351,18 @@ namespace ftk
         {
             FTK_P();
 
-            p.shaders["text"]->bind();
-            p.shaders["text"]->setUniform("color", color);
-            p.shaders["text"]->setUniform("textureSampler", 0);
+            if (!p.options.batch)
+            {
+#if defined(FTK_API_GLES_2)
+                p.shader(RenderShader::Text)->bind();
+                p.shader(RenderShader::Text)->setUniform(p.uniform(RenderShader::Text).color, color);
+                p.shader(RenderShader::Text)->setUniform(p.uniform(RenderShader::Text).textureSampler, 0);
+#endif // FTK_API_GLES_2
 
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-            glActiveTexture(static_cast<GLenum>(GL_TEXTURE0));
-            glBindTexture(GL_TEXTURE_2D, p.glyphAtlas->getTexture());
+                glActiveTexture(static_cast<GLenum>(GL_TEXTURE0));
+            }
 
             size_t glyphCount = 0;
             for (const auto& glyph : glyphs)
@@ -256,6 +377,9 @@ namespace ftk
             int x = 0;
             int y = 0;
             int32_t rsbDeltaPrev = 0;
+#if defined(FTK_API_GL_4_1)
+            p.textGlyphs.clear();
+#elif defined(FTK_API_GLES_2)
             p.textMesh.v.resize(glyphCount * 4);
             p.textMesh.t.resize(glyphCount * 4);
             p.textMesh.triangles.resize(glyphCount * 2);
@@ -264,6 +388,35 @@ namespace ftk
             Triangle2* triP = p.textMesh.triangles.data();
             size_t v = 0;
             size_t t = 0;
+
+            // Draw the glyphs so far, from the glyph atlas page they are on,
+            // and start the mesh again.
+            auto drawTextMesh = [this, &p, glyphCount, &vP, &tP, &triP, &v, &t]
+            {
+                if (v > 0)
+                {
+                    p.diag.glyphUploads += p.glyphAtlas->upload();
+                    glBindTexture(GL_TEXTURE_2D, p.textTexture);
+
+                    // Glyphs skipped by clipping leave unused slots at the end
+                    // of the (reused) mesh buffers; trim to the emitted counts
+                    // so stale data from a previous frame is not drawn.
+                    p.textMesh.v.resize(v);
+                    p.textMesh.t.resize(v);
+                    p.textMesh.triangles.resize(t);
+                    _drawTextMesh(p.textMesh);
+
+                    p.textMesh.v.resize(glyphCount * 4);
+                    p.textMesh.t.resize(glyphCount * 4);
+                    p.textMesh.triangles.resize(glyphCount * 2);
+                    vP = p.textMesh.v.data();
+                    tP = p.textMesh.t.data();
+                    triP = p.textMesh.triangles.data();
+                    v = 0;
+                    t = 0;
+                }
+            };
+#endif // FTK_API_GL_4_1
             Box2I lineRect(p.clipRect.min.x, pos.y, p.clipRect.w(), fontMetrics.lineHeight);
             for (auto glyphIt = glyphs.begin(); glyphIt != glyphs.end(); ++glyphIt)
             {
@@ -297,8 +450,15 @@ namespace ftk
                         if ((*glyphIt)->image && (*glyphIt)->image->isValid())
                         {
                             BoxPackID id = boxPackInvalidID;
-                            if (const auto j = p.glyphIDs.find((*glyphIt)->info);
-                                j != p.glyphIDs.end())
+                            // SDF glyphs of every size share an image, and
+                            // so a place in the atlas.
+                            const bool sdf = GlyphMode::SDF == (*glyphIt)->mode;
+                            const GlyphInfo& imageInfo = sdf ?
+                                (*glyphIt)->imageInfo :
+                                (*glyphIt)->info;
+                            auto& glyphIDs = sdf ? p.sdfGlyphIDs : p.glyphIDs;
+                            if (const auto j = glyphIDs.find(imageInfo);
+                                j != glyphIDs.end())
                             {
                                 id = j->second;
                             }
@@ -308,16 +468,45 @@ namespace ftk
                                 p.glyphAtlas->getItem(id, item);
                             if (!valid)
                             {
-                                // Atlas insertion fails when the atlas is full;
-                                // skip the glyph rather than drawing it with an
-                                // invalid (degenerate) texture region.
+                                // A full atlas makes room by emptying its
+                                // least recently used page, which glyphs
+                                // waiting to be drawn may still point at.
+                                if (!p.glyphAtlas->hasRoom((*glyphIt)->image->getSize()))
+                                {
+                                    flush();
+#if defined(FTK_API_GL_4_1)
+                                    p.drawTextGlyphs();
+#elif defined(FTK_API_GLES_2)
+                                    drawTextMesh();
+#endif // FTK_API_GL_4_1
+                                }
+
+                                // Atlas insertion fails for a glyph bigger
+                                // than a page; skip the glyph rather than
+                                // drawing it with an invalid (degenerate)
+                                // texture region.
                                 valid = p.glyphAtlas->addItem((*glyphIt)->image, item);
                                 if (valid)
                                 {
-                                    p.glyphIDs[(*glyphIt)->info] = item.id;
+                                    glyphIDs[imageInfo] = item.id;
                                 }
                             }
+                            const unsigned int texture = valid ?
+                                p.glyphAtlas->getTexture(item.page) :
+                                0;
+                            if (valid && !p.options.batch &&
+                                (texture != p.textTexture || sdf != p.textSDF))
+                            {
+#if defined(FTK_API_GL_4_1)
+                                p.drawTextGlyphs();
+#elif defined(FTK_API_GLES_2)
+                                drawTextMesh();
+#endif // FTK_API_GL_4_1
+                                p.textTexture = texture;
+                                p.textSDF = sdf;
+                            }
 
+#if defined(FTK_API_GL_4_1)
                             if (valid)
                             {
                                 const V2I& offset = (*glyphIt)->offset;
@@ -326,8 +515,51 @@ namespace ftk
                                 const Box2I box(
                                     pos.x + x + offset.x,
                                     pos.y + y + fontMetrics.ascender - offset.y - extraOffset,
-                                    (*glyphIt)->image->getWidth(),
-                                    (*glyphIt)->image->getHeight());
+                                    glyphSize(**glyphIt).w,
+                                    glyphSize(**glyphIt).h);
+                                if (p.options.batch)
+                                {
+                                    glyphInstance(_batchGlyph(texture, sdf), box, item, color);
+                                }
+                                else
+                                {
+                                    p.textGlyphs.emplace_back();
+                                    glyphInstance(p.textGlyphs.back(), box, item, color);
+                                }
+                            }
+#elif defined(FTK_API_GLES_2)
+                            if (valid && p.options.batch)
+                            {
+                                const V2I& offset = (*glyphIt)->offset;
+                                //! \bug Off by one?
+                                const int extraOffset = 1;
+                                const Box2I box(
+                                    pos.x + x + offset.x,
+                                    pos.y + y + fontMetrics.ascender - offset.y - extraOffset,
+                                    glyphSize(**glyphIt).w,
+                                    glyphSize(**glyphIt).h);
+                                const V2F v0(box.min.x, box.min.y);
+                                const V2F v1(box.max.x + 1, box.min.y);
+                                const V2F v2(box.max.x + 1, box.max.y + 1);
+                                const V2F v3(box.min.x, box.max.y + 1);
+                                float* pf = _batchVertices(6, texture);
+                                pf = batchVertex(pf, v0, color, item.u.min(), item.v.min());
+                                pf = batchVertex(pf, v2, color, item.u.max(), item.v.max());
+                                pf = batchVertex(pf, v1, color, item.u.max(), item.v.min());
+                                pf = batchVertex(pf, v2, color, item.u.max(), item.v.max());
+                                pf = batchVertex(pf, v0, color, item.u.min(), item.v.min());
+                                pf = batchVertex(pf, v3, color, item.u.min(), item.v.max());
+                            }
+                            else if (valid)
+                            {
+                                const V2I& offset = (*glyphIt)->offset;
+                                //! \bug Off by one?
+                                const int extraOffset = 1;
+                                const Box2I box(
+                                    pos.x + x + offset.x,
+                                    pos.y + y + fontMetrics.ascender - offset.y - extraOffset,
+                                    glyphSize(**glyphIt).w,
+                                    glyphSize(**glyphIt).h);
 
                                 vP[0].x = box.min.x;
                                 vP[0].y = box.min.y;
@@ -360,6 +592,7 @@ namespace ftk
                                 tP += 4;
                                 triP += 2;
                             }
+#endif // FTK_API_GL_4_1
                         }
 
                         x += (*glyphIt)->advance;
@@ -367,23 +600,13 @@ namespace ftk
                 }
             }
 
-            // Glyphs skipped by clipping leave unused slots at the end of the
-            // (reused) mesh buffers; trim to the emitted counts so stale data
-            // from a previous frame is not drawn.
-            p.textMesh.v.resize(v);
-            p.textMesh.t.resize(v);
-            p.textMesh.triangles.resize(t);
-
-            _drawTextMesh(p.textMesh);
-        }
-
-        namespace
-        {
-            std::string getTexturePoolKey(const ImageInfo& value)
+            if (!p.options.batch)
             {
-                std::stringstream ss;
-                ss << value.size << " " << value.type;
-                return ss.str();
+#if defined(FTK_API_GL_4_1)
+                p.drawTextGlyphs();
+#elif defined(FTK_API_GLES_2)
+                drawTextMesh();
+#endif // FTK_API_GL_4_1
             }
         }
 
@@ -591,6 +814,7 @@ namespace ftk
             drawTexture(id, rect, mirrorV);
 #else // FTK_API_GLES_2
             FTK_P();
+            flush();
             const Size2I destSize = rect.size();
             if (!sourceSize.isValid() || !destSize.isValid() ||
                 (destSize.w >= sourceSize.w && destSize.h >= sourceSize.h))
@@ -599,12 +823,12 @@ namespace ftk
                 return;
             }
 
-            if (!p.shaders["textureScale"])
+            if (!p.shader(RenderShader::TextureScale))
             {
-                p.shaders["textureScale"] = Shader::create(
-                    vertexSource(), textureScaleFragmentSource());
-                p.shaders["textureScale"]->bind();
-                p.shaders["textureScale"]->setUniform("transform.mvp", p.transform);
+                p.setShader(RenderShader::TextureScale, Shader::create(
+                    vertexSource(), textureScaleFragmentSource()));
+                p.shader(RenderShader::TextureScale)->bind();
+                p.shader(RenderShader::TextureScale)->setUniform("transform.mvp", p.transform);
             }
             _scaleContribUpdate(sourceSize, destSize);
 
@@ -623,7 +847,7 @@ namespace ftk
             GLint savedViewport[4] = { 0, 0, 0, 0 };
             glGetIntegerv(GL_VIEWPORT, savedViewport);
             const M44F savedTransform = p.transform;
-            auto& shader = p.shaders["textureScale"];
+            auto& shader = p.shader(RenderShader::TextureScale);
 
             {
                 OffscreenBufferBinding binding(p.scale.buffer);
@@ -676,7 +900,8 @@ namespace ftk
             const TriMesh2F& mesh,
             const Color4F& color,
             const ImageOptions& imageOptions,
-            const std::vector<std::shared_ptr<Texture> >& textures)
+            const std::vector<std::shared_ptr<Texture> >& textures,
+            const V2F& textureRegion)
         {
 #if defined(FTK_API_GLES_2)
             // See drawTextureScaled().
@@ -707,17 +932,17 @@ namespace ftk
             if (outW == inW && outH == inH)
                 return false;
 
-            if (!p.shaders["imageScaleX"])
+            if (!p.shader(RenderShader::ImageScaleX))
             {
-                p.shaders["imageScaleX"] = Shader::create(
-                    vertexSource(), imageScaleXFragmentSource());
-                p.shaders["imageScaleX"]->bind();
-                p.shaders["imageScaleX"]->setUniform("transform.mvp", p.transform);
+                p.setShader(RenderShader::ImageScaleX, Shader::create(
+                    vertexSource(), imageScaleXFragmentSource()));
+                p.shader(RenderShader::ImageScaleX)->bind();
+                p.shader(RenderShader::ImageScaleX)->setUniform("transform.mvp", p.transform);
             }
-            if (!p.shaders["imageScaleY"])
+            if (!p.shader(RenderShader::ImageScaleY))
             {
-                p.shaders["imageScaleY"] = Shader::create(
-                    vertexSource(), imageScaleYFragmentSource());
+                p.setShader(RenderShader::ImageScaleY, Shader::create(
+                    vertexSource(), imageScaleYFragmentSource()));
             }
 
             _scaleContribUpdate(Size2I(inW, inH), Size2I(outW, outH));
@@ -744,7 +969,7 @@ namespace ftk
                     -1.F,
                     1.F));
 
-                auto& shader = p.shaders["imageScaleX"];
+                auto& shader = p.shader(RenderShader::ImageScaleX);
                 shader->bind();
                 shader->setUniform("imageType", static_cast<int>(info.type));
                 shader->setUniform("channelCount", getChannelCount(info.type));
@@ -758,6 +983,7 @@ namespace ftk
                 shader->setUniform("videoLevels", static_cast<int>(videoLevels));
                 shader->setUniform("yuvCoefficients", getYUVCoefficients(info.yuvCoefficients));
                 shader->setUniform("mirrorX", info.layout.mirror.x);
+                shader->setUniform("textureRegion", textureRegion);
                 shader->setUniform("scaleTaps", p.scale.xTaps);
                 _setActiveTextures(shader, info, textures);
                 glActiveTexture(GL_TEXTURE3);
@@ -786,7 +1012,7 @@ namespace ftk
             {
                 glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
             }
-            auto& shader = p.shaders["imageScaleY"];
+            auto& shader = p.shader(RenderShader::ImageScaleY);
             shader->bind();
             shader->setUniform("transform.mvp", p.transform);
             shader->setUniform("color", color);
@@ -813,29 +1039,7 @@ namespace ftk
         void Render::_drawScaleQuad(const Box2F& box)
         {
             FTK_P();
-            const auto m = mesh(box);
-            const size_t size = m.triangles.size();
-            if (!p.vbos["imageScale"] ||
-                (p.vbos["imageScale"] && p.vbos["imageScale"]->getSize() < size * 3))
-            {
-                p.vbos["imageScale"] = VBO::create(size * 3, VBOType::Pos2_F32_UV_U16);
-                p.vaos["imageScale"].reset();
-            }
-            if (p.vbos["imageScale"])
-            {
-                p.vbos["imageScale"]->copy(convert(m, VBOType::Pos2_F32_UV_U16));
-                p.diag.triangles += size;
-            }
-            if (!p.vaos["imageScale"] && p.vbos["imageScale"])
-            {
-                p.vaos["imageScale"] = VAO::create(
-                    p.vbos["imageScale"]->getType(), p.vbos["imageScale"]->getID());
-            }
-            if (p.vaos["imageScale"] && p.vbos["imageScale"])
-            {
-                p.vaos["imageScale"]->bind();
-                p.vaos["imageScale"]->draw(GL_TRIANGLES, 0, size * 3);
-            }
+            p.drawStream(mesh(box), VBOType::Pos2_F32_UV_U16);
         }
 
         void Render::drawImage(
@@ -850,14 +1054,21 @@ namespace ftk
             if (!info.isValid())
                 return;
 
+            flush();
+
             std::vector<std::shared_ptr<Texture> > textures;
             if (!imageOptions.cache)
             {
-                const std::string texturePoolKey = getTexturePoolKey(info);
-                if (!p.texturePool.get(texturePoolKey, textures))
+                const TexturePoolKey key(info, imageOptions.imageFilters);
+                if (p.texturePool.acquire(key, textures))
                 {
-                    textures = _getTextures(info, imageOptions.imageFilters);
-                    p.texturePool.add(texturePoolKey, textures, image->getByteCount());
+                    ++p.diag.texturePoolHits;
+                }
+                else
+                {
+                    textures = _getTextures(key.info, imageOptions.imageFilters, true);
+                    p.diag.texturePoolEvictions += p.texturePool.add(key, textures);
+                    ++p.diag.texturePoolMisses;
                 }
                 _copyTextures(image, textures);
             }
@@ -865,23 +1076,35 @@ namespace ftk
             {
                 textures = _getTextures(info, imageOptions.imageFilters);
                 _copyTextures(image, textures);
-                p.textureCache.add(image, textures, image->getByteCount());
+                size_t byteCount = image->getByteCount();
+                if (ImageFilter::Mipmap == imageOptions.imageFilters.minify)
+                {
+                    // The levels add a third.
+                    byteCount += byteCount / 3;
+                }
+                p.textureCache.add(image, textures, byteCount);
             }
             p.diag.textures += textures.size();
+            if (textures.empty())
+                return;
+            // Pooled textures may be bigger than the image.
+            const V2F textureRegion(
+                info.size.w / static_cast<float>(textures[0]->getWidth()),
+                info.size.h / static_cast<float>(textures[0]->getHeight()));
 
             if (ImageFilter::HighQuality == imageOptions.imageFilters.minify &&
-                _drawImageScaled(image, mesh, color, imageOptions, textures))
+                _drawImageScaled(image, mesh, color, imageOptions, textures, textureRegion))
             {
                 return;
             }
 
-            p.shaders["image"]->bind();
-            _setActiveTextures(p.shaders["image"], info, textures);
-            p.shaders["image"]->setUniform("color", color);
-            p.shaders["image"]->setUniform("opaque", AlphaBlend::None == imageOptions.alphaBlend);
-            p.shaders["image"]->setUniform("imageType", static_cast<int>(info.type));
-            p.shaders["image"]->setUniform("channelCount", getChannelCount(info.type));
-            p.shaders["image"]->setUniform("channelDisplay", static_cast<int>(imageOptions.channelDisplay));
+            p.shader(RenderShader::Image)->bind();
+            _setActiveTextures(p.shader(RenderShader::Image), info, textures);
+            p.shader(RenderShader::Image)->setUniform(p.uniform(RenderShader::Image).color, color);
+            p.shader(RenderShader::Image)->setUniform("opaque", AlphaBlend::None == imageOptions.alphaBlend);
+            p.shader(RenderShader::Image)->setUniform("imageType", static_cast<int>(info.type));
+            p.shader(RenderShader::Image)->setUniform("channelCount", getChannelCount(info.type));
+            p.shader(RenderShader::Image)->setUniform("channelDisplay", static_cast<int>(imageOptions.channelDisplay));
             VideoLevels videoLevels = info.videoLevels;
             switch (imageOptions.videoLevels)
             {
@@ -893,10 +1116,11 @@ namespace ftk
                 break;
             default: break;
             }
-            p.shaders["image"]->setUniform("videoLevels", static_cast<int>(videoLevels));
-            p.shaders["image"]->setUniform("yuvCoefficients", getYUVCoefficients(info.yuvCoefficients));
-            p.shaders["image"]->setUniform("mirrorX", info.layout.mirror.x);
-            p.shaders["image"]->setUniform("mirrorY", info.layout.mirror.y);
+            p.shader(RenderShader::Image)->setUniform("videoLevels", static_cast<int>(videoLevels));
+            p.shader(RenderShader::Image)->setUniform("yuvCoefficients", getYUVCoefficients(info.yuvCoefficients));
+            p.shader(RenderShader::Image)->setUniform("mirrorX", info.layout.mirror.x);
+            p.shader(RenderShader::Image)->setUniform("mirrorY", info.layout.mirror.y);
+            p.shader(RenderShader::Image)->setUniform("textureRegion", textureRegion);
 
             if (imageOptions.alphaBlend != AlphaBlend::None)
             {
@@ -907,27 +1131,7 @@ namespace ftk
                 glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
             }
 
-            const size_t size = mesh.triangles.size();
-            if (!p.vbos["image"] || (p.vbos["image"] && p.vbos["image"]->getSize() < size * 3))
-            {
-                p.vbos["image"] = VBO::create(size * 3, VBOType::Pos2_F32_UV_U16);
-                p.vaos["image"].reset();
-            }
-            if (p.vbos["image"])
-            {
-                p.vbos["image"]->copy(convert(mesh, VBOType::Pos2_F32_UV_U16));
-                p.diag.triangles += mesh.triangles.size();
-            }
-
-            if (!p.vaos["image"] && p.vbos["image"])
-            {
-                p.vaos["image"] = VAO::create(p.vbos["image"]->getType(), p.vbos["image"]->getID());
-            }
-            if (p.vaos["image"] && p.vbos["image"])
-            {
-                p.vaos["image"]->bind();
-                p.vaos["image"]->draw(GL_TRIANGLES, 0, size * 3);
-            }
+            p.drawStream(mesh, VBOType::Pos2_F32_UV_U16);
         }
 
         void Render::drawImage(
@@ -941,30 +1145,7 @@ namespace ftk
 
         void Render::_drawTextMesh(const TriMesh2F& mesh)
         {
-            FTK_P();
-            const size_t size = mesh.triangles.size();
-            if (size > 0)
-            {
-                if (!p.vbos["text"] || (p.vbos["text"] && p.vbos["text"]->getSize() < size * 3))
-                {
-                    p.vbos["text"] = VBO::create(size * 3, VBOType::Pos2_F32_UV_U16);
-                    p.vaos["text"].reset();
-                }
-                if (p.vbos["text"])
-                {
-                    p.vbos["text"]->copy(convert(mesh, p.vbos["text"]->getType()));
-                    p.diag.triangles += mesh.triangles.size();
-                }
-                if (!p.vaos["text"] && p.vbos["text"])
-                {
-                    p.vaos["text"] = VAO::create(p.vbos["text"]->getType(), p.vbos["text"]->getID());
-                }
-                if (p.vaos["text"] && p.vbos["text"])
-                {
-                    p.vaos["text"]->bind();
-                    p.vaos["text"]->draw(GL_TRIANGLES, 0, size * 3);
-                }
-            }
+            _p->drawStream(mesh, VBOType::Pos2_F32_UV_U16);
         }
     }
 }
@@ -7,9 +7,12 @@
 #include <ftk/GL/Mesh.h>
 #include <ftk/GL/OffscreenBuffer.h>
 #include <ftk/GL/Shader.h>
+#include <ftk/GL/Texture.h>
 #include <ftk/GL/TextureAtlas.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <list>
 #include <map>
 #include <unordered_map>
@@ -30,6 +33,190 @@ namespace ftk
         std::string textureScaleFragmentSource();
         std::string imageScaleXFragmentSource();
         std::string imageScaleYFragmentSource();
+        std::string batchVertexSource();
+        std::string batchFragmentSource();
+#if defined(FTK_API_GL_4_1)
+        std::string glyphVertexSource();
+        std::string glyphSDFFragmentSource();
+#endif // FTK_API_GL_4_1
+
+        //! The renderer's shaders.
+        enum class RenderShader
+        {
+            Line,
+            Mesh,
+            ColorMesh,
+            Texture,
+            Text,
+            Image,
+            Batch,
+            Glyph,
+            GlyphSDF,
+            TextureScale,
+            ImageScaleX,
+            ImageScaleY,
+
+            Count
+        };
+
+        //! The locations of the uniforms set for every draw, looked up when
+        //! the shader is created.
+        struct RenderUniforms
+        {
+            int mvp = -1;
+            int color = -1;
+            int textureSampler = -1;
+        };
+
+        //! A glyph drawn as an instanced quad, in the
+        //! Quad_F32_UV_F32_Color_U8 layout: 36 bytes rather than six
+        //! 32 byte vertices.
+        struct GlyphInstance
+        {
+            float box[4];
+            float uv[4];
+            uint8_t color[4];
+        };
+
+        //! Round a width or height up to its size class: sixteen steps
+        //! between powers of two, and multiples of sixteen below 512. A
+        //! frame a few pixels smaller than another reuses its textures, at
+        //! the cost of at most a sixteenth more memory in each direction.
+        inline int getSizeClass(int value)
+        {
+            int step = 16;
+            while (step * 32 <= value)
+            {
+                step *= 2;
+            }
+            return (value + step - 1) / step * step;
+        }
+
+        //! A texture pool key: the image information with the size rounded
+        //! up to its size class, and the filters. The hash is computed once,
+        //! when the key is made.
+        struct TexturePoolKey
+        {
+            TexturePoolKey() = default;
+            TexturePoolKey(const ImageInfo& value, const ImageFilters& filters) :
+                info(
+                    Size2I(getSizeClass(value.size.w), getSizeClass(value.size.h)),
+                    value.type),
+                filters(filters)
+            {
+                info.layout = value.layout;
+                hash = std::hash<int>{}(info.size.w);
+                hash = hashCombine(hash, std::hash<int>{}(info.size.h));
+                hash = hashCombine(hash, std::hash<int>{}(static_cast<int>(info.type)));
+                hash = hashCombine(hash, std::hash<bool>{}(info.layout.mirror.x));
+                hash = hashCombine(hash, std::hash<bool>{}(info.layout.mirror.y));
+                hash = hashCombine(hash, std::hash<int>{}(info.layout.alignment));
+                hash = hashCombine(hash, std::hash<int>{}(static_cast<int>(info.layout.endian)));
+                hash = hashCombine(hash, std::hash<int>{}(static_cast<int>(filters.minify)));
+                hash = hashCombine(hash, std::hash<int>{}(static_cast<int>(filters.magnify)));
+            }
+
+            ImageInfo    info;
+            ImageFilters filters;
+            size_t       hash = 0;
+
+            bool operator == (const TexturePoolKey& other) const
+            {
+                return
+                    hash == other.hash &&
+                    info == other.info &&
+                    filters == other.filters;
+            }
+        };
+
+        //! Textures for images that are not cached, which are copied to
+        //! again each time they are drawn. A set of textures is leased to
+        //! one image for the rest of the frame, so two images of the same
+        //! size class drawn in the same frame do not overwrite each other's
+        //! textures, and returned to the pool by end().
+        struct TexturePool
+        {
+            struct Entry
+            {
+                TexturePoolKey key;
+                std::vector<std::shared_ptr<Texture> > textures;
+                size_t byteCount = 0;
+            };
+
+            // Sets not in use, the most recently used first.
+            std::list<Entry> free;
+
+            // Sets leased this frame.
+            std::list<Entry> leased;
+
+            // The total of both.
+            size_t byteCount = 0;
+            size_t max = 0;
+
+            //! Lease a set of textures that is not in use. Returns false if
+            //! there is none for the key.
+            bool acquire(
+                const TexturePoolKey& key,
+                std::vector<std::shared_ptr<Texture> >& out)
+            {
+                for (auto i = free.begin(); i != free.end(); ++i)
+                {
+                    if (i->key == key)
+                    {
+                        out = i->textures;
+                        leased.splice(leased.end(), free, i);
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            //! Add a new set of textures, leased. Returns the number of sets
+            //! evicted to make room.
+            size_t add(
+                const TexturePoolKey& key,
+                const std::vector<std::shared_ptr<Texture> >& textures)
+            {
+                Entry entry;
+                entry.key = key;
+                entry.textures = textures;
+                for (const auto& texture : textures)
+                {
+                    entry.byteCount += texture->getInfo().getByteCount();
+                }
+                byteCount += entry.byteCount;
+                leased.push_back(std::move(entry));
+                return evict();
+            }
+
+            //! Return the leased sets. Returns the number of sets evicted.
+            size_t release()
+            {
+                free.splice(free.begin(), leased);
+                return evict();
+            }
+
+            //! Evict the least recently used sets that are not in use until
+            //! the pool is under its byte count. Returns the number evicted.
+            size_t evict()
+            {
+                size_t out = 0;
+                while (byteCount > max && !free.empty())
+                {
+                    byteCount -= free.back().byteCount;
+                    free.pop_back();
+                    ++out;
+                }
+                return out;
+            }
+
+            void clear()
+            {
+                free.clear();
+                leased.clear();
+                byteCount = 0;
+            }
+        };
 
         struct Render::Private
         {
@@ -40,17 +227,114 @@ namespace ftk
             Box2I clipRect;
             M44F transform;
             
-            std::map<std::string, std::shared_ptr<gl::Shader> > shaders;
+            // Indexed rather than looked up by name: these are reached
+            // several times for every primitive drawn.
+            std::array<
+                std::shared_ptr<Shader>,
+                static_cast<size_t>(RenderShader::Count)> shaders;
+            std::array<
+                RenderUniforms,
+                static_cast<size_t>(RenderShader::Count)> uniforms;
 
-            LRUCache<
-                std::string,
-                std::vector<std::shared_ptr<Texture> > > texturePool;
+            std::shared_ptr<Shader>& shader(RenderShader value)
+            {
+                return shaders[static_cast<size_t>(value)];
+            }
+
+            const RenderUniforms& uniform(RenderShader value) const
+            {
+                return uniforms[static_cast<size_t>(value)];
+            }
+
+            void setShader(RenderShader value, const std::shared_ptr<Shader>& shader)
+            {
+                const size_t i = static_cast<size_t>(value);
+                shaders[i] = shader;
+                uniforms[i].mvp = shader->getUniformLocation("transform.mvp");
+                uniforms[i].color = shader->getUniformLocation("color");
+                uniforms[i].textureSampler = shader->getUniformLocation("textureSampler");
+            }
+
+            TexturePool texturePool;
             LRUCache<
                 std::shared_ptr<Image>,
                 std::vector<std::shared_ptr<Texture> > > textureCache;
             std::shared_ptr<gl::TextureAtlas> glyphAtlas;
+            // Bitmap and SDF glyphs are kept apart; an SDF glyph is keyed by
+            // its reference size, which a bitmap glyph may also have.
             std::unordered_map<GlyphInfo, BoxPackID> glyphIDs;
+            std::unordered_map<GlyphInfo, BoxPackID> sdfGlyphIDs;
+            GlyphMode glyphMode = GlyphMode::Bitmap;
+            // The eviction count when the frame began.
+            size_t glyphAtlasEvictions = 0;
             TriMesh2F textMesh;
+
+            // Rectangles, lines, meshes and text waiting to be drawn, as
+            // Pos2_F32_UV_F32_Color_F32 vertices, and on OpenGL 4.1 text as
+            // glyph instances. The runs keep the order they were recorded
+            // in, alternating between the two, and a new run starts where
+            // text moves to another glyph atlas page or between bitmap and
+            // SDF glyphs. The framebuffer and viewport are the ones set when
+            // the first of them was recorded, which is where they are drawn.
+            // Something that changes either without flushing first is a bug
+            // in the caller; it is logged and the batch put back in place.
+            struct BatchData
+            {
+                std::vector<uint8_t> vertices;
+                size_t count = 0;
+                std::vector<GlyphInstance> glyphs;
+                struct Run
+                {
+                    bool glyphs = false;
+                    bool sdf = false;
+                    unsigned int texture = 0;
+                    size_t first = 0;
+                    size_t count = 0;
+                };
+                std::vector<Run> runs;
+                GLint framebuffer = 0;
+                std::array<GLint, 4> viewport = { 0, 0, 0, 0 };
+
+                Run& run(bool glyphs, unsigned int texture = 0, bool sdf = false)
+                {
+                    if (runs.empty() ||
+                        runs.back().glyphs != glyphs ||
+                        runs.back().sdf != sdf ||
+                        (texture && runs.back().texture && runs.back().texture != texture))
+                    {
+                        Run run;
+                        run.glyphs = glyphs;
+                        run.sdf = sdf;
+                        run.first = glyphs ? this->glyphs.size() : count;
+                        runs.push_back(run);
+                    }
+                    if (texture)
+                    {
+                        runs.back().texture = texture;
+                    }
+                    return runs.back();
+                }
+
+                void clear()
+                {
+                    vertices.clear();
+                    count = 0;
+                    glyphs.clear();
+                    runs.clear();
+                }
+            };
+            BatchData batch;
+            bool flushing = false;
+            bool batchStateWarning = false;
+
+            // The renderer on this thread before begin(), put back by end().
+            Render* previousRender = nullptr;
+
+            // Glyphs for drawText() when not batching, the glyph atlas page
+            // they are on, and whether they are SDF glyphs.
+            std::vector<GlyphInstance> textGlyphs;
+            unsigned int textTexture = 0;
+            bool textSDF = false;
             // High quality scaling: the intermediate the first pass writes,
             // and the contribution tables, which depend only on the two sizes
             // so they are rebuilt only when those change.
@@ -80,8 +364,94 @@ namespace ftk
             };
             ScaleData scale;
 
-            std::map<std::string, std::shared_ptr<gl::VBO> > vbos;
-            std::map<std::string, std::shared_ptr<gl::VAO> > vaos;
+            // One streaming buffer for each vertex format rather than one
+            // for each kind of primitive: everything drawn with a format
+            // goes through the same ring, so a buffer is only created again
+            // when a draw is bigger than the ring.
+            std::array<
+                std::shared_ptr<VBOStream>,
+                static_cast<size_t>(VBOType::Count)> streams;
+            std::array<
+                std::shared_ptr<VAO>,
+                static_cast<size_t>(VBOType::Count)> streamVAOs;
+
+            //! Get the stream for a vertex format, with room for at least
+            //! the given number of vertices, and bind its vertex array.
+            VBOStream* stream(VBOType type, size_t count)
+            {
+                const size_t i = static_cast<size_t>(type);
+                if (!streams[i] || streams[i]->getSize() < count)
+                {
+                    const size_t size = std::max(
+                        count,
+                        streams[i] ? streams[i]->getSize() * 2 : streamSize);
+                    streams[i] = VBOStream::create(size, type);
+                    streamVAOs[i] = VAO::create(type, streams[i]->getID());
+                }
+                streamVAOs[i]->bind();
+                return streams[i].get();
+            }
+
+            //! Draw vertices written to a stream; the vertex array is the
+            //! one bound by stream().
+            void streamDraw(VBOType type, size_t first, size_t count)
+            {
+                streamVAOs[static_cast<size_t>(type)]->draw(GL_TRIANGLES, first, count);
+                diag.triangles += count / 3;
+                ++diag.drawCalls;
+            }
+
+#if defined(FTK_API_GL_4_1)
+            //! Draw glyph instances written to a stream; the vertex array is
+            //! the one bound by stream().
+            void streamDrawGlyphs(size_t first, size_t count)
+            {
+                streamVAOs[static_cast<size_t>(VBOType::Quad_F32_UV_F32_Color_U8)]->drawInstances(
+                    GL_TRIANGLES, 0, 6, first, count);
+                diag.triangles += count * 2;
+                ++diag.drawCalls;
+            }
+
+            //! Draw the glyphs waiting in textGlyphs.
+            void drawTextGlyphs()
+            {
+                const size_t count = textGlyphs.size();
+                if (count > 0)
+                {
+                    diag.glyphUploads += glyphAtlas->upload();
+                    const RenderShader shader = textSDF ? RenderShader::GlyphSDF : RenderShader::Glyph;
+                    this->shader(shader)->bind();
+                    this->shader(shader)->setUniform(uniform(shader).textureSampler, 0);
+                    glBindTexture(GL_TEXTURE_2D, textTexture);
+                    auto stream = this->stream(VBOType::Quad_F32_UV_F32_Color_U8, count);
+                    size_t first = 0;
+                    if (uint8_t* data = stream->map(count, first))
+                    {
+                        memcpy(data, textGlyphs.data(), count * sizeof(GlyphInstance));
+                        stream->unmap();
+                        streamDrawGlyphs(first, count);
+                    }
+                    textGlyphs.clear();
+                }
+            }
+#endif // FTK_API_GL_4_1
+
+            //! Write a mesh to the stream for the vertex format and draw it.
+            void drawStream(const TriMesh2F& mesh, VBOType type)
+            {
+                const size_t count = mesh.triangles.size() * 3;
+                if (count > 0)
+                {
+                    size_t first = 0;
+                    if (stream(type, count)->copy(mesh, first))
+                    {
+                        streamDraw(type, first, count);
+                    }
+                }
+            }
+
+            //! The initial size of a stream in vertices.
+            static constexpr size_t streamSize = 65536;
 
             std::chrono::time_point<std::chrono::steady_clock> startTime;
             RenderDiag diag;
@@ -130,6 +130,60 @@ namespace ftk
                 "}\n";
         }
 
+        std::string batchVertexSource()
+        {
+            return
+                "precision mediump float;\n"
+                "\n"
+                "attribute vec2 vPos;\n"
+                "attribute vec2 vTexture;\n"
+                "attribute vec4 vColor;\n"
+                "varying vec2 fTexture;\n"
+                "varying vec4 fColor;\n"
+                "\n"
+                "struct Transform\n"
+                "{\n"
+                "    mat4 mvp;\n"
+                "};\n"
+                "\n"
+                "uniform Transform transform;\n"
+                "\n"
+                "void main()\n"
+                "{\n"
+                "    gl_Position = transform.mvp * vec4(vPos, 0.0, 1.0);\n"
+                "    fTexture = vTexture;\n"
+                "    fColor = vColor;\n"
+                "}\n";
+        }
+
+        std::string batchFragmentSource()
+        {
+            return
+                "precision mediump float;\n"
+                "\n"
+                "varying vec2 fTexture;\n"
+                "varying vec4 fColor;\n"
+                "\n"
+                "uniform sampler2D textureSampler;\n"
+                "\n"
+                "void main()\n"
+                "{\n"
+                "    if (fTexture.x < 0.0)\n"
+                "    {\n"
+                "        gl_FragColor = fColor;\n"
+                "    }\n"
+                "    else\n"
+                "    {\n"
+                "        gl_FragColor.r = fColor.r;\n"
+                "        gl_FragColor.g = fColor.g;\n"
+                "        gl_FragColor.b = fColor.b;\n"
+                "        float coverage = texture2D(textureSampler, fTexture).r * fColor.a;\n"
+                "        float gamma = 1.3;\n"
+                "        gl_FragColor.a = pow(coverage, 1.0 / gamma);\n"
+                "    }\n"
+                "}\n";
+        }
+
         namespace
         {
             const std::string imageType =
@@ -320,6 +374,7 @@ namespace ftk
                 "uniform vec4      yuvCoefficients;\n"
                 "uniform int       mirrorX;\n"
                 "uniform int       mirrorY;\n"
+                "uniform vec2      textureRegion;\n"
                 "uniform sampler2D textureSampler0;\n"
                 "uniform sampler2D textureSampler1;\n"
                 "uniform sampler2D textureSampler2;\n"
@@ -335,6 +390,7 @@ namespace ftk
                 "    {\n"
                 "        t.y = 1.0 - t.y;\n"
                 "    }\n"
+                "    t *= textureRegion;\n"
                 "    gl_FragColor = sampleTexture("
                 "        t,\n"
                 "        imageType,\n"
@@ -134,6 +134,127 @@ namespace ftk
                 "}\n";
         }
 
+        std::string batchVertexSource()
+        {
+            return
+                "#version 410\n"
+                "\n"
+                "layout(location = 0) in vec2 vPos;\n"
+                "layout(location = 1) in vec2 vTexture;\n"
+                "layout(location = 2) in vec4 vColor;\n"
+                "out vec2 fTexture;\n"
+                "out vec4 fColor;\n"
+                "\n"
+                "struct Transform\n"
+                "{\n"
+                "    mat4 mvp;\n"
+                "};\n"
+                "\n"
+                "uniform Transform transform;\n"
+                "\n"
+                "void main()\n"
+                "{\n"
+                "    gl_Position = transform.mvp * vec4(vPos, 0.0, 1.0);\n"
+                "    fTexture = vTexture;\n"
+                "    fColor = vColor;\n"
+                "}\n";
+        }
+
+        std::string batchFragmentSource()
+        {
+            return
+                "#version 410\n"
+                "\n"
+                "in vec2 fTexture;\n"
+                "in vec4 fColor;\n"
+                "out vec4 outColor;\n"
+                "\n"
+                "uniform sampler2D textureSampler;\n"
+                "\n"
+                "void main()\n"
+                "{\n"
+                "    // Geometry carries a negative texture coordinate, glyphs a\n"
+                "    // position in the atlas.\n"
+                "    if (fTexture.x < 0.0)\n"
+                "    {\n"
+                "        outColor = fColor;\n"
+                "    }\n"
+                "    else\n"
+                "    {\n"
+                "        outColor.r = fColor.r;\n"
+                "        outColor.g = fColor.g;\n"
+                "        outColor.b = fColor.b;\n"
+                "        float coverage = texture(textureSampler, fTexture).r * fColor.a;\n"
+                "        float gamma = 1.3;\n"
+                "        outColor.a = pow(coverage, 1.0 / gamma);\n"
+                "    }\n"
+                "}\n";
+        }
+
+        std::string glyphVertexSource()
+        {
+            return
+                "#version 410\n"
+                "\n"
+                "layout(location = 0) in vec4 vBox;\n"
+                "layout(location = 1) in vec4 vTexture;\n"
+                "layout(location = 2) in vec4 vColor;\n"
+                "out vec2 fTexture;\n"
+                "out vec4 fColor;\n"
+                "\n"
+                "struct Transform\n"
+                "{\n"
+                "    mat4 mvp;\n"
+                "};\n"
+                "\n"
+                "uniform Transform transform;\n"
+                "\n"
+                "// The corners of the quad's two triangles, wound the same way\n"
+                "// as the batch's.\n"
+                "const vec2 corners[6] = vec2[6](\n"
+                "    vec2(0.0, 0.0),\n"
+                "    vec2(1.0, 1.0),\n"
+                "    vec2(1.0, 0.0),\n"
+                "    vec2(1.0, 1.0),\n"
+                "    vec2(0.0, 0.0),\n"
+                "    vec2(0.0, 1.0));\n"
+                "\n"
+                "void main()\n"
+                "{\n"
+                "    vec2 corner = corners[gl_VertexID];\n"
+                "    gl_Position = transform.mvp * vec4(vBox.xy + corner * vBox.zw, 0.0, 1.0);\n"
+                "    fTexture = mix(vTexture.xy, vTexture.zw, corner);\n"
+                "    fColor = vColor;\n"
+                "}\n";
+        }
+
+        std::string glyphSDFFragmentSource()
+        {
+            return
+                "#version 410\n"
+                "\n"
+                "in vec2 fTexture;\n"
+                "in vec4 fColor;\n"
+                "out vec4 outColor;\n"
+                "\n"
+                "uniform sampler2D textureSampler;\n"
+                "\n"
+                "void main()\n"
+                "{\n"
+                "    // The outline is at one half. Smoothing over the change in\n"
+                "    // distance from one pixel to the next keeps the edge about a\n"
+                "    // pixel wide at whatever size the glyph is drawn.\n"
+                "    float distance = texture(textureSampler, fTexture).r;\n"
+                "    float width = max(fwidth(distance) * 0.5, 0.0001);\n"
+                "    float coverage = smoothstep(0.5 - width, 0.5 + width, distance) * fColor.a;\n"
+                "    float gamma = 1.3;\n"
+                "    outColor.r = fColor.r;\n"
+                "    outColor.g = fColor.g;\n"
+                "    outColor.b = fColor.b;\n"
+                "    outColor.a = pow(coverage, 1.0 / gamma);\n"
+                "}\n";
+        }
+
         namespace
         {
             const std::string imageType =
@@ -375,6 +496,7 @@ namespace ftk
                 "uniform int       videoLevels;\n"
                 "uniform vec4      yuvCoefficients;\n"
                 "uniform int       mirrorX;\n"
+                "uniform vec2      textureRegion;\n"
                 "uniform sampler2D textureSampler0;\n"
                 "uniform sampler2D textureSampler1;\n"
                 "uniform sampler2D textureSampler2;\n"
@@ -392,6 +514,7 @@ namespace ftk
                 "        {\n"
                 "            t.x = 1.0 - t.x;\n"
                 "        }\n"
+                "        t *= textureRegion;\n"
                 "        c += tap.y * sampleTexture("
                 "            t,\n"
                 "            imageType,\n"
@@ -501,6 +624,7 @@ namespace ftk
                 "uniform vec4      yuvCoefficients;\n"
                 "uniform int       mirrorX;\n"
                 "uniform int       mirrorY;\n"
+                "uniform vec2      textureRegion;\n"
                 "uniform sampler2D textureSampler0;\n"
                 "uniform sampler2D textureSampler1;\n"
                 "uniform sampler2D textureSampler2;\n"
@@ -516,6 +640,7 @@ namespace ftk
                 "    {\n"
                 "        t.y = 1.0 - t.y;\n"
                 "    }\n"
+                "    t *= textureRegion;\n"
                 "    outColor = sampleTexture("
                 "        t,\n"
                 "        imageType,\n"
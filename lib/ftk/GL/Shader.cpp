@@ -4,6 +4,7 @@
 #include <ftk/GL/Shader.h>
 
 #include <ftk/GL/GL.h>
+#include <ftk/GL/Render.h>
 
 #include <ftk/Core/Color.h>
 #include <ftk/Core/Format.h>
@@ -11,6 +12,7 @@
 
 #include <atomic>
 #include <iostream>
+#include <unordered_map>
 
 namespace ftk
 {
@@ -23,6 +25,7 @@ namespace ftk
             GLuint vertex = 0;
             GLuint fragment = 0;
             GLuint program = 0;
+            std::unordered_map<std::string, GLint> uniformLocations;
         };
 
         namespace
@@ -100,6 +103,31 @@ namespace ftk
                 glGetProgramInfoLog(p.program, cStringSize, NULL, infoLog);
                 throw std::runtime_error(infoLog);
             }
+
+            // Look up every uniform now rather than on each set. Arrays are
+            // reported by their first element, "name[0]", and are found by
+            // either name.
+            GLint uniformCount = 0;
+            glGetProgramiv(p.program, GL_ACTIVE_UNIFORMS, &uniformCount);
+            for (GLint i = 0; i < uniformCount; ++i)
+            {
+                char name[cStringSize];
+                GLsizei length = 0;
+                GLint size = 0;
+                GLenum type = 0;
+                glGetActiveUniform(p.program, i, cStringSize, &length, &size, &type, name);
+                const GLint location = glGetUniformLocation(p.program, name);
+                if (location != -1)
+                {
+                    std::string s(name, length);
+                    p.uniformLocations[s] = location;
+                    const size_t j = s.rfind("[0]");
+                    if (j != std::string::npos && j + 3 == s.size())
+                    {
+                        p.uniformLocations[s.substr(0, j)] = location;
+                    }
+                }
+            }
         }
 
         Shader::Shader() :
@@ -156,9 +184,22 @@ namespace ftk
 
         void Shader::bind()
         {
+            flushRender();
             glUseProgram(_p->program);
         }
 
+        int Shader::getUniformLocation(const std::string& name) const
+        {
+            FTK_P();
+            const auto i = p.uniformLocations.find(name);
+            if (i != p.uniformLocations.end())
+                return i->second;
+            // Elements of an array past the first are not listed.
+            return !name.empty() && ']' == name.back() ?
+                glGetUniformLocation(p.program, name.c_str()) :
+                -1;
+        }
+
         void Shader::setUniform(int location, int value)
         {
             glUniform1i(location, value);
@@ -228,79 +269,79 @@ namespace ftk
 
         void Shader::setUniform(const std::string& name, int value)
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
 
         void Shader::setUniform(const std::string& name, float value)
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
 
         void Shader::setUniform(const std::string& name, const V2F& value)
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
 
         void Shader::setUniform(const std::string& name, const V3F& value)
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
 
         void Shader::setUniform(const std::string& name, const V4F& value)
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
 
         void Shader::setUniform(const std::string& name, const M33F& value)
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
 
         void Shader::setUniform(const std::string& name, const M44F& value)
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
         
         void Shader::setUniform(const std::string& name, const Color4F& value)
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
 
         void Shader::setUniform(const std::string& name, const float value[4])
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
 
         void Shader::setUniform(const std::string& name, const std::vector<int>& value)
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
 
         void Shader::setUniform(const std::string& name, const std::vector<float>& value)
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
 
         void Shader::setUniform(const std::string& name, const std::vector<V3F>& value)
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
 
         void Shader::setUniform(const std::string& name, const std::vector<V4F>& value)
         {
-            const GLint location = glGetUniformLocation(_p->program, name.c_str());
+            const GLint location = getUniformLocation(name);
             setUniform(location, value);
         }
 
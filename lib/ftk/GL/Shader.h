@@ -49,6 +49,11 @@ namespace ftk
             //! Bind the shader.
             FTK_API void bind();
 
+            //! Get the location of a uniform, or -1 if the program does not
+            //! use it. The locations are looked up once, when the program is
+            //! linked, so this does not call into OpenGL.
+            FTK_API int getUniformLocation(const std::string&) const;
+
             //! \name Uniforms
             //! Set uniform values.
             ///@{
@@ -11,6 +11,7 @@
 #include <ftk/Core/Format.h>
 #include <ftk/Core/String.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstring>
@@ -377,7 +378,8 @@ namespace ftk
         {
             return
                 filters == other.filters &&
-                pbo == other.pbo;
+                pbo == other.pbo &&
+                pboCount == other.pboCount;
         }
 
         bool TextureOptions::operator != (const TextureOptions& other) const
@@ -420,6 +422,9 @@ namespace ftk
                 // Anything that treats this as a plain texture parameter --
                 // an offscreen buffer's own filters, or magnifying, which the
                 // two pass path does not serve -- gets the sensible thing.
+                GL_LINEAR,
+                // Likewise: only a texture with a chain of levels can use a
+                // mipmap filter, and Texture asks for that itself.
                 GL_LINEAR
             };
             return data[static_cast<size_t>(value)];
@@ -435,10 +440,227 @@ namespace ftk
         {
             TextureInfo info;
             ImageInfo imageInfo;
-            GLuint pbo = 0;
             GLuint id = 0;
+
+            // Whether the mipmap levels are made again after each copy.
+            bool mipmaps = false;
+
+#if defined(FTK_API_GL_4_1)
+            // The pixel buffers, used in turn. A buffer's fence is set after
+            // the texture is updated from it, and has signalled once the
+            // transfer has finished with the buffer.
+            struct PBO
+            {
+                GLuint id = 0;
+                GLsync fence = NULL;
+            };
+            std::vector<PBO> pbos;
+            size_t pbo = 0;
+            bool mapped = false;
+
+            uint8_t* map();
+            void unmap(const ImageInfo&, int x, int y);
+#endif // FTK_API_GL_4_1
+
+            bool hasPBO() const;
+
+            //! Copy data to the texture. With edges, data smaller than the
+            //! texture has its last column and row repeated into the texels
+            //! beyond it, so that filtering at its edges blends with a copy
+            //! of the edge rather than whatever was there before.
+            bool copy(
+                const uint8_t*,
+                const ImageInfo&,
+                int x,
+                int y,
+                bool edges);
+
+            std::vector<uint8_t> edge;
         };
 
+#if defined(FTK_API_GL_4_1)
+        uint8_t* Texture::Private::map()
+        {
+            PBO& buffer = pbos[pbo];
+
+            // A buffer whose transfer has finished can be written without the
+            // driver checking. Otherwise its contents are invalidated, so the
+            // driver gives it new storage rather than waiting for the
+            // transfer.
+            GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+            if (buffer.fence)
+            {
+                const GLenum status = glClientWaitSync(buffer.fence, 0, 0);
+                if (GL_ALREADY_SIGNALED == status || GL_CONDITION_SATISFIED == status)
+                {
+                    access |= GL_MAP_UNSYNCHRONIZED_BIT;
+                }
+                glDeleteSync(buffer.fence);
+                buffer.fence = NULL;
+            }
+            else
+            {
+                access |= GL_MAP_UNSYNCHRONIZED_BIT;
+            }
+
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.id);
+            void* out = glMapBufferRange(
+                GL_PIXEL_UNPACK_BUFFER,
+                0,
+                info.getByteCount(),
+                access);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            mapped = out != nullptr;
+            return static_cast<uint8_t*>(out);
+        }
+
+        void Texture::Private::unmap(const ImageInfo& value, int x, int y)
+        {
+            PBO& buffer = pbos[pbo];
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.id);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            mapped = false;
+            glBindTexture(GL_TEXTURE_2D, id);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, value.layout.alignment);
+            glPixelStorei(GL_UNPACK_SWAP_BYTES, value.layout.endian != getEndian());
+            glTexSubImage2D(
+                GL_TEXTURE_2D,
+                0,
+                x,
+                y,
+                value.size.w,
+                value.size.h,
+                getTextureFormat(info.type),
+                getTextureType(info.type),
+                NULL);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            if (mipmaps)
+            {
+                glGenerateMipmap(GL_TEXTURE_2D);
+            }
+            buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            pbo = (pbo + 1) % pbos.size();
+        }
+#endif // FTK_API_GL_4_1
+
+        bool Texture::Private::hasPBO() const
+        {
+#if defined(FTK_API_GL_4_1)
+            return !pbos.empty();
+#else // FTK_API_GL_4_1
+            return false;
+#endif // FTK_API_GL_4_1
+        }
+
+        bool Texture::Private::copy(
+            const uint8_t* data,
+            const ImageInfo& value,
+            int x,
+            int y,
+            bool edges)
+        {
+            const UploadUnit uploadUnit;
+            const int w = value.size.w;
+            const int h = value.size.h;
+            const bool edgeX = edges && w < info.size.w;
+            const bool edgeY = edges && h < info.size.h;
+            const size_t pixelByteCount = ImageInfo(1, 1, value.type).getByteCount();
+            const size_t rowByteCount = getAlignedByteCount(
+                w * pixelByteCount,
+                value.layout.alignment);
+#if defined(FTK_API_GL_4_1)
+            if (!pbos.empty())
+            {
+                if (mapped)
+                    return false;
+                if (uint8_t* buffer = map())
+                {
+                    if (!edgeX && !edgeY)
+                    {
+                        memcpy(buffer, data, value.getByteCount());
+                        unmap(value, x, y);
+                    }
+                    else
+                    {
+                        // The edges go in the same transfer: the rows are
+                        // written packed, each with its last pixel repeated,
+                        // and then the last row again.
+                        ImageInfo padded = value;
+                        padded.size.w += edgeX ? 1 : 0;
+                        padded.size.h += edgeY ? 1 : 0;
+                        padded.layout.alignment = 1;
+                        const size_t paddedRowByteCount = padded.size.w * pixelByteCount;
+                        for (int i = 0; i < padded.size.h; ++i)
+                        {
+                            const uint8_t* row = data + std::min(i, h - 1) * rowByteCount;
+                            uint8_t* out = buffer + i * paddedRowByteCount;
+                            memcpy(out, row, w * pixelByteCount);
+                            if (edgeX)
+                            {
+                                memcpy(
+                                    out + w * pixelByteCount,
+                                    row + (w - 1) * pixelByteCount,
+                                    pixelByteCount);
+                            }
+                        }
+                        unmap(padded, x, y);
+                    }
+                }
+                return true;
+            }
+#endif // FTK_API_GL_4_1
+            glBindTexture(GL_TEXTURE_2D, id);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, value.layout.alignment);
+#if defined(FTK_API_GL_4_1)
+            glPixelStorei(GL_UNPACK_SWAP_BYTES, value.layout.endian != getEndian());
+#endif // FTK_API_GL_4_1
+            const GLenum format = getTextureFormat(getTextureType(value.type));
+            const GLenum type = getTextureType(getTextureType(value.type));
+            glTexSubImage2D(
+                GL_TEXTURE_2D,
+                0,
+                x,
+                y,
+                w,
+                h,
+                format,
+                type,
+                data);
+            if (edgeX)
+            {
+                const int count = edgeY ? h + 1 : h;
+                edge.resize(count * pixelByteCount);
+                for (int i = 0; i < count; ++i)
+                {
+                    memcpy(
+                        edge.data() + i * pixelByteCount,
+                        data + std::min(i, h - 1) * rowByteCount + (w - 1) * pixelByteCount,
+                        pixelByteCount);
+                }
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, x + w, y, 1, count, format, type, edge.data());
+                glPixelStorei(GL_UNPACK_ALIGNMENT, value.layout.alignment);
+            }
+            if (edgeY)
+            {
+                glTexSubImage2D(
+                    GL_TEXTURE_2D,
+                    0,
+                    x,
+                    y + h,
+                    w,
+                    1,
+                    format,
+                    type,
+                    data + (h - 1) * rowByteCount);
+            }
+            if (mipmaps)
+            {
+                glGenerateMipmap(GL_TEXTURE_2D);
+            }
+            return true;
+        }
+
         Texture::Texture(
             const ImageInfo& imageInfo,
             const TextureOptions& options) :
@@ -461,23 +683,37 @@ namespace ftk
 #if defined(FTK_API_GL_4_1)
             if (options.pbo)
             {
-                glGenBuffers(1, &p.pbo);
-                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, p.pbo);
-                glBufferData(
-                    GL_PIXEL_UNPACK_BUFFER,
-                    p.info.getByteCount(),
-                    NULL,
-                    GL_STREAM_DRAW);
+                p.pbos.resize(std::max(options.pboCount, static_cast<size_t>(1)));
+                for (auto& pbo : p.pbos)
+                {
+                    glGenBuffers(1, &pbo.id);
+                    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo.id);
+                    glBufferData(
+                        GL_PIXEL_UNPACK_BUFFER,
+                        p.info.getByteCount(),
+                        NULL,
+                        GL_STREAM_DRAW);
+                }
                 glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
             }
 #endif // FTK_API_GL_4_1
 
+            GLenum minify = getTextureFilter(options.filters.minify);
+#if defined(FTK_API_GL_4_1)
+            // OpenGL ES 2 only has mipmaps for power of two sizes.
+            if (ImageFilter::Mipmap == options.filters.minify)
+            {
+                minify = GL_LINEAR_MIPMAP_LINEAR;
+                p.mipmaps = true;
+            }
+#endif // FTK_API_GL_4_1
+
             const UploadUnit uploadUnit;
             glGenTextures(1, &p.id);
             glBindTexture(GL_TEXTURE_2D, p.id);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, getTextureFilter(options.filters.minify));
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minify);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, getTextureFilter(options.filters.magnify));
             glTexImage2D(
                 GL_TEXTURE_2D,
@@ -494,11 +730,23 @@ namespace ftk
         Texture::~Texture()
         {
             FTK_P();
-            if (p.pbo)
+#if defined(FTK_API_GL_4_1)
+            if (p.mapped)
             {
-                glDeleteBuffers(1, &p.pbo);
-                p.pbo = 0;
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, p.pbos[p.pbo].id);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            }
+            for (auto& pbo : p.pbos)
+            {
+                if (pbo.fence)
+                {
+                    glDeleteSync(pbo.fence);
+                }
+                glDeleteBuffers(1, &pbo.id);
             }
+            p.pbos.clear();
+#endif // FTK_API_GL_4_1
             if (p.id)
             {
                 glDeleteTextures(1, &p.id);
@@ -553,169 +801,56 @@ namespace ftk
 
         bool Texture::copy(const std::shared_ptr<Image>& data)
         {
-            const UploadUnit uploadUnit;
             FTK_P();
             const auto& info = data->getInfo();
             if (!_isCompatible(info))
                 return false;
-#if defined(FTK_API_GL_4_1)
-            if (p.pbo)
-            {
-                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, p.pbo);
-                if (void* buffer = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY))
-                {
-                    memcpy(
-                        buffer,
-                        data->getData(),
-                        data->getByteCount());
-                    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-                    glBindTexture(GL_TEXTURE_2D, p.id);
-                    glPixelStorei(GL_UNPACK_ALIGNMENT, p.imageInfo.layout.alignment);
-                    glPixelStorei(GL_UNPACK_SWAP_BYTES, p.imageInfo.layout.endian != getEndian());
-                    glTexSubImage2D(
-                        GL_TEXTURE_2D,
-                        0,
-                        0,
-                        0,
-                        info.size.w,
-                        info.size.h,
-                        getTextureFormat(p.info.type),
-                        getTextureType(p.info.type),
-                        NULL);
-                }
-                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-            }
-            else
-#endif // FTK_API_GL_4_1
-            {
-                glBindTexture(GL_TEXTURE_2D, p.id);
-                glPixelStorei(GL_UNPACK_ALIGNMENT, info.layout.alignment);
-#if defined(FTK_API_GL_4_1)
-                glPixelStorei(GL_UNPACK_SWAP_BYTES, info.layout.endian != getEndian());
-#endif // FTK_API_GL_4_1
-                glTexSubImage2D(
-                    GL_TEXTURE_2D,
-                    0,
-                    0,
-                    0,
-                    info.size.w,
-                    info.size.h,
-                    getTextureFormat(getTextureType(info.type)),
-                    getTextureType(getTextureType(info.type)),
-                    data->getData());
-            }
-            return true;
+            return p.copy(data->getData(), info, 0, 0, true);
         }
 
         bool Texture::copy(const std::shared_ptr<Image>& data, int x, int y)
         {
-            const UploadUnit uploadUnit;
             FTK_P();
             const auto& info = data->getInfo();
             if (!_isCompatible(info))
                 return false;
-#if defined(FTK_API_GL_4_1)
-            if (p.pbo)
-            {
-                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, p.pbo);
-                if (void* buffer = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY))
-                {
-                    memcpy(
-                        buffer,
-                        data->getData(),
-                        data->getByteCount());
-                    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-                    glBindTexture(GL_TEXTURE_2D, p.id);
-                    glPixelStorei(GL_UNPACK_ALIGNMENT, p.imageInfo.layout.alignment);
-                    glPixelStorei(GL_UNPACK_SWAP_BYTES, p.imageInfo.layout.endian != getEndian());
-                    glTexSubImage2D(
-                        GL_TEXTURE_2D,
-                        0,
-                        x,
-                        y,
-                        info.size.w,
-                        info.size.h,
-                        getTextureFormat(p.info.type),
-                        getTextureType(p.info.type),
-                        NULL);
-                }
-                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-            }
-            else
-#endif // FTK_API_GL_4_1
-            {
-                glBindTexture(GL_TEXTURE_2D, p.id);
-                glPixelStorei(GL_UNPACK_ALIGNMENT, info.layout.alignment);
-#if defined(FTK_API_GL_4_1)
-                glPixelStorei(GL_UNPACK_SWAP_BYTES, info.layout.endian != getEndian());
-#endif // FTK_API_GL_4_1
-                glTexSubImage2D(
-                    GL_TEXTURE_2D,
-                    0,
-                    x,
-                    y,
-                    info.size.w,
-                    info.size.h,
-                    getTextureFormat(getTextureType(info.type)),
-                    getTextureType(getTextureType(info.type)),
-                    data->getData());
-            }
-            return true;
+            return p.copy(data->getData(), info, x, y, false);
         }
 
         bool Texture::copy(const uint8_t* data, const ImageInfo& info)
         {
-            const UploadUnit uploadUnit;
             FTK_P();
             if (!_isCompatible(info))
                 return false;
+            return p.copy(data, info, 0, 0, true);
+        }
+
+        uint8_t* Texture::map()
+        {
+            FTK_P();
+            uint8_t* out = nullptr;
 #if defined(FTK_API_GL_4_1)
-            if (p.pbo)
+            if (!p.pbos.empty() && !p.mapped)
             {
-                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, p.pbo);
-                if (void* buffer = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY))
-                {
-                    memcpy(
-                        buffer,
-                        data,
-                        info.getByteCount());
-                    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-                    glBindTexture(GL_TEXTURE_2D, p.id);
-                    glPixelStorei(GL_UNPACK_ALIGNMENT, p.imageInfo.layout.alignment);
-                    glPixelStorei(GL_UNPACK_SWAP_BYTES, p.imageInfo.layout.endian != getEndian());
-                    glTexSubImage2D(
-                        GL_TEXTURE_2D,
-                        0,
-                        0,
-                        0,
-                        info.size.w,
-                        info.size.h,
-                        getTextureFormat(p.info.type),
-                        getTextureType(p.info.type),
-                        NULL);
-                }
-                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                out = p.map();
             }
-            else
 #endif // FTK_API_GL_4_1
-            {
-                glBindTexture(GL_TEXTURE_2D, p.id);
-                glPixelStorei(GL_UNPACK_ALIGNMENT, info.layout.alignment);
+            return out;
+        }
+
+        bool Texture::unmap()
+        {
+            FTK_P();
+            bool out = false;
 #if defined(FTK_API_GL_4_1)
-                glPixelStorei(GL_UNPACK_SWAP_BYTES, info.layout.endian != getEndian());
-#endif // FTK_API_GL_4_1
-                glTexSubImage2D(
-                    GL_TEXTURE_2D,
-                    0,
-                    0,
-                    0,
-                    info.size.w,
-                    info.size.h,
-                    getTextureFormat(getTextureType(info.type)),
-                    getTextureType(getTextureType(info.type)),
-                    data);
+            if (p.mapped)
+            {
+                const UploadUnit uploadUnit;
+                p.unmap(p.imageInfo, 0, 0);
+                out = true;
             }
-            return true;
+#endif // FTK_API_GL_4_1
+            return out;
         }
 
         void Texture::bind()
@@ -739,7 +874,7 @@ namespace ftk
             return
                 other.size.w <= p.info.size.w &&
                 other.size.h <= p.info.size.h &&
-                (p.pbo ? other.type == p.imageInfo.type : true) &&
+                (p.hasPBO() ? other.type == p.imageInfo.type : true) &&
                 other.layout == p.imageInfo.layout;
         }
     }
@@ -91,6 +91,13 @@ namespace ftk
             ImageFilters filters;
             bool         pbo     = false;
 
+            //! The number of pixel buffers copies go through in turn, when
+            //! pbo is set. With more than one, a copy does not have to wait
+            //! for the previous one to finish reading its buffer, so frames
+            //! that are streamed to the same texture overlap the transfer
+            //! with drawing.
+            size_t       pboCount = 1;
+
             FTK_API bool operator == (const TextureOptions&) const;
             FTK_API bool operator != (const TextureOptions&) const;
         };
@@ -135,7 +142,10 @@ namespace ftk
             FTK_API unsigned int getID() const;
 
             //! \name Copy
-            //! Copy image data to the texture.
+            //! Copy image data to the texture. Data copied to the origin may
+            //! be smaller than the texture; its last column and row are
+            //! repeated into the texels beyond it, so that filtering at its
+            //! edges does not pick up what is outside.
             ///@{
 
             FTK_API bool copy(const std::shared_ptr<Image>&);
@@ -144,6 +154,20 @@ namespace ftk
 
             ///@}
 
+            //! \name Streaming
+            //! Write image data straight to the next pixel buffer, for
+            //! example from a decoding thread, rather than copying it there
+            //! from an image. This requires TextureOptions::pbo. Call map()
+            //! and unmap() from the thread the OpenGL context is current on;
+            //! the memory map() returns can be written from any thread in
+            //! between. unmap() updates the texture from the buffer.
+            ///@{
+
+            FTK_API uint8_t* map();
+            FTK_API bool unmap();
+
+            ///@}
+
             //! Bind the texture.
             FTK_API void bind();
 
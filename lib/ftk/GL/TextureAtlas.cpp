@@ -8,6 +8,8 @@
 #include <ftk/Core/Assert.h>
 #include <ftk/Core/BoxPack.h>
 
+#include <algorithm>
+#include <cstring>
 #include <map>
 
 namespace ftk
@@ -18,27 +20,91 @@ namespace ftk
         {
             int size = 0;
             ImageType type = ImageType::None;
+            ImageFilter filter = ImageFilter::Linear;
             int border = 0;
-            std::shared_ptr<Texture> texture;
-            std::shared_ptr<BoxPack> boxPack;
+            size_t maxPages = 1;
+
+            struct Page
+            {
+                std::shared_ptr<Texture> texture;
+                std::shared_ptr<BoxPack> boxPack;
+                uint64_t timestamp = 0;
+                std::vector<BoxPackID> ids;
+            };
+            std::vector<Page> pages;
+            uint64_t timestamp = 0;
+
+            // The atlas IDs map to a page and the ID of the node in that
+            // page's packing, so that emptying a page invalidates every item
+            // in it without touching the others.
+            struct Entry
+            {
+                size_t page = 0;
+                BoxPackID node = boxPackInvalidID;
+            };
+            std::map<BoxPackID, Entry> entries;
+            BoxPackID id = 0;
+
+            struct Upload
+            {
+                size_t page = 0;
+                std::shared_ptr<Image> image;
+                V2I pos;
+            };
+            std::vector<Upload> uploads;
+
+            size_t evictionCount = 0;
+
+            void addPage();
+            void evictPage(size_t);
         };
 
+        void TextureAtlas::Private::addPage()
+        {
+            TextureOptions textureOptions;
+            textureOptions.filters.minify = filter;
+            textureOptions.filters.magnify = filter;
+            Page page;
+            page.texture = Texture::create(ImageInfo(size, size, type), textureOptions);
+            page.boxPack = BoxPack::create(Size2I(size, size), border);
+            pages.push_back(page);
+        }
+
+        void TextureAtlas::Private::evictPage(size_t index)
+        {
+            Page& page = pages[index];
+            for (const auto id : page.ids)
+            {
+                entries.erase(id);
+            }
+            page.ids.clear();
+            page.boxPack = BoxPack::create(Size2I(size, size), border);
+            uploads.erase(
+                std::remove_if(
+                    uploads.begin(),
+                    uploads.end(),
+                    [index](const Upload& value)
+                    {
+                        return value.page == index;
+                    }),
+                uploads.end());
+            ++evictionCount;
+        }
+
         void TextureAtlas::_init(
             int size,
             ImageType type,
             ImageFilter filter,
-            int border)
+            int border,
+            size_t maxPages)
         {
             FTK_P();
-
             p.size = size;
             p.type = type;
+            p.filter = filter;
             p.border = border;
-            TextureOptions textureOptions;
-            textureOptions.filters.minify = filter;
-            textureOptions.filters.magnify = filter;
-            p.texture = Texture::create(ImageInfo(size, size, type), textureOptions);
-            p.boxPack = BoxPack::create(Size2I(size, size), border);
+            p.maxPages = std::max(maxPages, static_cast<size_t>(1));
+            p.addPage();
         }
 
         TextureAtlas::TextureAtlas() :
@@ -52,10 +118,11 @@ namespace ftk
             int textureSize,
             ImageType textureType,
             ImageFilter filter,
-            int border)
+            int border,
+            size_t maxPages)
         {
             auto out = std::shared_ptr<TextureAtlas>(new TextureAtlas);
-            out->_init(textureSize, textureType, filter, border);
+            out->_init(textureSize, textureType, filter, border, maxPages);
             return out;
         }
 
@@ -69,19 +136,36 @@ namespace ftk
             return _p->type;
         }
 
-        unsigned int TextureAtlas::getTexture() const
+        size_t TextureAtlas::getMaxPages() const
+        {
+            return _p->maxPages;
+        }
+
+        size_t TextureAtlas::getPageCount() const
+        {
+            return _p->pages.size();
+        }
+
+        unsigned int TextureAtlas::getTexture(size_t page) const
         {
-            return _p->texture->getID();
+            FTK_P();
+            return page < p.pages.size() ? p.pages[page].texture->getID() : 0;
         }
 
         bool TextureAtlas::getItem(BoxPackID id, TextureAtlasItem& item)
         {
             FTK_P();
             bool out = false;
-            if (auto node = p.boxPack->getNode(id))
+            const auto i = p.entries.find(id);
+            if (i != p.entries.end())
             {
-                _toItem(node, item);
-                out = true;
+                auto& page = p.pages[i->second.page];
+                if (auto node = page.boxPack->getNode(i->second.node))
+                {
+                    page.timestamp = ++p.timestamp;
+                    _toItem(i->second.page, node, id, item);
+                    out = true;
+                }
             }
             return out;
         }
@@ -91,27 +175,107 @@ namespace ftk
             TextureAtlasItem& item)
         {
             FTK_P();
-            bool out = false;
-            if (auto node = p.boxPack->insert(image->getSize() + p.border * 2))
+            const Size2I& size = image->getSize();
+            if (size.w + p.border * 2 > p.size || size.h + p.border * 2 > p.size)
+            {
+                return false;
+            }
+
+            // The most recently used page with room, then a new page, and
+            // then the least recently used page, emptied.
+            size_t index = p.pages.size();
+            for (size_t i = 0; i < p.pages.size(); ++i)
             {
-                out = true;
-
-                auto zero = Image::create(
-                    node->box.size(),
-                    p.type);
-                zero->zero();
-                p.texture->copy(
-                    zero,
-                    node->box.min.x,
-                    node->box.min.y);
-
-                p.texture->copy(
-                    image,
-                    node->box.min.x + p.border,
-                    node->box.min.y + p.border);
-
-                _toItem(node, item);
+                if (p.pages[i].boxPack->hasRoom(size) &&
+                    (index == p.pages.size() ||
+                        p.pages[i].timestamp > p.pages[index].timestamp))
+                {
+                    index = i;
+                }
+            }
+            if (index == p.pages.size())
+            {
+                if (p.pages.size() < p.maxPages)
+                {
+                    p.addPage();
+                }
+                else
+                {
+                    index = 0;
+                    for (size_t i = 1; i < p.pages.size(); ++i)
+                    {
+                        if (p.pages[i].timestamp < p.pages[index].timestamp)
+                        {
+                            index = i;
+                        }
+                    }
+                    p.evictPage(index);
+                }
+            }
+
+            auto& page = p.pages[index];
+            auto node = page.boxPack->insert(size);
+            if (!node)
+            {
+                return false;
+            }
+            const BoxPackID id = p.id++;
+            p.entries[id] = Private::Entry{ index, node->id };
+            page.ids.push_back(id);
+            page.timestamp = ++p.timestamp;
+
+            // One copy for the item and its border rather than two.
+            std::shared_ptr<Image> upload = image;
+            if (p.border > 0)
+            {
+                upload = Image::create(node->box.size(), p.type);
+                upload->zero();
+                const size_t pixelByteCount = getChannelCount(p.type) * getBitDepth(p.type) / 8;
+                const size_t rowByteCount = size.w * pixelByteCount;
+                for (int y = 0; y < size.h; ++y)
+                {
+                    memcpy(
+                        upload->getData() +
+                            ((y + p.border) * upload->getWidth() + p.border) * pixelByteCount,
+                        image->getData() + y * rowByteCount,
+                        rowByteCount);
+                }
+            }
+            p.uploads.push_back(Private::Upload{ index, upload, node->box.min });
+
+            _toItem(index, node, id, item);
+            return true;
+        }
+
+        bool TextureAtlas::hasRoom(const Size2I& size) const
+        {
+            FTK_P();
+            if (p.pages.size() < p.maxPages)
+            {
+                return true;
+            }
+            for (const auto& page : p.pages)
+            {
+                if (page.boxPack->hasRoom(size))
+                {
+                    return true;
+                }
             }
+            return false;
+        }
+
+        size_t TextureAtlas::upload()
+        {
+            FTK_P();
+            const size_t out = p.uploads.size();
+            for (const auto& upload : p.uploads)
+            {
+                p.pages[upload.page].texture->copy(
+                    upload.image,
+                    upload.pos.x,
+                    upload.pos.y);
+            }
+            p.uploads.clear();
             return out;
         }
 
@@ -119,22 +283,34 @@ namespace ftk
         {
             FTK_P();
             float area = 0.F;
-            for (const auto& node : p.boxPack->getNodes())
+            for (const auto& page : p.pages)
             {
-                if (node->id != boxPackInvalidID)
+                for (const auto& node : page.boxPack->getNodes())
                 {
-                    area += ftk::area(node->box.size());
+                    if (node->id != boxPackInvalidID)
+                    {
+                        area += ftk::area(node->box.size());
+                    }
                 }
             }
-            return area / static_cast<float>(p.size * p.size);
+            return area / static_cast<float>(p.size * p.size * p.pages.size());
+        }
+
+        size_t TextureAtlas::getEvictionCount() const
+        {
+            return _p->evictionCount;
         }
 
         void TextureAtlas::_toItem(
+            size_t page,
             const std::shared_ptr<BoxPackNode>& node,
+            BoxPackID id,
             TextureAtlasItem& out)
         {
             FTK_P();
-            out.id = node->id;
+            out.id = id;
+            out.size = node->box.size() - p.border * 2;
+            out.page = page;
             out.u = RangeF(
                 (node->box.min.x + p.border) / static_cast<float>(p.size),
                 (node->box.max.x - 1 - p.border) / static_cast<float>(p.size));
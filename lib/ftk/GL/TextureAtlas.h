@@ -21,11 +21,23 @@ namespace ftk
         {
             BoxPackID id = boxPackInvalidID;
             Size2I size;
+            size_t page = 0;
             RangeF u;
             RangeF v;
         };
 
         //! Texture atlas.
+        //!
+        //! The atlas is made of pages, each a texture of its own, created as
+        //! they are needed up to a maximum. When every page is full the
+        //! least recently used page is emptied in one go, and its items are
+        //! no longer found by getItem(); this frees room for a whole set of
+        //! new items at once, rather than recycling the space of one old
+        //! item at a time.
+        //!
+        //! Items are copied to the textures by upload(), so that the copies
+        //! for a frame are made together rather than interleaved with
+        //! drawing. Call it before drawing with the textures.
         class FTK_API_TYPE TextureAtlas : public std::enable_shared_from_this<TextureAtlas>
         {
             FTK_NON_COPYABLE(TextureAtlas);
@@ -35,7 +47,8 @@ namespace ftk
                 int size,
                 ImageType,
                 ImageFilter,
-                int border);
+                int border,
+                size_t maxPages);
 
             TextureAtlas();
 
@@ -47,16 +60,23 @@ namespace ftk
                 int size,
                 ImageType,
                 ImageFilter = ImageFilter::Linear,
-                int border = 1);
+                int border = 1,
+                size_t maxPages = 1);
 
-            //! Get the texture atlas size.
+            //! Get the texture atlas page size.
             FTK_API int getSize() const;
 
             //! Get the texture atlas type.
             FTK_API ImageType getType() const;
 
-            //! Get the texture atlas ID.
-            FTK_API unsigned int getTexture() const;
+            //! Get the maximum number of pages.
+            FTK_API size_t getMaxPages() const;
+
+            //! Get the number of pages.
+            FTK_API size_t getPageCount() const;
+
+            //! Get a page's texture ID.
+            FTK_API unsigned int getTexture(size_t page = 0) const;
 
             //! Get a texture atlas item.
             FTK_API bool getItem(BoxPackID, TextureAtlasItem&);
@@ -64,11 +84,26 @@ namespace ftk
             //! Add a texture atlas item.
             FTK_API bool addItem(const std::shared_ptr<Image>&, TextureAtlasItem&);
 
-            //! Get the percentage of the texture atlas that is in use.
+            //! Get whether an image of the given size can be added without
+            //! emptying a page.
+            FTK_API bool hasRoom(const Size2I&) const;
+
+            //! Copy the items added since the last call to the textures.
+            //! Returns the number of copies made.
+            FTK_API size_t upload();
+
+            //! Get the fraction of the texture atlas pages that is in use.
             FTK_API float getPercentageUsed() const;
 
+            //! Get the number of pages that have been emptied to make room.
+            FTK_API size_t getEvictionCount() const;
+
         private:
-            void _toItem(const std::shared_ptr<BoxPackNode>&, TextureAtlasItem&);
+            void _toItem(
+                size_t page,
+                const std::shared_ptr<BoxPackNode>&,
+                BoxPackID,
+                TextureAtlasItem&);
 
             FTK_PRIVATE();
         };
@@ -56,6 +56,11 @@ namespace ftk
             {
                 _print(Format("{0} byte count: {1}").arg(i).arg(getByteCount(i)));
             }
+            FTK_TEST_ENUM(IndexType);
+            FTK_CHECK(2 == getByteCount(IndexType::U16));
+            FTK_CHECK(4 == getByteCount(IndexType::U32));
+            FTK_CHECK(IndexType::U16 == getIndexType(65536));
+            FTK_CHECK(IndexType::U32 == getIndexType(65537));
         }
         
         namespace
@@ -114,6 +119,51 @@ namespace ftk
                         FTK_CHECK(vao->getID());
                         vao->bind();
                         vao->draw(GL_TRIANGLES, 0, 3);
+                        if (VBOType::Quad_F32_UV_F32_Color_U8 == type)
+                        {
+                            vao->drawInstances(GL_TRIANGLES, 0, 6, 0, 1);
+                            vao->drawInstances(GL_TRIANGLES, 0, 6, 1, 1);
+                        }
+                    }
+                }
+                {
+                    auto mesh = ftk::mesh(Box2F(0.F, 0.F, 1.F, 1.F));
+                    for (auto type : getVBOTypeEnums())
+                    {
+                        const size_t size = mesh.triangles.size() * 3;
+                        auto stream = VBOStream::create(size * 3, type);
+                        FTK_CHECK(size * 3 == stream->getSize());
+                        FTK_CHECK(type == stream->getType());
+                        FTK_CHECK(stream->getID());
+                        auto vao = VAO::create(type, stream->getID());
+                        vao->bind();
+                        size_t first = 0;
+                        FTK_CHECK(!stream->map(0, first));
+                        FTK_CHECK(!stream->map(size * 4, first));
+                        for (size_t i = 0; i < 4; ++i)
+                        {
+                            // The fourth goes back round to the start.
+                            FTK_CHECK(stream->copy(mesh, first));
+                            FTK_CHECK(first == (i % 3) * size);
+                            vao->draw(GL_TRIANGLES, first, size);
+                        }
+                    }
+                }
+                {
+                    const auto mesh = indexed(ftk::mesh(Box2F(0.F, 0.F, 1.F, 1.F)));
+                    for (auto indexType : getIndexTypeEnums())
+                    {
+                        auto vbo = VBO::create(mesh.v.size(), VBOType::Pos2_F32_UV_U16);
+                        vbo->copy(convert(mesh, vbo->getType()));
+                        auto ibo = IBO::create(mesh.indices.size(), indexType);
+                        FTK_CHECK(mesh.indices.size() == ibo->getSize());
+                        FTK_CHECK(indexType == ibo->getType());
+                        FTK_CHECK(ibo->getID());
+                        auto vao = VAO::create(vbo->getType(), vbo->getID());
+                        vao->bind();
+                        ibo->bind();
+                        ibo->copy(mesh.indices);
+                        vao->drawElements(GL_TRIANGLES, 0, ibo->getSize(), ibo->getType());
                     }
                 }
             }
@@ -137,6 +187,28 @@ namespace ftk
                     data = convert(mesh, type, RangeSizeT(0, 0));
                 }
             }
+            {
+                const auto mesh = indexed(ftk::mesh(Box2F(0.F, 0.F, 1.F, 1.F)));
+                for (auto type : getVBOTypeEnums())
+                {
+                    const auto data = convert(mesh, type);
+                    if (type <= VBOType::Pos2_F32_UV_F32_Color_F32)
+                    {
+                        FTK_CHECK(data.size() == mesh.v.size() * getByteCount(type));
+                    }
+                }
+            }
+            {
+                const auto mesh = indexed(mesh3F());
+                for (auto type : getVBOTypeEnums())
+                {
+                    const auto data = convert(mesh, type);
+                    if (type >= VBOType::Pos3_F32)
+                    {
+                        FTK_CHECK(data.size() == mesh.v.size() * getByteCount(type));
+                    }
+                }
+            }
         }
     }
 }
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/GLTest/ReadbackTest.h>
+
+#include <ftk/GL/GL.h>
+#include <ftk/GL/OffscreenBuffer.h>
+#include <ftk/GL/Readback.h>
+#include <ftk/GL/Window.h>
+
+#include <ftk/Core/Assert.h>
+
+using namespace ftk::gl;
+
+namespace ftk
+{
+    namespace gl_test
+    {
+        ReadbackTest::ReadbackTest(const std::shared_ptr<Context>& context) :
+            ITest(context, "ftk::gl_test::ReadbackTest")
+        {}
+
+        ReadbackTest::~ReadbackTest()
+        {}
+
+        std::shared_ptr<ReadbackTest> ReadbackTest::create(
+            const std::shared_ptr<Context>& context)
+        {
+            return std::shared_ptr<ReadbackTest>(new ReadbackTest(context));
+        }
+
+        namespace
+        {
+            std::shared_ptr<Window> createWindow(
+                const std::shared_ptr<Context>& context)
+            {
+                return Window::create(
+                    context,
+                    "ReadbackTest",
+                    Size2I(100, 100),
+                    static_cast<int>(WindowOptions::MakeCurrent));
+            }
+
+            void clear(float r, float g, float b)
+            {
+                glClearColor(r, g, b, 1.F);
+                glClear(GL_COLOR_BUFFER_BIT);
+            }
+        }
+
+        void ReadbackTest::run()
+        {
+            _read();
+            _ring();
+        }
+
+        void ReadbackTest::_read()
+        {
+            auto window = createWindow(_context);
+            auto buffer = OffscreenBuffer::create(Size2I(64, 32), TextureType::RGBA_U8);
+            OffscreenBufferBinding binding(buffer);
+            clear(1.F, 0.F, 0.F);
+
+            auto readback = Readback::create();
+            std::shared_ptr<Image> image;
+            bool called = false;
+            readback->read(
+                Box2I(8, 4, 16, 8),
+                [&image, &called](const std::shared_ptr<Image>& value)
+                {
+                    image = value;
+                    called = true;
+                });
+            FTK_CHECK(1 == readback->getPending());
+            readback->tick(true);
+            FTK_CHECK(0 == readback->getPending());
+            FTK_CHECK(called);
+            FTK_CHECK(image);
+            if (image)
+            {
+                FTK_CHECK(Size2I(16, 8) == image->getSize());
+                FTK_CHECK(ImageType::RGBA_U8 == image->getType());
+                FTK_CHECK(255 == image->getData()[0]);
+                FTK_CHECK(0 == image->getData()[1]);
+            }
+
+            // An empty region gives a null image.
+            called = false;
+            readback->read(
+                Box2I(0, 0, 0, 0),
+                [&image, &called](const std::shared_ptr<Image>& value)
+                {
+                    image = value;
+                    called = true;
+                });
+            readback->tick();
+            FTK_CHECK(called);
+            FTK_CHECK(!image);
+        }
+
+        void ReadbackTest::_ring()
+        {
+            // More reads than buffers, each of a different color, come back
+            // in order.
+            auto window = createWindow(_context);
+            auto buffer = OffscreenBuffer::create(Size2I(16, 16), TextureType::RGBA_U8);
+            OffscreenBufferBinding binding(buffer);
+            auto readback = Readback::create(2);
+            std::vector<std::shared_ptr<Image> > images;
+            for (int i = 0; i < 5; ++i)
+            {
+                clear(i / 4.F, 0.F, 0.F);
+                readback->read(
+                    Box2I(0, 0, 16, 16),
+                    [&images](const std::shared_ptr<Image>& value)
+                    {
+                        images.push_back(value);
+                    });
+                readback->tick();
+            }
+            readback->tick(true);
+            FTK_CHECK(5 == images.size());
+            for (size_t i = 0; i < images.size(); ++i)
+            {
+                FTK_CHECK(images[i]);
+                if (images[i])
+                {
+                    FTK_CHECK(static_cast<int>(i * 255 / 4.F + .5F) == images[i]->getData()[0]);
+                }
+            }
+        }
+    }
+}
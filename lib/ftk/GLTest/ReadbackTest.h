@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#pragma once
+
+#include <ftk/TestLib/ITest.h>
+
+namespace ftk
+{
+    namespace gl_test
+    {
+        class ReadbackTest : public test::ITest
+        {
+        protected:
+            ReadbackTest(const std::shared_ptr<Context>&);
+
+        public:
+            virtual ~ReadbackTest();
+
+            static std::shared_ptr<ReadbackTest> create(
+                const std::shared_ptr<Context>&);
+
+            void run() override;
+
+        private:
+            void _read();
+            void _ring();
+        };
+    }
+}
@@ -10,6 +10,9 @@
 #include <ftk/Core/Assert.h>
 #include <ftk/Core/Context.h>
 #include <ftk/Core/FontSystem.h>
+#include <ftk/Core/Format.h>
+
+#include <chrono>
 
 using namespace ftk::gl;
 
@@ -171,6 +174,13 @@ namespace ftk
                     imageOptions.imageFilters.magnify = ImageFilter::Nearest;
                     imageOptionsList.push_back(imageOptions);
                 }
+                {
+                    ImageOptions imageOptions;
+                    imageOptions.imageFilters.minify = ImageFilter::Mipmap;
+                    imageOptionsList.push_back(imageOptions);
+                    imageOptions.cache = false;
+                    imageOptionsList.push_back(imageOptions);
+                }
                 for (const auto& imageSize : { Size2I(64, 64), Size2I(2048, 2048) })
                 {
                     for (auto imageType : getImageTypeEnums())
@@ -194,6 +204,162 @@ namespace ftk
 
                 render->end();
             }
+            for (bool batch : { true, false })
+            {
+                auto window = createWindow(_context);
+                Size2I size(1920, 1080);
+                auto buffer = OffscreenBuffer::create(size);
+                OffscreenBufferBinding bufferBinding(buffer);
+
+                auto render = Render::create(logSystem, fontSystem);
+                RenderOptions renderOptions;
+                renderOptions.batch = batch;
+                render->begin(size, renderOptions);
+
+                render->drawRect(Box2F(0.F, 0.F, 100.F, 100.F), Color4F(1.F, 0.F, 0.F, 1.F));
+                render->drawLine(V2F(0.F, 0.F), V2F(100.F, 100.F), Color4F(0.F, 1.F, 0.F, 1.F));
+                FontInfo fontInfo;
+                render->drawText(
+                    fontSystem->getGlyphs("Hello world", fontInfo),
+                    fontSystem->getMetrics(fontInfo),
+                    V2F(100.F, 100.F));
+
+                // Changing the clipping draws what was recorded so far.
+                render->setClipRectEnabled(true);
+                render->setClipRect(Box2I(0, 0, 50, 50));
+                render->drawRect(Box2F(0.F, 0.F, 100.F, 100.F), Color4F(0.F, 0.F, 1.F, 1.F));
+                render->setClipRectEnabled(false);
+
+                render->end();
+                const RenderDiag diag = render->getDiag();
+                _print(Format("Batch {0}: {1} draw calls, {2} batches").
+                    arg(batch).
+                    arg(diag.drawCalls).
+                    arg(diag.batches));
+                if (batch)
+                {
+                    FTK_CHECK(2 == diag.batches);
+#if defined(FTK_API_GL_4_1)
+                    // The text is drawn as instances, separately from the
+                    // rectangle and line before it.
+                    FTK_CHECK(3 == diag.drawCalls);
+#elif defined(FTK_API_GLES_2)
+                    FTK_CHECK(2 == diag.drawCalls);
+#endif // FTK_API_GL_4_1
+                }
+                else
+                {
+                    FTK_CHECK(0 == diag.batches);
+                    FTK_CHECK(4 == diag.drawCalls);
+                }
+            }
+#if defined(FTK_API_GL_4_1)
+            for (bool batch : { true, false })
+            {
+                auto window = createWindow(_context);
+                Size2I size(1920, 1080);
+                auto buffer = OffscreenBuffer::create(size);
+                OffscreenBufferBinding bufferBinding(buffer);
+
+                auto render = Render::create(logSystem, fontSystem);
+                RenderOptions renderOptions;
+                renderOptions.batch = batch;
+                render->begin(size, renderOptions);
+                fontSystem->setGlyphMode(GlyphMode::SDF);
+                for (int fontSize : { 12, 24 })
+                {
+                    const FontInfo fontInfo(getDefaultFont(FontType::Regular), fontSize);
+                    render->drawText(
+                        fontSystem->getGlyphs("Hello", fontInfo),
+                        fontSystem->getMetrics(fontInfo),
+                        V2F(100.F, 100.F));
+                }
+                fontSystem->setGlyphMode(GlyphMode::Bitmap);
+                render->end();
+
+                // Both sizes are drawn from the same four glyphs.
+                FTK_CHECK(4 == render->getDiag().glyphUploads);
+            }
+#endif // FTK_API_GL_4_1
+            {
+                auto window = createWindow(_context);
+                Size2I size(1920, 1080);
+                auto buffer = OffscreenBuffer::create(size);
+                OffscreenBufferBinding bufferBinding(buffer);
+
+                auto render = Render::create(logSystem, fontSystem);
+                ImageOptions imageOptions;
+                imageOptions.cache = false;
+                const std::vector<std::shared_ptr<Image> > images =
+                {
+                    Image::create(100, 100, ImageType::RGBA_U8),
+                    Image::create(98, 100, ImageType::RGBA_U8)
+                };
+                for (int frame = 0; frame < 2; ++frame)
+                {
+                    render->begin(size);
+                    for (const auto& image : images)
+                    {
+                        render->drawImage(
+                            image,
+                            Box2F(0.F, 0.F, 100.F, 100.F),
+                            Color4F(1.F, 1.F, 1.F, 1.F),
+                            imageOptions);
+                    }
+                    render->end();
+
+                    // The images are in the same size class, but each has
+                    // textures of its own for as long as the frame lasts.
+                    const RenderDiag diag = render->getDiag();
+                    FTK_CHECK((0 == frame ? 0 : 2) == diag.texturePoolHits);
+                    FTK_CHECK((0 == frame ? 2 : 0) == diag.texturePoolMisses);
+                    FTK_CHECK(0 == diag.texturePoolEvictions);
+                }
+
+                RenderOptions renderOptions;
+                renderOptions.texturePoolByteCount = 0;
+                render->begin(size, renderOptions);
+                for (const auto& image : images)
+                {
+                    render->drawImage(
+                        image,
+                        Box2F(0.F, 0.F, 100.F, 100.F),
+                        Color4F(1.F, 1.F, 1.F, 1.F),
+                        imageOptions);
+                }
+                render->end();
+                FTK_CHECK(2 == render->getDiag().texturePoolEvictions);
+            }
+            for (bool batch : { false, true })
+            {
+                // Not a check, a number to compare between builds: what a
+                // rectangle costs on the CPU, the time spent getting it to
+                // OpenGL rather than drawing it.
+                auto window = createWindow(_context);
+                Size2I size(1920, 1080);
+                auto buffer = OffscreenBuffer::create(size);
+                OffscreenBufferBinding bufferBinding(buffer);
+
+                auto render = Render::create(logSystem, fontSystem);
+                RenderOptions renderOptions;
+                renderOptions.batch = batch;
+                render->begin(size, renderOptions);
+                const int count = 10000;
+                const auto t0 = std::chrono::steady_clock::now();
+                for (int i = 0; i < count; ++i)
+                {
+                    render->drawRect(
+                        Box2F(i % size.w, i % size.h, 10.F, 10.F),
+                        Color4F(1.F, 0.F, 0.F, 1.F));
+                }
+                render->flush();
+                const auto t1 = std::chrono::steady_clock::now();
+                render->end();
+                const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0);
+                _print(Format("drawRect, batch {0}: {1}ns").
+                    arg(batch).
+                    arg(ns.count() / count));
+            }
         }
     }
 }
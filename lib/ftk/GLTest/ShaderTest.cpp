@@ -134,6 +134,7 @@ namespace ftk
                 shader->setUniform("af", std::vector<float>({ 1.F, 1.F, 1.F, 1.F }));
                 shader->setUniform("av3", std::vector<V3F>(4, V3F(1.F, 1.F, 1.F)));
                 shader->setUniform("av4", std::vector<V4F>(4, V4F(1.F, 1.F, 1.F, 1.F)));
+                FTK_CHECK(-1 == shader->getUniformLocation("doesNotExist"));
             }
             {
                 auto window = createWindow(_context);
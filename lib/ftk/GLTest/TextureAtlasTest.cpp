@@ -75,6 +75,46 @@ namespace ftk
                     _print(format(item));
                     _print(Format("Percentage: {0}").arg(atlas->getPercentageUsed()));
                 }
+                FTK_CHECK(1 == atlas->getPageCount());
+                FTK_CHECK(atlas->getEvictionCount() > 0);
+                FTK_CHECK(atlas->upload() > 0);
+                FTK_CHECK(0 == atlas->upload());
+            }
+            {
+                auto window = createWindow(_context);
+
+                auto atlas = TextureAtlas::create(
+                    1024,
+                    ImageType::L_U8,
+                    ImageFilter::Linear,
+                    1,
+                    2);
+                FTK_CHECK(2 == atlas->getMaxPages());
+                FTK_CHECK(1 == atlas->getPageCount());
+
+                // Four fill a page, so the ninth empties the first page.
+                std::vector<TextureAtlasItem> items;
+                for (size_t i = 0; i < 9; ++i)
+                {
+                    auto image = Image::create(510, 510, ImageType::L_U8);
+                    TextureAtlasItem item;
+                    FTK_CHECK(atlas->hasRoom(image->getSize()) == (i < 8));
+                    FTK_CHECK(atlas->addItem(image, item));
+                    FTK_CHECK(Size2I(510, 510) == item.size);
+                    FTK_CHECK(atlas->getTexture(item.page));
+                    items.push_back(item);
+                }
+                FTK_CHECK(2 == atlas->getPageCount());
+                FTK_CHECK(1 == atlas->getEvictionCount());
+                TextureAtlasItem item;
+                FTK_CHECK(!atlas->getItem(items[0].id, item));
+                FTK_CHECK(atlas->getItem(items[4].id, item));
+                FTK_CHECK(items[8].page == items[0].page);
+                FTK_CHECK(atlas->getItem(items[8].id, item));
+                FTK_CHECK(atlas->upload() > 0);
+
+                auto image = Image::create(2048, 2048, ImageType::L_U8);
+                FTK_CHECK(!atlas->addItem(image, item));
             }
         }
     }
@@ -9,6 +9,8 @@
 #include <ftk/Core/Assert.h>
 #include <ftk/Core/Format.h>
 
+#include <cstring>
+
 using namespace ftk::gl;
 
 namespace ftk
@@ -75,11 +77,31 @@ namespace ftk
                 }
                 {
                     TextureOptions options;
+                    options.filters.minify = ImageFilter::Mipmap;
+                    options.filters.magnify = ImageFilter::Mipmap;
+                    dataList.push_back({
+                        ImageInfo(1920, 1080, ImageType::RGBA_U8),
+                        options });
                     options.pbo = true;
                     dataList.push_back({
                         ImageInfo(1920, 1080, ImageType::RGBA_U8),
                         options });
                 }
+                {
+                    TextureOptions options;
+                    options.pbo = true;
+                    dataList.push_back({
+                        ImageInfo(1920, 1080, ImageType::RGBA_U8),
+                        options });
+                }
+                {
+                    TextureOptions options;
+                    options.pbo = true;
+                    options.pboCount = 3;
+                    dataList.push_back({
+                        ImageInfo(1920, 1080, ImageType::RGBA_U8),
+                        options });
+                }
                 for (const auto& data : dataList)
                 {
                     try
@@ -100,6 +122,27 @@ namespace ftk
                         texture->copy(image);
                         texture->copy(image, 0, 0);
                         texture->copy(image->getData(), image->getInfo());
+#if defined(FTK_API_GL_4_1)
+                        if (data.options.pbo)
+                        {
+                            // More copies than buffers, so they go round.
+                            for (size_t i = 0; i < data.options.pboCount + 1; ++i)
+                            {
+                                uint8_t* buffer = texture->map();
+                                FTK_CHECK(buffer);
+                                FTK_CHECK(!texture->map());
+                                FTK_CHECK(!texture->copy(image));
+                                memcpy(buffer, image->getData(), image->getByteCount());
+                                FTK_CHECK(texture->unmap());
+                                FTK_CHECK(!texture->unmap());
+                            }
+                        }
+                        else
+#endif // FTK_API_GL_4_1
+                        {
+                            FTK_CHECK(!texture->map());
+                            FTK_CHECK(!texture->unmap());
+                        }
                         texture->bind();
                     }
                     catch (const std::exception& e)
@@ -125,6 +168,9 @@ namespace ftk
                 FTK_CHECK(a == b);
                 b.pbo = true;
                 FTK_CHECK(a != b);
+                b = TextureOptions();
+                b.pboCount = 2;
+                FTK_CHECK(a != b);
             }
         }
     }
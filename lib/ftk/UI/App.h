@@ -10,6 +10,7 @@
 #include <ftk/Core/ObservableList.h>
 #include <ftk/Core/ObservableMap.h>
 #include <ftk/Core/Observable.h>
+#include <ftk/Core/Path.h>
 
 #include <filesystem>
 #include <list>
@@ -150,6 +151,19 @@ namespace ftk
         //! sizes the window and leaves a buffer behind to read.
         FTK_API bool writeScreenshot(const std::filesystem::path&);
 
+        //! Start recording the first window. Each frame it draws is read
+        //! back without waiting for the GPU and written on an ImageIO worker
+        //! thread, numbered from the path's frame number: given
+        //! "capture.0001.png" the frames are "capture.0001.png",
+        //! "capture.0002.png", and so on. Frames read back while eight are
+        //! still waiting to be written are dropped, leaving no gap in the
+        //! numbering. Returns false when there is no window.
+        FTK_API bool startCapture(const Path&);
+
+        //! Stop recording. Frames already read back are still written, and
+        //! the number of frames dropped is logged.
+        FTK_API void stopCapture();
+
         ///@}
 
         //! \name Color Style
@@ -233,20 +247,40 @@ namespace ftk
         //! should be called.
         FTK_API virtual void tick();
 
+        //! Wake the event loop. Safe to call from any thread.
+        //!
+        //! The loop sleeps until there is an event, a timer or system is due,
+        //! a widget wants a tick, or a window needs drawing. Anything else
+        //! that should be seen promptly, a worker thread finishing, calls this.
+        //! The application also sets this as the context's wakeup
+        //! (Context::setWakeup()), which the ImageIO workers and the
+        //! FontSystem prefetch thread call when they finish.
+        FTK_API void wakeup();
+
+        //! Run a function on the main thread the next time through the event
+        //! loop, and wake it. Safe to call from any thread.
+        FTK_API void post(const std::function<void(void)>&);
+
     protected:
         void _addWindow(const std::shared_ptr<IWindow>&);
         void _removeWindow(const std::shared_ptr<IWindow>&);
 
     private:
         void _screenshotInit(const std::string& fileName);
+        bool _writeScreenshot(
+            const std::shared_ptr<Image>&,
+            const std::filesystem::path&);
 
         std::shared_ptr<IWindow> _getWindow(uint32_t id) const;
 
         void _tickRecursive(
             const std::shared_ptr<IWidget>&,
-            bool visible,
-            bool enabled,
+            const std::chrono::steady_clock::time_point&,
             const TickEvent&);
+        void _getNextTick(
+            const std::shared_ptr<IWidget>&,
+            std::chrono::steady_clock::time_point&) const;
+        void _wait();
 
         void _monitorsUpdate();
         void _styleUpdate();
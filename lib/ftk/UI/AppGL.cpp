@@ -17,13 +17,13 @@
 #include <ftk/GL/Texture.h>
 
 #include <ftk/Core/Context.h>
+#include <ftk/Core/DiagSystem.h>
 #include <ftk/Core/Error.h>
 #include <ftk/Core/FileLogSystem.h>
 #include <ftk/Core/ImageIO.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/LogSystem.h>
 #include <ftk/Core/String.h>
-#include <ftk/Core/Time.h>
 #include <ftk/Core/Timer.h>
 
 #if defined(FTK_SDL2)
@@ -33,16 +33,96 @@
 #endif // FTK_SDL2
 
 #include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif // __GNUC__
 
 namespace ftk
 {
     namespace
     {
+        // The shortest time between ticks for a widget that asks to be
+        // ticked every time through the event loop.
         const std::chrono::milliseconds timeout(5);
 
+        // The longest the event loop sleeps.
+        const std::chrono::milliseconds waitMax(1000);
+
+        // Pushing an event is safe from any thread, and an empty user event
+        // is ignored by the loop once it has woken it.
+        void pushWakeupEvent()
+        {
+            SDL_Event event;
+            SDL_zero(event);
+#if defined(FTK_SDL2)
+            event.type = SDL_USEREVENT;
+#elif defined(FTK_SDL3)
+            event.type = SDL_EVENT_USER;
+#endif // FTK_SDL2
+            SDL_PushEvent(&event);
+        }
+
+        // Get the readable name of a class.
+        std::string getTypeName(const std::type_info& value)
+        {
+            std::string out = value.name();
+#if defined(__GNUC__)
+            int status = 0;
+            if (char* name = abi::__cxa_demangle(value.name(), nullptr, nullptr, &status))
+            {
+                if (0 == status)
+                {
+                    out = name;
+                }
+                free(name);
+            }
+#else // __GNUC__
+            for (const std::string& prefix : { "class ", "struct " })
+            {
+                if (0 == out.compare(0, prefix.size(), prefix))
+                {
+                    out = out.substr(prefix.size());
+                }
+            }
+#endif // __GNUC__
+            return out;
+        }
+
+        // The most captured frames waiting to be written. Each one holds a
+        // copy of the window, so frames read back while this many are
+        // waiting are dropped rather than queued.
+        const size_t captureWritesMax = 8;
+
         //! Set before any application exists; see App::setOffscreenDefault().
         bool offscreenDefault = false;
+
+        // Blending is done with straight alpha, so a semi-transparent overlay
+        // -- a dialog's dimming, say -- leaves that region with alpha < 1 even
+        // though its color is the correct darkened result. A window capture is
+        // logically opaque; left alone those pixels let whatever the image is
+        // shown against come through and the dimming reads inverted.
+        void setOpaque(const std::shared_ptr<Image>& image)
+        {
+            if (uint8_t* data = image->getData())
+            {
+                const Size2I size = image->getSize();
+                const size_t bytes = image->getByteCount();
+                if (bytes == static_cast<size_t>(size.w) * size.h * 4)
+                {
+                    for (size_t i = 3; i < bytes; i += 4)
+                    {
+                        data[i] = 255;
+                    }
+                }
+            }
+        }
     }
 
     bool MonitorInfo::operator == (const MonitorInfo& other) const
@@ -116,6 +196,16 @@ namespace ftk
 
         std::shared_ptr<Timer> screenshotTimer;
         int screenshotTicks = 0;
+        std::future<std::shared_ptr<Image> > screenshotFuture;
+        std::weak_ptr<Window> captureWindow;
+        struct CaptureData
+        {
+            Path path;
+            int64_t frame = 0;
+            std::list<std::future<bool> > writes;
+            size_t dropped = 0;
+        };
+        std::shared_ptr<CaptureData> capture;
         bool offscreen = false;
 
         std::shared_ptr<FontSystem> fontSystem;
@@ -135,6 +225,21 @@ namespace ftk
 
         std::list<int> tickTimes;
         std::shared_ptr<Timer> logTimer;
+
+        std::mutex postMutex;
+        std::vector<std::function<void(void)> > posted;
+
+        // The widgets ticked the last time through the event loop, by class,
+        // and how long their tick events took in microseconds. By class
+        // rather than object name so that widgets with generated names do
+        // not add a sampler each.
+        struct TickStats
+        {
+            std::string name;
+            int64_t count = 0;
+            int64_t time = 0;
+        };
+        std::unordered_map<std::type_index, TickStats> tickStats;
     };
 
     void App::_init(
@@ -327,6 +432,40 @@ namespace ftk
                     app->_log();
                 }
             });
+
+        // The systems wake the event loop when their threads finish work.
+        context->setWakeup(pushWakeupEvent);
+
+        auto diagSystem = context->getSystem<DiagSystem>();
+        diagSystem->addSampler(
+            "ftk Ticks/Widgets: {0}",
+            [weak]
+            {
+                int64_t out = 0;
+                if (auto app = weak.lock())
+                {
+                    for (const auto& i : app->_p->tickStats)
+                    {
+                        out += i.second.count;
+                    }
+                }
+                return out;
+            });
+        diagSystem->addSampler(
+            "ftk Ticks/Time: {0}ms",
+            [weak]
+            {
+                int64_t out = 0;
+                if (auto app = weak.lock())
+                {
+                    for (const auto& i : app->_p->tickStats)
+                    {
+                        out += i.second.time;
+                    }
+                }
+                return out;
+            },
+            DiagFormat{ 1000.0, 2 });
     }
 
     App::App() :
@@ -337,6 +476,7 @@ namespace ftk
     {
         auto logSystem = _context->getSystem<LogSystem>();
         logSystem->print("ftk::App", "Destroy app...");
+        _context->setWakeup(nullptr);
 
         // The application runs on the thread that owns the context, so this
         // is where the systems' threads can be stopped while the context is
@@ -533,16 +673,31 @@ namespace ftk
     {
         FTK_P();
 
+        std::vector<std::function<void(void)> > posted;
+        {
+            std::unique_lock<std::mutex> lock(p.postMutex);
+            posted.swap(p.posted);
+        }
+        for (const auto& i : posted)
+        {
+            i();
+        }
+
         _context->tick();
 
+        for (auto& i : p.tickStats)
+        {
+            i.second.count = 0;
+            i.second.time = 0;
+        }
+        const auto now = std::chrono::steady_clock::now();
         for (const auto& window : p.windows)
         {
             TickEvent tickEvent;
-            _tickRecursive(
-                window,
-                window->isVisible(false),
-                window->isEnabled(false),
-                tickEvent);
+            if (window->_tickCount > 0)
+            {
+                _tickRecursive(window, now, tickEvent);
+            }
 
             if (window->isVisible(false))
             {
@@ -1389,24 +1544,39 @@ namespace ftk
 
             tick();
 
-            auto t1 = std::chrono::steady_clock::now();
-            sleep(timeout, t0, t1);
-            t1 = std::chrono::steady_clock::now();
+            const auto t1 = std::chrono::steady_clock::now();
             const auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
             p.tickTimes.push_back(diff.count());
             while (p.tickTimes.size() > 10)
             {
                 p.tickTimes.pop_front();
             }
-            t0 = t1;
 
             if (p.cmdLine.exit->found())
             {
                 break;
             }
+
+            _wait();
+            t0 = std::chrono::steady_clock::now();
         }
     }
 
+    void App::wakeup()
+    {
+        pushWakeupEvent();
+    }
+
+    void App::post(const std::function<void(void)>& value)
+    {
+        FTK_P();
+        {
+            std::unique_lock<std::mutex> lock(p.postMutex);
+            p.posted.push_back(value);
+        }
+        wakeup();
+    }
+
     bool App::isOffscreen() const
     {
         return _p->offscreen;
@@ -1472,22 +1642,119 @@ namespace ftk
 
     void App::_tickRecursive(
         const std::shared_ptr<IWidget>& widget,
-        bool visible,
-        bool enabled,
+        const std::chrono::steady_clock::time_point& now,
         const TickEvent& event)
     {
         FTK_P();
-        const bool parentsVisible = visible && widget->isVisible(false);
-        const bool parentsEnabled = enabled && widget->isEnabled(false);
+
+        // Only the subtrees with a widget that asked for ticks are visited.
         for (const auto& child : widget->getChildren())
         {
-            _tickRecursive(
-                child,
-                parentsVisible,
-                parentsEnabled,
+            if (child->_tickCount > 0)
+            {
+                _tickRecursive(child, now, event);
+            }
+        }
+
+        if (widget->_tickEnabled && now - widget->_tickTime >= widget->_tickPeriod)
+        {
+            widget->_tickTime = now;
+            const auto t0 = std::chrono::steady_clock::now();
+            widget->tickEvent(
+                widget->_parentsVisible,
+                widget->_parentsEnabled,
                 event);
+            const auto t1 = std::chrono::steady_clock::now();
+
+            // The first widget of a class to tick adds a sampler for it.
+            const IWidget& ref = *widget;
+            const std::type_index type(typeid(ref));
+            auto i = p.tickStats.find(type);
+            if (i == p.tickStats.end())
+            {
+                Private::TickStats stats;
+                stats.name = getTypeName(typeid(ref));
+                i = p.tickStats.insert(std::make_pair(type, stats)).first;
+                auto weak = std::weak_ptr<App>(std::dynamic_pointer_cast<App>(shared_from_this()));
+                _context->getSystem<DiagSystem>()->addSampler(
+                    "ftk Ticks/" + stats.name + ": {0}us",
+                    [weak, type]
+                    {
+                        int64_t out = 0;
+                        if (auto app = weak.lock())
+                        {
+                            const auto i = app->_p->tickStats.find(type);
+                            if (i != app->_p->tickStats.end())
+                            {
+                                out = i->second.time;
+                            }
+                        }
+                        return out;
+                    });
+            }
+            ++i->second.count;
+            i->second.time += std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+        }
+    }
+
+    void App::_getNextTick(
+        const std::shared_ptr<IWidget>& widget,
+        std::chrono::steady_clock::time_point& out) const
+    {
+        for (const auto& child : widget->getChildren())
+        {
+            if (child->_tickCount > 0)
+            {
+                _getNextTick(child, out);
+            }
+        }
+        if (widget->_tickEnabled)
+        {
+            out = std::min(
+                out,
+                widget->_tickTime + std::max(
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(widget->_tickPeriod),
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout)));
+        }
+    }
+
+    void App::_wait()
+    {
+        FTK_P();
+
+        // Sleep until the first thing that is due, or until an event
+        // arrives. A window with something to draw is due now.
+        auto deadline = _context->getNextTick();
+        for (const auto& window : p.windows)
+        {
+            if (window->isVisible(false))
+            {
+                if (window->_hasUpdate())
+                {
+                    return;
+                }
+                window->_getNextUpdate(deadline);
+                if (window->_tickCount > 0)
+                {
+                    _getNextTick(window, deadline);
+                }
+            }
+        }
+        {
+            std::unique_lock<std::mutex> lock(p.postMutex);
+            if (!p.posted.empty())
+            {
+                return;
+            }
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (p.running && deadline > now)
+        {
+            const auto wait = std::min(
+                std::chrono::ceil<std::chrono::milliseconds>(deadline - now),
+                waitMax);
+            SDL_WaitEventTimeout(nullptr, static_cast<int>(wait.count()));
         }
-        widget->tickEvent(visible, enabled, event);
     }
 
     void App::_screenshotInit(const std::string& fileName)
@@ -1495,8 +1762,9 @@ namespace ftk
         FTK_P();
 
         // Driven from a timer inside the event loop, which is what realizes
-        // and sizes the window and leaves a readable offscreen buffer behind.
-        // The buffer is a frame behind, so the first ticks are let go by.
+        // and sizes the window. The screenshot is read back without waiting
+        // for the GPU, after the window has drawn, and written once it
+        // arrives.
         p.screenshotTimer = Timer::create(_context);
         p.screenshotTimer->setRepeating(true);
         auto weak = std::weak_ptr<App>(std::dynamic_pointer_cast<App>(shared_from_this()));
@@ -1509,13 +1777,108 @@ namespace ftk
                     return;
                 auto& p2 = *app->_p;
                 ++p2.screenshotTicks;
-                if (p2.screenshotTicks < 5)
+                if (p2.screenshotTicks < 2)
                     return;
-                app->writeScreenshot(std::filesystem::u8path(fileName));
-                app->exit();
+                if (!p2.screenshotFuture.valid())
+                {
+                    if (auto window = !p2.windows.empty() ?
+                        std::dynamic_pointer_cast<Window>(p2.windows.front()) :
+                        nullptr)
+                    {
+                        p2.screenshotFuture = window->screenshotAsync();
+                    }
+                    else
+                    {
+                        app->writeScreenshot(std::filesystem::u8path(fileName));
+                        app->exit();
+                    }
+                }
+                else if (p2.screenshotFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                {
+                    if (auto image = p2.screenshotFuture.get())
+                    {
+                        app->_writeScreenshot(image, std::filesystem::u8path(fileName));
+                    }
+                    else
+                    {
+                        app->_context->getSystem<LogSystem>()->print(
+                            "ftk::App",
+                            "Screenshot returned no image, the offscreen buffer was not ready.",
+                            LogType::Error);
+                    }
+                    app->exit();
+                }
             });
     }
 
+    bool App::startCapture(const Path& path)
+    {
+        FTK_P();
+        stopCapture();
+        auto window = !p.windows.empty() ?
+            std::dynamic_pointer_cast<Window>(p.windows.front()) :
+            nullptr;
+        if (!window)
+        {
+            _context->getSystem<LogSystem>()->print(
+                "ftk::App",
+                "No window to capture.",
+                LogType::Error);
+            return false;
+        }
+        p.captureWindow = window;
+        auto io = _context->getSystem<ImageIO>();
+        auto capture = std::make_shared<Private::CaptureData>();
+        capture->path = path;
+        capture->frame = path.getFrames().has_value() ? path.getFrames()->min() : 0;
+        p.capture = capture;
+        window->startCapture(
+            [io, capture](const std::shared_ptr<Image>& image)
+            {
+                if (image)
+                {
+                    auto& writes = capture->writes;
+                    writes.remove_if(
+                        [](const std::future<bool>& value)
+                        {
+                            return value.wait_for(std::chrono::seconds(0)) ==
+                                std::future_status::ready;
+                        });
+                    if (writes.size() < captureWritesMax)
+                    {
+                        setOpaque(image);
+                        writes.push_back(io->writeAsync(
+                            std::filesystem::u8path(capture->path.getFrame(capture->frame++, true)),
+                            image));
+                    }
+                    else
+                    {
+                        ++capture->dropped;
+                    }
+                }
+            });
+        return true;
+    }
+
+    void App::stopCapture()
+    {
+        FTK_P();
+        if (auto window = p.captureWindow.lock())
+        {
+            window->stopCapture();
+        }
+        p.captureWindow.reset();
+        if (p.capture && p.capture->dropped > 0)
+        {
+            _context->getSystem<LogSystem>()->print(
+                "ftk::App",
+                Format("Capture dropped {0} frames that could not be written in time.").
+                    arg(p.capture->dropped),
+                LogType::Warning);
+        }
+        p.capture.reset();
+    }
+
     bool App::writeScreenshot(const std::filesystem::path& path)
     {
         FTK_P();
@@ -1534,25 +1897,15 @@ namespace ftk
                 LogType::Error);
             return false;
         }
+        return _writeScreenshot(image, path);
+    }
 
-        // Blending is done with straight alpha, so a semi-transparent overlay
-        // -- a dialog's dimming, say -- leaves that region with alpha < 1 even
-        // though its color is the correct darkened result. A window capture is
-        // logically opaque; left alone those pixels let whatever the image is
-        // shown against come through and the dimming reads inverted.
-        if (uint8_t* data = image->getData())
-        {
-            const Size2I size = image->getSize();
-            const size_t bytes = image->getByteCount();
-            if (bytes == static_cast<size_t>(size.w) * size.h * 4)
-            {
-                for (size_t i = 3; i < bytes; i += 4)
-                {
-                    data[i] = 255;
-                }
-            }
-        }
-
+    bool App::_writeScreenshot(
+        const std::shared_ptr<Image>& image,
+        const std::filesystem::path& path)
+    {
+        auto logSystem = _context->getSystem<LogSystem>();
+        setOpaque(image);
         auto io = _context->getSystem<ImageIO>();
         auto writer = io->write(path, image->getInfo());
         if (!writer)
@@ -363,6 +363,10 @@ namespace ftk
         {
             setDrawUpdate();
         }
+        if (p.thumbnailRequests.empty())
+        {
+            setTickEnabled(false);
+        }
     }
 
     void FileBrowserView::sizeHintEvent(const SizeHintEvent& event)
@@ -602,6 +606,11 @@ namespace ftk
                 }
             }
             p.thumbnailRequests = thumbnailRequests;
+            if (!p.thumbnailRequests.empty())
+            {
+                // Ticks collect the thumbnails as they arrive.
+                setTickEnabled(true);
+            }
             if (!cancel.empty())
             {
                 p.thumbnails->cancelRequests(cancel);
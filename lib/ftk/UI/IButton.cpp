@@ -230,7 +230,11 @@ namespace ftk
     {
         IMouseWidget::tickEvent(parentsVisible, parentsEnabled, event);
         FTK_P();
-        if (_isMousePressed() && p.repeatClick)
+        if (!_isMousePressed())
+        {
+            setTickEnabled(false);
+        }
+        else if (p.repeatClick)
         {
             const float duration = p.repeatClickInit ? .4F : .02F;
             const auto now = std::chrono::steady_clock::now();
@@ -302,6 +306,7 @@ namespace ftk
         {
             p.repeatClickInit = true;
             p.repeatClickTimer = std::chrono::steady_clock::now();
+            setTickEnabled(true);
         }
     }
 
@@ -26,6 +26,8 @@ namespace ftk
 
             ChildAddEvent event(shared_from_this());
             parent->childAddEvent(event);
+
+            _parentsUpdate(parent->isVisible(), parent->isEnabled());
         }
     }
 
@@ -87,6 +89,10 @@ namespace ftk
             }
             if (i != parent->_children.end())
             {
+                if (_tickCount > 0)
+                {
+                    _tickCountAdd(parent, -_tickCount);
+                }
                 ChildRemoveEvent event(*i, j);
                 parent->_children.erase(i);
                 parent->childRemoveEvent(event);
@@ -103,7 +109,20 @@ namespace ftk
             value->childAddEvent(event);
             value->setSizeUpdate();
             value->setDrawUpdate();
+
+            // The window only looks at the widgets that are marked, and this
+            // one has not been sized or drawn in its new place.
+            setSizeUpdate();
+            setDrawUpdate();
+
+            if (_tickCount > 0)
+            {
+                _tickCountAdd(value, _tickCount);
+            }
         }
+        _parentsUpdate(
+            value ? value->isVisible() : true,
+            value ? value->isEnabled() : true);
     }
 
     int IWidget::getChildIndex(const std::shared_ptr<IWidget>& value) const
@@ -254,6 +273,11 @@ namespace ftk
         if (value == _geometry)
             return;
         _geometry = value;
+
+        // A widget that moved has to be clipped again even when its clip
+        // rectangle did not change, as with the contents of a scroll area,
+        // since its children have moved with it.
+        _clipUpdate = true;
         setSizeUpdate();
         setDrawUpdate();
     }
@@ -284,6 +308,10 @@ namespace ftk
             parent->setSizeUpdate();
             parent->setDrawUpdate();
         }
+        for (const auto& child : _children)
+        {
+            child->_parentsUpdate(isVisible(), isEnabled());
+        }
     }
 
     void IWidget::show()
@@ -317,6 +345,22 @@ namespace ftk
         }
         setSizeUpdate();
         setDrawUpdate();
+        for (const auto& child : _children)
+        {
+            child->_parentsUpdate(isVisible(), isEnabled());
+        }
+    }
+
+    void IWidget::setTickEnabled(
+        bool value,
+        const std::chrono::milliseconds& period)
+    {
+        _tickPeriod = period;
+        if (value == _tickEnabled)
+            return;
+        _tickEnabled = value;
+        _tickTime = std::chrono::steady_clock::time_point();
+        _tickCountAdd(shared_from_this(), value ? 1 : -1);
     }
 
     void IWidget::setBackgroundRole(ColorRole value)
@@ -392,14 +436,8 @@ namespace ftk
     void IWidget::childRemoveEvent(const ChildRemoveEvent&)
     {}
 
-    void IWidget::tickEvent(
-        bool parentsVisible,
-        bool parentsEnabled,
-        const TickEvent& event)
-    {
-        _parentsVisible = parentsVisible;
-        _parentsEnabled = parentsEnabled;
-    }
+    void IWidget::tickEvent(bool, bool, const TickEvent&)
+    {}
     
     void IWidget::styleEvent(const StyleEvent&)
     {}
@@ -491,4 +529,26 @@ namespace ftk
             child->setParent(nullptr);
         }
     }
+
+    void IWidget::_parentsUpdate(bool parentsVisible, bool parentsEnabled)
+    {
+        // Nothing below the widget changes if the widget does not.
+        if (parentsVisible == _parentsVisible &&
+            parentsEnabled == _parentsEnabled)
+            return;
+        _parentsVisible = parentsVisible;
+        _parentsEnabled = parentsEnabled;
+        for (const auto& child : _children)
+        {
+            child->_parentsUpdate(isVisible(), isEnabled());
+        }
+    }
+
+    void IWidget::_tickCountAdd(const std::shared_ptr<IWidget>& widget, int64_t value)
+    {
+        for (auto i = widget; i; i = i->_parent.lock())
+        {
+            i->_tickCount += value;
+        }
+    }
 }
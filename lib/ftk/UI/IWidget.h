@@ -6,6 +6,7 @@
 #include <ftk/UI/Event.h>
 #include <ftk/UI/WidgetOptions.h>
 
+#include <chrono>
 #include <functional>
 #include <list>
 
@@ -94,7 +95,8 @@ namespace ftk
         bool hasSizeUpdate() const;
 
         //! Set a size update. The sizeHintEvent() and setGeometry() methods
-        //! will be called the next tick of the event loop.
+        //! will be called the next tick of the event loop, for this widget
+        //! and its ancestors.
         void setSizeUpdate(bool value = true);
 
         //! Get the size hint.
@@ -191,6 +193,32 @@ namespace ftk
 
         ///@}
 
+        //! Ticks
+        ///@{
+
+        //! Get whether the widget receives tick events.
+        bool isTickEnabled() const;
+
+        //! Get how often the widget receives tick events.
+        const std::chrono::milliseconds& getTickPeriod() const;
+
+        //! Set whether the widget receives tick events, and how often. A
+        //! period of zero ticks the widget every time through the event loop.
+        //!
+        //! Ticks are disabled by default. The event loop only visits the
+        //! widgets that ask for ticks, so a widget should only ask while it
+        //! has something to do: a cursor to blink, a future to wait on.
+        //!
+        //! WARNING: Widgets used to be ticked whether they asked or not. A
+        //! C++ widget that overrides tickEvent() and does not call this is
+        //! no longer ticked. Widgets written in Python are created with ticks
+        //! enabled, as before.
+        FTK_API void setTickEnabled(
+            bool,
+            const std::chrono::milliseconds& period = std::chrono::milliseconds(0));
+
+        ///@}
+
         //! Drawing
         ///@{
 
@@ -276,8 +304,9 @@ namespace ftk
         //! Child remove event.
         FTK_API virtual void childRemoveEvent(const ChildRemoveEvent&);
 
-        //! Tick event. If this method is overridden the base method
-        //! should be called.
+        //! Tick event. Only sent to widgets that have ticks enabled with
+        //! setTickEnabled(); overriding this method does not enable them. If
+        //! this method is overridden the base method should be called.
         FTK_API virtual void tickEvent(
             bool parentsVisible,
             bool parentsEnabled,
@@ -351,6 +380,9 @@ namespace ftk
         FTK_API static size_t getObjectCount();
 
     private:
+        void _parentsUpdate(bool parentsVisible, bool parentsEnabled);
+        static void _tickCountAdd(const std::shared_ptr<IWidget>&, int64_t);
+
         std::weak_ptr<Context> _context;
 
         std::string _objectName;
@@ -361,6 +393,13 @@ namespace ftk
         std::list<std::shared_ptr<IWidget> > _children;
 
         bool _sizeUpdate = false;
+
+        // Set on the ancestors of a widget with a size update, so the window
+        // finds the updates without walking the whole tree. Whenever it is
+        // set on a widget it is set on all of that widget's ancestors too;
+        // only the window clears it, from the top down.
+        bool _childSizeUpdate = false;
+
         Stretch _hStretch = Stretch::Fixed;
         Stretch _vStretch = Stretch::Fixed;
         HAlign _hAlign = HAlign::Fill;
@@ -368,9 +407,27 @@ namespace ftk
         Box2I _geometry;
 
         bool _drawUpdate = false;
+
+        // Set on the ancestors of a widget with a draw update, like
+        // _childSizeUpdate.
+        bool _childDrawUpdate = false;
+
+        // The part of the window this widget covered the last time it was
+        // drawn. The window adds it to the damage when the widget moves or
+        // is clipped away, so whatever it left behind is drawn over.
+        Box2I _drawRect;
+        bool _drawn = false;
+
         bool _visible = true;
         bool _parentsVisible = true;
         bool _clipped = false;
+
+        // What the last clip event was given, and whether the last size
+        // update reached the widget or it has moved since. The window only
+        // clips the widgets whose clipping may have changed.
+        Box2I _clipRect;
+        bool _clipUpdate = false;
+
         bool _clipChildren = false;
         bool _enabled = true;
 
@@ -382,6 +439,18 @@ namespace ftk
         std::string _tooltip;
 
         std::function<std::shared_ptr<Menu>(void)> _contextMenuCallback;
+
+        bool _tickEnabled = false;
+        std::chrono::milliseconds _tickPeriod = std::chrono::milliseconds(0);
+        std::chrono::steady_clock::time_point _tickTime;
+
+        // The number of widgets with ticks enabled in this widget's subtree,
+        // itself included. The event loop only descends into the subtrees
+        // where it is not zero.
+        int64_t _tickCount = 0;
+
+        friend class App;
+        friend class IWindow;
     };
 
     //! Release a child from the given parent, unless it has been reparented.
@@ -59,6 +59,17 @@ namespace ftk
     inline void IWidget::setSizeUpdate(bool value)
     {
         _sizeUpdate = value;
+        if (value)
+        {
+            // An ancestor that is already marked has its own ancestors
+            // marked, so there is no need to go further.
+            for (auto parent = _parent.lock();
+                parent && !parent->_childSizeUpdate;
+                parent = parent->_parent.lock())
+            {
+                parent->_childSizeUpdate = true;
+            }
+        }
     }
 
     inline Stretch IWidget::getHStretch() const
@@ -116,6 +127,16 @@ namespace ftk
         return out;
     }
 
+    inline bool IWidget::isTickEnabled() const
+    {
+        return _tickEnabled;
+    }
+
+    inline const std::chrono::milliseconds& IWidget::getTickPeriod() const
+    {
+        return _tickPeriod;
+    }
+
     inline bool IWidget::hasDrawUpdate() const
     {
         return _drawUpdate;
@@ -124,6 +145,15 @@ namespace ftk
     inline void IWidget::setDrawUpdate(bool value)
     {
         _drawUpdate = value;
+        if (value)
+        {
+            for (auto parent = _parent.lock();
+                parent && !parent->_childDrawUpdate;
+                parent = parent->_parent.lock())
+            {
+                parent->_childDrawUpdate = true;
+            }
+        }
     }
 
     inline ColorRole IWidget::getBackgroundRole() const
@@ -19,6 +19,16 @@ namespace ftk
         "F16",
         "F32");
 
+    namespace
+    {
+        // How often the window looks for a tooltip to show while the cursor
+        // is inside it.
+        const std::chrono::milliseconds tickPeriod(100);
+
+        // The size of the cells in the grid of widgets under the cursor.
+        const int hitCellSize = 64;
+    }
+
     struct IWindow::Private
     {
         std::weak_ptr<App> app;
@@ -73,6 +83,26 @@ namespace ftk
             int dl = 0;
         };
         SizeData size;
+
+        // The widgets that can be under the cursor, in drawing order, with
+        // the part of the window where they can be, and a grid over the
+        // window of which of them reach each cell. Finding the widgets
+        // under the cursor looks in one cell rather than walking the tree.
+        //
+        // Built after the widgets have been laid out and clipped. Anything
+        // that changes what is under the cursor -- geometry, visibility,
+        // enabled state, the order of children, adding or removing them --
+        // also sets a size update, so the grid is only used while there is
+        // none; the pointers in it are valid for as long.
+        struct HitData
+        {
+            bool valid = false;
+            Box2I bounds;
+            Size2I size;
+            std::vector<std::pair<IWidget*, Box2I> > widgets;
+            std::vector<std::vector<uint32_t> > cells;
+        };
+        HitData hit;
     };
 
     void IWindow::_init(
@@ -437,15 +467,13 @@ namespace ftk
         {
             p.contextMenu.reset();
         }
+        if (!p.inside && !p.contextMenu)
+        {
+            setTickEnabled(false);
+        }
 
         if (p.inside)
         {
-            if (!p.mousePress.lock())
-            {
-                MouseMoveEvent mouseMoveEvent(p.cursorPos, p.cursorPos);
-                _hoverUpdate(mouseMoveEvent);
-            }
-
             if (p.tooltipsEnabled)
             {
                 const auto tooltipTime = std::chrono::steady_clock::now();
@@ -552,48 +580,47 @@ namespace ftk
                 shared_from_this(),
                 getGeometry(),
                 !isVisible(false));
+
+            _hitUpdate();
+
+            // The widgets may have moved under the cursor without it moving.
+            if (p.inside && !p.mousePress.lock())
+            {
+                MouseMoveEvent mouseMoveEvent(p.cursorPos, p.cursorPos);
+                _hoverUpdate(mouseMoveEvent);
+            }
         }
     }
 
+    bool IWindow::_hasUpdate() const
+    {
+        return
+            _sizeUpdate || _childSizeUpdate ||
+            _drawUpdate || _childDrawUpdate;
+    }
+
+    void IWindow::_getNextUpdate(std::chrono::steady_clock::time_point&) const
+    {}
+
     bool IWindow::_hasDrawUpdate(const std::shared_ptr<IWidget>& widget) const
     {
-        bool out = false;
-        if (!widget->isClipped())
+        return widget->hasDrawUpdate() || widget->_childDrawUpdate;
+    }
+
+    bool IWindow::_getDrawDamage(Box2I& out)
+    {
+        bool valid = false;
+        auto widget = shared_from_this();
+        if (_hasDrawUpdate(widget))
         {
-            out = widget->hasDrawUpdate();
-            if (out)
-            {
-                //std::cout << "Draw update: " << widget->getObjectName() << std::endl;
-            }
-            else
-            {
-                for (const auto& child : widget->getChildren())
-                {
-                    out |= _hasDrawUpdate(child);
-                }
-            }
+            _getDrawDamage(widget, getGeometry(), out, valid);
         }
-        return out;
+        return valid;
     }
 
     bool IWindow::_hasSizeUpdate(const std::shared_ptr<IWidget>& widget) const
     {
-        bool out = widget->hasSizeUpdate();
-        if (widget->isVisible(false))
-        {
-            if (out)
-            {
-                //std::cout << "Size update: " << widget->getObjectName() << std::endl;
-            }
-            else
-            {
-                for (const auto& child : widget->getChildren())
-                {
-                    out |= _hasSizeUpdate(child);
-                }
-            }
-        }
-        return out;
+        return widget->hasSizeUpdate() || widget->_childSizeUpdate;
     }
 
     bool IWindow::_key(
@@ -695,7 +722,11 @@ namespace ftk
         // the top left corner, and raises that widget's tooltip a moment
         // later.
         p.inside = enter && !p.offscreen;
-        if (!p.inside)
+        if (p.inside)
+        {
+            setTickEnabled(true, tickPeriod);
+        }
+        else
         {
             if (auto hover = p.hover.lock())
             {
@@ -710,6 +741,35 @@ namespace ftk
         _setSize(size, size);
     }
 
+    void IWindow::draw(const std::shared_ptr<IRender>& render)
+    {
+        auto app = getApp();
+        if (!app)
+            return;
+        const auto& fontSystem = app->getFontSystem();
+        const auto& iconSystem = app->getIconSystem();
+        const auto& style = app->getStyle();
+        IWindow::_update(fontSystem, iconSystem, style);
+        const Size2I& bufferSize = getBufferSize();
+        const Box2I drawRect(V2I(), bufferSize);
+        render->begin(bufferSize);
+        DrawEvent drawEvent(
+            fontSystem,
+            iconSystem,
+            getDisplayScale(),
+            style,
+            render);
+        _drawEventRecursive(
+            shared_from_this(),
+            drawRect,
+            drawRect,
+            drawEvent);
+        render->end();
+
+        // The draw updates were used up here, not in the window's buffer.
+        setDrawUpdate();
+    }
+
     void IWindow::click(const V2I& pos, MouseButton button, int modifiers)
     {
         _cursorEnter(true);
@@ -777,21 +837,21 @@ namespace ftk
                     p.cursorPosPrev,
                     p.dragDropData);
                 auto hover = p.dragDropHover.lock();
-                auto widgets = _getUnderCursor(UnderCursor::Hover, p.cursorPos);
+                const auto widgets = _getUnderCursor(UnderCursor::Hover, p.cursorPos);
                 std::shared_ptr<IWidget> widget;
-                while (!widgets.empty())
+                auto i = widgets.begin();
+                for (; i != widgets.end(); ++i)
                 {
-                    if (hover == widgets.front())
+                    if (hover == *i)
                     {
                         break;
                     }
-                    widgets.front()->dragEnterEvent(event);
+                    (*i)->dragEnterEvent(event);
                     if (event.accept)
                     {
-                        widget = widgets.front();
+                        widget = *i;
                         break;
                     }
-                    widgets.pop_front();
                 }
                 if (widget)
                 {
@@ -801,7 +861,7 @@ namespace ftk
                     }
                     p.dragDropHover = widget;
                 }
-                else if (widgets.empty() && hover)
+                else if (i == widgets.end() && hover)
                 {
                     p.dragDropHover.reset();
                     hover->dragLeaveEvent(event);
@@ -952,16 +1012,27 @@ namespace ftk
     void IWindow::_drawEventRecursive(
         const std::shared_ptr<IWidget>& widget,
         const Box2I& drawRect,
+        const Box2I& damage,
         const DrawEvent& event)
     {
         const Box2I& g = widget->getGeometry();
         if (!widget->isClipped() && g.w() > 0 && g.h() > 0)
         {
+            // The whole of what the widget covers is remembered, not just
+            // the damaged part drawn now, since that is what it leaves
+            // behind if it moves.
+            widget->_drawRect = drawRect;
+            widget->_drawn = true;
+
             // Cleared before the drawing rather than only after it, so that
             // a redraw asked for during the drawing can be told apart from
             // the one that got us here. Either way it is thrown away, which
             // is a thing to be caught rather than left to be discovered: a
             // widget that needs another drawing has to ask from tickEvent().
+            //
+            // The widget is given its whole draw rectangle, as when the
+            // window is drawn in full; the render clip rectangle keeps the
+            // drawing to the damage.
             widget->setDrawUpdate(false);
             widget->drawEvent(drawRect, event);
             FTK_ASSERT(!widget->hasDrawUpdate());
@@ -974,17 +1045,22 @@ namespace ftk
             if (widget->doesClipChildren())
             {
                 event.render->setClipRectEnabled(true);
-                event.render->setClipRect(childrenClipRect);
+                event.render->setClipRect(intersect(childrenClipRect, damage));
             }
             for (const auto& child : widget->getChildren())
             {
                 const Box2I& childGeometry = child->getGeometry();
                 if (intersects(childGeometry, childrenClipRect))
                 {
-                    _drawEventRecursive(
-                        child,
-                        intersect(childGeometry, childrenClipRect),
-                        event);
+                    const Box2I childDrawRect = intersect(childGeometry, childrenClipRect);
+                    if (intersects(childDrawRect, damage))
+                    {
+                        _drawEventRecursive(
+                            child,
+                            childDrawRect,
+                            damage,
+                            event);
+                    }
                 }
             }
             if (widget->doesClipChildren())
@@ -1000,6 +1076,10 @@ namespace ftk
         const std::shared_ptr<IWidget>& widget,
         const StyleEvent& event)
     {
+        // Widgets read the style in their size hint and draw events without
+        // always asking for an update when it changes.
+        widget->setSizeUpdate();
+        widget->setDrawUpdate();
         widget->styleEvent(event);
         for (const auto& child : widget->getChildren())
         {
@@ -1011,12 +1091,20 @@ namespace ftk
         const std::shared_ptr<IWidget>& widget,
         const SizeHintEvent& event)
     {
+        // Only the widgets with a size update and their ancestors need a new
+        // size hint; the size hints of the rest have not changed. The mark is
+        // cleared first so an update asked for from here is not lost.
+        widget->_childSizeUpdate = false;
         for (const auto& child : widget->getChildren())
         {
-            _sizeHintEventRecursive(child, event);
+            if (_hasSizeUpdate(child))
+            {
+                _sizeHintEventRecursive(child, event);
+            }
         }
         widget->sizeHintEvent(event);
         widget->setSizeUpdate(false);
+        widget->_clipUpdate = true;
     }
 
     void IWindow::_clipEventRecursive(
@@ -1028,6 +1116,23 @@ namespace ftk
         clipped |= !intersects(g, clipRect);
         clipped |= !widget->isVisible(false);
         const Box2I intersectedClipRect = intersect(g, clipRect);
+
+        // A widget that was not reached by the size update, has not moved,
+        // and is clipped the same as before has children that are clipped
+        // the same as before too.
+        if (!widget->_clipUpdate &&
+            !_hasSizeUpdate(widget) &&
+            intersectedClipRect == widget->_clipRect &&
+            clipped == widget->isClipped())
+            return;
+        widget->_clipUpdate = false;
+        widget->_clipRect = intersectedClipRect;
+
+        // What a widget asked to draw while it was clipped was not drawn.
+        if (!clipped && widget->isClipped())
+        {
+            widget->setDrawUpdate();
+        }
         widget->clipEvent(intersectedClipRect, clipped);
         const Box2I childrenClipRect = intersect(
             widget->getChildrenClipRect(), intersectedClipRect);
@@ -1041,13 +1146,115 @@ namespace ftk
         }
     }
 
-    std::list<std::shared_ptr<IWidget> > IWindow::_getUnderCursor(
+    void IWindow::_clearDrawUpdate(const std::shared_ptr<IWidget>& widget)
+    {
+        widget->_childDrawUpdate = false;
+        for (const auto& child : widget->getChildren())
+        {
+            if (child->_childDrawUpdate)
+            {
+                _clearDrawUpdate(child);
+            }
+        }
+    }
+
+    void IWindow::_getDrawDamage(
+        const std::shared_ptr<IWidget>& widget,
+        const Box2I& clipRect,
+        Box2I& damage,
+        bool& valid)
+    {
+        const auto add = [&damage, &valid](const Box2I& value)
+        {
+            damage = valid ? expand(damage, value) : value;
+            valid = true;
+        };
+        const Box2I& g = widget->getGeometry();
+        if (widget->isClipped() || g.w() <= 0 || g.h() <= 0)
+        {
+            // Nothing draws it any more, so what it drew last needs to be
+            // drawn over. Its children were drawn inside it.
+            if (widget->_drawn)
+            {
+                add(widget->_drawRect);
+                widget->_drawn = false;
+            }
+            _clearDrawUpdate(widget);
+        }
+        else if (widget->hasDrawUpdate())
+        {
+            // Its children are drawn with it, so they need not be looked at.
+            add(clipRect);
+            if (widget->_drawn && widget->_drawRect != clipRect)
+            {
+                add(widget->_drawRect);
+            }
+            _clearDrawUpdate(widget);
+        }
+        else
+        {
+            // Only the children with a draw update, or with one somewhere
+            // inside them, can add to the damage.
+            widget->_childDrawUpdate = false;
+            const Box2I childrenClipRect = intersect(
+                widget->getChildrenClipRect(),
+                clipRect);
+            for (const auto& child : widget->getChildren())
+            {
+                const Box2I& childGeometry = child->getGeometry();
+                if (intersects(childGeometry, childrenClipRect))
+                {
+                    if (_hasDrawUpdate(child))
+                    {
+                        _getDrawDamage(
+                            child,
+                            intersect(childGeometry, childrenClipRect),
+                            damage,
+                            valid);
+                    }
+                }
+                else
+                {
+                    if (child->_drawn)
+                    {
+                        add(child->_drawRect);
+                        child->_drawn = false;
+                    }
+                    _clearDrawUpdate(child);
+                }
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<IWidget> > IWindow::_getUnderCursor(
         UnderCursor type,
         const V2I& pos)
     {
         FTK_P();
-        std::list<std::shared_ptr<IWidget> > out;
-        _getUnderCursor(type, shared_from_this(), pos, out);
+        std::vector<std::shared_ptr<IWidget> > out;
+        if (p.hit.valid && !_hasSizeUpdate(shared_from_this()))
+        {
+            // The widgets are in drawing order, so the last is on top.
+            if (contains(p.hit.bounds, pos))
+            {
+                const int x = (pos.x - p.hit.bounds.min.x) / hitCellSize;
+                const int y = (pos.y - p.hit.bounds.min.y) / hitCellSize;
+                const auto& cell = p.hit.cells[y * p.hit.size.w + x];
+                for (auto i = cell.rbegin(); i != cell.rend(); ++i)
+                {
+                    const auto& widget = p.hit.widgets[*i];
+                    if (contains(widget.second, pos) &&
+                        (UnderCursor::Tooltip == type || widget.first->isEnabled()))
+                    {
+                        out.push_back(widget.first->shared_from_this());
+                    }
+                }
+            }
+        }
+        else
+        {
+            _getUnderCursor(type, shared_from_this(), pos, out);
+        }
         if (UnderCursor::Tooltip == type)
         {
             auto i = out.begin();
@@ -1065,7 +1272,7 @@ namespace ftk
         UnderCursor type,
         const std::shared_ptr<IWidget>& widget,
         const V2I& pos,
-        std::list<std::shared_ptr<IWidget> >& out)
+        std::vector<std::shared_ptr<IWidget> >& out)
     {
         if (!widget->isClipped() &&
             (UnderCursor::Tooltip == type ? true : widget->isEnabled()) &&
@@ -1081,6 +1288,63 @@ namespace ftk
         }
     }
 
+    void IWindow::_hitUpdate()
+    {
+        FTK_P();
+        p.hit.valid = false;
+        p.hit.widgets.clear();
+        for (auto& cell : p.hit.cells)
+        {
+            cell.clear();
+        }
+
+        // Widgets still waiting to be laid out may not be where the grid
+        // would put them.
+        auto widget = shared_from_this();
+        if (_hasSizeUpdate(widget))
+            return;
+
+        const Box2I& g = getGeometry();
+        p.hit.bounds = g;
+        p.hit.size = Size2I(
+            (g.w() + hitCellSize - 1) / hitCellSize,
+            (g.h() + hitCellSize - 1) / hitCellSize);
+        p.hit.cells.resize(p.hit.size.w * p.hit.size.h);
+        _hitAdd(widget, g);
+        p.hit.valid = true;
+    }
+
+    void IWindow::_hitAdd(
+        const std::shared_ptr<IWidget>& widget,
+        const Box2I& rect)
+    {
+        FTK_P();
+
+        // A widget is only under the cursor inside all of its parents, so
+        // neither it nor its children can be anywhere else.
+        const Box2I r = intersect(widget->getGeometry(), rect);
+        if (widget->isClipped() || !r.isValid())
+            return;
+
+        const uint32_t index = static_cast<uint32_t>(p.hit.widgets.size());
+        p.hit.widgets.push_back(std::make_pair(widget.get(), r));
+        const int x0 = (r.min.x - p.hit.bounds.min.x) / hitCellSize;
+        const int x1 = (r.max.x - p.hit.bounds.min.x) / hitCellSize;
+        const int y0 = (r.min.y - p.hit.bounds.min.y) / hitCellSize;
+        const int y1 = (r.max.y - p.hit.bounds.min.y) / hitCellSize;
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+            {
+                p.hit.cells[y * p.hit.size.w + x].push_back(index);
+            }
+        }
+        for (const auto& child : widget->getChildren())
+        {
+            _hitAdd(child, r);
+        }
+    }
+
     void IWindow::_hoverUpdate(MouseMoveEvent& event)
     {
         FTK_P();
@@ -1133,7 +1397,7 @@ namespace ftk
     }
 
     bool IWindow::_contextMenu(
-        const std::list<std::shared_ptr<IWidget> >& widgets)
+        const std::vector<std::shared_ptr<IWidget> >& widgets)
     {
         FTK_P();
         bool out = false;
@@ -1152,6 +1416,7 @@ namespace ftk
                 continue;
 
             p.contextMenu = menu;
+            setTickEnabled(true, tickPeriod);
             menu->open(
                 std::dynamic_pointer_cast<IWindow>(shared_from_this()),
                 p.cursorPos);
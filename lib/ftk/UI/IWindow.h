@@ -177,6 +177,12 @@ namespace ftk
         //! Press a key and release it.
         FTK_API void keyPress(Key, int modifiers = 0);
 
+        //! Lay out and draw the whole window with the given renderer, rather
+        //! than the window's own. With a SoftwareRender the widgets are drawn
+        //! on the CPU, and the picture is the renderer's image. The window's
+        //! own buffer is drawn again in full the next time it updates.
+        FTK_API void draw(const std::shared_ptr<IRender>&);
+
         ///@}
 
         //! Set the window icon.
@@ -230,7 +236,25 @@ namespace ftk
             const std::shared_ptr<IconSystem>&,
             const std::shared_ptr<Style>&);
 
+        //! Get whether the window has anything to do the next time it is
+        //! updated. The event loop does not sleep while it does.
+        virtual bool _hasUpdate() const;
+
+        //! Get the time the window next needs to be updated, for work that
+        //! finishes on its own such as a read back from the GPU. The event
+        //! loop sleeps no longer than this; the default changes nothing.
+        virtual void _getNextUpdate(std::chrono::steady_clock::time_point&) const;
+
+        //! Get whether the widget or any of its children have a draw update.
         bool _hasDrawUpdate(const std::shared_ptr<IWidget>&) const;
+
+        //! Get the part of the window that needs to be drawn: the union of
+        //! the clipped geometry of the widgets with a draw update, and of
+        //! wherever they were drawn before. Returns false if nothing needs
+        //! to be drawn.
+        bool _getDrawDamage(Box2I&);
+
+        //! Get whether the widget or any of its children have a size update.
         bool _hasSizeUpdate(const std::shared_ptr<IWidget>&) const;
 
         bool _key(Key, bool press, int modifiers);
@@ -241,16 +265,24 @@ namespace ftk
         void _scroll(const V2F&, int modifiers);
         void _drop(const V2I& pos, const std::shared_ptr<IDragDropData>&);
 
+        //! Draw the widgets that intersect the damage, clipped to it. The
+        //! rest of the buffer is left as the last draw left it.
         void _drawEventRecursive(
             const std::shared_ptr<IWidget>&,
-            const Box2I&,
+            const Box2I& drawRect,
+            const Box2I& damage,
             const DrawEvent&);
         void _styleEventRecursive(
             const std::shared_ptr<IWidget>&,
             const StyleEvent&);
+
+        //! Send size hint events to the widgets with a size update and to
+        //! their ancestors.
         void _sizeHintEventRecursive(
             const std::shared_ptr<IWidget>&,
             const SizeHintEvent&);
+
+        //! Send clip events to the widgets whose clipping may have changed.
         void _clipEventRecursive(
             const std::shared_ptr<IWidget>&,
             const Box2I&,
@@ -262,18 +294,31 @@ namespace ftk
             Hover,
             Tooltip
         };
-        std::list<std::shared_ptr<IWidget> > _getUnderCursor(
+
+        //! Get the widgets under the cursor, from the top down.
+        std::vector<std::shared_ptr<IWidget> > _getUnderCursor(
             UnderCursor,
             const V2I&);
+
+        void _getDrawDamage(
+            const std::shared_ptr<IWidget>&,
+            const Box2I& clipRect,
+            Box2I& damage,
+            bool& valid);
+        void _clearDrawUpdate(const std::shared_ptr<IWidget>&);
         void _getUnderCursor(
             UnderCursor,
             const std::shared_ptr<IWidget>&,
             const V2I&,
-            std::list<std::shared_ptr<IWidget> >&);
+            std::vector<std::shared_ptr<IWidget> >&);
+
+        //! Build the grid of widgets that can be under the cursor.
+        void _hitUpdate();
+        void _hitAdd(const std::shared_ptr<IWidget>&, const Box2I&);
 
         void _hoverUpdate(MouseMoveEvent&);
 
-        bool _contextMenu(const std::list<std::shared_ptr<IWidget> >&);
+        bool _contextMenu(const std::vector<std::shared_ptr<IWidget> >&);
 
         void _getKeyFocus(
             const std::shared_ptr<IWidget>&,
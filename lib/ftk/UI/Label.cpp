@@ -37,7 +37,7 @@ namespace ftk
         {
             Box2I g;
             Box2I g2;
-            std::vector<std::shared_ptr<Glyph> > glyphs;
+            std::shared_ptr<const GlyphRun> run;
         };
         std::optional<DrawData> draw;
     };
@@ -278,7 +278,7 @@ namespace ftk
             p.draw->g2 = margin(p.draw->g, -p.size.hMargin, -p.size.vMargin, -p.size.hMargin, -p.size.vMargin);
             if (!p.text.empty())
             {
-                p.draw->glyphs = event.fontSystem->getGlyphs(p.text, p.size.fontInfo);
+                p.draw->run = event.fontSystem->getGlyphRun(p.text, p.size.fontInfo);
             }
         }
 
@@ -290,11 +290,14 @@ namespace ftk
             event.render->setClipRect(getGeometry());
         }
 
-        event.render->drawText(
-            p.draw->glyphs,
-            p.size.fontMetrics,
-            p.draw->g2.min,
-            event.style->getColorRole(p.textRole, isEnabled()));
+        if (p.draw->run)
+        {
+            event.render->drawText(
+                p.draw->run->glyphs,
+                p.size.fontMetrics,
+                p.draw->g2.min,
+                event.style->getColorRole(p.textRole, isEnabled()));
+        }
 
         if (p.clipText)
         {
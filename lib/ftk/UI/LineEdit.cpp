@@ -63,7 +63,7 @@ namespace ftk
             TriMesh2F bgMesh;
             TriMesh2F border;
             TriMesh2F keyFocus;
-            std::vector<std::shared_ptr<Glyph> > glyphs;
+            std::shared_ptr<const GlyphRun> run;
         };
         std::optional<DrawData> draw;
     };
@@ -331,6 +331,10 @@ namespace ftk
                 p.cursorTimer = now;
             }
         }
+        else
+        {
+            setTickEnabled(false);
+        }
     }
 
     void LineEdit::styleEvent(const StyleEvent& event)
@@ -440,15 +444,18 @@ namespace ftk
         const V2I pos(
             p.draw->g3.x() - p.scroll,
             p.draw->g3.y() + p.draw->g3.h() / 2 - p.size.fontMetrics.lineHeight / 2);
-        if (!text.empty() && p.draw->glyphs.empty())
+        if (!text.empty() && !p.draw->run)
         {
-            p.draw->glyphs = event.fontSystem->getGlyphs(text, p.size.fontInfo);
+            p.draw->run = event.fontSystem->getGlyphRun(text, p.size.fontInfo);
+        }
+        if (p.draw->run)
+        {
+            event.render->drawText(
+                p.draw->run->glyphs,
+                p.size.fontMetrics,
+                pos,
+                event.style->getColorRole(ColorRole::Text, enabled));
         }
-        event.render->drawText(
-            p.draw->glyphs,
-            p.size.fontMetrics,
-            pos,
-            event.style->getColorRole(ColorRole::Text, enabled));
 
         // Draw the cursor.
         if (p.cursorVisible)
@@ -496,6 +503,9 @@ namespace ftk
             p.cursorVisible = true;
             p.cursorTimer = std::chrono::steady_clock::now();
             setDrawUpdate();
+
+            // Ticks blink the cursor.
+            setTickEnabled(true);
         }
         else
         {
@@ -3,8 +3,9 @@
 
 #include <ftk/UI/ListItemsWidgetPrivate.h>
 
-#include <ftk/UI/ButtonGroup.h>
-#include <ftk/UI/RowLayout.h>
+#include <ftk/Core/String.h>
+
+#include <optional>
 
 namespace ftk
 {
@@ -31,13 +32,37 @@ namespace ftk
     {
         ButtonGroupType type = ButtonGroupType::Click;
         std::vector<ListItem> items;
-        std::vector<std::shared_ptr<ListItemButton> > buttons;
-        std::shared_ptr<ButtonGroup> buttonGroup;
-        std::shared_ptr<VerticalLayout> layout;
+        std::vector<bool> checked;
+        int radio = -1;
         std::function<void(int, bool)> callback;
         std::shared_ptr<Observable<int> > current;
         std::shared_ptr<Observable<int> > scrollTo;
         std::string search;
+
+        //! The items that match the search, in order.
+        std::vector<int> filtered;
+
+        //! The row of each item in the filtered list, or -1.
+        std::vector<int> itemRows;
+
+        //! A button and the filtered row it is showing, or -1 when it is free.
+        struct Row
+        {
+            std::shared_ptr<ListItemButton> button;
+            int row = -1;
+        };
+        std::vector<Row> rows;
+
+        //! The visible part of the widget, in window coordinates.
+        Box2I viewport;
+
+        struct SizeData
+        {
+            int rowHeight = 0;
+            int width = 0;
+            std::optional<SizeHintEvent> event;
+        };
+        SizeData size;
     };
 
     void ListItemsWidget::_init(
@@ -45,47 +70,12 @@ namespace ftk
         ButtonGroupType type,
         const std::shared_ptr<IWidget>& parent)
     {
-        IContainer::_init(context, "ftk::ListItemsWidget", parent);
+        IWidget::_init(context, "ftk::ListItemsWidget", parent);
         FTK_P();
 
         setAcceptsKeyFocus(true);
 
-        p.buttonGroup = ButtonGroup::create(context, type);
-
-        p.layout = VerticalLayout::create(context);
-        _setWidget(p.layout);
-        p.layout->setSpacingRole(SizeRole::None);
-
-        _itemsUpdate();
-
-        switch (type)
-        {
-        case ButtonGroupType::Click:
-            p.buttonGroup->setClickedCallback(
-                [this](int index)
-                {
-                    setCurrent(index);
-                    takeKeyFocus();
-                    if (_p->callback)
-                    {
-                        _p->callback(index, true);
-                    }
-                });
-            break;
-        default:
-            p.buttonGroup->setCheckedCallback(
-                [this](int index, bool value)
-                {
-                    setCurrent(index);
-                    takeKeyFocus();
-                    if (_p->callback)
-                    {
-                        _p->callback(index, value);
-                    }
-                });
-            break;
-        }
-
+        p.type = type;
         p.current = Observable<int>::create(-1);
         p.scrollTo = Observable<int>::create(-1);
     }
@@ -118,12 +108,16 @@ namespace ftk
         if (value == p.items)
             return;
         p.items = value;
-        _itemsUpdate();
+        p.checked = std::vector<bool>(p.items.size(), false);
+        p.radio = -1;
+        p.size.width = 0;
+        _searchUpdate();
         const int index = !p.items.empty() ?
             clamp(p.current->get(), 0, static_cast<int>(p.items.size()) - 1) :
             -1;
         if (p.current->setIfChanged(index))
         {
+            _currentUpdate();
             p.scrollTo->setIfChanged(p.current->get());
         }
     }
@@ -142,16 +136,44 @@ namespace ftk
     {
         FTK_P();
         bool out = false;
-        if (index >= 0 && index < static_cast<int>(p.buttons.size()))
+        if (index >= 0 && index < static_cast<int>(p.checked.size()))
         {
-            out = p.buttons[index]->isChecked();
+            out = p.checked[index];
         }
         return out;
     }
 
     void ListItemsWidget::setChecked(int index, bool value)
     {
-        _p->buttonGroup->setChecked(index, value);
+        FTK_P();
+        const int size = static_cast<int>(p.checked.size());
+        switch (p.type)
+        {
+        case ButtonGroupType::Check:
+            if (index >= 0 && index < size)
+            {
+                p.checked[index] = value;
+            }
+            break;
+        case ButtonGroupType::Radio:
+            for (int i = 0; i < size; ++i)
+            {
+                p.checked[i] = i == index;
+            }
+            p.radio = index;
+            break;
+        case ButtonGroupType::Toggle:
+            for (int i = 0; i < size; ++i)
+            {
+                p.checked[i] = i == index ? value : false;
+            }
+            break;
+        default: break;
+        }
+        for (size_t i = 0; i < p.rows.size(); ++i)
+        {
+            _rowUpdate(i);
+        }
     }
 
     void ListItemsWidget::setCallback(const std::function<void(int, bool)>& value)
@@ -198,7 +220,7 @@ namespace ftk
         if (value == p.search)
             return;
         p.search = value;
-        _itemsUpdate();
+        _searchUpdate();
     }
 
     void ListItemsWidget::clearSearch()
@@ -207,7 +229,7 @@ namespace ftk
         if (!p.search.empty())
         {
             p.search = std::string();
-            _itemsUpdate();
+            _searchUpdate();
         }
     }
 
@@ -215,17 +237,87 @@ namespace ftk
     {
         FTK_P();
         Box2I out;
-        if (index >= 0 && index < static_cast<int>(p.buttons.size()))
+        if (index >= 0 && index < static_cast<int>(p.itemRows.size()))
         {
-            out = p.buttons[index]->getGeometry();
-            out = move(out, -p.layout->getGeometry().min);
+            const int row = p.itemRows[index];
+            if (row >= 0)
+            {
+                out = Box2I(
+                    0,
+                    row * p.size.rowHeight,
+                    getGeometry().w(),
+                    p.size.rowHeight);
+            }
         }
         return out;
     }
-    
-    
 
-    
+    Size2I ListItemsWidget::getSizeHint() const
+    {
+        FTK_P();
+        return Size2I(
+            p.size.width,
+            static_cast<int>(p.filtered.size()) * p.size.rowHeight);
+    }
+
+    void ListItemsWidget::setGeometry(const Box2I& value)
+    {
+        const bool changed = value != getGeometry();
+        IWidget::setGeometry(value);
+        if (changed)
+        {
+            _rowsUpdate();
+        }
+    }
+
+    void ListItemsWidget::styleEvent(const StyleEvent& event)
+    {
+        IWidget::styleEvent(event);
+        FTK_P();
+        if (event.hasChanges())
+        {
+            // The rows are measured again as they are shown.
+            p.size.width = 0;
+        }
+    }
+
+    void ListItemsWidget::sizeHintEvent(const SizeHintEvent& event)
+    {
+        IWidget::sizeHintEvent(event);
+        FTK_P();
+
+        // The same height as a ListItemButton, without needing one.
+        const int margin = event.style->getSizeRole(SizeRole::MarginInside, event.displayScale);
+        const int keyFocus = event.style->getSizeRole(SizeRole::KeyFocus, event.displayScale);
+        const FontInfo fontInfo = event.style->getFont(FontType::Regular, event.displayScale);
+        const FontMetrics fontMetrics = event.fontSystem->getMetrics(fontInfo);
+        p.size.rowHeight = fontMetrics.lineHeight + (margin + keyFocus) * 2;
+
+        // Keep the event so that buttons given to a new row can be measured
+        // straight away instead of on the next update.
+        p.size.event = event;
+
+        // The width is the widest row that has been shown. Measuring every
+        // item up front would cost as much as the buttons did.
+        for (const auto& row : p.rows)
+        {
+            if (row.row >= 0)
+            {
+                p.size.width = std::max(p.size.width, row.button->getSizeHint().w);
+            }
+        }
+    }
+
+    void ListItemsWidget::clipEvent(const Box2I& clipRect, bool clipped)
+    {
+        IWidget::clipEvent(clipRect, clipped);
+        FTK_P();
+        if (!clipped && clipRect != p.viewport)
+        {
+            p.viewport = clipRect;
+            _rowsUpdate();
+        }
+    }
 
     void ListItemsWidget::keyFocusEvent(bool value)
     {
@@ -243,38 +335,54 @@ namespace ftk
         FTK_P();
         if (0 == event.modifiers)
         {
+            // The keys move through the items that match the search.
+            const int current = p.current->get();
+            const int row =
+                current >= 0 && current < static_cast<int>(p.itemRows.size()) ?
+                p.itemRows[current] :
+                -1;
+            const int rows = static_cast<int>(p.filtered.size());
             switch (event.key)
             {
             case Key::Return:
-            {
                 event.accept = true;
                 takeKeyFocus();
-                const int current = p.current->get();
-                if (current >= 0 && current < static_cast<int>(p.buttons.size()))
+                if (row >= 0)
                 {
-                    p.buttons[current]->click();
+                    _click(current);
                 }
                 break;
-            }
             case Key::Up:
                 event.accept = true;
                 takeKeyFocus();
-                setCurrent(p.current->get() - 1);
+                if (rows > 0)
+                {
+                    setCurrent(p.filtered[clamp(row - 1, 0, rows - 1)]);
+                }
                 break;
             case Key::Down:
                 event.accept = true;
                 takeKeyFocus();
-                setCurrent(p.current->get() + 1);
+                if (rows > 0)
+                {
+                    setCurrent(p.filtered[clamp(row + 1, 0, rows - 1)]);
+                }
                 break;
             case Key::Home:
                 event.accept = true;
                 takeKeyFocus();
-                setCurrent(0);
+                if (rows > 0)
+                {
+                    setCurrent(p.filtered.front());
+                }
                 break;
             case Key::End:
                 event.accept = true;
                 takeKeyFocus();
-                setCurrent(static_cast<int>(p.items.size()) - 1);
+                if (rows > 0)
+                {
+                    setCurrent(p.filtered.back());
+                }
                 break;
             case Key::Escape:
                 event.accept = true;
@@ -295,23 +403,159 @@ namespace ftk
         event.accept = true;
     }
 
-    void ListItemsWidget::_itemsUpdate()
+    void ListItemsWidget::_searchUpdate()
     {
         FTK_P();
+        p.filtered.clear();
+        p.itemRows = std::vector<int>(p.items.size(), -1);
+        for (size_t i = 0; i < p.items.size(); ++i)
+        {
+            if (p.search.empty() ||
+                contains(p.items[i].text, p.search, CaseCompare::Insensitive))
+            {
+                p.itemRows[i] = static_cast<int>(p.filtered.size());
+                p.filtered.push_back(static_cast<int>(i));
+            }
+        }
+
+        // Every row is showing something else now.
+        for (auto& row : p.rows)
+        {
+            row.row = -1;
+        }
+        _rowsUpdate();
+
+        setSizeUpdate();
+        setDrawUpdate();
+    }
+
+    void ListItemsWidget::_rowsUpdate()
+    {
+        FTK_P();
+
+        // Find the rows in the viewport, with half a viewport either side so
+        // that scrolling a little reuses the buttons that are already set up.
+        const Box2I& g = getGeometry();
+        const int rowHeight = p.size.rowHeight;
+        int first = 0;
+        int last = -1;
+        if (rowHeight > 0 && !p.filtered.empty() && p.viewport.isValid())
+        {
+            const Box2I band = margin(p.viewport, 0, p.viewport.h() / 2);
+            if (band.max.y >= g.min.y)
+            {
+                first = std::max(0, (band.min.y - g.min.y) / rowHeight);
+                last = std::min(
+                    static_cast<int>(p.filtered.size()) - 1,
+                    (band.max.y - g.min.y) / rowHeight);
+            }
+        }
+
+        // Let go of the rows that left the band, and note the ones that are
+        // still in it.
+        std::vector<bool> shown(std::max(0, last - first + 1), false);
+        for (auto& row : p.rows)
+        {
+            if (row.row >= first && row.row <= last)
+            {
+                shown[row.row - first] = true;
+            }
+            else
+            {
+                row.row = -1;
+            }
+        }
 
-        p.buttons.clear();
-        p.buttonGroup->clearButtons();
-        p.layout->clear();
+        // Give the new rows a free button, or make one.
+        size_t free = 0;
+        for (int i = first; i <= last; ++i)
+        {
+            if (shown[i - first])
+                continue;
+            while (free < p.rows.size() && p.rows[free].row >= 0)
+            {
+                ++free;
+            }
+            if (free == p.rows.size())
+            {
+                auto context = getContext();
+                if (!context)
+                    break;
+                Private::Row row;
+                row.button = ListItemButton::create(context, std::string(), shared_from_this());
+                switch (p.type)
+                {
+                case ButtonGroupType::Click:
+                    row.button->setClickedCallback(
+                        [this, free]
+                        {
+                            const int row = _p->rows[free].row;
+                            if (row >= 0)
+                            {
+                                _click(_p->filtered[row]);
+                            }
+                        });
+                    break;
+                default:
+                    row.button->setCheckable(true);
+                    row.button->setCheckedCallback(
+                        [this, free](bool value)
+                        {
+                            const int row = _p->rows[free].row;
+                            if (row >= 0)
+                            {
+                                _check(_p->filtered[row], value);
+                            }
+                        });
+                    break;
+                }
+                p.rows.push_back(row);
+            }
+            p.rows[free].row = i;
+        }
+
+        for (size_t i = 0; i < p.rows.size(); ++i)
+        {
+            _rowUpdate(i);
+        }
+    }
 
-        if (auto context = getContext())
+    void ListItemsWidget::_rowUpdate(size_t index)
+    {
+        FTK_P();
+        const auto& row = p.rows[index];
+        if (row.row >= 0)
         {
-            for (const auto& item : p.items)
+            const int item = p.filtered[row.row];
+            const auto& button = row.button;
+            if (button->getText() != p.items[item].text)
             {
-                auto button = ListItemButton::create(context, item.text, p.layout);
-                button->setTooltip(item.tooltip);
-                p.buttons.push_back(button);
-                p.buttonGroup->addButton(button);
+                button->setText(p.items[item].text);
+                if (p.size.event.has_value())
+                {
+                    button->sizeHintEvent(*p.size.event);
+                    const int width = button->getSizeHint().w;
+                    if (width > p.size.width)
+                    {
+                        p.size.width = width;
+                        setSizeUpdate();
+                    }
+                }
             }
+            button->setTooltip(p.items[item].tooltip);
+            button->setChecked(p.checked[item]);
+            button->setCurrent(p.current->get() == item && hasKeyFocus());
+            const Box2I& g = getGeometry();
+            button->setGeometry(Box2I(
+                g.min.x,
+                g.min.y + row.row * p.size.rowHeight,
+                g.w(),
+                p.size.rowHeight));
+            button->setVisible(true);
+        }
+        else
+        {
+            row.button->setVisible(false);
         }
     }
 
@@ -320,9 +564,73 @@ namespace ftk
         FTK_P();
         const int current = p.current->get();
         const bool focus = hasKeyFocus();
-        for (size_t i = 0; i < p.buttons.size(); ++i)
+        for (const auto& row : p.rows)
+        {
+            if (row.row >= 0)
+            {
+                row.button->setCurrent(current == p.filtered[row.row] && focus);
+            }
+        }
+    }
+
+    void ListItemsWidget::_click(int item)
+    {
+        FTK_P();
+        if (ButtonGroupType::Click == p.type)
+        {
+            // Held alive across the callback, which is allowed to close the
+            // thing this widget is part of.
+            auto self = shared_from_this();
+            setCurrent(item);
+            takeKeyFocus();
+            if (p.callback)
+            {
+                p.callback(item, true);
+            }
+        }
+        else
+        {
+            _check(item, !p.checked[item]);
+        }
+    }
+
+    void ListItemsWidget::_check(int item, bool value)
+    {
+        FTK_P();
+        auto self = shared_from_this();
+        bool callback = true;
+        switch (p.type)
+        {
+        case ButtonGroupType::Check:
+            p.checked[item] = value;
+            break;
+        case ButtonGroupType::Radio:
+            // Clicking the checked item leaves it checked.
+            callback = item != p.radio;
+            p.radio = item;
+            value = true;
+            for (size_t i = 0; i < p.checked.size(); ++i)
+            {
+                p.checked[i] = static_cast<int>(i) == item;
+            }
+            break;
+        case ButtonGroupType::Toggle:
+            for (size_t i = 0; i < p.checked.size(); ++i)
+            {
+                p.checked[i] = static_cast<int>(i) == item ? value : false;
+            }
+            break;
+        default: break;
+        }
+        for (size_t i = 0; i < p.rows.size(); ++i)
+        {
+            _rowUpdate(i);
+        }
+        setCurrent(item);
+        takeKeyFocus();
+        if (callback && p.callback)
         {
-            p.buttons[i]->setCurrent(current == static_cast<int>(i) && focus);
+            p.callback(item, value);
         }
     }
-}
\ No newline at end of file
+}
@@ -3,7 +3,6 @@
 
 #pragma once
 
-#include <ftk/UI/IContainer.h>
 #include <ftk/UI/ButtonGroup.h>
 #include <ftk/UI/IWidget.h>
 
@@ -28,7 +27,12 @@ namespace ftk
     };
 
     //! List items widget.
-    class FTK_API_TYPE ListItemsWidget : public IContainer
+    //!
+    //! Only the rows near the visible part of the widget have a button; the
+    //! buttons are given to other items as the widget is scrolled. The items,
+    //! the checked state, and the search are kept here rather than in the
+    //! buttons, so a list of any length costs a screenful of widgets.
+    class FTK_API_TYPE ListItemsWidget : public IWidget
     {
     protected:
         void _init(
@@ -89,13 +93,22 @@ namespace ftk
         //! Get an item rectangle.
         FTK_API Box2I getRect(int) const;
 
+        FTK_API Size2I getSizeHint() const override;
+        FTK_API void setGeometry(const Box2I&) override;
+        FTK_API void styleEvent(const StyleEvent&) override;
+        FTK_API void sizeHintEvent(const SizeHintEvent&) override;
+        FTK_API void clipEvent(const Box2I&, bool) override;
         FTK_API void keyFocusEvent(bool) override;
         FTK_API void keyPressEvent(KeyEvent&) override;
         FTK_API void keyReleaseEvent(KeyEvent&) override;
 
     private:
-        void _itemsUpdate();
+        void _searchUpdate();
+        void _rowsUpdate();
+        void _rowUpdate(size_t);
         void _currentUpdate();
+        void _click(int);
+        void _check(int, bool);
 
         FTK_PRIVATE();
     };
@@ -239,10 +239,17 @@ namespace ftk
                 p.cursorTimer = now;
             }
         }
-        else if (p.cursorVisible)
+        else
         {
-            p.cursorVisible = false;
-            setDrawUpdate();
+            if (p.cursorVisible)
+            {
+                p.cursorVisible = false;
+                setDrawUpdate();
+            }
+            if (0 == p.autoScroll.x && 0 == p.autoScroll.y)
+            {
+                setTickEnabled(false);
+            }
         }
 
         if (p.autoScroll.x != 0 || p.autoScroll.y != 0)
@@ -370,11 +377,14 @@ namespace ftk
             const Box2I g3(pos.x, pos.y, p.size.textSize.w, p.size.fontMetrics.lineHeight);
             if (intersects(g3, drawRect))
             {
-                event.render->drawText(
-                    event.fontSystem->getGlyphs(line, p.size.fontInfo),
-                    p.size.fontMetrics,
-                    pos,
-                    textColor);
+                if (const auto run = event.fontSystem->getGlyphRun(line, p.size.fontInfo))
+                {
+                    event.render->drawText(
+                        run->glyphs,
+                        p.size.fontMetrics,
+                        pos,
+                        textColor);
+                }
             }
             pos.y += p.size.fontMetrics.lineHeight;
         }
@@ -427,6 +437,7 @@ namespace ftk
                 {
                     p.autoScrollTimer = std::chrono::steady_clock::now();
                 }
+                setTickEnabled(true);
             }
             p.autoScroll = autoScroll;
 
@@ -467,6 +478,12 @@ namespace ftk
         {
             window->setTextInput(value);
         }
+        if (value)
+        {
+            // Ticks blink the cursor, and hide it again once the focus is
+            // lost.
+            setTickEnabled(true);
+        }
         if (p.focusCallback)
         {
             p.focusCallback(value);
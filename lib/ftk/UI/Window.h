@@ -5,6 +5,8 @@
 
 #include <ftk/UI/IWindow.h>
 
+#include <future>
+
 namespace ftk
 {
     //! Window.
@@ -42,6 +44,32 @@ namespace ftk
         FTK_API std::shared_ptr<Image> screenshot(const Box2I& = Box2I(0, 0, -1, -1)) override;
         FTK_API std::vector<std::pair<std::string, std::string> > getWindowInfo() const override;
 
+        //! \name Capture
+        ///@{
+
+        //! Capture a screenshot without waiting for the GPU. The pixels are
+        //! read back from the offscreen buffer on the next update, and the
+        //! future is ready a frame or two later. The future carries a null
+        //! image if the window has not drawn yet or is destroyed first.
+        FTK_API std::future<std::shared_ptr<Image> > screenshotAsync(
+            const Box2I& = Box2I(0, 0, -1, -1));
+
+        //! Start capturing every frame the window draws. The frames are read
+        //! back without waiting for the GPU and given to the callback in
+        //! order, a frame or two after they are drawn.
+        FTK_API void startCapture(
+            const std::function<void(const std::shared_ptr<Image>&)>&,
+            const Box2I& = Box2I(0, 0, -1, -1));
+
+        //! Stop capturing. Frames already being read back are still given to
+        //! the callback.
+        FTK_API void stopCapture();
+
+        //! Get whether frames are being captured.
+        FTK_API bool isCapturing() const;
+
+        ///@}
+
         FTK_API Size2I getSizeHint() const override;
         FTK_API void setGeometry(const Box2I&) override;
         FTK_API void setVisible(bool) override;
@@ -55,6 +83,8 @@ namespace ftk
             const std::shared_ptr<FontSystem>&,
             const std::shared_ptr<IconSystem>&,
             const std::shared_ptr<Style>&) override;
+        bool _hasUpdate() const override;
+        void _getNextUpdate(std::chrono::steady_clock::time_point&) const override;
 
     private:
         friend class App;
@@ -9,6 +9,7 @@
 
 #include <ftk/GL/GL.h>
 #include <ftk/GL/OffscreenBuffer.h>
+#include <ftk/GL/Readback.h>
 #include <ftk/GL/System.h>
 #include <ftk/GL/Window.h>
 #if defined(FTK_API_GLES_2)
@@ -22,6 +23,8 @@
 #include <ftk/Core/LogSystem.h>
 #include <ftk/Core/FontSystem.h>
 
+#include <list>
+
 namespace ftk
 {
     struct Window::Private
@@ -32,6 +35,13 @@ namespace ftk
 
         std::shared_ptr<gl::OffscreenBuffer> buffer;
         std::shared_ptr<IRender> render;
+
+        std::shared_ptr<gl::Readback> readback;
+        std::list<std::pair<Box2I, std::shared_ptr<std::promise<std::shared_ptr<Image> > > > > screenshots;
+        std::function<void(const std::shared_ptr<Image>&)> capture;
+        Box2I captureRect;
+
+        Box2I getReadRect(const Box2I&) const;
 #if defined(FTK_API_GLES_2)
         std::shared_ptr<gl::Shader> shader;
         std::shared_ptr<gl::VBO> vbo;
@@ -41,6 +51,12 @@ namespace ftk
 #endif // FTK_API_GLES_2
     };
 
+    Box2I Window::Private::getReadRect(const Box2I& value) const
+    {
+        const Box2I bufferRect(V2I(), buffer->getSize());
+        return value.isValid() ? intersect(value, bufferRect) : bufferRect;
+    }
+
     void Window::_init(
         const std::shared_ptr<Context>& context,
         const std::shared_ptr<App>& app,
@@ -104,6 +120,70 @@ namespace ftk
                 auto window = windowWeak.lock();
                 return window ? window->_p->render->getDiag().glyphs : 0;
             });
+        // A group of their own; the frame graph has no colors left.
+        diagSystem->addSampler(
+            "ftk Draw/Calls: {0}",
+            [windowWeak]
+            {
+                auto window = windowWeak.lock();
+                return window ? window->_p->render->getDiag().drawCalls : 0;
+            });
+        diagSystem->addSampler(
+            "ftk Draw/Batches: {0}",
+            [windowWeak]
+            {
+                auto window = windowWeak.lock();
+                return window ? window->_p->render->getDiag().batches : 0;
+            });
+        diagSystem->addSampler(
+            "ftk Glyph Atlas/Pages: {0}",
+            [windowWeak]
+            {
+                auto window = windowWeak.lock();
+                return window ? window->_p->render->getDiag().glyphAtlasPages : 0;
+            });
+        diagSystem->addSampler(
+            "ftk Glyph Atlas/Used: {0}%",
+            [windowWeak]
+            {
+                auto window = windowWeak.lock();
+                return window ? window->_p->render->getDiag().glyphAtlasPercentage : 0;
+            });
+        diagSystem->addSampler(
+            "ftk Glyph Atlas/Evictions: {0}",
+            [windowWeak]
+            {
+                auto window = windowWeak.lock();
+                return window ? window->_p->render->getDiag().glyphAtlasEvictions : 0;
+            });
+        diagSystem->addSampler(
+            "ftk Glyph Atlas/Uploads: {0}",
+            [windowWeak]
+            {
+                auto window = windowWeak.lock();
+                return window ? window->_p->render->getDiag().glyphUploads : 0;
+            });
+        diagSystem->addSampler(
+            "ftk Texture Pool/Hits: {0}",
+            [windowWeak]
+            {
+                auto window = windowWeak.lock();
+                return window ? window->_p->render->getDiag().texturePoolHits : 0;
+            });
+        diagSystem->addSampler(
+            "ftk Texture Pool/Misses: {0}",
+            [windowWeak]
+            {
+                auto window = windowWeak.lock();
+                return window ? window->_p->render->getDiag().texturePoolMisses : 0;
+            });
+        diagSystem->addSampler(
+            "ftk Texture Pool/Evictions: {0}",
+            [windowWeak]
+            {
+                auto window = windowWeak.lock();
+                return window ? window->_p->render->getDiag().texturePoolEvictions : 0;
+            });
 
         setVisible(false);
     }
@@ -116,6 +196,15 @@ namespace ftk
     {
         FTK_P();
         p.window->makeCurrent();
+        if (p.readback)
+        {
+            p.readback->tick(true);
+            p.readback.reset();
+        }
+        for (const auto& screenshot : p.screenshots)
+        {
+            screenshot.second->set_value(nullptr);
+        }
         p.render.reset();
         p.buffer.reset();
     }
@@ -220,6 +309,37 @@ namespace ftk
         return out;
     }
 
+    std::future<std::shared_ptr<Image> > Window::screenshotAsync(const Box2I& rect)
+    {
+        FTK_P();
+        auto promise = std::make_shared<std::promise<std::shared_ptr<Image> > >();
+        auto out = promise->get_future();
+        p.screenshots.push_back(std::make_pair(rect, promise));
+        return out;
+    }
+
+    void Window::startCapture(
+        const std::function<void(const std::shared_ptr<Image>&)>& callback,
+        const Box2I& rect)
+    {
+        FTK_P();
+        p.capture = callback;
+        p.captureRect = rect;
+        // Start with what is on screen now rather than waiting for the
+        // window to change.
+        setDrawUpdate();
+    }
+
+    void Window::stopCapture()
+    {
+        _p->capture = nullptr;
+    }
+
+    bool Window::isCapturing() const
+    {
+        return _p->capture != nullptr;
+    }
+
     std::vector<std::pair<std::string, std::string> > Window::getWindowInfo() const
     {
         FTK_P();
@@ -280,6 +400,10 @@ namespace ftk
     
     namespace
     {
+        // How often a read back in flight is checked for, rather than every
+        // time through the event loop.
+        const std::chrono::milliseconds readbackPoll(2);
+
         gl::TextureType getTextureType(WindowBufferType value)
         {
             gl::TextureType out = gl::TextureType::None;
@@ -301,24 +425,33 @@ namespace ftk
     {
         IWindow::_update(fontSystem, iconSystem, style);
         FTK_P();
-        if (_hasDrawUpdate(shared_from_this()))
+        Box2I damage;
+        if (_getDrawDamage(damage))
         {
             p.window->makeCurrent();
 
+            // The buffer keeps what was drawn last time, so only the damaged
+            // part of it is cleared and drawn again; a new buffer has nothing
+            // in it to keep.
             const Size2I& bufferSize = getBufferSize();
             const WindowBufferType bufferType = getBufferType();
             const gl::TextureType textureType = getTextureType(bufferType);
+            const Box2I drawRect(V2I(), bufferSize);
             if (gl::doCreate(p.buffer, bufferSize, textureType))
             {
                 p.buffer = gl::OffscreenBuffer::create(bufferSize, textureType);
+                damage = drawRect;
             }
+            damage = intersect(damage, drawRect);
             if (p.buffer)
             {
                 gl::OffscreenBufferBinding bufferBinding(p.buffer);
-                p.render->begin(bufferSize);
-                const Box2I drawRect(V2I(), bufferSize);
-                p.render->setClipRectEnabled(false);
-                p.render->setClipRect(drawRect);
+                RenderOptions renderOptions;
+                renderOptions.clear = false;
+                p.render->begin(bufferSize, renderOptions);
+                p.render->setClipRectEnabled(true);
+                p.render->setClipRect(damage);
+                p.render->clearViewport(renderOptions.clearColor);
                 DrawEvent drawEvent(
                     fontSystem,
                     iconSystem,
@@ -328,9 +461,19 @@ namespace ftk
                 _drawEventRecursive(
                     shared_from_this(),
                     drawRect,
+                    damage,
                     drawEvent);
                 p.render->setClipRectEnabled(false);
                 p.render->end();
+
+                if (p.capture)
+                {
+                    if (!p.readback)
+                    {
+                        p.readback = gl::Readback::create();
+                    }
+                    p.readback->read(p.getReadRect(p.captureRect), p.capture);
+                }
             }
 
 #if defined(FTK_API_GL_4_1)
@@ -451,6 +594,51 @@ namespace ftk
                 p.window->swap();
             }
         }
+
+        // Read back the screenshots once there is something drawn, and hand
+        // over the reads that have finished.
+        if (p.buffer && !p.screenshots.empty())
+        {
+            p.window->makeCurrent();
+            if (!p.readback)
+            {
+                p.readback = gl::Readback::create();
+            }
+            gl::OffscreenBufferBinding bufferBinding(p.buffer);
+            for (const auto& screenshot : p.screenshots)
+            {
+                auto promise = screenshot.second;
+                p.readback->read(
+                    p.getReadRect(screenshot.first),
+                    [promise](const std::shared_ptr<Image>& image)
+                    {
+                        promise->set_value(image);
+                    });
+            }
+            p.screenshots.clear();
+        }
+        if (p.readback && p.readback->getPending() > 0)
+        {
+            p.window->makeCurrent();
+            p.readback->tick();
+        }
+    }
+
+    bool Window::_hasUpdate() const
+    {
+        FTK_P();
+        return
+            IWindow::_hasUpdate() ||
+            !p.screenshots.empty();
+    }
+
+    void Window::_getNextUpdate(std::chrono::steady_clock::time_point& out) const
+    {
+        FTK_P();
+        if (p.readback && p.readback->getPending() > 0)
+        {
+            out = std::min(out, std::chrono::steady_clock::now() + readbackPoll);
+        }
     }
 
     void Window::_makeCurrent()
@@ -114,7 +114,8 @@ namespace ftk
                 .def_property_readonly("observeTooltipsEnabled", &App::observeTooltipsEnabled)
                 .def("exit", &App::exit)
                 .def("run", &App::run)
-                .def("tick", &App::tick);
+                .def("tick", &App::tick)
+                .def("wakeup", &App::wakeup);
         }
     }
 }
@@ -24,6 +24,8 @@ namespace ftk
             {
                 auto out = std::shared_ptr<PyIContainer>(new PyIContainer);
                 out->_init(context, objectName, parent);
+                // Ticked as Python widgets always were; see PyIWidget.
+                out->setTickEnabled(true);
                 return out;
             }
 
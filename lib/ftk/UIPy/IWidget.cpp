@@ -6,6 +6,7 @@
 #include <ftk/UI/IWidget.h>
 #include <ftk/UI/IWindow.h>
 
+#include <pybind11/chrono.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -25,6 +26,11 @@ namespace ftk
             {
                 auto out = std::shared_ptr<PyIWidget>(new PyIWidget);
                 out->_init(context, objectName, parent);
+                // Whether a Python subclass overrides tickEvent() is not
+                // known yet, so they are ticked as they always were. A
+                // subclass that does not need ticks calls
+                // setTickEnabled(False).
+                out->setTickEnabled(true);
                 return out;
             }
             
@@ -145,6 +151,14 @@ namespace ftk
 
                 .def_property("enabled", &IWidget::isEnabled, &IWidget::setEnabled)
 
+                .def_property_readonly("tickEnabled", &IWidget::isTickEnabled)
+                .def_property_readonly("tickPeriod", &IWidget::getTickPeriod)
+                .def(
+                    "setTickEnabled",
+                    &IWidget::setTickEnabled,
+                    py::arg("value"),
+                    py::arg("period") = std::chrono::milliseconds(0))
+
                 .def_property("acceptsKeyFocus", &IWidget::acceptsKeyFocus, &IWidget::setAcceptsKeyFocus)
                 .def_property_readonly("keyFocus", &IWidget::hasKeyFocus)
                 .def("takeKeyFocus", &IWidget::takeKeyFocus)
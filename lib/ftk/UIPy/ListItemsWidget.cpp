@@ -28,7 +28,7 @@ namespace ftk
                 .def("__eq__", &ListItem::operator==)
                 .def("__ne__", &ListItem::operator!=);
 
-            py::class_<ListItemsWidget, IContainer, std::shared_ptr<ListItemsWidget> >(m, "ListItemsWidget")
+            py::class_<ListItemsWidget, IWidget, std::shared_ptr<ListItemsWidget> >(m, "ListItemsWidget")
                 .def(
                     py::init(&ListItemsWidget::create),
                     py::arg("context"),
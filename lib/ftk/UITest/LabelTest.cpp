@@ -10,6 +10,7 @@
 
 #include <ftk/Core/Assert.h>
 #include <ftk/Core/Format.h>
+#include <ftk/Core/SoftwareRender.h>
 
 namespace ftk
 {
@@ -69,6 +70,28 @@ namespace ftk
                 label->setFont(FontType::Mono);
                 FTK_CHECK(FontType::Mono == label->getFont());
 
+                // Draw the window on the CPU: the label's text leaves pixels
+                // that are not the background's.
+                auto render = SoftwareRender::create(
+                    _context->getLogSystem(),
+                    _context->getSystem<FontSystem>());
+                window->draw(render);
+                const auto& image = render->getImage();
+                FTK_CHECK(image);
+                FTK_CHECK(window->getBufferSize() == image->getSize());
+                const uint32_t* pixels = reinterpret_cast<const uint32_t*>(image->getData());
+                const size_t count = static_cast<size_t>(image->getWidth()) * image->getHeight();
+                size_t text = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (pixels[i] != pixels[0])
+                    {
+                        ++text;
+                    }
+                }
+                FTK_CHECK(text > 0);
+                app->tick();
+
                 label->setEnabled(false);
                 app->tick();
                 label->setEnabled(true);
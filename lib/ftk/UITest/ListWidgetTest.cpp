@@ -3,7 +3,10 @@
 
 #include <ftk/UITest/ListWidgetTest.h>
 
+#include <ftk/UI/IButton.h>
 #include <ftk/UI/ListWidget.h>
+#include <ftk/UI/ScrollArea.h>
+#include <ftk/UI/ScrollWidget.h>
 
 #include <ftk/Core/Assert.h>
 #include <ftk/Core/Format.h>
@@ -45,6 +48,19 @@ namespace ftk
             }
         }
 
+        namespace
+        {
+            size_t getButtonCount(const std::shared_ptr<IWidget>& widget)
+            {
+                size_t out = std::dynamic_pointer_cast<IButton>(widget) ? 1 : 0;
+                for (const auto& child : widget->getChildren())
+                {
+                    out += getButtonCount(child);
+                }
+                return out;
+            }
+        }
+
         void ListWidgetTest::_test(
             const std::shared_ptr<Context>& context,
             const std::shared_ptr<App>& app,
@@ -73,6 +89,73 @@ namespace ftk
             widget->clearSearch();
             FTK_CHECK(widget->getSearch().empty());
             app->tick();
+
+            switch (type)
+            {
+            case ButtonGroupType::Check:
+                widget->setChecked(1, true);
+                widget->setChecked(3, true);
+                FTK_CHECK(widget->getChecked(1));
+                FTK_CHECK(widget->getChecked(3));
+                break;
+            case ButtonGroupType::Radio:
+            case ButtonGroupType::Toggle:
+                widget->setChecked(1, true);
+                widget->setChecked(3, true);
+                FTK_CHECK(!widget->getChecked(1));
+                FTK_CHECK(widget->getChecked(3));
+                break;
+            default: break;
+            }
+            widget->setSearch("1");
+            FTK_CHECK(!widget->getChecked(0));
+            if (type != ButtonGroupType::Click)
+            {
+                FTK_CHECK(widget->getChecked(3));
+            }
+            app->tick();
+            widget->clearSearch();
+            app->tick();
+
+            items.clear();
+            for (size_t i = 0; i < 10000; ++i)
+            {
+                items.push_back(ListItem(Format("Item {0}").arg(i)));
+            }
+            widget->setItems(items);
+            app->tick();
+
+            // Only the rows in the viewport, and half a viewport either
+            // side, have a button.
+            auto scrollWidget = std::dynamic_pointer_cast<ScrollWidget>(
+                widget->getChildren().front());
+            FTK_CHECK(scrollWidget);
+            const int viewportHeight = scrollWidget->getScrollArea()->getGeometry().h();
+            const int rowHeight = scrollWidget->getScrollSize().h / 10000;
+            FTK_CHECK(viewportHeight > 0);
+            FTK_CHECK(rowHeight > 0);
+            const size_t buttonsMax = viewportHeight * 2 / rowHeight + 2;
+            size_t buttons = getButtonCount(widget);
+            FTK_CHECK(buttons > 0);
+            FTK_CHECK(buttons <= buttonsMax);
+
+            widget->setCurrent(9999);
+            FTK_CHECK(9999 == widget->getCurrent());
+            app->tick();
+            buttons = getButtonCount(widget);
+            FTK_CHECK(buttons > 0);
+            FTK_CHECK(buttons <= buttonsMax);
+            scrollWidget->setScrollPos(V2I(0, scrollWidget->getScrollSize().h / 2));
+            app->tick();
+            buttons = getButtonCount(widget);
+            FTK_CHECK(buttons > 0);
+            FTK_CHECK(buttons <= buttonsMax);
+            widget->setSearch("999");
+            app->tick();
+            widget->clearSearch();
+            app->tick();
+
+            widget->setParent(nullptr);
         }
     }
 }
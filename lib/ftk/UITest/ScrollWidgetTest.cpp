@@ -54,6 +54,7 @@ namespace ftk
             auto scrollWidget = ScrollWidget::create(context, scrollType, window);
             auto layout = GridLayout::create(context);
             layout->setMarginRole(SizeRole::MarginLarge);
+            std::vector<std::shared_ptr<Label> > labels;
             for (int row = 0; row < 20; ++row)
             {
                 for (int column = 0; column < 20; ++column)
@@ -65,6 +66,7 @@ namespace ftk
                     label->setFontSize(32);
                     label->setMarginRole(SizeRole::MarginLarge);
                     layout->setGridPos(label, row, column);
+                    labels.push_back(label);
                 }
             }
             scrollWidget->setWidget(layout);
@@ -100,6 +102,20 @@ namespace ftk
             Size2I size = scrollWidget->getScrollSize();
             scrollWidget->setScrollPos(V2I(size.w, size.h));
             app->tick();
+            if (ScrollType::Both == scrollType)
+            {
+                // Scrolling moves the contents without changing what the
+                // scroll widget is clipped to, and the labels scrolled into
+                // view still have to be clipped again.
+                FTK_CHECK(labels.front()->isClipped());
+                FTK_CHECK(!labels.back()->isClipped());
+                scrollWidget->setScrollPos(V2I(0, 0));
+                app->tick();
+                FTK_CHECK(!labels.front()->isClipped());
+                FTK_CHECK(labels.back()->isClipped());
+                scrollWidget->setScrollPos(V2I(size.w, size.h));
+                app->tick();
+            }
             window->setSize(Size2I(size.w * 2, size.h * 2));
             app->tick();
             window->setSize(Size2I(1280, 960));
@@ -14,6 +14,7 @@ class RenderOptionsTest(unittest.TestCase):
         self.assertTrue(o.texturePoolByteCount > 0)
         self.assertTrue(o.textureCacheByteCount > 0)
         self.assertTrue(o.glyphAtlasSize > 0)
+        self.assertTrue(o.glyphAtlasPages > 0)
         self.assertTrue(o.log)
         self.assertEqual(o, ftk.RenderOptions())
         o.clear = False
@@ -57,7 +58,7 @@ class RenderOptionsTest(unittest.TestCase):
             ["_None", "Straight", "Premultiplied"])
         self.assertEqual(
             [i.name for i in ftk.ImageFilter.__members__.values()],
-            ["Nearest", "Linear", "HighQuality"])
+            ["Nearest", "Linear", "HighQuality", "Mipmap"])
 
 if __name__ == '__main__':
     unittest.main()
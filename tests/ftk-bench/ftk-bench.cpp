@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the feather-tk project.
+
+#include <ftk/Core/Format.h>
+#include <ftk/Core/ImageConvert.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ftk
+{
+    namespace bench
+    {
+        struct Conversion
+        {
+            ImageType in = ImageType::None;
+            ImageType out = ImageType::None;
+            bool premultiply = false;
+        };
+
+        // Time a conversion, returning the bytes read and written per
+        // second.
+        double run(
+            const Conversion& conversion,
+            const Size2I& size,
+            size_t threads,
+            int iterations)
+        {
+            auto in = Image::create(size, conversion.in);
+            in->zero();
+            auto out = Image::create(size, conversion.out);
+            ConvertOptions options;
+            options.premultiply = conversion.premultiply;
+            options.threads = threads;
+            convert(*in, *out, options);
+            const auto t0 = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i)
+            {
+                convert(*in, *out, options);
+            }
+            const auto t1 = std::chrono::steady_clock::now();
+            const double seconds = std::chrono::duration<double>(t1 - t0).count();
+            return (in->getByteCount() + out->getByteCount()) * iterations / seconds;
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace ftk;
+
+    // Usage: ftk-bench [width height [threads [iterations]]]
+    Size2I size(3840, 2160);
+    size_t threads = 0;
+    int iterations = 10;
+    try
+    {
+        if (argc > 2)
+        {
+            size.w = std::stoi(argv[1]);
+            size.h = std::stoi(argv[2]);
+        }
+        if (argc > 3)
+        {
+            threads = std::stoul(argv[3]);
+        }
+        if (argc > 4)
+        {
+            iterations = std::stoi(argv[4]);
+        }
+    }
+    catch (const std::exception&)
+    {
+        std::cout << "Usage: ftk-bench [width height [threads [iterations]]]" << std::endl;
+        return 1;
+    }
+
+    const std::vector<bench::Conversion> conversions =
+    {
+        { ImageType::RGBA_U8, ImageType::RGBA_U8 },
+        { ImageType::L_U8, ImageType::RGBA_U8 },
+        { ImageType::RGB_U8, ImageType::RGBA_U8 },
+        { ImageType::RGBA_U8, ImageType::RGB_U8 },
+        { ImageType::RGBA_U8, ImageType::L_U8 },
+        { ImageType::RGBA_U8, ImageType::RGBA_U8, true },
+        { ImageType::RGBA_U8, ImageType::RGBA_F16 },
+        { ImageType::RGBA_U8, ImageType::RGBA_F32 },
+        { ImageType::RGBA_U16, ImageType::RGBA_U8 },
+        { ImageType::RGBA_F16, ImageType::RGBA_U8 },
+        { ImageType::RGBA_F32, ImageType::RGBA_U8 },
+        { ImageType::RGB_U10, ImageType::RGBA_U16 },
+        { ImageType::YUV_420P_U8, ImageType::RGBA_U8 },
+        { ImageType::YUV_422P_U8, ImageType::RGBA_U8 },
+        { ImageType::YUV_444P_U8, ImageType::RGBA_U8 },
+        { ImageType::YUV_420P_U16, ImageType::RGBA_U16 },
+        { ImageType::YUV_420SP_U8, ImageType::RGBA_U8 },
+        { ImageType::YUV_420SP_U16, ImageType::RGBA_F16 },
+        { ImageType::RGBA_U8, ImageType::YUV_420P_U8 }
+    };
+    for (const auto& conversion : conversions)
+    {
+        const double bytes = bench::run(conversion, size, threads, iterations);
+        std::cout << Format("{0} -> {1}{2}: {3} GB/s").
+            arg(to_string(conversion.in), 14).
+            arg(to_string(conversion.out)).
+            arg(conversion.premultiply ? " premultiplied" : "").
+            arg(bytes / 1000000000.0, 2) << std::endl;
+    }
+    return 0;
+}
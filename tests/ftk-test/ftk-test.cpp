@@ -64,6 +64,7 @@
 #if defined(FTK_API_GL_4_1) || defined(FTK_API_GLES_2)
 #include <ftk/GLTest/MeshTest.h>
 #include <ftk/GLTest/OffscreenBufferTest.h>
+#include <ftk/GLTest/ReadbackTest.h>
 #include <ftk/GLTest/TextureAtlasTest.h>
 #include <ftk/GLTest/TextureTest.h>
 #include <ftk/GLTest/RenderTest.h>
@@ -82,7 +83,9 @@
 #include <ftk/CoreTest/FileIOTest.h>
 #include <ftk/CoreTest/FontSystemTest.h>
 #include <ftk/CoreTest/FormatTest.h>
+#include <ftk/CoreTest/ImageConvertTest.h>
 #include <ftk/CoreTest/ImageIOTest.h>
+#include <ftk/CoreTest/ImageResizeTest.h>
 #include <ftk/CoreTest/ImageTest.h>
 #include <ftk/CoreTest/LRUCacheTest.h>
 #include <ftk/CoreTest/MathTest.h>
@@ -98,6 +101,7 @@
 #include <ftk/CoreTest/RangeTest.h>
 #include <ftk/CoreTest/RenderOptionsTest.h>
 #include <ftk/CoreTest/RenderUtilTest.h>
+#include <ftk/CoreTest/SoftwareRenderTest.h>
 #include <ftk/CoreTest/SizeTest.h>
 #include <ftk/CoreTest/StringTest.h>
 #include <ftk/CoreTest/SystemTest.h>
@@ -168,7 +172,9 @@ namespace ftk
             p.tests.push_back(core_test::FileIOTest::create(context));
             p.tests.push_back(core_test::FontSystemTest::create(context));
             p.tests.push_back(core_test::FormatTest::create(context));
+            p.tests.push_back(core_test::ImageConvertTest::create(context));
             p.tests.push_back(core_test::ImageIOTest::create(context));
+            p.tests.push_back(core_test::ImageResizeTest::create(context));
             p.tests.push_back(core_test::ImageTest::create(context));
             p.tests.push_back(core_test::LRUCacheTest::create(context));
             p.tests.push_back(core_test::MathTest::create(context));
@@ -184,6 +190,7 @@ namespace ftk
             p.tests.push_back(core_test::RangeTest::create(context));
             p.tests.push_back(core_test::RenderOptionsTest::create(context));
             p.tests.push_back(core_test::RenderUtilTest::create(context));
+            p.tests.push_back(core_test::SoftwareRenderTest::create(context));
             p.tests.push_back(core_test::SizeTest::create(context));
             p.tests.push_back(core_test::StringTest::create(context));
             p.tests.push_back(core_test::SystemTest::create(context));
@@ -196,6 +203,7 @@ namespace ftk
             {
                 p.tests.push_back(gl_test::MeshTest::create(context));
                 p.tests.push_back(gl_test::OffscreenBufferTest::create(context));
+                p.tests.push_back(gl_test::ReadbackTest::create(context));
                 p.tests.push_back(gl_test::TextureAtlasTest::create(context));
                 p.tests.push_back(gl_test::TextureTest::create(context));
                 p.tests.push_back(gl_test::RenderTest::create(context));